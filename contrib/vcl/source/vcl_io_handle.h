@@ -44,6 +44,9 @@ public:
                                   uint32_t self_port, RecvMsgOutput& output) override;
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                    RecvMsgOutput& output) override;
+  Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, uint64_t gso_size,
+                                   const Envoy::Network::Address::Ip* self_ip,
+                                   const Envoy::Network::Address::Instance& peer_address) override;
   absl::optional<std::chrono::milliseconds> lastRoundTripTime() override;
   absl::optional<uint64_t> congestionWindowInBytes() const override;
 
@@ -117,6 +117,18 @@ public:
                    absl::get<InlinedStringVector>(buffer_).begin(), unary_op);
   }
 
+  /**
+   * Transforms the inlined vector data in place using the given RangeOperation, which is called
+   * once with the data pointer and size. Allows transforms that work on more than one element at
+   * a time.
+   * @param range_op the operation to be performed on the elements.
+   */
+  template <typename RangeOperation> void inlineTransformRange(RangeOperation&& range_op) {
+    ASSERT(type() == Type::Inline);
+    auto& vec = absl::get<InlinedStringVector>(buffer_);
+    range_op(vec.data(), vec.size());
+  }
+
   /**
    * Trim trailing whitespaces from the InlinedString. Only supported by the "Inline" InlinedString
    * representation.
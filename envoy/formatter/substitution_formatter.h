@@ -76,6 +76,30 @@ public:
                                          const Http::ResponseTrailerMap& response_trailers,
                                          const StreamInfo::StreamInfo& stream_info,
                                          absl::string_view local_reply_body) const PURE;
+  /**
+   * Append a value extracted from the provided headers/trailers/stream to output. Providers
+   * override it to write their value without the temporary string returned by format().
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param local_reply_body supplies the local reply body.
+   * @param output supplies the string to append the value to.
+   * @return false if there is no value, in which case output is left unchanged.
+   */
+  virtual bool formatTo(const Http::RequestHeaderMap& request_headers,
+                        const Http::ResponseHeaderMap& response_headers,
+                        const Http::ResponseTrailerMap& response_trailers,
+                        const StreamInfo::StreamInfo& stream_info,
+                        absl::string_view local_reply_body, std::string& output) const {
+    const absl::optional<std::string> value =
+        format(request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+    if (!value.has_value()) {
+      return false;
+    }
+    output.append(value.value());
+    return true;
+  }
 };
 
 using FormatterProviderPtr = std::unique_ptr<FormatterProvider>;
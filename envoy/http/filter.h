@@ -20,6 +20,7 @@
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
 
+#include "source/common/common/arena.h"
 #include "source/common/common/scope_tracked_object_stack.h"
 
 #include "absl/types/optional.h"
@@ -1166,6 +1167,14 @@ public:
    * @param return the worker thread's dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Allows filter factories to allocate their filters, e.g. with std::allocate_shared() and an
+   * ArenaAllocator, from an arena released when the stream is destroyed. Filters allocated from
+   * the arena must not be referenced after the stream is destroyed.
+   * @return the stream arena, if per-stream arenas are enabled.
+   */
+  virtual OptRef<Arena> streamArena() { return {}; }
 };
 } // namespace Http
 } // namespace Envoy
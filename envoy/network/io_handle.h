@@ -183,6 +183,22 @@ public:
   virtual Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                            RecvMsgOutput& output) PURE;
 
+  /**
+   * If the platform supports, send multiple messages to the address in one call.
+   * @param slices are the payloads of the messages. Each entry of |slices| is sent as an
+   * individual message.
+   * @param gso_size if not 0, the payload of each message is split by the kernel into datagrams
+   * of gso_size bytes, the last of which may be shorter. Only valid if the platform supports UDP
+   * GSO.
+   * @param self_ip is the same as the one in sendmsg().
+   * @param peer_address is the destination address.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages sent for success.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, uint64_t gso_size,
+                                           const Address::Ip* self_ip,
+                                           const Address::Instance& peer_address) PURE;
+
   /**
    * Read data into given buffer for connected handles
    * @param buffer buffer to read the data into
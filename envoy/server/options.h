@@ -200,6 +200,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint32_t the number of threads shared by all files to flush logs, or 0 if each file
+   *         uses its own flush thread.
+   */
+  virtual uint32_t fileFlushThreads() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -94,6 +94,19 @@ public:
   virtual void forEachSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) const PURE;
   virtual void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const PURE;
 
+  /**
+   * Iterate over the stats that need to be flushed to sinks and were written since the previous
+   * call, forgetting that they were. The first call visits every stat that needs to be flushed to
+   * sinks and starts tracking the writes, which costs a lock on the first write of each stat after
+   * each call. The same restrictions on the functors apply as for forEachSinkedCounter.
+   * @param f_size functor that is provided an upper bound of the number of stats that will be
+   * visited. Note that this is called only once, prior to any calls to f_stat.
+   * @param f_stat functor that is provided one stat that changed, at a time.
+   */
+  virtual void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) PURE;
+  virtual void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) PURE;
+  virtual void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) PURE;
+
   /**
    * Set the predicates to filter stats for sink.
    */
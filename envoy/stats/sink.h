@@ -91,6 +91,13 @@ public:
    */
   virtual void flush(MetricSnapshot& snapshot) PURE;
 
+  /**
+   * @return true if the sink only needs the counters, gauges and text readouts written since the
+   * previous flush, and the histograms with samples in the flush interval. The first flush has all
+   * the metrics. Only the changed metrics are snapshotted if all the sinks return true.
+   */
+  virtual bool flushChangedMetricsOnly() const { return false; }
+
   /**
    * Flush a single histogram sample. Note: this call is called synchronously as a part of recording
    * the metric, so implementations must be thread-safe.
@@ -139,6 +139,20 @@ public:
   virtual void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const PURE;
   virtual void forEachSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) const PURE;
 
+  /**
+   * Iterate over the stats that need to be flushed to sinks and were written since the previous
+   * call, forgetting that they were. The first call visits every stat that needs to be flushed to
+   * sinks. Implementations that do not track writes visit every stat that needs to be flushed to
+   * sinks on each call. The same restrictions on the functors apply as for forEachSinkedCounter.
+   * Histograms are not tracked, as they are all merged on each flush anyway.
+   * @param f_size functor that is provided an upper bound of the number of stats that will be
+   * visited. Note that this is called only once, prior to any calls to f_stat.
+   * @param f_stat functor that is provided one stat that changed, at a time.
+   */
+  virtual void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) PURE;
+  virtual void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) PURE;
+  virtual void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) PURE;
+
   /**
    * Calls 'fn' for every stat. Note that in the case of overlapping scopes, the
    * implementation may call fn more than one time for each counter. Iteration
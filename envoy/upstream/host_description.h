@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -16,6 +18,7 @@
 #include "envoy/upstream/outlier_detection.h"
 #include "envoy/upstream/resource_manager.h"
 
+#include "absl/base/optimization.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -85,6 +88,36 @@ public:
   virtual StatMapPtr latch() PURE;
 };
 
+/**
+ * Load of a host shared by all workers. It is updated by the connection pools of every worker and
+ * read by load balancers on every worker, so it is kept on its own cache line, apart from the
+ * host stats that are also updated for each request.
+ */
+struct ABSL_CACHELINE_ALIGNED HostLoad {
+  // The requests assigned to the host, both those waiting for a connection and those active on
+  // one.
+  std::atomic<uint64_t> outstanding_requests_{0};
+};
+
+/**
+ * State kept for a host by the load balancing policy of its cluster, shared by the load balancers
+ * of all workers. It is notified of the requests completed by the host, on the worker that
+ * completed them, so it must be thread safe.
+ */
+class HostLbPolicyData {
+public:
+  virtual ~HostLbPolicyData() = default;
+
+  /**
+   * Called when a request to the host completed.
+   * @param response_time the time from sending the first byte of the request to receiving the last
+   *        byte of the response.
+   */
+  virtual void onResponseTime(std::chrono::microseconds response_time) PURE;
+};
+
+using HostLbPolicyDataPtr = std::unique_ptr<HostLbPolicyData>;
+
 class ClusterInfo;
 
 /**
@@ -172,6 +205,23 @@ public:
    */
   virtual LoadMetricStats& loadMetricStats() const PURE;
 
+  /**
+   * @return the load of the host across all workers.
+   */
+  virtual HostLoad& load() const PURE;
+
+  /**
+   * @return the state kept for the host by the load balancing policy of its cluster, or nullptr if
+   *         there is none yet.
+   */
+  virtual HostLbPolicyData* lbPolicyData() const PURE;
+
+  /**
+   * Sets the state kept for the host by the load balancing policy of its cluster, unless it is
+   * already set. Called on the main thread, possibly after workers started using the host.
+   */
+  virtual void setLbPolicyData(HostLbPolicyDataPtr&& lb_policy_data) PURE;
+
   /**
    * @return the locality of the host (deployment specific). This will be the default instance if
    *         unknown.
@@ -892,6 +892,12 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the adaptive preconnect configuration of the cluster, if it is set.
+   */
+  virtual OptRef<const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>
+  adaptivePreconnect() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
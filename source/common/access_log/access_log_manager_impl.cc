@@ -1,5 +1,6 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -13,6 +14,117 @@
 namespace Envoy {
 namespace AccessLog {
 
+AccessLogFlushThreadPool::AccessLogFlushThreadPool(uint32_t num_threads,
+                                                   Event::Dispatcher& dispatcher,
+                                                   std::chrono::milliseconds flush_interval_msec,
+                                                   Thread::ThreadFactory& thread_factory,
+                                                   AccessLogFileStats& stats)
+    : flush_interval_msec_(flush_interval_msec), stats_(stats),
+      flush_timer_(dispatcher.createTimer([this]() -> void { onFlushTimer(); })) {
+  ASSERT(num_threads > 0);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    auto flush_thread = std::make_unique<FlushThread>();
+    FlushThread& flush_thread_ref = *flush_thread;
+    flush_thread->thread_ = thread_factory.createThread(
+        [this, &flush_thread_ref]() -> void { flushThreadFunc(flush_thread_ref); },
+        Thread::Options{"AccessLogFlush"});
+    flush_threads_.push_back(std::move(flush_thread));
+  }
+  flush_timer_->enableTimer(flush_interval_msec_);
+}
+
+AccessLogFlushThreadPool::~AccessLogFlushThreadPool() {
+  for (auto& flush_thread : flush_threads_) {
+    Thread::LockGuard lock(flush_thread->lock_);
+    flush_thread->exit_ = true;
+    flush_thread->flush_event_.notifyOne();
+  }
+  for (auto& flush_thread : flush_threads_) {
+    flush_thread->thread_->join();
+  }
+}
+
+uint32_t AccessLogFlushThreadPool::addFile(AccessLogFileImpl& file) {
+  const uint32_t thread_index = next_thread_index_;
+  next_thread_index_ = (next_thread_index_ + 1) % flush_threads_.size();
+
+  FlushThread& flush_thread = *flush_threads_[thread_index];
+  Thread::LockGuard lock(flush_thread.lock_);
+  flush_thread.files_.push_back(&file);
+  return thread_index;
+}
+
+void AccessLogFlushThreadPool::removeFile(AccessLogFileImpl& file, uint32_t thread_index) {
+  FlushThread& flush_thread = *flush_threads_[thread_index];
+  {
+    Thread::LockGuard lock(flush_thread.lock_);
+    flush_thread.files_.erase(
+        std::remove(flush_thread.files_.begin(), flush_thread.files_.end(), &file),
+        flush_thread.files_.end());
+    flush_thread.scheduled_files_.erase(&file);
+  }
+
+  // The file may have been picked up for flushing before it was removed. Wait for that flush to
+  // complete.
+  Thread::LockGuard flushing_lock(flush_thread.flushing_lock_);
+}
+
+void AccessLogFlushThreadPool::scheduleFlush(AccessLogFileImpl& file, uint32_t thread_index) {
+  FlushThread& flush_thread = *flush_threads_[thread_index];
+  Thread::LockGuard lock(flush_thread.lock_);
+  flush_thread.scheduled_files_.insert(&file);
+  flush_thread.flush_event_.notifyOne();
+}
+
+void AccessLogFlushThreadPool::onFlushTimer() {
+  for (auto& flush_thread : flush_threads_) {
+    Thread::LockGuard lock(flush_thread->lock_);
+    if (flush_thread->files_.empty()) {
+      continue;
+    }
+    stats_.flushed_by_timer_.add(flush_thread->files_.size());
+    flush_thread->flush_all_ = true;
+    flush_thread->flush_event_.notifyOne();
+  }
+  flush_timer_->enableTimer(flush_interval_msec_);
+}
+
+void AccessLogFlushThreadPool::flushThreadFunc(FlushThread& flush_thread) {
+  while (true) {
+    std::vector<AccessLogFileImpl*> files;
+    std::unique_lock<Thread::BasicLockable> flushing_lock;
+
+    {
+      Thread::LockGuard lock(flush_thread.lock_);
+      while (!flush_thread.flush_all_ && flush_thread.scheduled_files_.empty() &&
+             !flush_thread.exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        flush_thread.flush_event_.wait(flush_thread.lock_);
+      }
+
+      if (flush_thread.exit_) {
+        return;
+      }
+
+      if (flush_thread.flush_all_) {
+        files = flush_thread.files_;
+      } else {
+        files.assign(flush_thread.scheduled_files_.begin(), flush_thread.scheduled_files_.end());
+      }
+      flush_thread.flush_all_ = false;
+      flush_thread.scheduled_files_.clear();
+
+      // Acquired before releasing lock_, so that removeFile() either removes a file before it is
+      // picked up here, or waits for the flush below to complete.
+      flushing_lock = std::unique_lock<Thread::BasicLockable>(flush_thread.flushing_lock_);
+    }
+
+    for (AccessLogFileImpl* file : files) {
+      file->flushAndReopen();
+    }
+  }
+}
+
 AccessLogManagerImpl::~AccessLogManagerImpl() {
   for (auto& [log_key, log_file_ptr] : access_logs_) {
     ENVOY_LOG(debug, "destroying access logger {}", log_key);
@@ -34,29 +146,41 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   if (access_logs_.count(file_name)) {
     return access_logs_[file_name];
   }
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  if (file_flush_threads_ > 0 && flush_thread_pool_ == nullptr) {
+    flush_thread_pool_ = std::make_unique<AccessLogFlushThreadPool>(
+        file_flush_threads_, dispatcher_, file_flush_interval_msec_, api_.threadFactory(),
+        file_stats_);
+  }
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_,
+      api_.threadFactory(), flush_thread_pool_.get());
   return access_logs_[file_name];
 }
 
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
-      flush_timer_(dispatcher.createTimer([this]() -> void {
-        stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
-        flush_timer_->enableTimer(flush_interval_msec_);
-      })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
-  flush_timer_->enableTimer(flush_interval_msec_);
+                                     Thread::ThreadFactory& thread_factory,
+                                     AccessLogFlushThreadPool* flush_thread_pool)
+    : file_(std::move(file)), file_lock_(lock), thread_factory_(thread_factory),
+      flush_interval_msec_(flush_interval_msec), stats_(stats),
+      flush_thread_pool_(flush_thread_pool) {
+  if (flush_thread_pool_ == nullptr) {
+    flush_timer_ = dispatcher.createTimer([this]() -> void {
+      stats_.flushed_by_timer_.inc();
+      flush_event_.notifyOne();
+      flush_timer_->enableTimer(flush_interval_msec_);
+    });
+    flush_timer_->enableTimer(flush_interval_msec_);
+  }
   auto open_result = open();
   if (!open_result.return_value_) {
     throw EnvoyException(fmt::format("unable to open file '{}': {}", file_->path(),
                                      open_result.err_->getErrorDetails()));
   }
+  if (flush_thread_pool_ != nullptr) {
+    flush_thread_index_ = flush_thread_pool_->addFile(*this);
+  }
 }
 
 Filesystem::FlagSet AccessLogFileImpl::defaultFlags() {
@@ -75,8 +199,12 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
+  if (flush_thread_pool_ != nullptr) {
+    flush_thread_pool_->removeFile(*this, flush_thread_index_);
+  }
+
   {
-    Thread::LockGuard lock(write_lock_);
+    Thread::LockGuard lock(flush_event_lock_);
     flush_thread_exit_ = true;
     flush_event_.notifyOne();
   }
@@ -87,8 +215,10 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    Thread::LockGuard flush_lock(flush_lock_);
+    drainWriteQueue();
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -125,91 +255,154 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
+AccessLogFileImpl::WriteQueue::WriteQueue() : head_(&stub_), tail_(&stub_) {}
+
+AccessLogFileImpl::WriteQueue::~WriteQueue() {
+  while (pop() != nullptr) {
+  }
+}
+
+void AccessLogFileImpl::WriteQueue::push(NodePtr node) { pushNode(node.release()); }
+
+void AccessLogFileImpl::WriteQueue::pushNode(Node* node) {
+  node->next_.store(nullptr, std::memory_order_relaxed);
+  Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+  // Until this store the consumer can't get past prev, pop() returns nullptr in the meantime.
+  prev->next_.store(node, std::memory_order_release);
+}
+
+AccessLogFileImpl::WriteQueue::NodePtr AccessLogFileImpl::WriteQueue::pop() {
+  Node* tail = tail_;
+  Node* next = tail->next_.load(std::memory_order_acquire);
+  if (tail == &stub_) {
+    if (next == nullptr) {
+      return nullptr;
+    }
+    tail_ = next;
+    tail = next;
+    next = next->next_.load(std::memory_order_acquire);
+  }
+
+  if (next != nullptr) {
+    tail_ = next;
+    return NodePtr(tail);
+  }
+
+  if (tail != head_.load(std::memory_order_acquire)) {
+    // A producer is in the middle of pushing after tail.
+    return nullptr;
+  }
+
+  // tail is the last node. Push the stub behind it so that tail can be handed out without leaving
+  // the list empty.
+  pushNode(&stub_);
+  next = tail->next_.load(std::memory_order_acquire);
+  if (next != nullptr) {
+    tail_ = next;
+    return NodePtr(tail);
+  }
+  return nullptr;
+}
+
+void AccessLogFileImpl::drainWriteQueue() {
+  uint64_t drained_bytes = 0;
+  for (WriteQueue::NodePtr node = write_queue_.pop(); node != nullptr;
+       node = write_queue_.pop()) {
+    about_to_write_buffer_.add(node->data_);
+    drained_bytes += node->data_.size();
+  }
+  pending_bytes_ -= drained_bytes;
+}
+
 void AccessLogFileImpl::flushThreadFunc() {
 
   while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
-
     {
-      Thread::LockGuard write_lock(write_lock_);
+      Thread::LockGuard flush_event_lock(flush_event_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      // flush_event_ can be woken up either by large enough pending data or by timer.
+      // In case it was timer, there can be no pending data.
+      while (pending_bytes_ == 0 && !flush_thread_exit_ && !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
+        flush_event_.wait(flush_event_lock_);
       }
 
       if (flush_thread_exit_) {
         return;
       }
-
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
     }
 
-    // if we failed to reopen before, do it next loop.
-    if (reopen_file_) {
-      if (file_->isOpen()) {
-        const Api::IoCallBoolResult result = file_->close();
-        ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                                 result.err_->getErrorDetails()));
-      }
-      const Api::IoCallBoolResult open_result = open();
-      if (!open_result.return_value_) {
-        stats_.reopen_failed_.inc();
-      } else {
-        reopen_file_ = false;
-      }
-    }
-    // doWrite no matter file isOpen, if not, we can drain buffer
-    doWrite(about_to_write_buffer_);
+    flushAndReopen();
   }
 }
 
-void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+void AccessLogFileImpl::flushAndReopen() {
+  Thread::LockGuard flush_lock(flush_lock_);
+  drainWriteQueue();
 
-    if (flush_buffer_.length() == 0) {
-      return;
+  // if we failed to reopen before, do it next loop.
+  if (reopen_file_) {
+    if (file_->isOpen()) {
+      const Api::IoCallBoolResult result = file_->close();
+      ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                               result.err_->getErrorDetails()));
     }
+    const Api::IoCallBoolResult open_result = open();
+    if (!open_result.return_value_) {
+      stats_.reopen_failed_.inc();
+    } else {
+      reopen_file_ = false;
+    }
+  }
+  // doWrite no matter file isOpen, if not, we can drain buffer
+  doWrite(about_to_write_buffer_);
+}
 
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+void AccessLogFileImpl::flush() {
+  // flush_lock_ must be held while draining or else it is possible that
+  // flushThreadFunc() has already drained the queue into
+  // about_to_write_buffer_ but has not yet completed doWrite(). This would
+  // allow flush() to return before the pending data has actually been written
+  // to disk.
+  Thread::LockGuard flush_lock(flush_lock_);
+  drainWriteQueue();
+
+  if (about_to_write_buffer_.length() == 0) {
+    return;
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
-
-  if (flush_thread_ == nullptr) {
+  if (flush_thread_pool_ == nullptr && !flush_thread_created_.load(std::memory_order_acquire)) {
     createFlushStructures();
   }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+  // Account for the data before queueing it so that pending_bytes_ never goes below zero.
+  const uint64_t pending_bytes = pending_bytes_.fetch_add(data.length()) + data.length();
+  write_queue_.push(std::make_unique<WriteQueue::Node>(data));
+  if (pending_bytes > MIN_FLUSH_SIZE && pending_bytes - data.length() <= MIN_FLUSH_SIZE) {
+    // Only the write crossing the threshold wakes up the flush thread. The lock makes sure the
+    // wakeup isn't lost if the flush thread is about to wait.
+    if (flush_thread_pool_ != nullptr) {
+      flush_thread_pool_->scheduleFlush(*this, flush_thread_index_);
+    } else {
+      Thread::LockGuard flush_event_lock(flush_event_lock_);
+      flush_event_.notifyOne();
+    }
   }
 }
 
 void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
-                                               Thread::Options{"AccessLogFlush"});
+  Thread::LockGuard flush_event_lock(flush_event_lock_);
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
+                                                 Thread::Options{"AccessLogFlush"});
+    flush_thread_created_.store(true, std::memory_order_release);
+  }
 }
 
 } // namespace AccessLog
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -13,6 +16,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -31,15 +35,81 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * A fixed set of threads flushing the files of an AccessLogManagerImpl, as an alternative to a
+ * flush thread per file. Each file is assigned to one of the threads, and all files are flushed
+ * together when the flush interval elapses so that a flush tick wakes up each thread only once.
+ * Disk writes of all files are serialized by the cross process file lock anyway, so a single
+ * thread is usually enough.
+ */
+class AccessLogFlushThreadPool {
+public:
+  AccessLogFlushThreadPool(uint32_t num_threads, Event::Dispatcher& dispatcher,
+                           std::chrono::milliseconds flush_interval_msec,
+                           Thread::ThreadFactory& thread_factory, AccessLogFileStats& stats);
+  ~AccessLogFlushThreadPool();
+
+  /**
+   * Start flushing a file.
+   * @param file supplies the file to flush.
+   * @return uint32_t the index of the thread flushing the file, to pass to the other methods.
+   */
+  uint32_t addFile(AccessLogFileImpl& file);
+
+  /**
+   * Stop flushing a file. Once this returns the file isn't being flushed, and won't be anymore.
+   * @param file supplies the file to stop flushing.
+   * @param thread_index supplies the index returned by addFile().
+   */
+  void removeFile(AccessLogFileImpl& file, uint32_t thread_index);
+
+  /**
+   * Wake up the thread flushing a file to flush it ahead of the flush interval. Thread safe.
+   * @param file supplies the file to flush.
+   * @param thread_index supplies the index returned by addFile().
+   */
+  void scheduleFlush(AccessLogFileImpl& file, uint32_t thread_index);
+
+private:
+  struct FlushThread {
+    Thread::MutexBasicLockable lock_;
+    Thread::CondVar flush_event_;
+    std::vector<AccessLogFileImpl*> files_ ABSL_GUARDED_BY(lock_);
+    absl::flat_hash_set<AccessLogFileImpl*> scheduled_files_ ABSL_GUARDED_BY(lock_);
+    bool flush_all_ ABSL_GUARDED_BY(lock_){};
+    bool exit_ ABSL_GUARDED_BY(lock_){};
+    // Held while flushing files so that removeFile() can wait for an in progress flush. Always
+    // acquired after lock_ if both are held.
+    Thread::MutexBasicLockable flushing_lock_;
+    Thread::ThreadPtr thread_;
+  };
+
+  void flushThreadFunc(FlushThread& flush_thread);
+  void onFlushTimer();
+
+  std::vector<std::unique_ptr<FlushThread>> flush_threads_;
+  const std::chrono::milliseconds flush_interval_msec_;
+  AccessLogFileStats& stats_;
+  Event::TimerPtr flush_timer_;
+  uint32_t next_thread_index_{};
+};
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
-                       Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+  /**
+   * @param file_flush_interval_msec supplies the interval between file flushes.
+   * @param file_flush_threads supplies the number of threads shared by all files to flush them,
+   *        or 0 to use a flush thread per file.
+   */
+  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec,
+                       uint32_t file_flush_threads, Api::Api& api, Event::Dispatcher& dispatcher,
+                       Thread::BasicLockable& lock, Stats::Store& stats_store)
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_flush_threads_(file_flush_threads), api_(api), dispatcher_(dispatcher), lock_(lock),
+        file_stats_{ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                                          POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -48,26 +118,37 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint32_t file_flush_threads_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Created with the first file if file_flush_threads_ is set.
+  std::unique_ptr<AccessLogFlushThreadPool> flush_thread_pool_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * This implementation uses a flush thread per file by default, with the idea there aren't that
+ * many files. Alternatively files can be flushed by an AccessLogFlushThreadPool shared by all files.
+ *
+ * Writers hand their data to the flush thread through a lock-free queue, so that workers logging
+ * to the same file don't contend on a lock. Data written by a given thread is flushed in the order
+ * it was written.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
+  /**
+   * @param flush_thread_pool supplies the pool of threads flushing the file, or nullptr to use a
+   *        dedicated flush thread and flush timer.
+   */
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    Thread::ThreadFactory& thread_factory,
+                    AccessLogFlushThreadPool* flush_thread_pool);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -82,8 +163,50 @@ public:
   void flush() override;
 
 private:
+  friend class AccessLogFlushThreadPool;
+
+  /**
+   * Intrusive multi-producer single-consumer queue of pending writes. Pushing only takes an
+   * atomic exchange so producers never block each other. Entries pushed by one thread are popped
+   * in the order they were pushed.
+   */
+  class WriteQueue {
+  public:
+    struct Node {
+      Node() = default;
+      explicit Node(absl::string_view data) : data_(data) {}
+
+      std::atomic<Node*> next_{};
+      const std::string data_;
+    };
+    using NodePtr = std::unique_ptr<Node>;
+
+    WriteQueue();
+    ~WriteQueue();
+
+    void push(NodePtr node);
+
+    /**
+     * Must not be called concurrently with itself.
+     * @return the oldest entry, or nullptr if the queue is empty or the oldest entry is still
+     *         being pushed.
+     */
+    NodePtr pop();
+
+  private:
+    void pushNode(Node* node);
+
+    std::atomic<Node*> head_; // Most recently pushed node.
+    Node* tail_;              // Next node to pop, only accessed by the consumer.
+    Node stub_;               // Keeps the list non-empty so that push doesn't need to touch tail_.
+  };
+
   void doWrite(Buffer::Instance& buffer);
+  // Moves all queued writes to about_to_write_buffer_. flush_lock_ must be held.
+  void drainWriteQueue();
   void flushThreadFunc();
+  // Writes all queued data to the file, reopening it first if requested.
+  void flushAndReopen();
   Api::IoCallBoolResult open();
   void createFlushStructures();
 
@@ -96,7 +219,7 @@ private:
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
+  //    1) flush_event_lock_
   //    2) flush_lock_
   //    3) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
@@ -106,34 +229,34 @@ private:
   Thread::MutexBasicLockable flush_lock_; // This lock is used to prevent simultaneous flushes from
                                           // the flush thread and a synchronous flush. This protects
                                           // concurrent access to the about_to_write_buffer_, fd_,
-                                          // and all other data used during flushing and file
-                                          // re-opening.
+                                          // the consumer side of write_queue_ and all other data
+                                          // used during flushing and file re-opening.
   Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+      flush_event_lock_; // The lock is used by the flush thread to wait for flush_event_, and by
+                         // writers only when waking it up. It is always local to the process.
   Thread::ThreadPtr flush_thread_;
+  std::atomic<bool> flush_thread_created_{};
   Thread::CondVar flush_event_;
   std::atomic<bool> flush_thread_exit_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+  WriteQueue write_queue_;                // This queue is filled by multiple threads. It gets
+                                          // drained either when enough data is pending or when a
+                                          // timer fires.
+  std::atomic<uint64_t> pending_bytes_{}; // Size of the data queued in write_queue_.
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only while flushing. Data is
+                                            // moved from write_queue_ under flush_lock_ and then
+                                            // used for the final write to disk.
   Event::TimerPtr flush_timer_;
   Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
   AccessLogFileStats& stats_;
+  AccessLogFlushThreadPool* const flush_thread_pool_;
+  uint32_t flush_thread_index_{};
 };
 
 } // namespace AccessLog
@@ -0,0 +1,31 @@
+#include "source/common/common/arena.h"
+
+#include <algorithm>
+
+namespace Envoy {
+
+Arena::~Arena() {
+  while (last_block_ != nullptr) {
+    Block* previous = last_block_->previous_;
+    ::operator delete(last_block_);
+    last_block_ = previous;
+  }
+}
+
+void* Arena::allocateSlow(size_t size, size_t alignment) {
+  // Leave room for the block header and for aligning the allocation within the block.
+  const size_t required = sizeof(Block) + size + alignment - 1;
+  const size_t block_size = std::max(next_block_size_, required);
+  next_block_size_ *= 2;
+
+  auto* block = static_cast<Block*>(::operator new(block_size));
+  block->previous_ = last_block_;
+  last_block_ = block;
+  ++blocks_;
+
+  current_ = reinterpret_cast<char*>(block + 1);
+  end_ = reinterpret_cast<char*>(block) + block_size;
+  return allocate(size, alignment);
+}
+
+} // namespace Envoy
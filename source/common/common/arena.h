@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Bump allocator for objects sharing a lifetime, e.g. the per-request objects of an HTTP stream.
+ * Allocations are carved out of a chain of blocks and are only released, all at once, when the
+ * arena is destroyed. The arena does not run destructors: objects must be destroyed by their
+ * owners, e.g. through ArenaPtr or allocator aware containers, before the arena goes away.
+ *
+ * The arena is not thread safe and is meant to be used from the thread owning the stream.
+ */
+class Arena : NonCopyable {
+public:
+  /**
+   * @param initial_block_size supplies the size of the first block. Blocks are allocated on first
+   *        use and each following block doubles in size.
+   */
+  explicit Arena(size_t initial_block_size = DefaultInitialBlockSize)
+      : next_block_size_(initial_block_size) {}
+  ~Arena();
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two.
+   * @return the allocated memory, which remains valid until the arena is destroyed.
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    uintptr_t start = (reinterpret_cast<uintptr_t>(current_) + alignment - 1) & ~(alignment - 1);
+    if (current_ == nullptr || start + size > reinterpret_cast<uintptr_t>(end_)) {
+      return allocateSlow(size, alignment);
+    }
+    current_ = reinterpret_cast<char*>(start + size);
+    bytes_allocated_ += size;
+    return reinterpret_cast<void*>(start);
+  }
+
+  /**
+   * @return the number of bytes handed out by allocate().
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return the number of blocks allocated from the heap.
+   */
+  uint32_t blocks() const { return blocks_; }
+
+  static constexpr size_t DefaultInitialBlockSize = 2048;
+
+private:
+  struct Block {
+    Block* previous_;
+  };
+
+  void* allocateSlow(size_t size, size_t alignment);
+
+  Block* last_block_{};
+  char* current_{};
+  char* end_{};
+  size_t next_block_size_;
+  uint64_t bytes_allocated_{};
+  uint32_t blocks_{};
+};
+
+/**
+ * STL allocator allocating from an arena, for containers and std::allocate_shared(). Deallocation
+ * is a no-op as the memory is released with the arena. Without an arena the allocator falls back
+ * to the heap, so that the same container type can be used whether or not an arena is in use.
+ */
+template <class T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  ArenaAllocator() = default;
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_ == nullptr) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, size_t n) {
+    if (arena_ == nullptr) {
+      std::allocator<T>().deallocate(p, n);
+    }
+  }
+
+  Arena* arena() const { return arena_; }
+
+  template <class U> bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& other) const {
+    return !(*this == other);
+  }
+
+private:
+  Arena* arena_{};
+};
+
+/**
+ * Deleter for objects which may have been created in an arena, in which case only the destructor
+ * runs, or on the heap.
+ */
+class ArenaDeleter {
+public:
+  ArenaDeleter() = default;
+  explicit ArenaDeleter(bool in_arena) : in_arena_(in_arena) {}
+
+  template <class T> void operator()(T* object) const {
+    if (in_arena_) {
+      object->~T();
+    } else {
+      delete object;
+    }
+  }
+
+private:
+  bool in_arena_{false};
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+/**
+ * Create an object in the given arena, or on the heap if there is no arena.
+ */
+template <class T, class... Args> ArenaPtr<T> makeArenaPtr(Arena* arena, Args&&... args) {
+  if (arena == nullptr) {
+    return ArenaPtr<T>(new T(std::forward<Args>(args)...));
+  }
+  void* memory = arena->allocate(sizeof(T), alignof(T));
+  return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...), ArenaDeleter(true));
+}
+
+} // namespace Envoy
@@ -1,8 +1,12 @@
 #include "source/common/conn_pool/conn_pool_base.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "source/common/common/assert.h"
 #include "source/common/common/debug_recursion_checker.h"
 #include "source/common/network/transport_socket_options_impl.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stats/timespan_impl.h"
 #include "source/common/upstream/upstream_impl.h"
@@ -19,6 +23,45 @@ namespace {
 }
 } // namespace
 
+AdaptivePreconnectEstimator::AdaptivePreconnectEstimator(
+    const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect& config)
+    : percentile_(config.has_connect_time_percentile() ? config.connect_time_percentile().value()
+                                                        : 99.0),
+      rate_interval_seconds_(PROTOBUF_GET_MS_OR_DEFAULT(config, rate_interval, 1000) / 1000.0),
+      max_anticipated_streams_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_anticipated_streams, 10)) {}
+
+double AdaptivePreconnectEstimator::decayedRate(MonotonicTime now) const {
+  const double elapsed_seconds =
+      std::chrono::duration<double>(std::max(now - last_stream_time_, MonotonicTime::duration{0}))
+          .count();
+  return rate_ * std::exp(-elapsed_seconds / rate_interval_seconds_);
+}
+
+void AdaptivePreconnectEstimator::onNewStream(MonotonicTime now) {
+  rate_ = decayedRate(now) + 1 / rate_interval_seconds_;
+  last_stream_time_ = now;
+}
+
+void AdaptivePreconnectEstimator::onConnected(std::chrono::milliseconds connect_time) {
+  connect_times_[connect_count_ % ConnectTimeSamples] = connect_time;
+  connect_count_++;
+
+  // Connects are rare compared to streams, so the percentile is computed here rather than when
+  // streams are anticipated.
+  std::array<std::chrono::milliseconds, ConnectTimeSamples> samples = connect_times_;
+  const size_t count = std::min<uint64_t>(connect_count_, ConnectTimeSamples);
+  const size_t rank = std::clamp<double>(std::ceil(percentile_ / 100 * count) - 1, 0, count - 1);
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.begin() + count);
+  connect_time_ = samples[rank];
+}
+
+uint32_t AdaptivePreconnectEstimator::anticipatedStreams(MonotonicTime now) const {
+  const double streams =
+      decayedRate(now) * std::chrono::duration<double>(connect_time_).count();
+  return static_cast<uint32_t>(std::min<double>(std::ceil(streams), max_anticipated_streams_));
+}
+
 ConnPoolImplBase::ConnPoolImplBase(
     Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -26,6 +69,10 @@ ConnPoolImplBase::ConnPoolImplBase(
     Upstream::ClusterConnectivityState& state)
     : state_(state), host_(host), priority_(priority), dispatcher_(dispatcher),
       socket_options_(options), transport_socket_options_(transport_socket_options),
+      preconnect_estimator_(host_->cluster().adaptivePreconnect().has_value()
+                                ? std::make_unique<AdaptivePreconnectEstimator>(
+                                      *host_->cluster().adaptivePreconnect())
+                                : nullptr),
       upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {}
 
 ConnPoolImplBase::~ConnPoolImplBase() {
@@ -98,7 +145,8 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // new streams are established or torn down and simply attempts to maintain
     // the correct ratio of streams and anticipated capacity.
     return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
-                         perUpstreamPreconnectRatio());
+                         perUpstreamPreconnectRatio()) ||
+           adaptivePreconnectNeeded();
   }
 }
 
@@ -106,6 +154,24 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   return host_->cluster().perUpstreamPreconnectRatio();
 }
 
+bool ConnPoolImplBase::adaptivePreconnectNeeded(uint64_t excluded_capacity) const {
+  // As with the preconnect ratios, only pools with traffic preconnect. This also keeps pools that
+  // are being destroyed from replacing the connections they close.
+  if (preconnect_estimator_ == nullptr || (pending_streams_.empty() && num_active_streams_ == 0)) {
+    return false;
+  }
+  const uint64_t needed =
+      pending_streams_.size() + excluded_capacity +
+      preconnect_estimator_->anticipatedStreams(dispatcher_.timeSource().monotonicTime());
+  // Unlike connecting capacity, the capacity of ready clients is not tracked per pool, so only
+  // count as many ready clients as it takes to cover the need.
+  uint64_t capacity = connecting_stream_capacity_;
+  for (auto it = ready_clients_.begin(); it != ready_clients_.end() && capacity < needed; ++it) {
+    capacity += (*it)->currentUnusedCapacity();
+  }
+  return needed > capacity;
+}
+
 ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   ASSERT(!is_draining_for_deletion_);
   ConnPoolImplBase::ConnectionResult result;
@@ -203,6 +269,7 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   num_active_streams_++;
   host_->stats().rq_total_.inc();
   host_->stats().rq_active_.inc();
+  host_->load().outstanding_requests_.fetch_add(1, std::memory_order_relaxed);
   traffic_stats.upstream_rq_total_.inc();
   traffic_stats.upstream_rq_active_.inc();
   host_->cluster().resourceManager(priority_).requests().inc();
@@ -219,6 +286,7 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
   state_.decrActiveStreams(1);
   num_active_streams_--;
   host_->stats().rq_active_.dec();
+  host_->load().outstanding_requests_.fetch_sub(1, std::memory_order_relaxed);
   host_->cluster().trafficStats()->upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
   // We don't update the capacity for HTTP/3 as the stream count should only
@@ -259,6 +327,10 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& cont
   ASSERT(!is_draining_for_deletion_);
   ASSERT(!deferred_deleting_);
 
+  if (preconnect_estimator_ != nullptr) {
+    preconnect_estimator_->onNewStream(dispatcher_.timeSource().monotonicTime());
+  }
+
   ASSERT(static_cast<ssize_t>(connecting_stream_capacity_) ==
          connectingCapacity(connecting_clients_) +
              connectingCapacity(early_data_clients_)); // O(n) debug check.
@@ -566,6 +638,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ASSERT(connecting_stream_capacity_ >= client.currentUnusedCapacity());
     connecting_stream_capacity_ -= client.currentUnusedCapacity();
     client.has_handshake_completed_ = true;
+    if (preconnect_estimator_ != nullptr) {
+      preconnect_estimator_->onConnected(client.conn_connect_ms_->elapsed());
+    }
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
     if (client.state() == ActiveClient::State::Connecting ||
@@ -613,11 +688,13 @@ PendingStream::PendingStream(ConnPoolImplBase& parent, bool can_send_early_data)
   traffic_stats.upstream_rq_pending_total_.inc();
   traffic_stats.upstream_rq_pending_active_.inc();
   parent_.host()->cluster().resourceManager(parent_.priority()).pendingRequests().inc();
+  parent_.host()->load().outstanding_requests_.fetch_add(1, std::memory_order_relaxed);
 }
 
 PendingStream::~PendingStream() {
   parent_.host()->cluster().trafficStats()->upstream_rq_pending_active_.dec();
   parent_.host()->cluster().resourceManager(parent_.priority()).pendingRequests().dec();
+  parent_.host()->load().outstanding_requests_.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void PendingStream::cancel(Envoy::ConnectionPool::CancelPolicy policy) {
@@ -649,8 +726,11 @@ bool ConnPoolImplBase::connectingConnectionIsExcess(const ActiveClient& client)
   // If preconnect ratio is set, it also factors in the anticipated load based on both queued
   // streams and active streams, and makes sure the connecting capacity would still be sufficient to
   // serve that even with the most recent client removed.
+  //
+  // With adaptive preconnect, the remaining capacity must also cover the anticipated streams.
   return (pending_streams_.size() + num_active_streams_) * perUpstreamPreconnectRatio() <=
-         (connecting_stream_capacity_ - client.currentUnusedCapacity() + num_active_streams_);
+             (connecting_stream_capacity_ - client.currentUnusedCapacity() + num_active_streams_) &&
+         !adaptivePreconnectNeeded(client.currentUnusedCapacity());
 }
 
 void ConnPoolImplBase::onPendingStreamCancel(PendingStream& stream,
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+
 #include "envoy/common/conn_pool.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection.h"
@@ -179,6 +182,43 @@ using PendingStreamPtr = std::unique_ptr<PendingStream>;
 
 using ActiveClientPtr = std::unique_ptr<ActiveClient>;
 
+// Estimates how many streams a connection pool should be able to serve without connecting, on top
+// of its pending streams: the streams expected to arrive during a connect, given the recent stream
+// arrival rate of the pool and a percentile of its recent connect times.
+class AdaptivePreconnectEstimator {
+public:
+  AdaptivePreconnectEstimator(
+      const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect& config);
+
+  // Called for each new stream of the pool.
+  void onNewStream(MonotonicTime now);
+  // Called with the duration of each successful connect of the pool.
+  void onConnected(std::chrono::milliseconds connect_time);
+  // Returns the number of streams expected to arrive during a connect, rounded up.
+  uint32_t anticipatedStreams(MonotonicTime now) const;
+
+private:
+  // The number of recent connect times the percentile is taken from.
+  static constexpr size_t ConnectTimeSamples = 32;
+
+  double decayedRate(MonotonicTime now) const;
+
+  const double percentile_;
+  const double rate_interval_seconds_;
+  const uint32_t max_anticipated_streams_;
+  // The stream arrival rate in streams per second as of last_stream_time_, with each stream
+  // decaying exponentially over rate_interval_seconds_.
+  double rate_{0};
+  MonotonicTime last_stream_time_;
+  // The most recent connect times, used as a ring buffer.
+  std::array<std::chrono::milliseconds, ConnectTimeSamples> connect_times_{};
+  uint64_t connect_count_{0};
+  // The percentile of connect_times_, updated on each connect.
+  std::chrono::milliseconds connect_time_{0};
+};
+
+using AdaptivePreconnectEstimatorPtr = std::unique_ptr<AdaptivePreconnectEstimator>;
+
 // Base class that handles stream queueing logic shared between connection pool implementations.
 class ConnPoolImplBase : protected Logger::Loggable<Logger::Id::pool> {
 public:
@@ -342,6 +382,11 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // Returns true if adaptive preconnect is configured, the pool has streams, and the connecting
+  // capacity plus the unused capacity of the ready clients, less excluded_capacity, cannot serve
+  // the pending streams and the streams anticipated by preconnect_estimator_.
+  bool adaptivePreconnectNeeded(uint64_t excluded_capacity = 0) const;
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -388,6 +433,9 @@ protected:
   // if all Connecting connections become connected.
   uint32_t connecting_stream_capacity_{0};
 
+  // Set if adaptive preconnect is configured for the cluster.
+  const AdaptivePreconnectEstimatorPtr preconnect_estimator_;
+
 private:
   // Drain all the clients in the given list.
   // Prerequisite: the given clients shouldn't be idle.
@@ -23,6 +23,7 @@
 #include "source/common/grpc/common.h"
 #include "source/common/grpc/status.h"
 #include "source/common/http/utility.h"
+#include "source/common/json/json_sanitizer.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
@@ -133,25 +134,169 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
   log_line.reserve(256);
 
   for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+    if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, log_line)) {
+      log_line.append(empty_value_string_);
+    }
   }
 
   return log_line;
 }
 
+JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping,
+                                     bool preserve_types, bool omit_empty_values)
+    : JsonFormatterImpl(format_mapping, preserve_types, omit_empty_values, {}) {}
+
+JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping,
+                                     bool preserve_types, bool omit_empty_values,
+                                     const std::vector<CommandParserPtr>& commands)
+    : omit_empty_values_(omit_empty_values) {
+  // Typed values are only known once formatted, so they still go through a Struct.
+  if (preserve_types || !Runtime::runtimeFeatureEnabled(
+                            "envoy.reloadable_features.logging_with_fast_json_formatter")) {
+    struct_formatter_ = std::make_unique<StructFormatter>(format_mapping, preserve_types,
+                                                          omit_empty_values, commands);
+    return;
+  }
+  json_format_ = std::make_unique<const JsonFormatNode>(compileObject(format_mapping, commands));
+}
+
+JsonFormatterImpl::JsonFormatNode
+JsonFormatterImpl::compileObject(const ProtobufWkt::Struct& struct_format,
+                                 const std::vector<CommandParserPtr>& commands) {
+  JsonFormatNode node;
+  node.type_ = JsonFormatNode::Type::Object;
+  // Keep the members in the order of their keys, as the StructFormatter does.
+  std::vector<absl::string_view> keys;
+  keys.reserve(struct_format.fields().size());
+  for (const auto& pair : struct_format.fields()) {
+    keys.push_back(pair.first);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::string sanitize_buffer;
+  for (absl::string_view key : keys) {
+    JsonFormatNode child = compileValue(struct_format.fields().at(std::string(key)), commands);
+    child.key_ = absl::StrCat("\"", Json::sanitize(sanitize_buffer, key), "\":");
+    node.children_.push_back(std::move(child));
+  }
+  return node;
+}
+
+JsonFormatterImpl::JsonFormatNode
+JsonFormatterImpl::compileValue(const ProtobufWkt::Value& value,
+                                const std::vector<CommandParserPtr>& commands) {
+  JsonFormatNode node;
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kStringValue:
+    node.type_ = JsonFormatNode::Type::String;
+    node.providers_ = SubstitutionFormatParser::parse(value.string_value(), commands);
+    break;
+
+  case ProtobufWkt::Value::kStructValue:
+    node = compileObject(value.struct_value(), commands);
+    break;
+
+  case ProtobufWkt::Value::kListValue:
+    node.type_ = JsonFormatNode::Type::List;
+    for (const auto& element : value.list_value().values()) {
+      node.children_.push_back(compileValue(element, commands));
+    }
+    break;
+
+  case ProtobufWkt::Value::kNumberValue:
+    node.type_ = JsonFormatNode::Type::String;
+    node.providers_.push_back(std::make_unique<PlainNumberFormatter>(value.number_value()));
+    break;
+
+  default:
+    throw EnvoyException("Only string values, nested structs, list values and number values are "
+                         "supported in structured access log format.");
+  }
+  return node;
+}
+
+bool JsonFormatterImpl::writeNode(const JsonFormatNode& node,
+                                  const Http::RequestHeaderMap& request_headers,
+                                  const Http::ResponseHeaderMap& response_headers,
+                                  const Http::ResponseTrailerMap& response_trailers,
+                                  const StreamInfo::StreamInfo& stream_info,
+                                  absl::string_view local_reply_body, JsonWriteBuffers& buffers,
+                                  std::string& log_line) const {
+  switch (node.type_) {
+  case JsonFormatNode::Type::String: {
+    buffers.value_.clear();
+    if (node.providers_.size() == 1) {
+      if (!node.providers_.front()->formatTo(request_headers, response_headers, response_trailers,
+                                             stream_info, local_reply_body, buffers.value_)) {
+        if (omit_empty_values_) {
+          return false;
+        }
+        buffers.value_.append(DefaultUnspecifiedValueString);
+      }
+    } else {
+      // Multiple providers always produce a string, as in the text format.
+      for (const FormatterProviderPtr& provider : node.providers_) {
+        if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                                local_reply_body, buffers.value_) &&
+            !omit_empty_values_) {
+          buffers.value_.append(DefaultUnspecifiedValueString);
+        }
+      }
+    }
+    log_line.push_back('"');
+    log_line.append(Json::sanitize(buffers.sanitized_, buffers.value_));
+    log_line.push_back('"');
+    return true;
+  }
+
+  case JsonFormatNode::Type::Object:
+  case JsonFormatNode::Type::List: {
+    const bool object = node.type_ == JsonFormatNode::Type::Object;
+    log_line.push_back(object ? '{' : '[');
+    bool first = true;
+    for (const JsonFormatNode& child : node.children_) {
+      // Write the separator and key up front, and take them back if the value is omitted.
+      const size_t start = log_line.size();
+      if (!first) {
+        log_line.push_back(',');
+      }
+      log_line.append(child.key_);
+      if (writeNode(child, request_headers, response_headers, response_trailers, stream_info,
+                    local_reply_body, buffers, log_line)) {
+        first = false;
+      } else {
+        log_line.resize(start);
+      }
+    }
+    log_line.push_back(object ? '}' : ']');
+    return true;
+  }
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
 std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                       const Http::ResponseHeaderMap& response_headers,
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
-  const ProtobufWkt::Struct output_struct = struct_formatter_.format(
-      request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+  if (struct_formatter_ != nullptr) {
+    const ProtobufWkt::Struct output_struct = struct_formatter_->format(
+        request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+
+    const std::string log_line =
+        MessageUtil::getJsonStringFromMessageOrDie(output_struct, false, true);
+    return absl::StrCat(log_line, "\n");
+  }
 
-  const std::string log_line =
-      MessageUtil::getJsonStringFromMessageOrDie(output_struct, false, true);
-  return absl::StrCat(log_line, "\n");
+  std::string log_line;
+  log_line.reserve(256);
+  JsonWriteBuffers buffers;
+  writeNode(*json_format_, request_headers, response_headers, response_trailers, stream_info,
+            local_reply_body, buffers, log_line);
+  log_line.push_back('\n');
+  return log_line;
 }
 
 StructFormatter::StructFormatter(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
@@ -263,9 +408,10 @@ ProtobufWkt::Value StructFormatter::providersCallback(
   // Multiple providers forces string output.
   std::string str;
   for (const auto& provider : providers) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    str += bit.value_or(empty_value_);
+    if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, str)) {
+      str.append(empty_value_);
+    }
   }
   return ValueUtil::stringValue(str);
 }
@@ -699,6 +845,16 @@ public:
 
     return ValueUtil::numberValue(millis.value());
   }
+  bool extractTo(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    const auto millis = extractMillis(stream_info);
+    if (!millis) {
+      return false;
+    }
+
+    const fmt::format_int formatted(millis.value());
+    output.append(formatted.data(), formatted.size());
+    return true;
+  }
 
 private:
   absl::optional<int64_t> extractMillis(const StreamInfo::StreamInfo& stream_info) const {
@@ -726,6 +882,11 @@ public:
   ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo& stream_info) const override {
     return ValueUtil::numberValue(field_extractor_(stream_info));
   }
+  bool extractTo(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    const fmt::format_int formatted(field_extractor_(stream_info));
+    output.append(formatted.data(), formatted.size());
+    return true;
+  }
 
 private:
   FieldExtractor field_extractor_;
@@ -1586,6 +1747,13 @@ ProtobufWkt::Value StreamInfoFormatter::formatValue(const Http::RequestHeaderMap
   return field_extractor_->extractValue(stream_info);
 }
 
+bool StreamInfoFormatter::formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                   const Http::ResponseTrailerMap&,
+                                   const StreamInfo::StreamInfo& stream_info, absl::string_view,
+                                   std::string& output) const {
+  return field_extractor_->extractTo(stream_info, output);
+}
+
 PlainStringFormatter::PlainStringFormatter(const std::string& str) { str_.set_string_value(str); }
 
 absl::optional<std::string> PlainStringFormatter::format(const Http::RequestHeaderMap&,
@@ -1604,15 +1772,23 @@ ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::RequestHeaderMa
   return str_;
 }
 
-PlainNumberFormatter::PlainNumberFormatter(double num) { num_.set_number_value(num); }
+bool PlainStringFormatter::formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                    const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                    absl::string_view, std::string& output) const {
+  output.append(str_.string_value());
+  return true;
+}
+
+PlainNumberFormatter::PlainNumberFormatter(double num) : formatted_(absl::StrFormat("%g", num)) {
+  num_.set_number_value(num);
+}
 
 absl::optional<std::string> PlainNumberFormatter::format(const Http::RequestHeaderMap&,
                                                          const Http::ResponseHeaderMap&,
                                                          const Http::ResponseTrailerMap&,
                                                          const StreamInfo::StreamInfo&,
                                                          absl::string_view) const {
-  std::string str = absl::StrFormat("%g", num_.number_value());
-  return str;
+  return formatted_;
 }
 
 ProtobufWkt::Value PlainNumberFormatter::formatValue(const Http::RequestHeaderMap&,
@@ -1623,6 +1799,13 @@ ProtobufWkt::Value PlainNumberFormatter::formatValue(const Http::RequestHeaderMa
   return num_;
 }
 
+bool PlainNumberFormatter::formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                    const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                    absl::string_view, std::string& output) const {
+  output.append(formatted_);
+  return true;
+}
+
 absl::optional<std::string>
 LocalReplyBodyFormatter::format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                 const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
@@ -1638,6 +1821,16 @@ ProtobufWkt::Value LocalReplyBodyFormatter::formatValue(const Http::RequestHeade
   return ValueUtil::stringValue(std::string(local_reply_body));
 }
 
+bool LocalReplyBodyFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap&,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&,
+                                       absl::string_view local_reply_body,
+                                       std::string& output) const {
+  output.append(local_reply_body.data(), local_reply_body.size());
+  return true;
+}
+
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
@@ -1677,6 +1870,20 @@ ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers)
   return ValueUtil::stringValue(val);
 }
 
+bool HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    return false;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+  return true;
+}
+
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
                                                  const std::string& alternative_header,
                                                  absl::optional<size_t> max_length)
@@ -1694,6 +1901,14 @@ ProtobufWkt::Value ResponseHeaderFormatter::formatValue(
   return HeaderFormatter::formatValue(response_headers);
 }
 
+bool ResponseHeaderFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&, absl::string_view,
+                                       std::string& output) const {
+  return HeaderFormatter::formatTo(response_headers, output);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const std::string& alternative_header,
                                                absl::optional<size_t> max_length)
@@ -1713,6 +1928,14 @@ RequestHeaderFormatter::formatValue(const Http::RequestHeaderMap& request_header
   return HeaderFormatter::formatValue(request_headers);
 }
 
+bool RequestHeaderFormatter::formatTo(const Http::RequestHeaderMap& request_headers,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&,
+                                      const StreamInfo::StreamInfo&, absl::string_view,
+                                      std::string& output) const {
+  return HeaderFormatter::formatTo(request_headers, output);
+}
+
 ResponseTrailerFormatter::ResponseTrailerFormatter(const std::string& main_header,
                                                    const std::string& alternative_header,
                                                    absl::optional<size_t> max_length)
@@ -1732,6 +1955,14 @@ ResponseTrailerFormatter::formatValue(const Http::RequestHeaderMap&, const Http:
   return HeaderFormatter::formatValue(response_trailers);
 }
 
+bool ResponseTrailerFormatter::formatTo(const Http::RequestHeaderMap&,
+                                        const Http::ResponseHeaderMap&,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, absl::string_view,
+                                        std::string& output) const {
+  return HeaderFormatter::formatTo(response_trailers, output);
+}
+
 HeadersByteSizeFormatter::HeadersByteSizeFormatter(const HeaderType header_type)
     : header_type_(header_type) {}
 
@@ -1766,6 +1997,17 @@ HeadersByteSizeFormatter::formatValue(const Http::RequestHeaderMap& request_head
       extractHeadersByteSize(request_headers, response_headers, response_trailers));
 }
 
+bool HeadersByteSizeFormatter::formatTo(const Http::RequestHeaderMap& request_headers,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, absl::string_view,
+                                        std::string& output) const {
+  const fmt::format_int formatted(
+      extractHeadersByteSize(request_headers, response_headers, response_trailers));
+  output.append(formatted.data(), formatted.size());
+  return true;
+}
+
 GrpcStatusFormatter::Format GrpcStatusFormatter::parseFormat(absl::string_view format) {
   if (format.empty() || format == "CAMEL_STRING") {
     return GrpcStatusFormatter::CamelString;
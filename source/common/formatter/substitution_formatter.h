@@ -136,7 +136,7 @@ private:
 };
 
 /**
- * Composite formatter implementation.
+ * Composite formatter implementation. The providers append their values directly to the log line.
  */
 class FormatterImpl : public Formatter {
 public:
@@ -241,14 +241,17 @@ private:
 
 using StructFormatterPtr = std::unique_ptr<StructFormatter>;
 
+/**
+ * A formatter for JSON log formats. Unless the types of the values are preserved, the format
+ * mapping is compiled into a tree whose object keys are escaped once, and the log line is written
+ * directly from it. Otherwise the log line is converted from the output of a StructFormatter.
+ */
 class JsonFormatterImpl : public Formatter {
 public:
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
-                    bool omit_empty_values)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values) {}
+                    bool omit_empty_values);
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
-                    bool omit_empty_values, const std::vector<CommandParserPtr>& commands)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands) {}
+                    bool omit_empty_values, const std::vector<CommandParserPtr>& commands);
 
   // Formatter::format
   std::string format(const Http::RequestHeaderMap& request_headers,
@@ -258,7 +261,38 @@ public:
                      absl::string_view local_reply_body) const override;
 
 private:
-  const StructFormatter struct_formatter_;
+  // A value of the compiled format: a string formatted from providers, an object or a list.
+  struct JsonFormatNode {
+    enum class Type { String, Object, List };
+
+    Type type_;
+    // The escaped and quoted key followed by a colon, for the members of an object.
+    std::string key_;
+    std::vector<FormatterProviderPtr> providers_;
+    std::vector<JsonFormatNode> children_;
+  };
+
+  // Holds the scratch strings used while writing a log line.
+  struct JsonWriteBuffers {
+    std::string value_;
+    std::string sanitized_;
+  };
+
+  static JsonFormatNode compileObject(const ProtobufWkt::Struct& struct_format,
+                                      const std::vector<CommandParserPtr>& commands);
+  static JsonFormatNode compileValue(const ProtobufWkt::Value& value,
+                                     const std::vector<CommandParserPtr>& commands);
+  // Returns false if the value is empty and omitted, in which case nothing is written.
+  bool writeNode(const JsonFormatNode& node, const Http::RequestHeaderMap& request_headers,
+                 const Http::ResponseHeaderMap& response_headers,
+                 const Http::ResponseTrailerMap& response_trailers,
+                 const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                 JsonWriteBuffers& buffers, std::string& log_line) const;
+
+  const bool omit_empty_values_;
+  // Exactly one of these is set.
+  StructFormatterPtr struct_formatter_;
+  std::unique_ptr<const JsonFormatNode> json_format_;
 };
 
 /**
@@ -276,6 +310,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 
 private:
   ProtobufWkt::Value str_;
@@ -295,9 +332,14 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 
 private:
   ProtobufWkt::Value num_;
+  // The number formatted once, as it is the same for every log line.
+  const std::string formatted_;
 };
 
 /**
@@ -314,6 +356,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view local_reply_body) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view local_reply_body, std::string& output) const override;
 };
 
 class HeaderFormatter {
@@ -324,6 +369,7 @@ public:
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
+  bool formatTo(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers) const;
@@ -352,6 +398,10 @@ public:
                                  const Http::ResponseHeaderMap& response_headers,
                                  const Http::ResponseTrailerMap& response_trailers,
                                  const StreamInfo::StreamInfo&, absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                absl::string_view, std::string& output) const override;
 
 private:
   uint64_t extractHeadersByteSize(const Http::RequestHeaderMap& request_headers,
@@ -376,6 +426,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap& request_headers, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 };
 
 /**
@@ -394,6 +447,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 };
 
 /**
@@ -412,6 +468,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                absl::string_view, std::string& output) const override;
 };
 
 class GrpcStatusFormatter : public FormatterProvider, HeaderFormatter {
@@ -456,6 +515,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo& stream_info,
+                absl::string_view, std::string& output) const override;
 
   class FieldExtractor {
   public:
@@ -463,6 +525,15 @@ public:
 
     virtual absl::optional<std::string> extract(const StreamInfo::StreamInfo&) const PURE;
     virtual ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo&) const PURE;
+    // Appends the extracted value to output, returning false if there is none.
+    virtual bool extractTo(const StreamInfo::StreamInfo& stream_info, std::string& output) const {
+      const absl::optional<std::string> value = extract(stream_info);
+      if (!value.has_value()) {
+        return false;
+      }
+      output.append(value.value());
+      return true;
+    }
   };
   using FieldExtractorPtr = std::unique_ptr<FieldExtractor>;
   using FieldExtractorCreateFunc =
@@ -14,6 +14,7 @@
 #include "envoy/protobuf/message_validator.h"
 
 #include "source/common/buffer/watermark_buffer.h"
+#include "source/common/common/arena.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
@@ -25,12 +26,17 @@
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/matcher/matcher.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/stream_info/stream_info_impl.h"
 
 namespace Envoy {
 namespace Http {
 
 class FilterManager;
+
+// Filter wrappers and their list nodes are allocated from the stream arena when it is enabled.
+template <class T>
+using ActiveStreamFilterList = std::list<ArenaPtr<T>, ArenaAllocator<ArenaPtr<T>>>;
 class DownstreamFilterManager;
 
 struct ActiveStreamFilterBase;
@@ -169,7 +175,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
  */
 struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
                                    public StreamDecoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamDecoderFilter> {
+                                   LinkedObject<ActiveStreamDecoderFilter,
+                                                ActiveStreamFilterList<ActiveStreamDecoderFilter>> {
   ActiveStreamDecoderFilter(FilterManager& parent, StreamDecoderFilterSharedPtr filter,
                             bool is_encoder_decoder_filter, FilterContext filter_context)
       : ActiveStreamFilterBase(parent, is_encoder_decoder_filter, std::move(filter_context)),
@@ -256,14 +263,16 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
   bool is_grpc_request_{};
 };
 
-using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+using ActiveStreamDecoderFilterPtr = ArenaPtr<ActiveStreamDecoderFilter>;
+using ActiveStreamDecoderFilterList = ActiveStreamFilterList<ActiveStreamDecoderFilter>;
 
 /**
  * Wrapper for a stream encoder filter.
  */
 struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
                                    public StreamEncoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamEncoderFilter> {
+                                   LinkedObject<ActiveStreamEncoderFilter,
+                                                ActiveStreamFilterList<ActiveStreamEncoderFilter>> {
   ActiveStreamEncoderFilter(FilterManager& parent, StreamEncoderFilterSharedPtr filter,
                             bool is_encoder_decoder_filter, FilterContext filter_context)
       : ActiveStreamFilterBase(parent, is_encoder_decoder_filter, std::move(filter_context)),
@@ -315,7 +324,8 @@ struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
   StreamEncoderFilterSharedPtr handle_;
 };
 
-using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+using ActiveStreamEncoderFilterPtr = ArenaPtr<ActiveStreamEncoderFilter>;
+using ActiveStreamEncoderFilterList = ActiveStreamFilterList<ActiveStreamEncoderFilter>;
 
 /**
  * Callbacks invoked by the FilterManager to pass filter data/events back to the caller.
@@ -605,8 +615,12 @@ public:
                 uint32_t buffer_limit, const FilterChainFactory& filter_chain_factory)
       : filter_manager_callbacks_(filter_manager_callbacks), dispatcher_(dispatcher),
         connection_(connection), stream_id_(stream_id), account_(std::move(account)),
-        proxy_100_continue_(proxy_100_continue), buffer_limit_(buffer_limit),
-        filter_chain_factory_(filter_chain_factory) {}
+        proxy_100_continue_(proxy_100_continue),
+        use_stream_arena_(
+            Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_stream_arena")),
+        decoder_filters_(ArenaAllocator<ActiveStreamDecoderFilterPtr>(streamArenaPtr())),
+        encoder_filters_(ArenaAllocator<ActiveStreamEncoderFilterPtr>(streamArenaPtr())),
+        buffer_limit_(buffer_limit), filter_chain_factory_(filter_chain_factory) {}
   ~FilterManager() override {
     ASSERT(state_.destroyed_);
     ASSERT(state_.filter_call_state_ == 0);
@@ -651,6 +665,12 @@ public:
   }
   void addStreamFilterBase(StreamFilterBase* filter) { filters_.push_back(filter); }
 
+  /**
+   * @return the arena for objects living as long as the stream, if enabled by the
+   *         envoy.reloadable_features.http_stream_arena runtime feature.
+   */
+  OptRef<Arena> streamArena() { return makeOptRefFromPtr(streamArenaPtr()); }
+
   // FilterChainManager
   void applyFilterFactoryCb(FilterContext context, FilterFactoryCb& factory) override;
 
@@ -880,24 +900,24 @@ private:
 
     void addStreamDecoderFilter(Http::StreamDecoderFilterSharedPtr filter) override {
       manager_.addStreamFilterBase(filter.get());
-      manager_.addStreamDecoderFilter(std::make_unique<ActiveStreamDecoderFilter>(
-          manager_, std::move(filter), false, context_));
+      manager_.addStreamDecoderFilter(makeArenaPtr<ActiveStreamDecoderFilter>(
+          manager_.streamArenaPtr(), manager_, std::move(filter), false, context_));
     }
 
     void addStreamEncoderFilter(Http::StreamEncoderFilterSharedPtr filter) override {
       manager_.addStreamFilterBase(filter.get());
-      manager_.addStreamEncoderFilter(std::make_unique<ActiveStreamEncoderFilter>(
-          manager_, std::move(filter), false, context_));
+      manager_.addStreamEncoderFilter(makeArenaPtr<ActiveStreamEncoderFilter>(
+          manager_.streamArenaPtr(), manager_, std::move(filter), false, context_));
     }
 
     void addStreamFilter(Http::StreamFilterSharedPtr filter) override {
       StreamDecoderFilter* decoder_filter = filter.get();
       manager_.addStreamFilterBase(decoder_filter);
 
-      manager_.addStreamDecoderFilter(
-          std::make_unique<ActiveStreamDecoderFilter>(manager_, filter, true, context_));
-      manager_.addStreamEncoderFilter(
-          std::make_unique<ActiveStreamEncoderFilter>(manager_, std::move(filter), true, context_));
+      manager_.addStreamDecoderFilter(makeArenaPtr<ActiveStreamDecoderFilter>(
+          manager_.streamArenaPtr(), manager_, filter, true, context_));
+      manager_.addStreamEncoderFilter(makeArenaPtr<ActiveStreamEncoderFilter>(
+          manager_.streamArenaPtr(), manager_, std::move(filter), true, context_));
     }
 
     void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
@@ -906,6 +926,8 @@ private:
 
     Event::Dispatcher& dispatcher() override { return manager_.dispatcher_; }
 
+    OptRef<Arena> streamArena() override { return manager_.streamArena(); }
+
   private:
     FilterManager& manager_;
     const Http::FilterContext& context_;
@@ -915,11 +937,11 @@ private:
   enum class FilterIterationStartState { AlwaysStartFromNext, CanStartFromCurrent };
 
   // Returns the encoder filter to start iteration with.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator
+  ActiveStreamEncoderFilterList::iterator
   commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
                      FilterIterationStartState filter_iteration_start_state);
   // Returns the decoder filter to start iteration with.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator
+  ActiveStreamDecoderFilterList::iterator
   commonDecodePrefix(ActiveStreamDecoderFilter* filter,
                      FilterIterationStartState filter_iteration_start_state);
   void addDecodedData(ActiveStreamDecoderFilter& filter, Buffer::Instance& data, bool streaming);
@@ -928,7 +950,7 @@ private:
   // Helper function for the case where we have a header only request, but a filter adds a body
   // to it.
   void maybeContinueDecoding(
-      const std::list<ActiveStreamDecoderFilterPtr>::iterator& maybe_continue_data_entry);
+      const ActiveStreamDecoderFilterList::iterator& maybe_continue_data_entry);
   void decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHeaderMap& headers, bool end_stream);
   // Sends data through decoding filter chains. filter_iteration_start_state indicates which
   // filter to start the iteration with.
@@ -943,7 +965,7 @@ private:
   // filters before calling encodeHeadersInternal which does final header munging and passes the
   // headers to the encoder.
   void maybeContinueEncoding(
-      const std::list<ActiveStreamEncoderFilterPtr>::iterator& maybe_continue_data_entry);
+      const ActiveStreamEncoderFilterList::iterator& maybe_continue_data_entry);
   void encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHeaderMap& headers,
                      bool end_stream);
   // Sends data through encoding filter chains. filter_iteration_start_state indicates which
@@ -963,6 +985,8 @@ private:
   bool handleDataIfStopAll(ActiveStreamFilterBase& filter, Buffer::Instance& data,
                            bool& filter_streaming);
 
+  Arena* streamArenaPtr() { return use_stream_arena_ ? &stream_arena_ : nullptr; }
+
   MetadataMapVector* getRequestMetadataMapVector() {
     if (request_metadata_map_vector_ == nullptr) {
       request_metadata_map_vector_ = std::make_unique<MetadataMapVector>();
@@ -978,9 +1002,13 @@ private:
   const uint64_t stream_id_;
   Buffer::BufferMemoryAccountSharedPtr account_;
   const bool proxy_100_continue_;
+  const bool use_stream_arena_;
 
-  std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-  std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
+  // The arena must outlive the filter wrappers and the filters allocated from it, so it is
+  // declared before them.
+  Arena stream_arena_;
+  ActiveStreamDecoderFilterList decoder_filters_;
+  ActiveStreamEncoderFilterList encoder_filters_;
   std::list<StreamFilterBase*> filters_;
   std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
 
@@ -53,20 +53,20 @@ HeaderString::HeaderString(UnionString&& move_value) noexcept {
 // Specialization needed for HeaderMapImpl::HeaderList::insert() when key is LowerCaseString.
 // A fully specialized template must be defined once in the program, hence this may not be in
 // a header file.
-template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString& key) {
+template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString& key) const {
   return key.get().c_str()[0] == ':';
 }
 
 bool HeaderMapImpl::HeaderList::maybeMakeMap() {
   if (lazy_map_.empty()) {
-    if (headers_.size() < kMinHeadersForLazyMap) {
+    if (size() < kMinHeadersForLazyMap) {
       return false;
     }
     // Add all entries from the list into the map.
-    for (auto node = headers_.begin(); node != headers_.end(); ++node) {
-      HeaderNodeVector& v = lazy_map_[node->key().getStringView()];
-      v.push_back(node);
-    }
+    iterate([this](HeaderEntryImpl& entry) {
+      lazy_map_[entry.key().getStringView()].push_back(&entry);
+      return HeaderMap::Iterate::Continue;
+    });
   }
   return true;
 }
@@ -82,23 +82,37 @@ size_t HeaderMapImpl::HeaderList::remove(absl::string_view key) {
       for (const HeaderNode& node : header_nodes) {
         ASSERT(node->key() == key);
         removed_bytes += node->key().size() + node->value().size();
-        erase(node, false /* remove_from_map */);
+        eraseEntry(*node);
       }
     }
   } else {
     // Erase all same key entries from the list.
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key) {
-        removed_bytes += i->key().size() + i->value().size();
-        i = erase(i, false /* remove_from_map */);
-      } else {
-        ++i;
+    removeIf([key, &removed_bytes](const HeaderEntryImpl& entry) {
+      if (entry.key() == key) {
+        removed_bytes += entry.key().size() + entry.value().size();
+        return true;
       }
-    }
+      return false;
+    });
   }
   return removed_bytes;
 }
 
+void HeaderMapImpl::HeaderList::eraseEntry(HeaderEntryImpl& entry) {
+  if (contiguous_) {
+    if (isPseudoHeader(entry.key())) {
+      pseudo_header_vector_.erase(entry);
+    } else {
+      header_vector_.erase(entry);
+    }
+    return;
+  }
+  if (pseudo_headers_end_ == entry.entry_) {
+    pseudo_headers_end_++;
+  }
+  headers_.erase(entry.entry_);
+}
+
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key) : key_(key) {}
 
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value)
@@ -184,6 +198,10 @@ void HeaderMapImpl::subtractSize(uint64_t size) {
   cached_byte_size_ -= size;
 }
 
+HeaderMapImpl::HeaderMapImpl()
+    : headers_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.contiguous_header_map_storage")) {}
+
 void HeaderMapImpl::copyFrom(HeaderMap& lhs, const HeaderMap& header_map) {
   header_map.iterate([&lhs](const HeaderEntry& header) -> HeaderMap::Iterate {
     // TODO(mattklein123) PERF: Avoid copying here if not necessary.
@@ -220,15 +238,18 @@ bool HeaderMapImpl::operator==(const HeaderMap& rhs) const {
   rhs_headers.reserve(rhs.size());
   rhs.iterate(collectAllHeaders(&rhs_headers));
 
-  auto i = headers_.begin();
+  bool equal = true;
   auto j = rhs_headers.begin();
-  for (; i != headers_.end(); ++i, ++j) {
-    if (i->key() != j->first || i->value() != j->second) {
-      return false;
+  headers_.iterate([&equal, &j](const HeaderEntryImpl& header) {
+    if (header.key() != j->first || header.value() != j->second) {
+      equal = false;
+      return HeaderMap::Iterate::Break;
     }
-  }
+    ++j;
+    return HeaderMap::Iterate::Continue;
+  });
 
-  return true;
+  return equal;
 }
 
 bool HeaderMapImpl::operator!=(const HeaderMap& rhs) const { return !operator==(rhs); }
@@ -248,8 +269,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     }
   } else {
     addSize(key.size() + value.size());
-    HeaderNode i = headers_.insert(std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.insert(std::move(key), std::move(value));
   }
 }
 
@@ -335,10 +355,11 @@ uint64_t HeaderMapImpl::byteSize() const { return cached_byte_size_; }
 void HeaderMapImpl::verifyByteSizeInternalForTest() const {
   // Computes the total byte size by summing the byte size of the keys and values.
   uint64_t byte_size = 0;
-  for (const HeaderEntryImpl& header : headers_) {
+  headers_.iterate([&byte_size](const HeaderEntryImpl& header) {
     byte_size += header.key().size();
     byte_size += header.value().size();
-  }
+    return HeaderMap::Iterate::Continue;
+  });
   ASSERT(cached_byte_size_ == byte_size);
 }
 
@@ -367,9 +388,8 @@ HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(absl::string_view key) {
     if (iter != headers_.mapEnd()) {
       const HeaderList::HeaderNodeVector& v = iter->second;
       ASSERT(!v.empty()); // It's impossible to have a map entry with an empty vector as its value.
-      for (const auto& values_it : v) {
-        // Convert the iterated value to a HeaderEntry*.
-        ret.push_back(&(*values_it));
+      for (HeaderNode node : v) {
+        ret.push_back(node);
       }
     }
     return ret;
@@ -378,29 +398,20 @@ HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(absl::string_view key) {
   // If the requested header is not an O(1) header and the lazy map is not in use, we do a full
   // scan. Doing the trie lookup is wasteful in the miss case, but is present for code consistency
   // with other functions that do similar things.
-  for (HeaderEntryImpl& header : headers_) {
+  headers_.iterate([&key, &ret](HeaderEntryImpl& header) {
     if (header.key() == key) {
       ret.push_back(&header);
     }
-  }
+    return HeaderMap::Iterate::Continue;
+  });
 
   return ret;
 }
 
-void HeaderMapImpl::iterate(HeaderMap::ConstIterateCb cb) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (cb(header) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
-}
+void HeaderMapImpl::iterate(HeaderMap::ConstIterateCb cb) const { headers_.iterate(cb); }
 
 void HeaderMapImpl::iterateReverse(HeaderMap::ConstIterateCb cb) const {
-  for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
-    if (cb(*it) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
+  headers_.iterateReverse(cb);
 }
 
 void HeaderMapImpl::clear() {
@@ -457,9 +468,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size());
-  HeaderNode i = headers_.insert(key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = headers_.insert(key);
   return **entry;
 }
 
@@ -472,9 +481,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size() + value.size());
-  HeaderNode i = headers_.insert(key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = headers_.insert(key, std::move(value));
   return **entry;
 }
 
@@ -495,10 +502,10 @@ size_t HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
   }
 
   HeaderEntryImpl* entry = *ptr_to_entry;
-  const uint64_t size_to_subtract = entry->entry_->key().size() + entry->entry_->value().size();
+  const uint64_t size_to_subtract = entry->key().size() + entry->value().size();
   subtractSize(size_to_subtract);
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_, true);
+  headers_.erase(entry, true);
   return 1;
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -15,6 +17,10 @@
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/inlined_vector.h"
+#include "absl/numeric/bits.h"
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -52,6 +58,7 @@ public:
  */
 class HeaderMapImpl : NonCopyable {
 public:
+  HeaderMapImpl();
   virtual ~HeaderMapImpl() = default;
 
   // The following "constructors" call virtual functions during construction and must use the
@@ -122,9 +129,168 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
+    // The position of the entry in the HeaderList storage in use: the list node for list storage,
+    // or the index in the insertion order of its HeaderVector for contiguous storage.
     std::list<HeaderEntryImpl>::iterator entry_;
+    uint32_t position_{};
+  };
+  using HeaderNode = HeaderEntryImpl*;
+
+  /**
+   * Insertion ordered storage of HeaderEntryImpl in chunks of doubling size, used by HeaderList
+   * instead of a std::list when contiguous header storage is enabled. Entries are allocated a
+   * chunk at a time rather than each on its own, and iteration walks an array of slot positions
+   * rather than following a pointer per entry.
+   *
+   * Entries never move once inserted, so pointers to them (held by the inline headers, the lazy
+   * map and callers of get() and iterate()) stay valid until they are erased. Erasing an entry
+   * frees its slot for the next insertion, and leaves a tombstone in the insertion order, which is
+   * compacted once tombstones outnumber the entries.
+   */
+  template <uint32_t FirstChunkSize> class HeaderVector : NonCopyable {
+  public:
+    static_assert((FirstChunkSize & (FirstChunkSize - 1)) == 0,
+                  "FirstChunkSize must be a power of 2");
+
+    template <class... Args> HeaderEntryImpl& emplaceBack(Args&&... args) {
+      uint32_t slot_position;
+      if (!free_slots_.empty()) {
+        slot_position = free_slots_.back();
+        free_slots_.pop_back();
+      } else {
+        if (allocated_ == capacity_) {
+          // Chunks are kept across clear(), so a new one is only needed once all of them are used.
+          chunks_.emplace_back(new Slot[chunkSize(chunks_.size())]);
+          capacity_ += chunkSize(chunks_.size() - 1);
+        }
+        slot_position = allocated_++;
+      }
+      Slot& slot = slotAt(slot_position);
+      slot.emplace(std::forward<Args>(args)...);
+      slot->position_ = order_.size();
+      order_.push_back(slot_position);
+      size_++;
+      return *slot;
+    }
+
+    void erase(HeaderEntryImpl& entry) {
+      eraseAt(entry.position_);
+      maybeCompactOrder();
+    }
+
+    template <class UnaryPredicate> void removeIf(UnaryPredicate& p) {
+      for (uint32_t i = 0; i < order_.size(); i++) {
+        if (order_[i] != Tombstone && p(*slotAt(order_[i]))) {
+          eraseAt(i);
+        }
+      }
+      maybeCompactOrder();
+    }
+
+    /**
+     * Calls cb with the entries in insertion order, until it returns HeaderMap::Iterate::Break.
+     * @return false if the iteration was stopped by cb.
+     */
+    template <class Callback> bool iterate(Callback& cb) { return iterateImpl(*this, cb); }
+    template <class Callback> bool iterate(Callback& cb) const { return iterateImpl(*this, cb); }
+
+    /**
+     * Calls cb with the entries in reverse insertion order, until it returns
+     * HeaderMap::Iterate::Break.
+     * @return false if the iteration was stopped by cb.
+     */
+    template <class Callback> bool iterateReverse(Callback& cb) const {
+      for (uint32_t i = order_.size(); i-- > 0;) {
+        if (order_[i] != Tombstone && cb(*slotAt(order_[i])) == HeaderMap::Iterate::Break) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    size_t size() const { return size_; }
+    void clear() {
+      for (const uint32_t slot_position : order_) {
+        if (slot_position != Tombstone) {
+          slotAt(slot_position).reset();
+        }
+      }
+      order_.clear();
+      free_slots_.clear();
+      allocated_ = 0;
+      size_ = 0;
+    }
+
+  private:
+    using Slot = absl::optional<HeaderEntryImpl>;
+    static constexpr uint32_t Tombstone = std::numeric_limits<uint32_t>::max();
+
+    // Chunk n holds FirstChunkSize * 2^n slots, and starts at position FirstChunkSize * (2^n - 1).
+    static uint32_t chunkSize(size_t chunk) { return FirstChunkSize << chunk; }
+    static uint32_t chunkBegin(size_t chunk) { return FirstChunkSize * ((1U << chunk) - 1); }
+    static size_t chunkOf(uint32_t position) {
+      return absl::bit_width(position / FirstChunkSize + 1) - 1;
+    }
+    Slot& slotAt(uint32_t position) {
+      const size_t chunk = chunkOf(position);
+      return chunks_[chunk][position - chunkBegin(chunk)];
+    }
+    const Slot& slotAt(uint32_t position) const {
+      const size_t chunk = chunkOf(position);
+      return chunks_[chunk][position - chunkBegin(chunk)];
+    }
+
+    template <class Self, class Callback> static bool iterateImpl(Self& self, Callback& cb) {
+      for (const uint32_t slot_position : self.order_) {
+        if (slot_position != Tombstone &&
+            cb(*self.slotAt(slot_position)) == HeaderMap::Iterate::Break) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Destroys the entry at the given position in the insertion order, and frees its slot.
+    void eraseAt(uint32_t position) {
+      const uint32_t slot_position = order_[position];
+      ASSERT(slot_position != Tombstone && slotAt(slot_position)->position_ == position);
+      slotAt(slot_position).reset();
+      free_slots_.push_back(slot_position);
+      order_[position] = Tombstone;
+      size_--;
+    }
+
+    // Drops the tombstones at the end of the insertion order, and all of them once they outnumber
+    // the entries. Only positions in the insertion order change; the entries stay in their slots.
+    void maybeCompactOrder() {
+      while (!order_.empty() && order_.back() == Tombstone) {
+        order_.pop_back();
+      }
+      if (order_.size() - size_ <= size_) {
+        return;
+      }
+      uint32_t next = 0;
+      for (const uint32_t slot_position : order_) {
+        if (slot_position != Tombstone) {
+          slotAt(slot_position)->position_ = next;
+          order_[next++] = slot_position;
+        }
+      }
+      order_.resize(next);
+    }
+
+    absl::InlinedVector<std::unique_ptr<Slot[]>, 4> chunks_;
+    // The slot positions of the entries in insertion order, with Tombstone for erased entries.
+    absl::InlinedVector<uint32_t, FirstChunkSize> order_;
+    // The positions of the slots below allocated_ that hold no entry.
+    absl::InlinedVector<uint32_t, 4> free_slots_;
+    // The number of slots in chunks_.
+    uint32_t capacity_{};
+    // The number of slots handed out since the last clear(); the next new slot is allocated_.
+    uint32_t allocated_{};
+    // The number of entries.
+    uint32_t size_{};
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
@@ -185,6 +351,10 @@ protected:
    * access given a header key. Once the map is initialized, it will be used even
    * if the number of headers decreases below the threshold.
    *
+   * The headers are stored either in a std::list, or, when contiguous storage is requested, in one
+   * HeaderVector for the pseudo headers followed by one for the other headers. The storage is
+   * chosen at construction and not changed for the lifetime of the list.
+   *
    * Note: the internal iterators held in fields make this unsafe to copy and move, since the
    * reference to end() is not preserved across a move (see Notes in
    * https://en.cppreference.com/w/cpp/container/list/list). The NonCopyable will suppress both copy
@@ -197,33 +367,41 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    explicit HeaderList(bool contiguous)
+        : contiguous_(contiguous), pseudo_headers_end_(headers_.end()) {}
 
-    template <class Key> bool isPseudoHeader(const Key& key) {
+    template <class Key> bool isPseudoHeader(const Key& key) const {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
     }
 
     template <class Key, class... Value> HeaderNode insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      HeaderNode i = headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
-                                      std::forward<Key>(key), std::forward<Value>(value)...);
-      if (!lazy_map_.empty()) {
-        lazy_map_[i->key().getStringView()].push_back(i);
+      HeaderNode node;
+      if (contiguous_) {
+        node = is_pseudo_header ? &pseudo_header_vector_.emplaceBack(std::forward<Key>(key),
+                                                                     std::forward<Value>(value)...)
+                                : &header_vector_.emplaceBack(std::forward<Key>(key),
+                                                              std::forward<Value>(value)...);
+      } else {
+        auto i = headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
+                                  std::forward<Key>(key), std::forward<Value>(value)...);
+        i->entry_ = i;
+        if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
+          pseudo_headers_end_ = i;
+        }
+        node = &*i;
       }
-      if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
-        pseudo_headers_end_ = i;
+      if (!lazy_map_.empty()) {
+        lazy_map_[node->key().getStringView()].push_back(node);
       }
-      return i;
+      return node;
     }
 
-    HeaderNode erase(HeaderNode i, bool remove_from_map) {
-      if (pseudo_headers_end_ == i) {
-        pseudo_headers_end_++;
-      }
+    void erase(HeaderNode node, bool remove_from_map) {
       if (remove_from_map) {
-        lazy_map_.erase(i->key().getStringView());
+        lazy_map_.erase(node->key().getStringView());
       }
-      return headers_.erase(i);
+      eraseEntry(*node);
     }
 
     template <class UnaryPredicate> void removeIf(UnaryPredicate p) {
@@ -238,13 +416,10 @@ protected:
           // The call to erase that follows erases the unneeded cells (from remove_pos to the
           // end) and modifies the vector's size.
           const auto remove_pos =
-              std::remove_if(values_vec.begin(), values_vec.end(), [&](HeaderNode it) {
-                if (p(*(it->entry_))) {
+              std::remove_if(values_vec.begin(), values_vec.end(), [&](HeaderNode node) {
+                if (p(*node)) {
                   // Remove the element from the list.
-                  if (pseudo_headers_end_ == it->entry_) {
-                    pseudo_headers_end_++;
-                  }
-                  headers_.erase(it);
+                  eraseEntry(*node);
                   return true;
                 }
                 return false;
@@ -258,6 +433,9 @@ protected:
             map_it++;
           }
         }
+      } else if (contiguous_) {
+        pseudo_header_vector_.removeIf(p);
+        header_vector_.removeIf(p);
       } else {
         // The lazy map isn't used, iterate over the list elements and remove elements that satisfy
         // the predicate.
@@ -287,25 +465,70 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    /*
+     * Calls cb with each header, pseudo headers first and otherwise in insertion order, until it
+     * returns HeaderMap::Iterate::Break.
+     */
+    template <class Callback> void iterate(Callback&& cb) { iterateImpl(*this, cb); }
+    template <class Callback> void iterate(Callback&& cb) const { iterateImpl(*this, cb); }
+
+    /*
+     * Calls cb with each header in the reverse order of iterate(), until it returns
+     * HeaderMap::Iterate::Break.
+     */
+    template <class Callback> void iterateReverse(Callback&& cb) const {
+      if (contiguous_) {
+        if (header_vector_.iterateReverse(cb)) {
+          pseudo_header_vector_.iterateReverse(cb);
+        }
+        return;
+      }
+      for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
+        if (cb(*it) == HeaderMap::Iterate::Break) {
+          return;
+        }
+      }
+    }
+
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
-    size_t size() const { return headers_.size(); }
-    bool empty() const { return headers_.empty(); }
+    size_t size() const {
+      return contiguous_ ? pseudo_header_vector_.size() + header_vector_.size() : headers_.size();
+    }
+    bool empty() const { return size() == 0; }
     void clear() {
       headers_.clear();
       pseudo_headers_end_ = headers_.end();
+      pseudo_header_vector_.clear();
+      header_vector_.clear();
       lazy_map_.clear();
     }
 
   private:
+    template <class Self, class Callback> static void iterateImpl(Self& self, Callback& cb) {
+      if (self.contiguous_) {
+        if (self.pseudo_header_vector_.iterate(cb)) {
+          self.header_vector_.iterate(cb);
+        }
+        return;
+      }
+      for (auto& entry : self.headers_) {
+        if (cb(entry) == HeaderMap::Iterate::Break) {
+          return;
+        }
+      }
+    }
+
+    // Removes the entry from the storage, but not from the lazy map.
+    void eraseEntry(HeaderEntryImpl& entry);
+
+    const bool contiguous_;
+    // List storage.
     std::list<HeaderEntryImpl> headers_;
-    HeaderNode pseudo_headers_end_;
+    std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+    // Contiguous storage. Responses usually have a single pseudo header, and requests four.
+    HeaderVector<4> pseudo_header_vector_;
+    HeaderVector<8> header_vector_;
     HeaderLazyMap lazy_map_;
   };
 
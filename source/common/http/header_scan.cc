@@ -0,0 +1,124 @@
+#include "source/common/http/header_scan.h"
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+bool isValidValueChar(uint8_t c) { return (c >= 0x20 && c != 0x7f) || c == '\t'; }
+
+} // namespace
+
+bool HeaderScan::valueIsValid(absl::string_view value) {
+  const auto* data = reinterpret_cast<const uint8_t*>(value.data());
+  const size_t size = value.size();
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  const __m256i max_control = _mm256_set1_epi8(0x1f);
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i del = _mm256_set1_epi8(0x7f);
+  for (; i + 32 <= size; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    // Unsigned v <= 0x1f.
+    const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_control), v);
+    const __m256i invalid = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(v, tab), control),
+                                            _mm256_cmpeq_epi8(v, del));
+    if (_mm256_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i max_control = _mm_set1_epi8(0x1f);
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i del = _mm_set1_epi8(0x7f);
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // Unsigned v <= 0x1f.
+    const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, max_control), v);
+    const __m128i invalid = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(v, tab), control),
+                                         _mm_cmpeq_epi8(v, del));
+    if (_mm_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint8x16_t max_control = vdupq_n_u8(0x1f);
+  const uint8x16_t tab = vdupq_n_u8('\t');
+  const uint8x16_t del = vdupq_n_u8(0x7f);
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t v = vld1q_u8(data + i);
+    const uint8x16_t invalid =
+        vorrq_u8(vbicq_u8(vcleq_u8(v, max_control), vceqq_u8(v, tab)), vceqq_u8(v, del));
+    if (vmaxvq_u8(invalid) != 0) {
+      return false;
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    if (!isValidValueChar(data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HeaderScan::toLowerAscii(char* data, size_t size) {
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  // Bytes >= 0x80 are negative in the signed compares and are never in range.
+  const __m256i before_upper = _mm256_set1_epi8('A' - 1);
+  const __m256i after_upper = _mm256_set1_epi8('Z' + 1);
+  const __m256i case_bit = _mm256_set1_epi8(0x20);
+  for (; i + 32 <= size; i += 32) {
+    auto* p = reinterpret_cast<__m256i*>(data + i);
+    const __m256i v = _mm256_loadu_si256(p);
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, before_upper),
+                                           _mm256_cmpgt_epi8(after_upper, v));
+    _mm256_storeu_si256(p, _mm256_or_si256(v, _mm256_and_si256(upper, case_bit)));
+  }
+#elif defined(__SSE2__)
+  // Bytes >= 0x80 are negative in the signed compares and are never in range.
+  const __m128i before_upper = _mm_set1_epi8('A' - 1);
+  const __m128i after_upper = _mm_set1_epi8('Z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  for (; i + 16 <= size; i += 16) {
+    auto* p = reinterpret_cast<__m128i*>(data + i);
+    const __m128i v = _mm_loadu_si128(p);
+    const __m128i upper =
+        _mm_and_si128(_mm_cmpgt_epi8(v, before_upper), _mm_cmplt_epi8(v, after_upper));
+    _mm_storeu_si128(p, _mm_or_si128(v, _mm_and_si128(upper, case_bit)));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint8x16_t upper_a = vdupq_n_u8('A');
+  const uint8x16_t upper_z = vdupq_n_u8('Z');
+  const uint8x16_t case_bit = vdupq_n_u8(0x20);
+  for (; i + 16 <= size; i += 16) {
+    auto* p = reinterpret_cast<uint8_t*>(data + i);
+    const uint8x16_t v = vld1q_u8(p);
+    const uint8x16_t upper = vandq_u8(vcgeq_u8(v, upper_a), vcleq_u8(v, upper_z));
+    vst1q_u8(p, vorrq_u8(v, vandq_u8(upper, case_bit)));
+  }
+#endif
+
+  for (; i < size; ++i) {
+    data[i] = absl::ascii_tolower(data[i]);
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Byte scans run over every header name and value received by the codecs. They process 16 or 32
+ * bytes per step with SSE2 (always available on x86-64) or AVX2 when the build targets it, and with
+ * NEON on aarch64, falling back to scalar loops elsewhere and for the last few bytes.
+ */
+class HeaderScan {
+public:
+  /**
+   * @return true if the value only contains characters allowed in a header field value, i.e. no
+   *         control characters other than horizontal tab. Same as nghttp2_check_header_value().
+   */
+  static bool valueIsValid(absl::string_view value);
+
+  /**
+   * Convert ASCII upper case letters to lower case in place. Other bytes are left as is.
+   */
+  static void toLowerAscii(char* data, size_t size);
+};
+
+} // namespace Http
+} // namespace Envoy
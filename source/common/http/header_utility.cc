@@ -6,6 +6,7 @@
 #include "source/common/common/regex.h"
 #include "source/common/common/utility.h"
 #include "source/common/http/header_map_impl.h"
+#include "source/common/http/header_scan.h"
 #include "source/common/http/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
@@ -190,8 +191,7 @@ bool HeaderUtility::schemeIsValid(const absl::string_view scheme) {
 }
 
 bool HeaderUtility::headerValueIsValid(const absl::string_view header_value) {
-  return nghttp2_check_header_value(reinterpret_cast<const uint8_t*>(header_value.data()),
-                                    header_value.size()) != 0;
+  return HeaderScan::valueIsValid(header_value);
 }
 
 bool HeaderUtility::headerNameContainsUnderscore(const absl::string_view header_name) {
@@ -88,6 +88,8 @@ struct DelegatingFactoryCallbacks : public Envoy::Http::FilterChainFactoryCallba
     delegated_callbacks_.addAccessLogHandler(std::move(handler));
   }
 
+  OptRef<Arena> streamArena() override { return delegated_callbacks_.streamArena(); }
+
   Envoy::Http::FilterChainFactoryCallbacks& delegated_callbacks_;
   Matcher::MatchTreeSharedPtr<Envoy::Http::HttpMatchingData> match_tree_;
 };
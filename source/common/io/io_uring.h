@@ -1,6 +1,8 @@
 #pragma once
 
+#include "envoy/common/optref.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
 
 #include "source/common/network/address_impl.h"
 
@@ -86,6 +88,14 @@ public:
    */
   virtual IoUringResult prepareClose(os_fd_t fd, void* user_data) PURE;
 
+  /**
+   * Prepares a cancellation of the in-flight request identified by cancelling_user_data and puts
+   * it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareCancel(void* cancelling_user_data, void* user_data) PURE;
+
   /**
    * Submits the entries in the submission queue to the kernel using the
    * `io_uring_enter()` system call.
@@ -97,6 +107,102 @@ public:
   virtual IoUringResult submit() PURE;
 };
 
+using IoUringPtr = std::unique_ptr<IoUring>;
+
+/**
+ * A request submitted to an IoUringWorker. The address of the request is used as the user data of
+ * the corresponding submission queue entry.
+ */
+class Request {
+public:
+  virtual ~Request() = default;
+
+  /**
+   * Called by the worker once the completion of the request has been reaped.
+   * @param result is a return code of the submitted system call, i.e. the negated errno value in
+   * case of failure.
+   */
+  virtual void onCompletion(int32_t result) PURE;
+};
+
+using RequestPtr = std::unique_ptr<Request>;
+
+/**
+ * Per-thread owner of an IoUring integrated with the thread's dispatcher through the registered
+ * eventfd. Requests submitted in the same event loop iteration are flushed to the kernel with a
+ * single `io_uring_enter()` call at the end of the iteration.
+ */
+class IoUringWorker {
+public:
+  virtual ~IoUringWorker() = default;
+
+  /**
+   * Returns the dispatcher the worker delivers completions on.
+   */
+  virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Submits an accept request. The worker owns the request until its completion is delivered.
+   * Returns IoUringResult::Failed in case the submission queue is full even after flushing it.
+   */
+  virtual IoUringResult submitAcceptRequest(os_fd_t fd, struct sockaddr* remote_addr,
+                                            socklen_t* remote_addr_len, RequestPtr request) PURE;
+
+  /**
+   * Submits a connect request. The worker owns the request until its completion is delivered.
+   * Returns IoUringResult::Failed in case the submission queue is full even after flushing it.
+   */
+  virtual IoUringResult
+  submitConnectRequest(os_fd_t fd, const Network::Address::InstanceConstSharedPtr& address,
+                       RequestPtr request) PURE;
+
+  /**
+   * Submits a readv request. The worker owns the request until its completion is delivered.
+   * Returns IoUringResult::Failed in case the submission queue is full even after flushing it.
+   */
+  virtual IoUringResult submitReadvRequest(os_fd_t fd, const struct iovec* iovecs,
+                                           unsigned nr_vecs, RequestPtr request) PURE;
+
+  /**
+   * Submits a writev request. The worker owns the request until its completion is delivered.
+   * Returns IoUringResult::Failed in case the submission queue is full even after flushing it.
+   */
+  virtual IoUringResult submitWritevRequest(os_fd_t fd, const struct iovec* iovecs,
+                                            unsigned nr_vecs, RequestPtr request) PURE;
+
+  /**
+   * Submits a cancellation of a previously submitted request. The cancelled request still gets
+   * its completion delivered, usually with -ECANCELED as the result.
+   */
+  virtual IoUringResult submitCancelRequest(Request& request) PURE;
+
+  /**
+   * Returns the number of submitted requests whose completions haven't been delivered yet.
+   */
+  virtual uint32_t numOfRequests() const PURE;
+};
+
+/**
+ * Abstract factory for IoUringWorker instances.
+ */
+class IoUringWorkerFactory {
+public:
+  virtual ~IoUringWorkerFactory() = default;
+
+  /**
+   * Returns the worker of the current thread if the thread has one.
+   */
+  virtual OptRef<IoUringWorker> getIoUringWorker() PURE;
+
+  /**
+   * Initializes the factory upon server readiness by creating a worker on every thread registered
+   * with thread local storage.
+   */
+  virtual void onServerInitialized() PURE;
+};
+
+using IoUringWorkerFactorySharedPtr = std::shared_ptr<IoUringWorkerFactory>;
+
 /**
  * Abstract factory for IoUring wrappers.
  */
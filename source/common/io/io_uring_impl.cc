@@ -84,7 +84,9 @@ IoUringResult IoUringImpl::prepareAccept(os_fd_t fd, struct sockaddr* remote_add
     return IoUringResult::Failed;
   }
 
-  io_uring_prep_accept(sqe, fd, remote_addr, remote_addr_len, 0);
+  // Accepted sockets are expected to be non-blocking the same way as the ones returned by
+  // accept4() in the readiness-based code path.
+  io_uring_prep_accept(sqe, fd, remote_addr, remote_addr_len, SOCK_NONBLOCK);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -137,6 +139,17 @@ IoUringResult IoUringImpl::prepareClose(os_fd_t fd, void* user_data) {
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareCancel(void* cancelling_user_data, void* user_data) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_cancel(sqe, cancelling_user_data, 0);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::submit() {
   int res = io_uring_submit(&ring_);
   RELEASE_ASSERT(res >= 0 || res == -EBUSY, "unable to submit io_uring queue entries");
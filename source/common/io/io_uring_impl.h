@@ -29,6 +29,7 @@ public:
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, void* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, void* user_data) override;
+  IoUringResult prepareCancel(void* cancelling_user_data, void* user_data) override;
   IoUringResult submit() override;
 
 private:
@@ -0,0 +1,166 @@
+#include "source/common/io/io_uring_worker_impl.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/io/io_uring_impl.h"
+
+namespace Envoy {
+namespace Io {
+
+IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                                     Event::Dispatcher& dispatcher)
+    : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
+                        dispatcher) {}
+
+IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr io_uring, Event::Dispatcher& dispatcher)
+    : io_uring_(std::move(io_uring)), dispatcher_(dispatcher),
+      submit_cb_(dispatcher_.createSchedulableCallback([this]() { submit(); })) {
+  event_fd_ = io_uring_->registerEventfd();
+  file_event_ = dispatcher_.createFileEvent(
+      event_fd_, [this](uint32_t) { onFileEvent(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+}
+
+IoUringWorkerImpl::~IoUringWorkerImpl() {
+  ENVOY_LOG(trace, "destroying io_uring worker with {} in-flight requests", requests_.size());
+  file_event_.reset();
+  submit_cb_.reset();
+  io_uring_->unregisterEventfd();
+  Api::OsSysCallsSingleton::get().close(event_fd_);
+  // Tear down the ring before releasing the requests so the kernel doesn't touch their buffers.
+  io_uring_.reset();
+  requests_.clear();
+}
+
+IoUringResult IoUringWorkerImpl::submitAcceptRequest(os_fd_t fd, struct sockaddr* remote_addr,
+                                                     socklen_t* remote_addr_len,
+                                                     RequestPtr request) {
+  Request* user_data = request.get();
+  const IoUringResult result = prepareRequest(
+      [this, fd, remote_addr, remote_addr_len](void* user_data) {
+        return io_uring_->prepareAccept(fd, remote_addr, remote_addr_len, user_data);
+      },
+      user_data);
+  if (result == IoUringResult::Ok) {
+    requests_.emplace(user_data, std::move(request));
+  }
+  return result;
+}
+
+IoUringResult
+IoUringWorkerImpl::submitConnectRequest(os_fd_t fd,
+                                        const Network::Address::InstanceConstSharedPtr& address,
+                                        RequestPtr request) {
+  Request* user_data = request.get();
+  const IoUringResult result = prepareRequest(
+      [this, fd, &address](void* user_data) {
+        return io_uring_->prepareConnect(fd, address, user_data);
+      },
+      user_data);
+  if (result == IoUringResult::Ok) {
+    requests_.emplace(user_data, std::move(request));
+  }
+  return result;
+}
+
+IoUringResult IoUringWorkerImpl::submitReadvRequest(os_fd_t fd, const struct iovec* iovecs,
+                                                    unsigned nr_vecs, RequestPtr request) {
+  Request* user_data = request.get();
+  const IoUringResult result = prepareRequest(
+      [this, fd, iovecs, nr_vecs](void* user_data) {
+        return io_uring_->prepareReadv(fd, iovecs, nr_vecs, 0, user_data);
+      },
+      user_data);
+  if (result == IoUringResult::Ok) {
+    requests_.emplace(user_data, std::move(request));
+  }
+  return result;
+}
+
+IoUringResult IoUringWorkerImpl::submitWritevRequest(os_fd_t fd, const struct iovec* iovecs,
+                                                     unsigned nr_vecs, RequestPtr request) {
+  Request* user_data = request.get();
+  const IoUringResult result = prepareRequest(
+      [this, fd, iovecs, nr_vecs](void* user_data) {
+        return io_uring_->prepareWritev(fd, iovecs, nr_vecs, 0, user_data);
+      },
+      user_data);
+  if (result == IoUringResult::Ok) {
+    requests_.emplace(user_data, std::move(request));
+  }
+  return result;
+}
+
+IoUringResult IoUringWorkerImpl::submitCancelRequest(Request& request) {
+  ASSERT(requests_.contains(&request));
+  // Cancellations carry no user data: there is nothing to notify when they complete.
+  return prepareRequest(
+      [this, &request](void* user_data) { return io_uring_->prepareCancel(&request, user_data); },
+      nullptr);
+}
+
+IoUringResult IoUringWorkerImpl::prepareRequest(const PrepareCb& prepare_cb, void* user_data) {
+  IoUringResult result = prepare_cb(user_data);
+  if (result == IoUringResult::Failed) {
+    // The submission queue is full. Flush it and retry once.
+    ENVOY_LOG(trace, "io_uring submission queue is full, submitting early");
+    submit();
+    result = prepare_cb(user_data);
+    if (result == IoUringResult::Failed) {
+      return result;
+    }
+  }
+  if (!submit_cb_->enabled()) {
+    submit_cb_->scheduleCallbackCurrentIteration();
+  }
+  return result;
+}
+
+void IoUringWorkerImpl::onFileEvent() {
+  io_uring_->forEveryCompletion([this](void* user_data, int32_t result) {
+    if (user_data == nullptr) {
+      return;
+    }
+    auto it = requests_.find(static_cast<Request*>(user_data));
+    ASSERT(it != requests_.end());
+    RequestPtr request = std::move(it->second);
+    requests_.erase(it);
+    request->onCompletion(result);
+  });
+}
+
+void IoUringWorkerImpl::submit() {
+  if (io_uring_->submit() == IoUringResult::Busy) {
+    // The completion queue is overcommitted. Retry after the pending completions are handled.
+    ENVOY_LOG(trace, "io_uring is busy, deferring submission");
+    submit_cb_->scheduleCallbackNextIteration();
+  }
+}
+
+IoUringWorkerFactoryImpl::IoUringWorkerFactoryImpl(uint32_t io_uring_size,
+                                                   bool use_submission_queue_polling,
+                                                   ThreadLocal::SlotAllocator& tls)
+    : io_uring_size_(io_uring_size), use_submission_queue_polling_(use_submission_queue_polling),
+      tls_(tls) {}
+
+OptRef<IoUringWorker> IoUringWorkerFactoryImpl::getIoUringWorker() {
+  if (!tls_.currentThreadRegistered()) {
+    return {};
+  }
+  auto worker = tls_.get();
+  if (!worker.has_value()) {
+    return {};
+  }
+  return *worker;
+}
+
+void IoUringWorkerFactoryImpl::onServerInitialized() {
+  tls_.set([io_uring_size = io_uring_size_,
+            use_submission_queue_polling =
+                use_submission_queue_polling_](Event::Dispatcher& dispatcher) {
+    return std::make_shared<IoUringWorkerImpl>(io_uring_size, use_submission_queue_polling,
+                                               dispatcher);
+  });
+}
+
+} // namespace Io
+} // namespace Envoy
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/io/io_uring.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Io {
+
+class IoUringWorkerImpl : public IoUringWorker,
+                          public ThreadLocal::ThreadLocalObject,
+                          protected Logger::Loggable<Logger::Id::io> {
+public:
+  IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                    Event::Dispatcher& dispatcher);
+  IoUringWorkerImpl(IoUringPtr io_uring, Event::Dispatcher& dispatcher);
+  ~IoUringWorkerImpl() override;
+
+  // IoUringWorker
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  IoUringResult submitAcceptRequest(os_fd_t fd, struct sockaddr* remote_addr,
+                                    socklen_t* remote_addr_len, RequestPtr request) override;
+  IoUringResult submitConnectRequest(os_fd_t fd,
+                                     const Network::Address::InstanceConstSharedPtr& address,
+                                     RequestPtr request) override;
+  IoUringResult submitReadvRequest(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                   RequestPtr request) override;
+  IoUringResult submitWritevRequest(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                    RequestPtr request) override;
+  IoUringResult submitCancelRequest(Request& request) override;
+  uint32_t numOfRequests() const override { return requests_.size(); }
+
+private:
+  using PrepareCb = std::function<IoUringResult(void* user_data)>;
+
+  // Puts the request into the submission queue, flushing the queue once if it's full, and makes
+  // sure the queue gets submitted by the end of the current event loop iteration.
+  IoUringResult prepareRequest(const PrepareCb& prepare_cb, void* user_data);
+  void onFileEvent();
+  void submit();
+
+  IoUringPtr io_uring_;
+  Event::Dispatcher& dispatcher_;
+  os_fd_t event_fd_{INVALID_SOCKET};
+  Event::FileEventPtr file_event_;
+  Event::SchedulableCallbackPtr submit_cb_;
+  // In-flight requests keyed by the user data of their submission queue entries.
+  absl::flat_hash_map<Request*, RequestPtr> requests_;
+};
+
+class IoUringWorkerFactoryImpl : public IoUringWorkerFactory {
+public:
+  IoUringWorkerFactoryImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                           ThreadLocal::SlotAllocator& tls);
+
+  // IoUringWorkerFactory
+  OptRef<IoUringWorker> getIoUringWorker() override;
+  void onServerInitialized() override;
+
+private:
+  const uint32_t io_uring_size_{};
+  const bool use_submission_queue_polling_{};
+  ThreadLocal::TypedSlot<IoUringWorkerImpl> tls_;
+};
+
+} // namespace Io
+} // namespace Envoy
@@ -59,6 +59,41 @@ constexpr int messageTruncatedOption() {
 #endif
 }
 
+// Space needed by the control message carrying the source address of an outgoing packet.
+size_t selfIpControlMessageSpace(const Network::Address::Ip& self_ip) {
+  // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
+  return (self_ip.version() == Network::Address::IpVersion::v4) ? CMSG_SPACE(sizeof(in_pktinfo))
+                                                                : CMSG_SPACE(sizeof(in6_pktinfo));
+}
+
+void fillSelfIpControlMessage(cmsghdr& cmsg, const Network::Address::Ip& self_ip) {
+  if (self_ip.version() == Network::Address::IpVersion::v4) {
+    cmsg.cmsg_level = IPPROTO_IP;
+#ifndef IP_SENDSRCADDR
+    cmsg.cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg.cmsg_type = IP_PKTINFO;
+    auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(&cmsg));
+    pktinfo->ipi_ifindex = 0;
+#ifdef WIN32
+    pktinfo->ipi_addr.s_addr = self_ip.ipv4()->address();
+#else
+    pktinfo->ipi_spec_dst.s_addr = self_ip.ipv4()->address();
+#endif
+#else
+    cmsg.cmsg_type = IP_SENDSRCADDR;
+    cmsg.cmsg_len = CMSG_LEN(sizeof(in_addr));
+    *(reinterpret_cast<struct in_addr*>(CMSG_DATA(&cmsg))).s_addr = self_ip.ipv4()->address();
+#endif
+  } else if (self_ip.version() == Network::Address::IpVersion::v6) {
+    cmsg.cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    cmsg.cmsg_level = IPPROTO_IPV6;
+    cmsg.cmsg_type = IPV6_PKTINFO;
+    auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(&cmsg));
+    pktinfo->ipi6_ifindex = 0;
+    *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip.ipv6()->address();
+  }
+}
+
 } // namespace
 
 namespace Network {
@@ -180,12 +215,7 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   } else {
-    const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
-    const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
-
-    // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
-    const size_t cmsg_space = (self_ip->version() == Address::IpVersion::v4) ? space_v4 : space_v6;
-    // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
+    const size_t cmsg_space = selfIpControlMessageSpace(*self_ip);
     absl::FixedArray<char> cbuf(cmsg_space);
     memset(cbuf.begin(), 0, cmsg_space);
 
@@ -194,31 +224,7 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
     RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
                                                 sizeof(cbuf), sizeof(cmsghdr)));
-    if (self_ip->version() == Address::IpVersion::v4) {
-      cmsg->cmsg_level = IPPROTO_IP;
-#ifndef IP_SENDSRCADDR
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-      cmsg->cmsg_type = IP_PKTINFO;
-      auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi_ifindex = 0;
-#ifdef WIN32
-      pktinfo->ipi_addr.s_addr = self_ip->ipv4()->address();
-#else
-      pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
-#endif
-#else
-      cmsg->cmsg_type = IP_SENDSRCADDR;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
-      *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip->ipv4()->address();
-#endif
-    } else if (self_ip->version() == Address::IpVersion::v6) {
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-      cmsg->cmsg_level = IPPROTO_IPV6;
-      cmsg->cmsg_type = IPV6_PKTINFO;
-      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi6_ifindex = 0;
-      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
-    }
+    fillSelfIpControlMessage(*cmsg, *self_ip);
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   }
@@ -434,6 +440,87 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmmsg(RawSliceArrays& slices, uin
   return sysCallResultToIoCallResult(result);
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const RawSliceArrays& slices,
+                                                     uint64_t gso_size, const Address::Ip* self_ip,
+                                                     const Address::Instance& peer_address) {
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
+  if (sock_addr == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+  const uint32_t num_messages = slices.size();
+  if (num_messages == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+#ifndef UDP_SEGMENT
+  if (gso_size > 0) {
+    return {0, Api::IoErrorPtr(new IoSocketError(EOPNOTSUPP), IoSocketError::deleteIoError)};
+  }
+#endif
+
+  uint64_t num_iovs = 0;
+  for (const auto& message_slices : slices) {
+    num_iovs += message_slices.size();
+  }
+  size_t cmsg_space = 0;
+  if (self_ip != nullptr) {
+    cmsg_space += selfIpControlMessageSpace(*self_ip);
+  }
+  if (gso_size > 0) {
+    cmsg_space += CMSG_SPACE(sizeof(uint16_t));
+  }
+
+  absl::FixedArray<mmsghdr> mmsg_hdr(num_messages);
+  absl::FixedArray<iovec> iovs(num_iovs);
+  absl::FixedArray<char> cbufs(num_messages * cmsg_space);
+  memset(cbufs.begin(), 0, cbufs.size());
+  iovec* next_iov = iovs.begin();
+  for (uint32_t i = 0; i < num_messages; ++i) {
+    msghdr* hdr = &mmsg_hdr[i].msg_hdr;
+    hdr->msg_name = reinterpret_cast<void*>(sock_addr);
+    hdr->msg_namelen = address_base->sockAddrLen();
+    hdr->msg_iov = next_iov;
+    hdr->msg_iovlen = 0;
+    hdr->msg_flags = 0;
+    mmsg_hdr[i].msg_len = 0;
+    for (const Buffer::RawSlice& slice : slices[i]) {
+      if (slice.mem_ != nullptr && slice.len_ != 0) {
+        next_iov->iov_base = slice.mem_;
+        next_iov->iov_len = slice.len_;
+        ++next_iov;
+        ++hdr->msg_iovlen;
+      }
+    }
+
+    if (cmsg_space == 0) {
+      hdr->msg_control = nullptr;
+      hdr->msg_controllen = 0;
+      continue;
+    }
+    hdr->msg_control = cbufs.begin() + i * cmsg_space;
+    hdr->msg_controllen = cmsg_space;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+    if (self_ip != nullptr) {
+      fillSelfIpControlMessage(*cmsg, *self_ip);
+      cmsg = CMSG_NXTHDR(hdr, cmsg);
+    }
+#ifdef UDP_SEGMENT
+    if (gso_size > 0) {
+      ASSERT(cmsg != nullptr);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = gso_size;
+    }
+#endif
+  }
+
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().sendmmsg(fd_, mmsg_hdr.data(), num_messages, 0);
+  return sysCallResultToIoCallResult(result);
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
   const Api::SysCallSizeResult result =
       Api::OsSysCallsSingleton::get().recv(fd_, buffer, length, flags);
@@ -49,6 +49,9 @@ public:
 
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                    RecvMsgOutput& output) override;
+  Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, uint64_t gso_size,
+                                   const Address::Ip* self_ip,
+                                   const Address::Instance& peer_address) override;
   Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
 
   bool supportsMmsg() const override;
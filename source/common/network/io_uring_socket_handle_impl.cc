@@ -0,0 +1,669 @@
+#include "source/common/network/io_uring_socket_handle_impl.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+// The maximum number of slices submitted in a single writev request. The rest of the data goes out
+// with the follow-up requests.
+constexpr uint64_t MaxWriteSlices = 64;
+
+Api::IoCallUint64Result ioCallResultFromErrno(int sys_errno) {
+  return Api::IoCallUint64Result(
+      0, sys_errno == SOCKET_ERROR_AGAIN
+             ? Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                               IoSocketError::deleteIoError)
+             : Api::IoErrorPtr(new IoSocketError(sys_errno), IoSocketError::deleteIoError));
+}
+
+} // namespace
+
+class IoUringSocketHandleImpl::AcceptRequest : public Io::Request {
+public:
+  explicit AcceptRequest(IoUringSocketHandleImpl& parent) : parent_(&parent) {}
+
+  // Io::Request
+  void onCompletion(int32_t result) override {
+    if (parent_ != nullptr) {
+      parent_->onAcceptCompleted(*this, result);
+    } else if (result >= 0) {
+      // The listener has been closed while the accept was in flight.
+      Api::OsSysCallsSingleton::get().close(result);
+    }
+  }
+
+  IoUringSocketHandleImpl* parent_;
+  sockaddr_storage remote_addr_{};
+  socklen_t remote_addr_len_{sizeof(remote_addr_)};
+};
+
+class IoUringSocketHandleImpl::ConnectRequest : public Io::Request {
+public:
+  ConnectRequest(IoUringSocketHandleImpl& parent, Address::InstanceConstSharedPtr address)
+      : parent_(&parent), address_(std::move(address)) {}
+
+  // Io::Request
+  void onCompletion(int32_t result) override {
+    if (parent_ != nullptr) {
+      parent_->onConnectCompleted(result);
+    }
+  }
+
+  IoUringSocketHandleImpl* parent_;
+  // Keeps the socket address alive until the kernel is done with it.
+  const Address::InstanceConstSharedPtr address_;
+};
+
+class IoUringSocketHandleImpl::ReadRequest : public Io::Request {
+public:
+  ReadRequest(IoUringSocketHandleImpl& parent, uint32_t read_buffer_size)
+      : parent_(&parent), reservation_(buffer_.reserveSingleSlice(read_buffer_size)) {
+    iov_.iov_base = reservation_.slice().mem_;
+    iov_.iov_len = reservation_.slice().len_;
+  }
+
+  // Io::Request
+  void onCompletion(int32_t result) override {
+    if (parent_ != nullptr) {
+      parent_->onReadCompleted(*this, result);
+    }
+  }
+
+  IoUringSocketHandleImpl* parent_;
+  Buffer::OwnedImpl buffer_;
+  Buffer::ReservationSingleSlice reservation_;
+  struct iovec iov_;
+};
+
+class IoUringSocketHandleImpl::WriteRequest : public Io::Request {
+public:
+  WriteRequest(IoUringSocketHandleImpl* parent, Io::IoUringWorker& worker, os_fd_t fd)
+      : parent_(parent), worker_(worker), fd_(fd) {}
+
+  void prepareIovecs() {
+    const Buffer::RawSliceVector slices = buffer_.getRawSlices(MaxWriteSlices);
+    iovecs_.resize(slices.size());
+    for (size_t i = 0; i < slices.size(); i++) {
+      iovecs_[i].iov_base = slices[i].mem_;
+      iovecs_[i].iov_len = slices[i].len_;
+    }
+  }
+
+  // Io::Request
+  void onCompletion(int32_t result) override {
+    if (parent_ != nullptr) {
+      parent_->onWriteCompleted(*this, result);
+      return;
+    }
+
+    // The handle has been closed while the write was in flight. Flush the rest of the data and
+    // close the socket afterwards, the same way the kernel would do it for a readiness-based socket
+    // closed with a non-empty send buffer.
+    if (result > 0) {
+      buffer_.drain(result);
+      if (buffer_.length() > 0) {
+        auto request = std::make_unique<WriteRequest>(nullptr, worker_, fd_);
+        request->buffer_.move(buffer_);
+        request->prepareIovecs();
+        WriteRequest& request_ref = *request;
+        if (worker_.submitWritevRequest(fd_, request_ref.iovecs_.data(), request_ref.iovecs_.size(),
+                                        std::move(request)) == Io::IoUringResult::Ok) {
+          return;
+        }
+      }
+    }
+    Api::OsSysCallsSingleton::get().close(fd_);
+  }
+
+  IoUringSocketHandleImpl* parent_;
+  Io::IoUringWorker& worker_;
+  const os_fd_t fd_;
+  Buffer::OwnedImpl buffer_;
+  std::vector<struct iovec> iovecs_;
+};
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                                                 uint32_t read_buffer_size, os_fd_t fd,
+                                                 bool socket_v6only, absl::optional<int> domain,
+                                                 bool is_connected)
+    : IoSocketHandleImpl(fd, socket_v6only, domain),
+      io_uring_worker_factory_(io_uring_worker_factory), read_buffer_size_(read_buffer_size),
+      is_connected_(is_connected) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (SOCKET_VALID(fd_)) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::close();
+  }
+
+  file_event_cb_.reset();
+  cb_ = nullptr;
+  if (accept_request_ != nullptr) {
+    accept_request_->parent_ = nullptr;
+    io_uring_worker_->submitCancelRequest(*accept_request_);
+    accept_request_ = nullptr;
+  }
+  if (connect_request_ != nullptr) {
+    connect_request_->parent_ = nullptr;
+    io_uring_worker_->submitCancelRequest(*connect_request_);
+    connect_request_ = nullptr;
+  }
+  if (read_request_ != nullptr) {
+    read_request_->parent_ = nullptr;
+    io_uring_worker_->submitCancelRequest(*read_request_);
+    read_request_ = nullptr;
+  }
+  for (const AcceptedSocket& socket : accepted_sockets_) {
+    Api::OsSysCallsSingleton::get().close(socket.fd_);
+  }
+  accepted_sockets_.clear();
+
+  if (write_request_ != nullptr) {
+    // The in-flight write takes over the socket and closes it once all the data is written out.
+    write_request_->parent_ = nullptr;
+    write_request_ = nullptr;
+    SET_SOCKET_INVALID(fd_);
+    return Api::ioCallUint64ResultNoError();
+  }
+  return IoSocketHandleImpl::close();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+
+  if (read_buffer_.length() == 0) {
+    return readResultWithoutData();
+  }
+
+  uint64_t bytes_read = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_read < max_length && read_buffer_.length() > 0;
+       i++) {
+    const uint64_t length = std::min({static_cast<uint64_t>(slices[i].len_),
+                                      max_length - bytes_read, read_buffer_.length()});
+    read_buffer_.copyOut(0, length, slices[i].mem_);
+    read_buffer_.drain(length);
+    bytes_read += length;
+  }
+  peek_length_ = 0;
+  submitReadRequest();
+  return {bytes_read, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      absl::optional<uint64_t> max_length_opt) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::read(buffer, max_length_opt);
+  }
+
+  const uint64_t max_length = max_length_opt.value_or(UINT64_MAX);
+  if (max_length == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  if (read_buffer_.length() == 0) {
+    return readResultWithoutData();
+  }
+
+  // The data read by io_uring is handed over without copying.
+  const uint64_t bytes_read = std::min(read_buffer_.length(), max_length);
+  buffer.move(read_buffer_, bytes_read);
+  peek_length_ = 0;
+  submitReadRequest();
+  return {bytes_read, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
+                                                         const uint64_t num_slice,
+                                                         uint32_t self_port,
+                                                         RecvMsgOutput& output) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::recvmsg(slices, num_slice, self_port, output);
+  }
+
+  // Only stream sockets are driven by io_uring, so the data comes from read_buffer_ like for
+  // readv() and the addresses are those of the connection.
+  Api::IoCallUint64Result result = readv(UINT64_MAX, slices, num_slice);
+  if (result.ok() && result.return_value_ > 0) {
+    output.msg_[0].msg_len_ = result.return_value_;
+    output.msg_[0].local_address_ = localAddress();
+    output.msg_[0].peer_address_ = peerAddress();
+  }
+  return result;
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recvmmsg(RawSliceArrays& slices,
+                                                          uint32_t self_port,
+                                                          RecvMsgOutput& output) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::recvmmsg(slices, self_port, output);
+  }
+
+  // The data of a stream socket is returned as a single message.
+  Api::IoCallUint64Result result = recvmsg(slices[0].data(), slices[0].size(), self_port, output);
+  if (!result.ok() || result.return_value_ == 0) {
+    return result;
+  }
+  return {1, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::recv(buffer, length, flags);
+  }
+
+  // The data has been read from the socket into read_buffer_ already, so that is where it is
+  // peeked at and consumed from, e.g. by the listener filters.
+  const bool peek = (flags & MSG_PEEK) != 0;
+  if (peek) {
+    peek_length_ = read_buffer_.length() < length ? length : 0;
+  }
+  if (read_buffer_.length() == 0) {
+    return readResultWithoutData();
+  }
+
+  const uint64_t bytes_read = std::min<uint64_t>(read_buffer_.length(), length);
+  read_buffer_.copyOut(0, bytes_read, buffer);
+  if (!peek) {
+    read_buffer_.drain(bytes_read);
+    peek_length_ = 0;
+  }
+  submitReadRequest();
+  return {bytes_read, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readResultWithoutData() {
+  if (read_error_.has_value()) {
+    return ioCallResultFromErrno(read_error_.value());
+  }
+  if (read_eof_) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  submitReadRequest();
+  return ioCallResultFromErrno(SOCKET_ERROR_AGAIN);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::writev(slices, num_slice);
+  }
+
+  Buffer::OwnedImpl buffer;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      buffer.add(slices[i].mem_, slices[i].len_);
+    }
+  }
+  return write(buffer);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  if (!isIoUringEnabled()) {
+    return IoSocketHandleImpl::write(buffer);
+  }
+
+  if (write_error_.has_value()) {
+    return ioCallResultFromErrno(write_error_.value());
+  }
+  // Only one write is kept in flight. The socket becomes writable again once it completes, which
+  // preserves the backpressure of the connection's write buffer.
+  if (write_request_ != nullptr) {
+    return ioCallResultFromErrno(SOCKET_ERROR_AGAIN);
+  }
+  const uint64_t length = buffer.length();
+  if (length == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  auto request = std::make_unique<WriteRequest>(this, *io_uring_worker_, fd_);
+  request->buffer_.move(buffer);
+  submitWriteRequest(std::move(request));
+  return {length, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)};
+}
+
+IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  if (!isIoUringEnabled()) {
+    auto result = Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen);
+    if (SOCKET_INVALID(result.return_value_)) {
+      return nullptr;
+    }
+    return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, read_buffer_size_,
+                                                     result.return_value_, socket_v6only_,
+                                                     domain_, true);
+  }
+
+  if (accepted_sockets_.empty()) {
+    return nullptr;
+  }
+  const AcceptedSocket socket = accepted_sockets_.front();
+  accepted_sockets_.pop_front();
+  if (addr != nullptr && addrlen != nullptr) {
+    memcpy(addr, &socket.remote_addr_, std::min(*addrlen, socket.remote_addr_len_)); // NOLINT
+    *addrlen = socket.remote_addr_len_;
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, read_buffer_size_,
+                                                   socket.fd_, socket_v6only_, domain_, true);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::connect(Address::InstanceConstSharedPtr address) {
+  if (!isIoUringEnabled()) {
+    connect_without_io_uring_ = true;
+    return IoSocketHandleImpl::connect(address);
+  }
+
+  ASSERT(connect_request_ == nullptr);
+  auto request = std::make_unique<ConnectRequest>(*this, std::move(address));
+  ConnectRequest* request_ptr = request.get();
+  if (io_uring_worker_->submitConnectRequest(fd_, request_ptr->address_, std::move(request)) !=
+      Io::IoUringResult::Ok) {
+    return {-1, SOCKET_ERROR_AGAIN};
+  }
+  connect_request_ = request_ptr;
+  return {-1, SOCKET_ERROR_IN_PROGRESS};
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::getOption(int level, int optname, void* optval,
+                                                         socklen_t* optlen) {
+  // The result of a connect submitted to io_uring is delivered with its completion rather than
+  // via the socket error.
+  if (level == SOL_SOCKET && optname == SO_ERROR && connect_error_.has_value()) {
+    ASSERT(*optlen >= sizeof(int));
+    *static_cast<int*>(optval) = connect_error_.value();
+    *optlen = sizeof(int);
+    connect_error_.reset();
+    return {0, 0};
+  }
+  return IoSocketHandleImpl::getOption(level, optname, optval, optlen);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (isIoUringEnabled() && write_request_ != nullptr && how != ENVOY_SHUT_RD) {
+    // Don't cut off the data which is still being written out.
+    pending_shutdown_ = how;
+    return {0, 0};
+  }
+  return IoSocketHandleImpl::shutdown(how);
+}
+
+IoUringSocketHandleImpl::IoUringSocketType IoUringSocketHandleImpl::detectSocketType() {
+  if (is_connected_) {
+    return IoUringSocketType::Connection;
+  }
+
+  int value = 0;
+  socklen_t value_len = sizeof(value);
+  if (IoSocketHandleImpl::getOption(SOL_SOCKET, SO_TYPE, &value, &value_len).return_value_ != 0 ||
+      value != SOCK_STREAM) {
+    return IoUringSocketType::Disabled;
+  }
+  value_len = sizeof(value);
+  if (IoSocketHandleImpl::getOption(SOL_SOCKET, SO_ACCEPTCONN, &value, &value_len).return_value_ !=
+      0) {
+    return IoUringSocketType::Disabled;
+  }
+  return value != 0 ? IoUringSocketType::Listener : IoUringSocketType::Connection;
+}
+
+void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                  Event::FileReadyCb cb,
+                                                  Event::FileTriggerType trigger, uint32_t events) {
+  ASSERT(file_event_ == nullptr && file_event_cb_ == nullptr,
+         "Attempting to initialize two file events for the same file descriptor. This is not "
+         "allowed.");
+
+  if (!isIoUringEnabled() && !connect_without_io_uring_) {
+    OptRef<Io::IoUringWorker> worker = io_uring_worker_factory_.getIoUringWorker();
+    // Sockets handled by threads without a ring, e.g. by the main thread when the factory isn't
+    // initialized yet, stay readiness-based.
+    if (worker.has_value() && &worker->dispatcher() == &dispatcher) {
+      io_uring_socket_type_ = detectSocketType();
+      io_uring_worker_ = worker.ptr();
+    }
+  }
+  if (!isIoUringEnabled()) {
+    IoSocketHandleImpl::initializeFileEvent(dispatcher, cb, trigger, events);
+    return;
+  }
+
+  // The in-flight requests are bound to the worker of the thread the socket was first used on.
+  ASSERT(&io_uring_worker_->dispatcher() == &dispatcher);
+  cb_ = std::move(cb);
+  file_event_cb_ = dispatcher.createSchedulableCallback([this]() { onFileEventActivated(); });
+  enableFileEvents(events);
+}
+
+IoHandlePtr IoUringSocketHandleImpl::duplicate() {
+  auto result = Api::OsSysCallsSingleton::get().duplicate(fd_);
+  RELEASE_ASSERT(result.return_value_ != -1,
+                 fmt::format("duplicate failed for '{}': ({}) {}", fd_, result.errno_,
+                             errorDetails(result.errno_)));
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, read_buffer_size_,
+                                                   result.return_value_, socket_v6only_, domain_,
+                                                   is_connected_);
+}
+
+void IoUringSocketHandleImpl::activateFileEvents(uint32_t events) {
+  if (!isIoUringEnabled()) {
+    IoSocketHandleImpl::activateFileEvents(events);
+    return;
+  }
+  if (file_event_cb_ == nullptr) {
+    ENVOY_BUG(false, "Null file_event_cb_");
+    return;
+  }
+  activate(events);
+}
+
+void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
+  if (!isIoUringEnabled()) {
+    IoSocketHandleImpl::enableFileEvents(events);
+    return;
+  }
+  if (file_event_cb_ == nullptr) {
+    ENVOY_BUG(false, "Null file_event_cb_");
+    return;
+  }
+
+  // Align with Event::FileEventImpl. Clear pending events on updates to the event mask to avoid
+  // delivering events that are no longer relevant, and re-deliver the ones that are still ready.
+  enabled_events_ = events;
+  pending_events_ = 0;
+  if (io_uring_socket_type_ == IoUringSocketType::Listener) {
+    submitAcceptRequest();
+  } else {
+    submitReadRequest();
+  }
+
+  uint32_t ready_events = 0;
+  if ((events & Event::FileReadyType::Read) && isReadable()) {
+    ready_events |= Event::FileReadyType::Read;
+  }
+  if ((events & Event::FileReadyType::Write) && isWritable()) {
+    ready_events |= Event::FileReadyType::Write;
+  }
+  if ((events & Event::FileReadyType::Closed) && read_eof_) {
+    ready_events |= Event::FileReadyType::Closed;
+  }
+  if (ready_events != 0) {
+    activate(ready_events);
+  } else {
+    file_event_cb_->cancel();
+  }
+}
+
+void IoUringSocketHandleImpl::resetFileEvents() {
+  if (!isIoUringEnabled()) {
+    IoSocketHandleImpl::resetFileEvents();
+    return;
+  }
+  // The in-flight requests keep running and buffer their results until the file event is
+  // initialized again.
+  file_event_cb_.reset();
+  cb_ = nullptr;
+  enabled_events_ = 0;
+  pending_events_ = 0;
+}
+
+bool IoUringSocketHandleImpl::isReadable() const {
+  if (io_uring_socket_type_ == IoUringSocketType::Listener) {
+    return !accepted_sockets_.empty();
+  }
+  return read_buffer_.length() > 0 || read_eof_ || read_error_.has_value();
+}
+
+bool IoUringSocketHandleImpl::isWritable() const {
+  if (io_uring_socket_type_ == IoUringSocketType::Listener) {
+    return false;
+  }
+  return connect_error_.has_value() || (is_connected_ && write_request_ == nullptr);
+}
+
+void IoUringSocketHandleImpl::activate(uint32_t events) {
+  ASSERT((events & (Event::FileReadyType::Read | Event::FileReadyType::Write |
+                    Event::FileReadyType::Closed)) == events);
+  pending_events_ |= events;
+  file_event_cb_->scheduleCallbackCurrentIteration();
+}
+
+void IoUringSocketHandleImpl::activateIfEnabled(uint32_t events) {
+  const uint32_t enabled_events = events & enabled_events_;
+  if (enabled_events != 0 && file_event_cb_ != nullptr) {
+    activate(enabled_events);
+  }
+}
+
+void IoUringSocketHandleImpl::onFileEventActivated() {
+  const uint32_t events = std::exchange(pending_events_, 0);
+  ENVOY_LOG(trace, "io_uring socket handle fd={} invokes callbacks on events = {}", fd_, events);
+  if (events != 0) {
+    // Note that the callback may close or destroy this handle.
+    cb_(events);
+  }
+}
+
+void IoUringSocketHandleImpl::submitAcceptRequest() {
+  if (accept_request_ != nullptr || !(enabled_events_ & Event::FileReadyType::Read)) {
+    return;
+  }
+
+  auto request = std::make_unique<AcceptRequest>(*this);
+  AcceptRequest* request_ptr = request.get();
+  if (io_uring_worker_->submitAcceptRequest(
+          fd_, reinterpret_cast<struct sockaddr*>(&request_ptr->remote_addr_),
+          &request_ptr->remote_addr_len_, std::move(request)) == Io::IoUringResult::Ok) {
+    accept_request_ = request_ptr;
+  }
+}
+
+void IoUringSocketHandleImpl::submitReadRequest() {
+  // Only one read is kept in flight and only when all the previously read data has been consumed,
+  // or is still short of what was last peeked at, which preserves the read backpressure of the
+  // connection.
+  if (!is_connected_ || read_request_ != nullptr || read_eof_ || read_error_.has_value() ||
+      read_buffer_.length() >= std::max<uint64_t>(peek_length_, 1) ||
+      !(enabled_events_ & (Event::FileReadyType::Read | Event::FileReadyType::Closed))) {
+    return;
+  }
+
+  auto request = std::make_unique<ReadRequest>(*this, read_buffer_size_);
+  ReadRequest* request_ptr = request.get();
+  if (io_uring_worker_->submitReadvRequest(fd_, &request_ptr->iov_, 1, std::move(request)) ==
+      Io::IoUringResult::Ok) {
+    read_request_ = request_ptr;
+  }
+}
+
+void IoUringSocketHandleImpl::submitWriteRequest(std::unique_ptr<WriteRequest> request) {
+  ASSERT(write_request_ == nullptr);
+  request->prepareIovecs();
+  WriteRequest* request_ptr = request.get();
+  if (io_uring_worker_->submitWritevRequest(fd_, request_ptr->iovecs_.data(),
+                                            request_ptr->iovecs_.size(),
+                                            std::move(request)) != Io::IoUringResult::Ok) {
+    // The data has been accepted from the caller already, so the failure is reported by the
+    // following write.
+    write_error_ = ENOBUFS;
+    activateIfEnabled(Event::FileReadyType::Write);
+    return;
+  }
+  write_request_ = request_ptr;
+}
+
+void IoUringSocketHandleImpl::onAcceptCompleted(AcceptRequest& request, int32_t result) {
+  ASSERT(accept_request_ == &request);
+  accept_request_ = nullptr;
+  if (result < 0) {
+    ENVOY_LOG(debug, "io_uring accept on fd={} failed: {}", fd_, errorDetails(-result));
+  } else {
+    accepted_sockets_.push_back({result, request.remote_addr_, request.remote_addr_len_});
+  }
+  // Keep accepting while the listener is enabled.
+  submitAcceptRequest();
+  if (!accepted_sockets_.empty()) {
+    activateIfEnabled(Event::FileReadyType::Read);
+  }
+}
+
+void IoUringSocketHandleImpl::onConnectCompleted(int32_t result) {
+  connect_request_ = nullptr;
+  if (result < 0) {
+    connect_error_ = -result;
+  } else {
+    is_connected_ = true;
+    submitReadRequest();
+  }
+  activateIfEnabled(Event::FileReadyType::Write);
+}
+
+void IoUringSocketHandleImpl::onReadCompleted(ReadRequest& request, int32_t result) {
+  ASSERT(read_request_ == &request);
+  read_request_ = nullptr;
+  if (result > 0) {
+    request.reservation_.commit(result);
+    read_buffer_.move(request.buffer_);
+    activateIfEnabled(Event::FileReadyType::Read);
+  } else if (result == 0) {
+    read_eof_ = true;
+    activateIfEnabled(Event::FileReadyType::Read | Event::FileReadyType::Closed);
+  } else if (result != -ECANCELED) {
+    read_error_ = -result;
+    activateIfEnabled(Event::FileReadyType::Read);
+  }
+}
+
+void IoUringSocketHandleImpl::onWriteCompleted(WriteRequest& request, int32_t result) {
+  ASSERT(write_request_ == &request);
+  write_request_ = nullptr;
+  if (result < 0) {
+    write_error_ = -result;
+  } else {
+    request.buffer_.drain(result);
+    if (request.buffer_.length() > 0) {
+      auto next_request = std::make_unique<WriteRequest>(this, *io_uring_worker_, fd_);
+      next_request->buffer_.move(request.buffer_);
+      submitWriteRequest(std::move(next_request));
+      return;
+    }
+    if (pending_shutdown_.has_value()) {
+      IoSocketHandleImpl::shutdown(pending_shutdown_.value());
+      pending_shutdown_.reset();
+    }
+  }
+  activateIfEnabled(Event::FileReadyType::Write);
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <list>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring.h"
+#include "source/common/network/io_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * IoHandle derivative for stream sockets driven by io_uring. On threads owning an
+ * Io::IoUringWorker the accepts, connects, reads and writes are submitted to the worker's ring and
+ * file events are emulated from the completions, so that the syscalls of all sockets handled in
+ * one event loop iteration are batched. On other threads and for non-stream sockets the handle
+ * behaves exactly like IoSocketHandleImpl.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                          uint32_t read_buffer_size, os_fd_t fd = INVALID_SOCKET,
+                          bool socket_v6only = false, absl::optional<int> domain = absl::nullopt,
+                          bool is_connected = false);
+  ~IoUringSocketHandleImpl() override;
+
+  // IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer,
+                               absl::optional<uint64_t> max_length) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
+                                  uint32_t self_port, RecvMsgOutput& output) override;
+  Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
+                                   RecvMsgOutput& output) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  Api::SysCallIntResult connect(Address::InstanceConstSharedPtr address) override;
+  Api::SysCallIntResult getOption(int level, int optname, void* optval, socklen_t* optlen) override;
+  Api::SysCallIntResult shutdown(int how) override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  IoHandlePtr duplicate() override;
+  void activateFileEvents(uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+
+private:
+  enum class IoUringSocketType { Disabled, Listener, Connection };
+
+  class AcceptRequest;
+  class ConnectRequest;
+  class ReadRequest;
+  class WriteRequest;
+
+  struct AcceptedSocket {
+    os_fd_t fd_;
+    sockaddr_storage remote_addr_;
+    socklen_t remote_addr_len_;
+  };
+
+  IoUringSocketType detectSocketType();
+  bool isIoUringEnabled() const { return io_uring_socket_type_ != IoUringSocketType::Disabled; }
+  bool isReadable() const;
+  bool isWritable() const;
+
+  void activate(uint32_t events);
+  void activateIfEnabled(uint32_t events);
+  void onFileEventActivated();
+
+  void submitAcceptRequest();
+  void submitReadRequest();
+  void submitWriteRequest(std::unique_ptr<WriteRequest> request);
+
+  void onAcceptCompleted(AcceptRequest& request, int32_t result);
+  void onConnectCompleted(int32_t result);
+  void onReadCompleted(ReadRequest& request, int32_t result);
+  void onWriteCompleted(WriteRequest& request, int32_t result);
+
+  // Result of a read attempt which found no buffered data.
+  Api::IoCallUint64Result readResultWithoutData();
+
+  Io::IoUringWorkerFactory& io_uring_worker_factory_;
+  const uint32_t read_buffer_size_;
+  // Connected sockets, e.g. the accepted ones, start reading right away.
+  bool is_connected_;
+  // Set if connect() went through the readiness-based path before initializeFileEvent(). Such
+  // sockets can't learn about the connect completion from io_uring and stay readiness-based.
+  bool connect_without_io_uring_{false};
+
+  IoUringSocketType io_uring_socket_type_{IoUringSocketType::Disabled};
+  Io::IoUringWorker* io_uring_worker_{nullptr};
+  Event::FileReadyCb cb_;
+  Event::SchedulableCallbackPtr file_event_cb_;
+  uint32_t enabled_events_{0};
+  uint32_t pending_events_{0};
+
+  // In-flight requests. The requests are owned by the worker and get detached from the handle on
+  // close.
+  AcceptRequest* accept_request_{nullptr};
+  ConnectRequest* connect_request_{nullptr};
+  ReadRequest* read_request_{nullptr};
+  WriteRequest* write_request_{nullptr};
+
+  std::list<AcceptedSocket> accepted_sockets_;
+  absl::optional<int> connect_error_;
+  Buffer::OwnedImpl read_buffer_;
+  // The length of the last recv() with MSG_PEEK which found less data than it asked for, e.g.
+  // from a listener filter. Reads keep being submitted until read_buffer_ holds that much.
+  uint64_t peek_length_{0};
+  bool read_eof_{false};
+  absl::optional<int> read_error_;
+  absl::optional<int> write_error_;
+  // shutdown() of the write side deferred until the in-flight write completes.
+  absl::optional<int> pending_shutdown_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -5,10 +5,18 @@
 
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/common/assert.h"
+#include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
 #include "source/common/network/win32_socket_handle_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#ifdef __linux__
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_impl.h"
+#endif
 
 namespace Envoy {
 namespace Network {
@@ -23,6 +31,11 @@ IoHandlePtr SocketInterfaceImpl::makePlatformSpecificSocket(int socket_fd, bool
 
 IoHandlePtr SocketInterfaceImpl::makeSocket(int socket_fd, bool socket_v6only,
                                             absl::optional<int> domain) const {
+  if (auto io_uring_worker_factory = io_uring_worker_factory_.lock();
+      io_uring_worker_factory != nullptr) {
+    return std::make_unique<IoUringSocketHandleImpl>(
+        *io_uring_worker_factory, io_uring_read_buffer_size_, socket_fd, socket_v6only, domain);
+  }
   return makePlatformSpecificSocket(socket_fd, socket_v6only, domain);
 }
 
@@ -117,8 +130,27 @@ bool SocketInterfaceImpl::ipFamilySupported(int domain) {
 }
 
 Server::BootstrapExtensionPtr
-SocketInterfaceImpl::createBootstrapExtension(const Protobuf::Message&,
-                                              Server::Configuration::ServerFactoryContext&) {
+SocketInterfaceImpl::createBootstrapExtension(const Protobuf::Message& config,
+                                              Server::Configuration::ServerFactoryContext& context) {
+  const auto& message = MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::DefaultSocketInterface&>(
+      config, context.messageValidationVisitor());
+  if (message.has_io_uring_options()) {
+#ifdef __linux__
+    if (Io::isIoUringSupported()) {
+      const auto& options = message.io_uring_options();
+      io_uring_read_buffer_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, read_buffer_size, 8192);
+      auto io_uring_worker_factory = std::make_shared<Io::IoUringWorkerFactoryImpl>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, io_uring_size, 1000),
+          options.enable_submission_queue_polling(), context.threadLocal());
+      io_uring_worker_factory_ = io_uring_worker_factory;
+      return std::make_unique<IoUringSocketInterfaceExtension>(*this,
+                                                               std::move(io_uring_worker_factory));
+    }
+#endif
+    ENVOY_LOG_MISC(warn, "io_uring is not supported by this platform, falling back to the "
+                         "readiness-based socket handles");
+  }
   return std::make_unique<SocketInterfaceExtension>(*this);
 }
 
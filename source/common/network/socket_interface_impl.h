@@ -2,11 +2,28 @@
 
 #include "envoy/network/socket.h"
 
+#include "source/common/io/io_uring.h"
 #include "source/common/network/socket_interface.h"
 
 namespace Envoy {
 namespace Network {
 
+// Bootstrap extension which owns the io_uring worker factory and initializes it upon server
+// readiness.
+class IoUringSocketInterfaceExtension : public SocketInterfaceExtension {
+public:
+  IoUringSocketInterfaceExtension(SocketInterface& sock_interface,
+                                  Io::IoUringWorkerFactorySharedPtr io_uring_worker_factory)
+      : SocketInterfaceExtension(sock_interface),
+        io_uring_worker_factory_(std::move(io_uring_worker_factory)) {}
+
+  // Server::BootstrapExtension
+  void onServerInitialized() override { io_uring_worker_factory_->onServerInitialized(); }
+
+private:
+  Io::IoUringWorkerFactorySharedPtr io_uring_worker_factory_;
+};
+
 class SocketInterfaceImpl : public SocketInterfaceBase {
 public:
   // SocketInterface
@@ -32,6 +49,11 @@ public:
 protected:
   virtual IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
                                  absl::optional<int> domain) const;
+
+private:
+  // Set when the io_uring options are configured. The factory is owned by the bootstrap extension.
+  std::weak_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+  uint32_t io_uring_read_buffer_size_{};
 };
 
 DECLARE_FACTORY(SocketInterfaceImpl);
@@ -0,0 +1,144 @@
+#include "source/common/network/udp_batch_writer.h"
+
+#include <algorithm>
+
+#include "envoy/network/udp_packet_writer_handler.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/network/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+UdpBatchWriter::UdpBatchWriter(IoHandle& io_handle, bool prefer_gso)
+    : io_handle_(io_handle), use_mmsg_(io_handle.supportsMmsg()),
+      use_gso_(prefer_gso && use_mmsg_ && Api::OsSysCallsSingleton::get().supportsUdpGso()) {}
+
+void UdpBatchWriter::write(const Buffer::Instance& buffer) {
+  const uint64_t length = buffer.length();
+  const size_t offset = data_.size();
+  data_.resize(offset + length);
+  buffer.copyOut(0, length, data_.data() + offset);
+  lengths_.push_back(length);
+}
+
+UdpBatchWriter::FlushResult UdpBatchWriter::flush(const Address::Ip* local_ip,
+                                                  const Address::Instance& peer_address) {
+  const FlushResult result = use_mmsg_ ? flushWithMmsg(local_ip, peer_address)
+                                       : flushWithSendmsg(local_ip, peer_address);
+  data_.clear();
+  lengths_.clear();
+  return result;
+}
+
+uint64_t UdpBatchWriter::buildMessages(size_t next, uint64_t offset,
+                                       std::vector<Message>& messages) const {
+  messages.clear();
+  // Datagrams larger than the usual path MTU can't be segmented by the kernel, send them as is.
+  const uint64_t gso_size =
+      (use_gso_ && lengths_[next] <= UdpMaxOutgoingPacketSize) ? lengths_[next] : 0;
+  while (next < lengths_.size() && messages.size() < MaxMessagesPerCall) {
+    if (gso_size > 0 && lengths_[next] > gso_size) {
+      break;
+    }
+    Message message{next, 1, offset, lengths_[next]};
+    if (gso_size > 0) {
+      // Only the last datagram of a GSO message may be shorter than the GSO size.
+      while (lengths_[next + message.count_ - 1] == gso_size &&
+             next + message.count_ < lengths_.size() && message.count_ < MaxGsoSegments) {
+        const uint32_t length = lengths_[next + message.count_];
+        if (length > gso_size || message.length_ + length > MaxGsoBytes) {
+          break;
+        }
+        message.length_ += length;
+        message.count_++;
+      }
+    }
+    next += message.count_;
+    offset += message.length_;
+    messages.push_back(message);
+  }
+  return gso_size;
+}
+
+UdpBatchWriter::FlushResult UdpBatchWriter::flushWithMmsg(const Address::Ip* local_ip,
+                                                          const Address::Instance& peer_address) {
+  FlushResult result;
+  std::vector<Message> messages;
+  messages.reserve(std::min<size_t>(lengths_.size(), MaxMessagesPerCall));
+  size_t next = 0;
+  uint64_t offset = 0;
+  while (next < lengths_.size()) {
+    const uint64_t gso_size = buildMessages(next, offset, messages);
+    RawSliceArrays slices(messages.size(), absl::FixedArray<Buffer::RawSlice>(1));
+    for (size_t i = 0; i < messages.size(); i++) {
+      slices[i][0] = {data_.data() + messages[i].offset_, messages[i].length_};
+    }
+
+    const Api::IoCallUint64Result rc =
+        io_handle_.sendmmsg(slices, gso_size, local_ip, peer_address);
+    uint64_t messages_sent = 0;
+    if (rc.ok()) {
+      messages_sent = rc.return_value_;
+    } else {
+      const Api::IoError::IoErrorCode error_code = rc.err_->getErrorCode();
+      if (error_code == Api::IoError::IoErrorCode::Interrupt) {
+        continue;
+      }
+      if (gso_size > 0 && error_code != Api::IoError::IoErrorCode::Again) {
+        // The route or the device doesn't support GSO, e.g. because of a small MTU or lack of
+        // checksum offload. Send the datagrams individually from now on.
+        ENVOY_LOG(debug, "disabling UDP GSO after sendmmsg failure: {}",
+                  rc.err_->getErrorDetails());
+        use_gso_ = false;
+        continue;
+      }
+      ENVOY_LOG(debug, "sendmmsg failed with error code {}: {}", static_cast<int>(error_code),
+                rc.err_->getErrorDetails());
+      if (error_code == Api::IoError::IoErrorCode::Again) {
+        result.datagrams_dropped_ += lengths_.size() - next;
+        break;
+      }
+      // Only the first message failed, drop it and carry on with the rest.
+      result.datagrams_dropped_ += messages[0].count_;
+      next += messages[0].count_;
+      offset += messages[0].length_;
+      continue;
+    }
+
+    if (messages_sent == 0) {
+      result.datagrams_dropped_ += lengths_.size() - next;
+      break;
+    }
+    for (uint64_t i = 0; i < messages_sent && i < messages.size(); i++) {
+      result.datagrams_sent_ += messages[i].count_;
+      result.bytes_sent_ += messages[i].length_;
+      next += messages[i].count_;
+      offset += messages[i].length_;
+    }
+  }
+  return result;
+}
+
+UdpBatchWriter::FlushResult
+UdpBatchWriter::flushWithSendmsg(const Address::Ip* local_ip,
+                                 const Address::Instance& peer_address) {
+  FlushResult result;
+  uint64_t offset = 0;
+  for (const uint32_t length : lengths_) {
+    Buffer::RawSlice slice{data_.data() + offset, length};
+    offset += length;
+    const Api::IoCallUint64Result rc =
+        Utility::writeToSocket(io_handle_, &slice, 1, local_ip, peer_address);
+    if (rc.ok()) {
+      result.datagrams_sent_++;
+      result.bytes_sent_ += length;
+    } else {
+      result.datagrams_dropped_++;
+    }
+  }
+  return result;
+}
+
+} // namespace Network
+} // namespace Envoy
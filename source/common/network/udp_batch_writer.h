@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/address.h"
+#include "envoy/network/io_handle.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Buffers the datagrams written to a UDP socket for a single destination and sends them together
+ * on flush(). If the platform supports it, the datagrams are sent with sendmmsg(), and runs of
+ * equally sized datagrams are coalesced into a single message segmented by the kernel (UDP GSO).
+ * Otherwise each datagram is sent with its own sendmsg() call.
+ */
+class UdpBatchWriter : Logger::Loggable<Logger::Id::udp> {
+public:
+  struct FlushResult {
+    uint64_t datagrams_sent_{};
+    uint64_t bytes_sent_{};
+    // Datagrams which couldn't be sent because of a socket error.
+    uint64_t datagrams_dropped_{};
+  };
+
+  /**
+   * @param io_handle supplies the UDP socket to send the datagrams with.
+   * @param prefer_gso supplies whether to use UDP GSO when the platform supports it. If a GSO send
+   *        fails, e.g. because the datagrams exceed the path MTU, GSO is disabled for the writer.
+   */
+  UdpBatchWriter(IoHandle& io_handle, bool prefer_gso);
+
+  /**
+   * Buffer a datagram. The contents of the buffer are copied.
+   * @param buffer supplies the datagram payload.
+   */
+  void write(const Buffer::Instance& buffer);
+
+  /**
+   * Send all the buffered datagrams. Datagrams which fail to send are dropped.
+   * @param local_ip supplies the source address to send from, or nullptr to let the kernel pick
+   *        one.
+   * @param peer_address supplies the destination address.
+   * @return the number of datagrams and bytes sent and the number of datagrams dropped.
+   */
+  FlushResult flush(const Address::Ip* local_ip, const Address::Instance& peer_address);
+
+  /**
+   * @return the number of buffered datagrams.
+   */
+  uint64_t bufferedDatagrams() const { return lengths_.size(); }
+
+  /**
+   * @return whether datagrams are coalesced with UDP GSO.
+   */
+  bool usingGso() const { return use_gso_; }
+
+  // Maximum number of messages per sendmmsg() call.
+  static constexpr uint32_t MaxMessagesPerCall = 64;
+  // Maximum number of datagrams coalesced into a single GSO message. This is the UDP_MAX_SEGMENTS
+  // of the oldest kernels supporting GSO.
+  static constexpr uint32_t MaxGsoSegments = 64;
+  // Maximum payload of a GSO message, bounded by the length of an IPv4 packet.
+  static constexpr uint64_t MaxGsoBytes = 65507;
+
+private:
+  struct Message {
+    // Index of the first datagram of the message.
+    size_t first_;
+    // Number of datagrams in the message.
+    size_t count_;
+    uint64_t offset_;
+    uint64_t length_;
+  };
+
+  FlushResult flushWithMmsg(const Address::Ip* local_ip, const Address::Instance& peer_address);
+  FlushResult flushWithSendmsg(const Address::Ip* local_ip, const Address::Instance& peer_address);
+  // Group the datagrams starting at index next into at most MaxMessagesPerCall messages and
+  // return the GSO size to send them with, or 0 without GSO.
+  uint64_t buildMessages(size_t next, uint64_t offset, std::vector<Message>& messages) const;
+
+  IoHandle& io_handle_;
+  const bool use_mmsg_;
+  bool use_gso_;
+  // The payloads of the buffered datagrams, back to back, and their lengths.
+  std::string data_;
+  std::vector<uint32_t> lengths_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -81,6 +81,15 @@ public:
     }
     return io_handle_.recvmmsg(slices, self_port, output);
   }
+  Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, uint64_t gso_size,
+                                   const Network::Address::Ip* self_ip,
+                                   const Network::Address::Instance& peer_address) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.sendmmsg(slices, gso_size, self_ip, peer_address);
+  }
   Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override {
     if (closed_) {
       ASSERT(false, "recv called after close.");
@@ -1820,6 +1820,9 @@ VirtualHostImpl::VirtualHostImpl(
       routes_.emplace_back(createAndValidateRoute(route, *this, optional_http_filters,
                                                   factory_context, validator, validation_clusters));
     }
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.router_path_route_index")) {
+      buildPathRouteIndex();
+    }
   }
 
   if (!virtual_host.virtual_clusters().empty()) {
@@ -1943,6 +1946,71 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
   }
 }
 
+void VirtualHostImpl::buildPathRouteIndex() {
+  auto index = std::make_unique<PathRouteIndex>();
+  for (uint32_t position = 0; position < routes_.size(); ++position) {
+    const RouteEntryImplBase& route = *routes_[position];
+    if (!route.case_sensitive()) {
+      index->addUnindexed(position);
+      continue;
+    }
+    const PathMatchCriterion& criterion = route.pathMatchCriterion();
+    switch (criterion.matchType()) {
+    case PathMatchType::Prefix:
+    case PathMatchType::PathSeparatedPrefix:
+      // Path separated prefixes are indexed as plain prefixes, the separator is checked when the
+      // candidate route is evaluated.
+      index->addPrefix(criterion.matcher(), position);
+      break;
+    case PathMatchType::Exact:
+      index->addExact(criterion.matcher(), position);
+      break;
+    default:
+      index->addUnindexed(position);
+      break;
+    }
+  }
+
+  // Nothing to narrow down if every route has to be evaluated anyway.
+  if (index->size() > 0) {
+    path_route_index_ = std::move(index);
+  }
+}
+
+RouteConstSharedPtr
+VirtualHostImpl::getRouteFromPathRouteIndex(const Http::RequestHeaderMap& headers,
+                                            const StreamInfo::StreamInfo& stream_info,
+                                            uint64_t random_value) const {
+  // Sanitize the path the same way the route entries do before matching.
+  absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+  if (global_route_config_.ignorePathParametersInPathMatching()) {
+    path = path.substr(0, path.find_first_of(';'));
+  }
+
+  PathRouteIndex::Positions candidates;
+  path_route_index_->findCandidates(path, candidates);
+
+  // Evaluate the indexed candidates and the unindexed routes in route table order.
+  const std::vector<uint32_t>& unindexed = path_route_index_->unindexed();
+  auto candidate = candidates.begin();
+  auto other = unindexed.begin();
+  while (candidate != candidates.end() || other != unindexed.end()) {
+    uint32_t position;
+    if (other == unindexed.end() || (candidate != candidates.end() && *candidate < *other)) {
+      position = *candidate++;
+    } else {
+      position = *other++;
+    }
+
+    RouteConstSharedPtr route_entry = routes_[position]->matches(headers, stream_info, random_value);
+    if (route_entry != nullptr) {
+      return route_entry;
+    }
+  }
+
+  return nullptr;
+}
+
 RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb,
                                                          const Http::RequestHeaderMap& headers,
                                                          const StreamInfo::StreamInfo& stream_info,
@@ -2002,6 +2070,12 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
 
     return nullptr;
   } else {
+    // The callback needs to know whether more routes follow a match, which requires walking the
+    // whole route table.
+    if (path_route_index_ != nullptr && !cb && headers.Path()) {
+      return getRouteFromPathRouteIndex(headers, stream_info, random_value);
+    }
+
     // Check for a route that matches the request.
     for (auto route = routes_.begin(); route != routes_.end(); ++route) {
       if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
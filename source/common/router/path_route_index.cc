@@ -0,0 +1,100 @@
+#include "source/common/router/path_route_index.h"
+
+#include <algorithm>
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+template <class Children> auto childLowerBound(Children& children, char c) {
+  return std::lower_bound(children.begin(), children.end(), c,
+                          [](const auto& child, char value) { return child->label_[0] < value; });
+}
+
+} // namespace
+
+PathRouteIndex::PathRouteIndex() : root_(std::make_unique<Node>()) {}
+
+PathRouteIndex::Node* PathRouteIndex::Node::findChild(char c) const {
+  auto it = childLowerBound(children_, c);
+  if (it == children_.end() || (*it)->label_[0] != c) {
+    return nullptr;
+  }
+  return it->get();
+}
+
+void PathRouteIndex::addPrefix(absl::string_view prefix, uint32_t position) {
+  Node* node = root_.get();
+  while (!prefix.empty()) {
+    auto it = childLowerBound(node->children_, prefix[0]);
+    if (it == node->children_.end() || (*it)->label_[0] != prefix[0]) {
+      auto child = std::make_unique<Node>();
+      child->label_ = std::string(prefix);
+      child->positions_.push_back(position);
+      node->children_.insert(it, std::move(child));
+      ++size_;
+      return;
+    }
+
+    Node& child = **it;
+    const size_t max_common = std::min(child.label_.size(), prefix.size());
+    size_t common = 1;
+    while (common < max_common && child.label_[common] == prefix[common]) {
+      ++common;
+    }
+
+    if (common < child.label_.size()) {
+      // The prefix diverges from the edge, or ends within it. Split the edge at the divergence
+      // point so that the prefix ends at, or branches off from, a node.
+      auto split = std::make_unique<Node>();
+      split->label_ = child.label_.substr(0, common);
+      child.label_.erase(0, common);
+      split->children_.push_back(std::move(*it));
+      *it = std::move(split);
+    }
+
+    node = it->get();
+    prefix.remove_prefix(common);
+  }
+
+  node->positions_.push_back(position);
+  ++size_;
+}
+
+void PathRouteIndex::addExact(absl::string_view path, uint32_t position) {
+  exact_[path].push_back(position);
+  ++size_;
+}
+
+void PathRouteIndex::addUnindexed(uint32_t position) { unindexed_.push_back(position); }
+
+void PathRouteIndex::findCandidates(absl::string_view path, Positions& candidates) const {
+  const Node* node = root_.get();
+  candidates.insert(candidates.end(), node->positions_.begin(), node->positions_.end());
+
+  absl::string_view remaining = path;
+  while (!remaining.empty()) {
+    node = node->findChild(remaining[0]);
+    if (node == nullptr || !absl::StartsWith(remaining, node->label_)) {
+      break;
+    }
+    candidates.insert(candidates.end(), node->positions_.begin(), node->positions_.end());
+    remaining.remove_prefix(node->label_.size());
+  }
+
+  auto exact = exact_.find(path);
+  if (exact != exact_.end()) {
+    candidates.insert(candidates.end(), exact->second.begin(), exact->second.end());
+  }
+
+  // Positions are sorted per node, but nodes along the path and the exact matches interleave.
+  if (candidates.size() > 1) {
+    std::sort(candidates.begin(), candidates.end());
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
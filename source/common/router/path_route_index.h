@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index of the case sensitive prefix and exact path routes of a virtual host, used to narrow down
+ * the routes that have to be evaluated for a request path. Routes are identified by their position
+ * in the route table. Prefixes are kept in a radix tree with compressed edges so that the lookup
+ * cost is bounded by the path length rather than by the number of routes. Routes that can't be
+ * indexed (regex, templates, case insensitive matches, etc.) are tracked separately and are
+ * always candidates.
+ *
+ * The index only narrows down candidates: the caller still has to evaluate the full route match
+ * (headers, query parameters, runtime fractions, etc.) for each candidate, in position order, to
+ * preserve the first-match-wins semantics of the route table.
+ */
+class PathRouteIndex {
+public:
+  using Positions = absl::InlinedVector<uint32_t, 8>;
+
+  PathRouteIndex();
+
+  /**
+   * Index a route matching all paths starting with the given prefix.
+   * @param prefix supplies the route prefix.
+   * @param position supplies the position of the route in the route table. Positions must be
+   *        added in increasing order.
+   */
+  void addPrefix(absl::string_view prefix, uint32_t position);
+
+  /**
+   * Index a route matching only the given path.
+   * @param path supplies the route path.
+   * @param position supplies the position of the route in the route table.
+   */
+  void addExact(absl::string_view path, uint32_t position);
+
+  /**
+   * Track a route whose path match can't be indexed.
+   * @param position supplies the position of the route in the route table.
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * Find the indexed routes whose path match accepts the given path.
+   * @param path supplies the sanitized request path, without query and fragment.
+   * @param candidates receives the positions of the matching routes in increasing order. Routes
+   *        returned by unindexed() are not included.
+   */
+  void findCandidates(absl::string_view path, Positions& candidates) const;
+
+  /**
+   * @return the positions of the routes that weren't indexed, in increasing order.
+   */
+  const std::vector<uint32_t>& unindexed() const { return unindexed_; }
+
+  /**
+   * @return the number of indexed routes.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  struct Node;
+  using NodePtr = std::unique_ptr<Node>;
+
+  struct Node {
+    // The edge label leading to this node from its parent.
+    std::string label_;
+    // Positions of the routes whose prefix ends at this node.
+    std::vector<uint32_t> positions_;
+    // Children sorted by the first byte of their label. Labels of siblings never share their first
+    // byte.
+    std::vector<NodePtr> children_;
+
+    Node* findChild(char c) const;
+  };
+
+  NodePtr root_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_;
+  std::vector<uint32_t> unindexed_;
+  uint32_t size_{};
+};
+
+using PathRouteIndexPtr = std::unique_ptr<PathRouteIndex>;
+
+} // namespace Router
+} // namespace Envoy
@@ -1644,6 +1644,19 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
   std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
       dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
 
+  // Latency aware load balancing policies learn the round trip time of the host from here.
+  Upstream::HostLbPolicyData* lb_policy_data = upstream_request.upstreamHost()->lbPolicyData();
+  if (lb_policy_data != nullptr) {
+    const StreamInfo::UpstreamTiming& upstream_timing =
+        upstream_request.streamInfo().upstreamInfo()->upstreamTiming();
+    if (upstream_timing.first_upstream_tx_byte_sent_.has_value() &&
+        upstream_timing.last_upstream_rx_byte_received_.has_value()) {
+      lb_policy_data->onResponseTime(std::chrono::duration_cast<std::chrono::microseconds>(
+          upstream_timing.last_upstream_rx_byte_received_.value() -
+          upstream_timing.first_upstream_tx_byte_sent_.value()));
+    }
+  }
+
   Upstream::ClusterTimeoutBudgetStatsOptRef tb_stats = cluster()->timeoutBudgetStats();
   if (tb_stats.has_value()) {
     tb_stats->get().upstream_rq_timeout_budget_percent_used_.recordValue(
@@ -50,6 +50,7 @@ RUNTIME_GUARD(envoy_reloadable_features_http_reject_path_with_fragment);
 RUNTIME_GUARD(envoy_reloadable_features_http_response_half_close);
 RUNTIME_GUARD(envoy_reloadable_features_http_skip_adding_content_length_to_upgrade);
 RUNTIME_GUARD(envoy_reloadable_features_http_strip_fragment_from_path_unsafe_if_disabled);
+RUNTIME_GUARD(envoy_reloadable_features_logging_with_fast_json_formatter);
 RUNTIME_GUARD(envoy_reloadable_features_lua_respond_with_send_local_reply);
 RUNTIME_GUARD(envoy_reloadable_features_no_extension_lookup_by_name);
 RUNTIME_GUARD(envoy_reloadable_features_no_full_scan_certs_on_sni_mismatch);
@@ -60,6 +61,8 @@ RUNTIME_GUARD(envoy_reloadable_features_postpone_h3_client_connect_to_next_loop)
 RUNTIME_GUARD(envoy_reloadable_features_quic_defer_logging_to_ack_listener);
 RUNTIME_GUARD(envoy_reloadable_features_quic_defer_send_in_response_to_packet);
 RUNTIME_GUARD(envoy_reloadable_features_reject_require_client_certificate_with_quic);
+RUNTIME_GUARD(envoy_reloadable_features_ring_hash_incremental_update);
+RUNTIME_GUARD(envoy_reloadable_features_router_path_route_index);
 RUNTIME_GUARD(envoy_reloadable_features_skip_dns_lookup_for_proxied_requests);
 RUNTIME_GUARD(envoy_reloadable_features_successful_active_health_check_uneject_host);
 RUNTIME_GUARD(envoy_reloadable_features_tcp_pool_idle_timeout);
@@ -101,6 +104,26 @@ FALSE_RUNTIME_GUARD(envoy_reloadable_features_no_delay_close_for_upgrades);
 FALSE_RUNTIME_GUARD(envoy_reloadable_features_use_api_listener);
 // TODO(pradeepcrao) reset this to true after 2 releases (1.27)
 FALSE_RUNTIME_GUARD(envoy_reloadable_features_enable_include_histograms);
+// Per-stream arenas for HTTP filters, to be enabled by default after a burn-in period.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_http_stream_arena);
+// Incremental EDF scheduler updates change the pick order following host set updates, so they are
+// disabled by default until weighted load balancing tests and deployments have been validated.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_edf_lb_incremental_update);
+// Batching upstream UDP proxy writes defers them to the end of the event loop iteration, which
+// changes the timing of upstream datagrams and of the session stats, so it is opt-in for now.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_udp_proxy_batch_upstream_writes);
+// Contiguous header map storage trades a per-header allocation for chunked allocations which keep
+// the slots of removed headers, so it is opt-in until its memory use has been validated.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_contiguous_header_map_storage);
+// Incrementally updated Maglev tables depend on the sequence of host set updates, so Envoys that
+// have seen different updates may map the same keys differently. Opt-in until this is acceptable.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_maglev_incremental_update);
+// Flat thread-local histograms hold 90 counters for each power of ten recorded per histogram and
+// worker rather than a sparse circllhist, so they are opt-in until their memory use is validated.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_flat_tls_histograms);
+// The parent latches its counters when it writes the stats segment, so their deltas are lost if the
+// child cannot read it. Opt-in until the child can ask for the stats to be sent inline instead.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_hot_restart_stats_shared_memory);
 
 // Block of non-boolean flags. Use of int flags is deprecated. Do not add more.
 ABSL_FLAG(uint64_t, re2_max_program_size_error_level, 100, ""); // NOLINT
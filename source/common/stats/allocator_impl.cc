@@ -86,6 +86,8 @@ public:
   SymbolTable& symbolTable() final { return alloc_.symbolTable(); }
   bool used() const override { return flags_ & Metric::Flags::Used; }
 
+  void clearChanged() { flags_ &= ~Metric::Flags::Changed; }
+
   // RefcountInterface
   void incRefCount() override { ++ref_count_; }
   bool decRefCount() override {
@@ -119,6 +121,32 @@ public:
   virtual void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) PURE;
 
 protected:
+  /**
+   * Sets flags on a write. While the allocator tracks the writes to this type of stat, the stat is
+   * also flagged as changed, and added to changed_stats by its first write since they were last
+   * visited.
+   */
+  void onWrite(uint16_t flags, const std::atomic<bool>& tracking,
+               AllocatorImpl::StatPointerSet<BaseClass>& changed_stats) {
+    if (!tracking) {
+      if (flags != 0) {
+        flags_ |= flags;
+      }
+    } else if ((flags_.fetch_or(flags | Metric::Flags::Changed) & Metric::Flags::Changed) == 0) {
+      Thread::LockGuard lock(alloc_.changed_mutex_);
+      changed_stats.insert(this);
+    }
+  }
+
+  // A stat is only in changed_stats while it is flagged as changed.
+  void removeFromChangedLockHeld(AllocatorImpl::StatPointerSet<BaseClass>& changed_stats)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) {
+    if (flags_ & Metric::Flags::Changed) {
+      Thread::LockGuard lock(alloc_.changed_mutex_);
+      changed_stats.erase(this);
+    }
+  }
+
   AllocatorImpl& alloc_;
 
   // ref_count_ can be incremented as an atomic, without taking a new lock, as
@@ -145,6 +173,7 @@ public:
     const size_t count = alloc_.counters_.erase(statName());
     ASSERT(count == 1);
     alloc_.sinked_counters_.erase(this);
+    removeFromChangedLockHeld(alloc_.changed_counters_);
   }
 
   // Stats::Counter
@@ -153,7 +182,7 @@ public:
     // used(). From a system perspective this should be eventually consistent.
     value_ += amount;
     pending_increment_ += amount;
-    flags_ |= Flags::Used;
+    onWrite(Flags::Used, alloc_.track_changed_counters_, alloc_.changed_counters_);
   }
   void inc() override { add(1); }
   uint64_t latch() override { return pending_increment_.exchange(0); }
@@ -190,23 +219,25 @@ public:
     const size_t count = alloc_.gauges_.erase(statName());
     ASSERT(count == 1);
     alloc_.sinked_gauges_.erase(this);
+    removeFromChangedLockHeld(alloc_.changed_gauges_);
   }
 
   // Stats::Gauge
   void add(uint64_t amount) override {
     child_value_ += amount;
-    flags_ |= Flags::Used;
+    onWrite(Flags::Used, alloc_.track_changed_gauges_, alloc_.changed_gauges_);
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     child_value_ = value;
-    flags_ |= Flags::Used;
+    onWrite(Flags::Used, alloc_.track_changed_gauges_, alloc_.changed_gauges_);
   }
   void sub(uint64_t amount) override {
     ASSERT(child_value_ >= amount);
     ASSERT(used() || amount == 0);
     child_value_ -= amount;
+    onWrite(0, alloc_.track_changed_gauges_, alloc_.changed_gauges_);
   }
   uint64_t value() const override { return child_value_ + parent_value_; }
 
@@ -246,7 +277,10 @@ public:
     }
   }
 
-  void setParentValue(uint64_t value) override { parent_value_ = value; }
+  void setParentValue(uint64_t value) override {
+    parent_value_ = value;
+    onWrite(0, alloc_.track_changed_gauges_, alloc_.changed_gauges_);
+  }
 
 private:
   std::atomic<uint64_t> parent_value_{0};
@@ -263,14 +297,17 @@ public:
     const size_t count = alloc_.text_readouts_.erase(statName());
     ASSERT(count == 1);
     alloc_.sinked_text_readouts_.erase(this);
+    removeFromChangedLockHeld(alloc_.changed_text_readouts_);
   }
 
   // Stats::TextReadout
   void set(absl::string_view value) override {
     std::string value_copy(value);
-    absl::MutexLock lock(&mutex_);
-    value_ = std::move(value_copy);
-    flags_ |= Flags::Used;
+    {
+      absl::MutexLock lock(&mutex_);
+      value_ = std::move(value_copy);
+    }
+    onWrite(Flags::Used, alloc_.track_changed_text_readouts_, alloc_.changed_text_readouts_);
   }
   std::string value() const override {
     absl::MutexLock lock(&mutex_);
@@ -421,6 +458,68 @@ void AllocatorImpl::forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout>
   }
 }
 
+void AllocatorImpl::forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) {
+  if (!track_changed_counters_.exchange(true)) {
+    // No writes were tracked before the first call.
+    forEachSinkedCounter(f_size, f_stat);
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  StatPointerSet<Counter> changed;
+  {
+    Thread::LockGuard changed_lock(changed_mutex_);
+    changed.swap(changed_counters_);
+  }
+  forEachChangedLockHeld(changed, sinked_counters_, f_size, f_stat);
+}
+
+void AllocatorImpl::forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) {
+  if (!track_changed_gauges_.exchange(true)) {
+    // No writes were tracked before the first call.
+    forEachSinkedGauge(f_size, f_stat);
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  StatPointerSet<Gauge> changed;
+  {
+    Thread::LockGuard changed_lock(changed_mutex_);
+    changed.swap(changed_gauges_);
+  }
+  forEachChangedLockHeld(changed, sinked_gauges_, f_size, f_stat);
+}
+
+void AllocatorImpl::forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) {
+  if (!track_changed_text_readouts_.exchange(true)) {
+    // No writes were tracked before the first call.
+    forEachSinkedTextReadout(f_size, f_stat);
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  StatPointerSet<TextReadout> changed;
+  {
+    Thread::LockGuard changed_lock(changed_mutex_);
+    changed.swap(changed_text_readouts_);
+  }
+  forEachChangedLockHeld(changed, sinked_text_readouts_, f_size, f_stat);
+}
+
+template <class StatType>
+void AllocatorImpl::forEachChangedLockHeld(const StatPointerSet<StatType>& changed_stats,
+                                           const StatPointerSet<StatType>& sinked_stats,
+                                           SizeFn f_size, StatFn<StatType> f_stat) const {
+  if (f_size != nullptr) {
+    f_size(changed_stats.size());
+  }
+  for (StatType* stat : changed_stats) {
+    // The flag is cleared before the stat is read, so that a racing write is tracked for the
+    // next call. Only StatsSharedImpl adds itself to the changed stats.
+    static_cast<StatsSharedImpl<StatType>*>(stat)->clearChanged();
+    if (sink_predicates_ == nullptr || sinked_stats.contains(stat)) {
+      f_stat(*stat);
+    }
+  }
+}
+
 void AllocatorImpl::setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) {
   Thread::LockGuard lock(mutex_);
   ASSERT(sink_predicates_ == nullptr);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "envoy/common/optref.h"
@@ -44,6 +45,10 @@ public:
   void forEachSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) const override;
   void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const override;
 
+  void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) override;
+  void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) override;
+  void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) override;
+
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) override;
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
@@ -74,6 +79,15 @@ private:
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
 
+  template <typename StatType> using StatPointerSet = absl::flat_hash_set<StatType*>;
+
+  // Visits the changed stats of a type that need to be flushed to sinks, forgetting that they
+  // changed.
+  template <class StatType>
+  void forEachChangedLockHeld(const StatPointerSet<StatType>& changed_stats,
+                              const StatPointerSet<StatType>& sinked_stats, SizeFn f_size,
+                              StatFn<StatType> f_stat) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // A mutex is needed here to protect both the stats_ object from both
   // alloc() and free() operations. Although alloc() operations are called under existing locking,
   // free() operations are made from the destructors of the individual stat objects, which are not
@@ -84,12 +98,23 @@ private:
   StatSet<Gauge> gauges_ ABSL_GUARDED_BY(mutex_);
   StatSet<TextReadout> text_readouts_ ABSL_GUARDED_BY(mutex_);
 
-  template <typename StatType> using StatPointerSet = absl::flat_hash_set<StatType*>;
   // Stat pointers that participate in the flush to sink process.
   StatPointerSet<Counter> sinked_counters_ ABSL_GUARDED_BY(mutex_);
   StatPointerSet<Gauge> sinked_gauges_ ABSL_GUARDED_BY(mutex_);
   StatPointerSet<TextReadout> sinked_text_readouts_ ABSL_GUARDED_BY(mutex_);
 
+  // Whether the stats written since the changed stats of their type were last visited are
+  // tracked, which starts when they are first visited. The changed stats are added to the sets on
+  // their first write since, which only takes changed_mutex_ so that stats may be written while
+  // mutex_ is held. When both are needed, mutex_ is taken first.
+  std::atomic<bool> track_changed_counters_{false};
+  std::atomic<bool> track_changed_gauges_{false};
+  std::atomic<bool> track_changed_text_readouts_{false};
+  mutable Thread::MutexBasicLockable changed_mutex_;
+  StatPointerSet<Counter> changed_counters_ ABSL_GUARDED_BY(changed_mutex_);
+  StatPointerSet<Gauge> changed_gauges_ ABSL_GUARDED_BY(changed_mutex_);
+  StatPointerSet<TextReadout> changed_text_readouts_ ABSL_GUARDED_BY(changed_mutex_);
+
   // Predicates used to filter stats to be flushed.
   std::unique_ptr<SinkPredicates> sink_predicates_;
   SymbolTable& symbol_table_;
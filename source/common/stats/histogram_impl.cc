@@ -1,10 +1,12 @@
 #include "source/common/stats/histogram_impl.h"
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 #include "source/common/common/utility.h"
 
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -119,6 +121,108 @@ const ConstSupportedBuckets& HistogramSettingsImpl::buckets(absl::string_view st
   return defaultBuckets();
 }
 
+namespace {
+
+constexpr uint64_t PowersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+                                    1000000000, 10000000000, 100000000000, 1000000000000,
+                                    10000000000000, 100000000000000, 1000000000000000,
+                                    10000000000000000, 100000000000000000, 1000000000000000000};
+
+} // namespace
+
+uint32_t FlatHistogram::bucketIndex(uint64_t value) {
+  if (value == 0) {
+    return 0;
+  }
+  value = std::min<uint64_t>(value, std::numeric_limits<int64_t>::max());
+  // The number of decimal digits, from an estimate of log10 based on the bit width.
+  const uint32_t log10_estimate = (absl::bit_width(value) * 1233) >> 12;
+  const uint32_t digits = log10_estimate + 1 - (value < PowersOfTen[log10_estimate]);
+  // The two significant digits, truncated like circllhist does. Values below 10 are exact, and use
+  // every tenth bucket of the first decade.
+  const uint64_t significant = digits == 1 ? value * 10 : value / PowersOfTen[digits - 2];
+  return 1 + (digits - 1) * BucketsPerDecade + (significant - 10);
+}
+
+uint64_t FlatHistogram::bucketLowerBound(uint32_t index) {
+  ASSERT(index < NumBuckets);
+  if (index == 0) {
+    return 0;
+  }
+  const uint32_t decade = (index - 1) / BucketsPerDecade;
+  const uint64_t significant = (index - 1) % BucketsPerDecade + 10;
+  return decade == 0 ? significant / 10 : significant * PowersOfTen[decade - 1];
+}
+
+void FlatHistogram::recordValue(uint64_t value) {
+  const uint32_t index = bucketIndex(value);
+  if (index == 0) {
+    ++zeros_;
+    return;
+  }
+  std::unique_ptr<Decade>& decade = decades_[(index - 1) / BucketsPerDecade];
+  if (decade == nullptr) {
+    decade = std::make_unique<Decade>();
+  }
+  ++(*decade)[(index - 1) % BucketsPerDecade];
+}
+
+void FlatHistogram::moveInto(FlatHistogram& target) {
+  ASSERT(&target != this);
+  target.zeros_ += zeros_;
+  zeros_ = 0;
+  for (uint32_t d = 0; d < NumDecades; ++d) {
+    if (decades_[d] == nullptr) {
+      continue;
+    }
+    if (target.decades_[d] == nullptr) {
+      target.decades_[d] = std::make_unique<Decade>();
+    }
+    Decade& source = *decades_[d];
+    Decade& destination = *target.decades_[d];
+    // Kept as plain loops over the counts so that they are vectorized.
+    for (uint32_t i = 0; i < BucketsPerDecade; ++i) {
+      destination[i] += source[i];
+    }
+    source.fill(0);
+  }
+}
+
+void FlatHistogram::addTo(histogram_t* target) const {
+  if (zeros_ != 0) {
+    hist_insert_intscale(target, 0, 0, zeros_);
+  }
+  for (uint32_t d = 0; d < NumDecades; ++d) {
+    if (decades_[d] == nullptr) {
+      continue;
+    }
+    for (uint32_t i = 0; i < BucketsPerDecade; ++i) {
+      const uint64_t count = (*decades_[d])[i];
+      if (count != 0) {
+        hist_insert_intscale(target, bucketLowerBound(1 + d * BucketsPerDecade + i), 0, count);
+      }
+    }
+  }
+}
+
+void FlatHistogram::clear() {
+  zeros_ = 0;
+  for (const std::unique_ptr<Decade>& decade : decades_) {
+    if (decade != nullptr) {
+      decade->fill(0);
+    }
+  }
+}
+
+uint64_t FlatHistogram::count(uint32_t index) const {
+  ASSERT(index < NumBuckets);
+  if (index == 0) {
+    return zeros_;
+  }
+  const std::unique_ptr<Decade>& decade = decades_[(index - 1) / BucketsPerDecade];
+  return decade == nullptr ? 0 : (*decade)[(index - 1) % BucketsPerDecade];
+}
+
 const ConstSupportedBuckets& HistogramSettingsImpl::defaultBuckets() {
   CONSTRUCT_ON_FIRST_USE(ConstSupportedBuckets,
                          {0.5, 1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000,
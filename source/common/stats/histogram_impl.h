@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "envoy/config/metrics/v3/stats.pb.h"
@@ -73,6 +75,56 @@ private:
   const Histogram::Unit unit_{Histogram::Unit::Unspecified};
 };
 
+/**
+ * Counts of non-negative integer values in fixed log-linear buckets, held in flat arrays. The
+ * buckets have the same bounds as the circllhist bins of integers, with two significant decimal
+ * digits, so the counts can be added to a circllhist without changing its statistics. Compared to
+ * circllhist, recording only indexes an array and merging is a loop over arrays which compilers
+ * vectorize, at the cost of 90 counters for each power of ten that was recorded.
+ */
+class FlatHistogram {
+public:
+  // Bucket 0 counts zeros, followed by 90 buckets for each power of ten from 1 to 10^18, the
+  // last one covering up to INT64_MAX.
+  static constexpr uint32_t BucketsPerDecade = 90;
+  static constexpr uint32_t NumDecades = 19;
+  static constexpr uint32_t NumBuckets = 1 + NumDecades * BucketsPerDecade;
+
+  /**
+   * @return the index of the bucket counting value. Values above INT64_MAX, which circllhist
+   * records as negative, are counted as INT64_MAX.
+   */
+  static uint32_t bucketIndex(uint64_t value);
+
+  /**
+   * @return the smallest value counted by a bucket.
+   */
+  static uint64_t bucketLowerBound(uint32_t index);
+
+  void recordValue(uint64_t value);
+
+  /**
+   * Adds the counts of this histogram to target, and clears this histogram.
+   */
+  void moveInto(FlatHistogram& target);
+
+  /**
+   * Adds the counts of this histogram to a circllhist.
+   */
+  void addTo(histogram_t* target) const;
+
+  void clear();
+  uint64_t count(uint32_t index) const;
+
+private:
+  using Decade = std::array<uint64_t, BucketsPerDecade>;
+
+  // The counts of the values from 1. Values usually span a few powers of ten, so the decades are
+  // allocated on first use, and then kept.
+  std::array<std::unique_ptr<Decade>, NumDecades> decades_;
+  uint64_t zeros_{0};
+};
+
 class HistogramImplHelper : public MetricImpl<Histogram> {
 public:
   HistogramImplHelper(StatName name, StatName tag_extracted_name,
@@ -201,6 +201,17 @@ public:
     UNREFERENCED_PARAMETER(f_stat);
   }
 
+  // Writes are not tracked, so every stat is visited.
+  void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) override {
+    forEachSinkedCounter(f_size, f_stat);
+  }
+  void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) override {
+    forEachSinkedGauge(f_size, f_stat);
+  }
+  void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) override {
+    forEachSinkedTextReadout(f_size, f_stat);
+  }
+
   NullCounterImpl& nullCounter() override { return *null_counter_; }
   NullGaugeImpl& nullGauge() override { return *null_gauge_; }
 
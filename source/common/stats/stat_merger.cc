@@ -25,8 +25,15 @@ StatName StatMerger::DynamicContext::makeDynamicStatName(const std::string& name
   if (iter == map.end()) {
     return symbolic_pool_.add(name);
   }
+  return makeDynamicStatName(absl::string_view(name), iter->second);
+}
+
+StatName StatMerger::DynamicContext::makeDynamicStatName(absl::string_view name,
+                                                         const DynamicSpans& dynamic_spans) {
+  if (dynamic_spans.empty()) {
+    return symbolic_pool_.add(name);
+  }
 
-  const DynamicSpans& dynamic_spans = iter->second;
   auto dynamic = dynamic_spans.begin();
   auto dynamic_end = dynamic_spans.end();
 
@@ -84,62 +91,77 @@ void StatMerger::mergeCounters(const Protobuf::Map<std::string, uint64_t>& count
   }
 }
 
+void StatMerger::mergeCounter(absl::string_view name, const DynamicSpans& dynamic_spans,
+                              uint64_t value) {
+  StatMerger::DynamicContext dynamic_context(temp_scope_->symbolTable());
+  StatName stat_name = dynamic_context.makeDynamicStatName(name, dynamic_spans);
+  temp_scope_->counterFromStatName(stat_name).add(value);
+}
+
 void StatMerger::mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                              const DynamicsMap& dynamic_map) {
   for (const auto& gauge : gauges) {
-    // Merging gauges via RPC from the parent has 3 cases; case 1 and 3b are the
-    // most common.
-    //
-    // 1. Child thinks gauge is Accumulate : data is combined in
-    //    gauge_ref.add() below.
-    // 2. Child thinks gauge is NeverImport: we skip this loop entry via
-    //    'continue'.
-    // 3. Child has not yet initialized gauge yet -- this merge is the
-    //    first time the child learns of the gauge. It's possible the child
-    //    will think the gauge is NeverImport due to a code change. But for
-    //    now we will leave the gauge in the child process as
-    //    import_mode==Uninitialized, and accumulate the parent value in
-    //    gauge_ref.add(). Gauges in this mode will not be included in
-    //    stats-sinks or the admin /stats calls, until the child initializes
-    //    the gauge, in which case:
-    // 3a. Child later initializes gauges as NeverImport: the parent value is
-    //     cleared during the mergeImportMode call.
-    // 3b. Child later initializes gauges as Accumulate: the parent value is
-    //     retained.
-
     StatMerger::DynamicContext dynamic_context(temp_scope_->symbolTable());
-    StatName stat_name = dynamic_context.makeDynamicStatName(gauge.first, dynamic_map);
-    GaugeOptConstRef gauge_opt = temp_scope_->findGauge(stat_name);
-
-    Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
-    if (gauge_opt) {
-      import_mode = gauge_opt->get().importMode();
-      if (import_mode == Gauge::ImportMode::NeverImport) {
-        continue;
-      }
-    }
+    mergeGaugeValue(dynamic_context.makeDynamicStatName(gauge.first, dynamic_map), gauge.second);
+  }
+}
+
+void StatMerger::mergeGauge(absl::string_view name, const DynamicSpans& dynamic_spans,
+                            uint64_t value) {
+  StatMerger::DynamicContext dynamic_context(temp_scope_->symbolTable());
+  mergeGaugeValue(dynamic_context.makeDynamicStatName(name, dynamic_spans), value);
+}
 
-    // TODO(snowp): Propagate tag values during hot restarts.
-    auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
-    if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
-      // On the first iteration through the loop, the gauge will not be loaded into the scope
-      // cache even though it might exist in another scope. Thus, we need to check again for
-      // the import status to see if we should skip this gauge.
-      //
-      // TODO(mattklein123): There is a race condition here. It's technically possible that
-      // between the time we created this stat, the stat might be created by the child as a
-      // never import stat, making the below math invalid. A follow up solution is to take the
-      // store lock starting from gaugeFromStatName() to the end of this function, but this will
-      // require adding some type of mergeGauge() function to the scope and dealing with recursive
-      // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
-      // rare.
-      continue;
+void StatMerger::mergeGaugeValue(StatName stat_name, uint64_t value) {
+  // Merging gauges via RPC from the parent has 3 cases; case 1 and 3b are the
+  // most common.
+  //
+  // 1. Child thinks gauge is Accumulate : data is combined in
+  //    gauge_ref.add() below.
+  // 2. Child thinks gauge is NeverImport: we skip this gauge via an early
+  //    return.
+  // 3. Child has not yet initialized gauge yet -- this merge is the
+  //    first time the child learns of the gauge. It's possible the child
+  //    will think the gauge is NeverImport due to a code change. But for
+  //    now we will leave the gauge in the child process as
+  //    import_mode==Uninitialized, and accumulate the parent value in
+  //    gauge_ref.add(). Gauges in this mode will not be included in
+  //    stats-sinks or the admin /stats calls, until the child initializes
+  //    the gauge, in which case:
+  // 3a. Child later initializes gauges as NeverImport: the parent value is
+  //     cleared during the mergeImportMode call.
+  // 3b. Child later initializes gauges as Accumulate: the parent value is
+  //     retained.
+
+  GaugeOptConstRef gauge_opt = temp_scope_->findGauge(stat_name);
+
+  Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
+  if (gauge_opt) {
+    import_mode = gauge_opt->get().importMode();
+    if (import_mode == Gauge::ImportMode::NeverImport) {
+      return;
     }
+  }
 
-    const uint64_t new_parent_value = gauge.second;
-    parent_gauges_.insert(gauge_ref.statName());
-    gauge_ref.setParentValue(new_parent_value);
+  // TODO(snowp): Propagate tag values during hot restarts.
+  auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
+  if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
+    // The first time the gauge is merged, it will not be loaded into the scope
+    // cache even though it might exist in another scope. Thus, we need to check again for
+    // the import status to see if we should skip this gauge.
+    //
+    // TODO(mattklein123): There is a race condition here. It's technically possible that
+    // between the time we created this stat, the stat might be created by the child as a
+    // never import stat, making the below math invalid. A follow up solution is to take the
+    // store lock starting from gaugeFromStatName() to the end of this function, but this will
+    // require adding some type of mergeGauge() function to the scope and dealing with recursive
+    // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
+    // rare.
+    return;
   }
+
+  parent_gauges_.insert(gauge_ref.statName());
+  gauge_ref.setParentValue(value);
 }
 
 void StatMerger::retainParentGaugeValue(Stats::StatName gauge_name) {
@@ -6,6 +6,7 @@
 #include "source/common/stats/symbol_table.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Stats {
@@ -33,6 +34,15 @@ public:
      */
     StatName makeDynamicStatName(const std::string& name, const DynamicsMap& map);
 
+    /**
+     * Like makeDynamicStatName above, given the dynamic spans of the name directly.
+     *
+     * @param name The string corresponding to the desired StatName.
+     * @param dynamic_spans the spans of tokens in the stat-name which are dynamic.
+     * @return the generated StatName, valid as long as the DynamicContext.
+     */
+    StatName makeDynamicStatName(absl::string_view name, const DynamicSpans& dynamic_spans);
+
   private:
     SymbolTable& symbol_table_;
     StatNamePool symbolic_pool_;
@@ -56,6 +66,16 @@ public:
                   const Protobuf::Map<std::string, uint64_t>& gauges,
                   const DynamicsMap& dynamics = DynamicsMap());
 
+  /**
+   * Merges a single counter or gauge, as mergeStats does, without building maps of names.
+   *
+   * @param name the name of the stat in the parent.
+   * @param dynamic_spans the spans of tokens in the name which are dynamic.
+   * @param value the counter change or gauge value from the parent.
+   */
+  void mergeCounter(absl::string_view name, const DynamicSpans& dynamic_spans, uint64_t value);
+  void mergeGauge(absl::string_view name, const DynamicSpans& dynamic_spans, uint64_t value);
+
   /**
    * Indicates that a gauge's value from the hot-restart parent should be
    * retained, combining it with the child data. By default, data is transferred
@@ -76,6 +96,7 @@ private:
                      const DynamicsMap& dynamics_map);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                    const DynamicsMap& dynamics_map);
+  void mergeGaugeValue(StatName stat_name, uint64_t value);
 
   StatNameHashSet parent_gauges_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
@@ -46,7 +46,12 @@ ThreadLocalStoreImpl::ThreadLocalStoreImpl(Allocator& alloc)
 ThreadLocalStoreImpl::~ThreadLocalStoreImpl() {
   ASSERT(shutting_down_ || !threading_ever_initialized_);
   default_scope_.reset();
-  ASSERT(scopes_.empty());
+#ifndef NDEBUG
+  for (ScopeShard& shard : scope_shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    ASSERT(shard.scopes_.empty());
+  }
+#endif
   ASSERT(scopes_to_cleanup_.empty());
   ASSERT(central_cache_entries_to_cleanup_.empty());
   ASSERT(histograms_to_cleanup_.empty());
@@ -54,6 +59,7 @@ ThreadLocalStoreImpl::~ThreadLocalStoreImpl() {
 
 void ThreadLocalStoreImpl::setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) {
   iterateScopes([](const ScopeImplSharedPtr& scope) -> bool {
+    Thread::LockGuard lock(scope->central_cache_lock_);
     ASSERT(scope->centralCacheLockHeld()->histograms_.empty());
     return true;
   });
@@ -72,8 +78,9 @@ void ThreadLocalStoreImpl::setStatsMatcher(StatsMatcherPtr&& stats_matcher) {
   // be no copies in TLS caches.
   Thread::LockGuard lock(lock_);
   const uint32_t first_histogram_index = deleted_histograms_.size();
-  iterateScopesLockHeld([this](const ScopeImplSharedPtr& scope) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
-                            lock_) -> bool {
+  iterateScopes([this](const ScopeImplSharedPtr& scope) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+                    lock_) -> bool {
+    Thread::LockGuard scope_lock(scope->central_cache_lock_);
     const CentralCacheEntrySharedPtr& central_cache = scope->centralCacheLockHeld();
     removeRejectedStats<CounterSharedPtr>(central_cache->counters_,
                                           [this](const CounterSharedPtr& counter) mutable {
@@ -164,8 +171,9 @@ ScopeSharedPtr ThreadLocalStoreImpl::ScopeImpl::scopeFromStatName(StatName name)
 }
 
 void ThreadLocalStoreImpl::addScope(std::shared_ptr<ScopeImpl>& new_scope) {
-  Thread::LockGuard lock(lock_);
-  scopes_[new_scope.get()] = std::weak_ptr<ScopeImpl>(new_scope);
+  ScopeShard& shard = scopeShard(*new_scope);
+  Thread::LockGuard lock(shard.lock_);
+  shard.scopes_[new_scope.get()] = std::weak_ptr<ScopeImpl>(new_scope);
 }
 
 std::vector<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
@@ -266,9 +274,14 @@ ThreadLocalStoreImpl::CentralCacheEntry::~CentralCacheEntry() {
 }
 
 void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
+  {
+    ScopeShard& shard = scopeShard(*scope);
+    Thread::LockGuard shard_lock(shard.lock_);
+    ASSERT(shard.scopes_.count(scope) == 1);
+    shard.scopes_.erase(scope);
+  }
+
   Thread::ReleasableLockGuard lock(lock_);
-  ASSERT(scopes_.count(scope) == 1);
-  scopes_.erase(scope);
 
   // This method is called directly from the ScopeImpl destructor, but we can't
   // destroy scope->central_cache_ until all the TLS caches are be destroyed, as
@@ -297,7 +310,8 @@ void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
     // VirtualHosts.
     bool need_post = scopes_to_cleanup_.empty();
     scopes_to_cleanup_.push_back(scope->scope_id_);
-    central_cache_entries_to_cleanup_.push_back(scope->centralCacheLockHeld());
+    // The scope is being destroyed, so no other thread can access its central cache pointer.
+    central_cache_entries_to_cleanup_.push_back(scope->centralCacheNoThreadAnalysis());
     lock.release();
 
     if (need_post) {
@@ -503,7 +517,7 @@ StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
 
   // We must now look in the central store so we must be locked. We grab a reference to the
   // central store location. It might contain nothing. In this case, we allocate a new stat.
-  Thread::LockGuard lock(parent_.lock_);
+  Thread::LockGuard lock(central_cache_lock_);
   auto iter = central_cache_map.find(full_stat_name);
   RefcountPtr<StatType>* central_ref = nullptr;
   if (iter != central_cache_map.end()) {
@@ -653,8 +667,8 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
     }
   }
 
-  Thread::LockGuard lock(parent_.lock_);
-  const CentralCacheEntrySharedPtr& central_cache = centralCacheNoThreadAnalysis();
+  Thread::LockGuard lock(central_cache_lock_);
+  const CentralCacheEntrySharedPtr& central_cache = centralCacheLockHeld();
   auto iter = central_cache->histograms_.find(final_stat_name);
   ParentHistogramImplSharedPtr* central_ref = nullptr;
   if (iter != central_cache->histograms_.end()) {
@@ -736,22 +750,22 @@ TextReadout& ThreadLocalStoreImpl::ScopeImpl::textReadoutFromStatNameWithTags(
 }
 
 CounterOptConstRef ThreadLocalStoreImpl::ScopeImpl::findCounter(StatName name) const {
-  Thread::LockGuard lock(parent_.lock_);
+  Thread::LockGuard lock(central_cache_lock_);
   return findStatLockHeld<Counter>(name, central_cache_->counters_);
 }
 
 GaugeOptConstRef ThreadLocalStoreImpl::ScopeImpl::findGauge(StatName name) const {
-  Thread::LockGuard lock(parent_.lock_);
+  Thread::LockGuard lock(central_cache_lock_);
   return findStatLockHeld<Gauge>(name, central_cache_->gauges_);
 }
 
 HistogramOptConstRef ThreadLocalStoreImpl::ScopeImpl::findHistogram(StatName name) const {
-  Thread::LockGuard lock(parent_.lock_);
+  Thread::LockGuard lock(central_cache_lock_);
   return findHistogramLockHeld(name);
 }
 
 HistogramOptConstRef ThreadLocalStoreImpl::ScopeImpl::findHistogramLockHeld(StatName name) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(parent_.lock_) {
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(central_cache_lock_) {
   auto iter = central_cache_->histograms_.find(name);
   if (iter == central_cache_->histograms_.end()) {
     return absl::nullopt;
@@ -762,7 +776,7 @@ HistogramOptConstRef ThreadLocalStoreImpl::ScopeImpl::findHistogramLockHeld(Stat
 }
 
 TextReadoutOptConstRef ThreadLocalStoreImpl::ScopeImpl::findTextReadout(StatName name) const {
-  Thread::LockGuard lock(parent_.lock_);
+  Thread::LockGuard lock(central_cache_lock_);
   return findStatLockHeld<TextReadout>(name, central_cache_->text_readouts_);
 }
 
@@ -785,7 +799,7 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 
   TlsHistogramSharedPtr hist_tls_ptr(
       new ThreadLocalHistogramImpl(parent.statName(), parent.unit(), tag_helper.tagExtractedName(),
-                                   tag_helper.statNameTags(), symbolTable()));
+                                   tag_helper.statNameTags(), symbolTable(), parent.flat()));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -799,40 +813,59 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
                                                    StatName tag_extracted_name,
                                                    const StatNameTagVector& stat_name_tags,
-                                                   SymbolTable& symbol_table)
+                                                   SymbolTable& symbol_table, bool flat)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
       current_active_(0), used_(false), created_thread_id_(std::this_thread::get_id()),
       symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
+  if (flat) {
+    flat_histograms_[0] = std::make_unique<FlatHistogram>();
+    flat_histograms_[1] = std::make_unique<FlatHistogram>();
+  } else {
+    histograms_[0] = hist_alloc();
+    histograms_[1] = hist_alloc();
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  if (histograms_[0] != nullptr) {
+    hist_free(histograms_[0]);
+    hist_free(histograms_[1]);
+  }
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  if (flat_histograms_[0] != nullptr) {
+    flat_histograms_[current_active_]->recordValue(value);
+  } else {
+    hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  }
   used_ = true;
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
+  ASSERT(histograms_[0] != nullptr);
   histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
   hist_accumulate(target, other_histogram, 1);
   hist_clear(*other_histogram);
 }
 
+void ThreadLocalHistogramImpl::merge(FlatHistogram& target) {
+  ASSERT(flat_histograms_[0] != nullptr);
+  flat_histograms_[otherHistogramIndex()]->moveInto(target);
+}
+
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ThreadLocalStoreImpl& thread_local_store,
                                          StatName tag_extracted_name,
                                          const StatNameTagVector& stat_name_tags,
                                          ConstSupportedBuckets& supported_buckets, uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
-      unit_(unit), thread_local_store_(thread_local_store), interval_histogram_(hist_alloc()),
-      cumulative_histogram_(hist_alloc()),
+      unit_(unit), thread_local_store_(thread_local_store),
+      flat_(Runtime::runtimeFeatureEnabled("envoy.reloadable_features.flat_tls_histograms")),
+      interval_flat_histogram_(flat_ ? std::make_unique<FlatHistogram>() : nullptr),
+      interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
       interval_statistics_(interval_histogram_, unit, supported_buckets),
       cumulative_statistics_(cumulative_histogram_, unit, supported_buckets), merged_(false),
       id_(id) {}
@@ -914,8 +947,17 @@ void ParentHistogramImpl::merge() {
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
-    for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
+    if (flat_) {
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(*interval_flat_histogram_);
+      }
+      // Only the merged counts are converted to circllhist.
+      interval_flat_histogram_->addTo(interval_histogram_);
+      interval_flat_histogram_->clear();
+    } else {
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(interval_histogram_);
+      }
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
@@ -1010,20 +1052,22 @@ void ThreadLocalStoreImpl::forEachScope(std::function<void(std::size_t)> f_size,
   }
 }
 
-bool ThreadLocalStoreImpl::iterateScopesLockHeld(
-    const std::function<bool(const ScopeImplSharedPtr&)> fn) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
-  for (auto& iter : scopes_) {
-    sync_.syncPoint(ThreadLocalStoreImpl::IterateScopeSync);
-
-    // We keep the scopes as a map from Scope* to weak_ptr<Scope> so that if,
-    // during the iteration, the last reference to a ScopeSharedPtr is dropped,
-    // we can test for that here by attempting to lock the weak pointer, and
-    // skip those that are nullptr.
-    const std::weak_ptr<ScopeImpl>& scope = iter.second;
-    const ScopeImplSharedPtr& locked = scope.lock();
-    if (locked != nullptr && !fn(locked)) {
-      return false;
+bool ThreadLocalStoreImpl::iterateScopes(
+    const std::function<bool(const ScopeImplSharedPtr&)> fn_lock_held) const {
+  for (const ScopeShard& shard : scope_shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    for (auto& iter : shard.scopes_) {
+      sync_.syncPoint(ThreadLocalStoreImpl::IterateScopeSync);
+
+      // We keep the scopes as a map from Scope* to weak_ptr<Scope> so that if,
+      // during the iteration, the last reference to a ScopeSharedPtr is dropped,
+      // we can test for that here by attempting to lock the weak pointer, and
+      // skip those that are nullptr.
+      const std::weak_ptr<ScopeImpl>& scope = iter.second;
+      const ScopeImplSharedPtr& locked = scope.lock();
+      if (locked != nullptr && !fn_lock_held(locked)) {
+        return false;
+      }
     }
   }
   return true;
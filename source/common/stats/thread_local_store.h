@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -33,11 +34,14 @@ namespace Stats {
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
+  // If flat is set, values are recorded into FlatHistograms rather than circllhists.
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
-                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
+                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
+                           bool flat = false);
   ~ThreadLocalHistogramImpl() override;
 
   void merge(histogram_t* target);
+  void merge(FlatHistogram& target);
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
@@ -65,7 +69,9 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
-  histogram_t* histograms_[2];
+  // Only one of histograms_ and flat_histograms_ is allocated.
+  histogram_t* histograms_[2]{};
+  std::unique_ptr<FlatHistogram> flat_histograms_[2];
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -86,6 +92,7 @@ public:
   ~ParentHistogramImpl() override;
 
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
+  bool flat() const { return flat_; }
 
   // Stats::Histogram
   Histogram::Unit unit() const override;
@@ -124,6 +131,10 @@ private:
 
   Histogram::Unit unit_;
   ThreadLocalStoreImpl& thread_local_store_;
+  // Set if the TLS histograms record into flat histograms, which are merged into
+  // interval_flat_histogram_ before it is added to interval_histogram_.
+  const bool flat_;
+  std::unique_ptr<FlatHistogram> interval_flat_histogram_;
   histogram_t* interval_histogram_;
   histogram_t* cumulative_histogram_;
   HistogramStatisticsImpl interval_statistics_;
@@ -193,6 +204,15 @@ public:
   void forEachSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) const override;
   void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const override;
   void forEachSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) const override;
+  void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) override {
+    alloc_.forEachChangedSinkedCounter(f_size, f_stat);
+  }
+  void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) override {
+    alloc_.forEachChangedSinkedGauge(f_size, f_stat);
+  }
+  void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) override {
+    alloc_.forEachChangedSinkedTextReadout(f_size, f_stat);
+  }
 
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) override;
   OptRef<SinkPredicates> sinkPredicates() override { return sink_predicates_; }
@@ -309,19 +329,19 @@ private:
     }
 
     bool iterate(const IterateFn<Counter>& fn) const override {
-      Thread::LockGuard lock(parent_.lock_);
+      Thread::LockGuard lock(central_cache_lock_);
       return iterateLockHeld(fn);
     }
     bool iterate(const IterateFn<Gauge>& fn) const override {
-      Thread::LockGuard lock(parent_.lock_);
+      Thread::LockGuard lock(central_cache_lock_);
       return iterateLockHeld(fn);
     }
     bool iterate(const IterateFn<Histogram>& fn) const override {
-      Thread::LockGuard lock(parent_.lock_);
+      Thread::LockGuard lock(central_cache_lock_);
       return iterateLockHeld(fn);
     }
     bool iterate(const IterateFn<TextReadout>& fn) const override {
-      Thread::LockGuard lock(parent_.lock_);
+      Thread::LockGuard lock(central_cache_lock_);
       return iterateLockHeld(fn);
     }
 
@@ -401,13 +421,13 @@ private:
 
     StatName prefix() const override { return prefix_.statName(); }
 
-    // Returns the central cache, asserting that the parent lock is held.
+    // Returns the central cache, asserting that the scope's central cache lock is held.
     //
-    // When a ThreadLocalStore method takes lock_ and then accesses
-    // scope->central_cache_, the analysis system cannot understand that the
-    // scope's parent_.lock_ is held, so we assert that here.
+    // When a ThreadLocalStore method takes scope->central_cache_lock_ and then
+    // accesses scope->central_cache_, the analysis system cannot understand
+    // that the lock is held, so we assert that here.
     const CentralCacheEntrySharedPtr& centralCacheLockHeld() const
-        ABSL_ASSERT_EXCLUSIVE_LOCK(parent_.lock_) {
+        ABSL_ASSERT_EXCLUSIVE_LOCK(central_cache_lock_) {
       return central_cache_;
     }
 
@@ -424,9 +444,16 @@ private:
     const uint64_t scope_id_;
     ThreadLocalStoreImpl& parent_;
 
+    // Guards the central cache of this scope. Each scope has its own lock so
+    // that stats created concurrently in different scopes, e.g. for clusters
+    // added in bulk by CDS, don't contend with each other. This lock may be
+    // taken while holding the parent's lock_ or a scope shard lock, but not
+    // the other way around.
+    mutable Thread::MutexBasicLockable central_cache_lock_;
+
   private:
     StatNameStorage prefix_;
-    mutable CentralCacheEntrySharedPtr central_cache_ ABSL_GUARDED_BY(parent_.lock_);
+    mutable CentralCacheEntrySharedPtr central_cache_ ABSL_GUARDED_BY(central_cache_lock_);
   };
 
   struct TlsCache : public ThreadLocal::ThreadLocalObject {
@@ -449,26 +476,33 @@ private:
 
   using ScopeImplSharedPtr = std::shared_ptr<ScopeImpl>;
 
+  // Scopes are registered in a fixed number of shards, keyed by scope ID, so
+  // that concurrent scope creation and destruction don't serialize on lock_.
+  static constexpr uint32_t NumScopeShards = 16;
+
+  struct ScopeShard {
+    mutable Thread::MutexBasicLockable lock_;
+    absl::flat_hash_map<ScopeImpl*, std::weak_ptr<ScopeImpl>> scopes_ ABSL_GUARDED_BY(lock_);
+  };
+
+  ScopeShard& scopeShard(const ScopeImpl& scope) {
+    return scope_shards_[scope.scope_id_ % NumScopeShards];
+  }
+
   /**
-   * Calls fn_lock_held for every scope with, lock_ held. This avoids iterate/destruct
-   * races for scopes.
+   * Calls fn_lock_held for every scope, with the lock of the scope's shard
+   * held. This avoids iterate/destruct races for scopes.
    *
-   * @param fn_lock_held function to be called, with lock_ held, on every scope, until
+   * @param fn_lock_held function to be called, with the shard lock held, on every scope, until
    *   fn_lock_held() returns false.
    * @return true if the iteration completed with fn_lock_held never returning false.
    */
-  bool iterateScopes(const std::function<bool(const ScopeImplSharedPtr&)> fn_lock_held) const {
-    Thread::LockGuard lock(lock_);
-    return iterateScopesLockHeld(fn_lock_held);
-  }
-
-  bool iterateScopesLockHeld(const std::function<bool(const ScopeImplSharedPtr&)> fn) const
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  bool iterateScopes(const std::function<bool(const ScopeImplSharedPtr&)> fn_lock_held) const;
 
   // The Store versions of iterate cover all the scopes in the store.
   template <class StatFn> bool iterHelper(StatFn fn) const {
     return iterateScopes(
-        [fn](const ScopeImplSharedPtr& scope) -> bool { return scope->iterateLockHeld(fn); });
+        [fn](const ScopeImplSharedPtr& scope) -> bool { return scope->iterate(fn); });
   }
 
   std::string getTagsForName(const std::string& name, TagVector& tags) const;
@@ -497,7 +531,7 @@ private:
   using TlsCacheSlot = ThreadLocal::TypedSlotPtr<TlsCache>;
   ThreadLocal::TypedSlotPtr<TlsCache> tls_cache_;
   mutable Thread::MutexBasicLockable lock_;
-  absl::flat_hash_map<ScopeImpl*, std::weak_ptr<ScopeImpl>> scopes_ ABSL_GUARDED_BY(lock_);
+  std::array<ScopeShard, NumScopeShards> scope_shards_;
   ScopeSharedPtr default_scope_;
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
@@ -1,12 +1,16 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
-#include <queue>
+#include <list>
+#include <vector>
 
 #include "envoy/upstream/scheduler.h"
 
 #include "source/common/common/assert.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -58,12 +62,54 @@ public:
     const double deadline = current_time_ + 1.0 / weight;
     EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
               static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
-    ASSERT(queue_.top().deadline_ >= current_time_);
+    queue_.push_back({deadline, order_offset_++, entry});
+    std::push_heap(queue_.begin(), queue_.end());
+    ASSERT(queue_.front().deadline_ >= current_time_);
   }
 
   bool empty() const override { return queue_.empty(); }
 
+  /**
+   * Updates the set of scheduled entries to match the given entries, without resetting the
+   * schedule. Entries that are already scheduled keep their current deadline, entries that are no
+   * longer present are dropped and new entries are added with the weight returned by
+   * calculate_weight, in the order they appear in entries. This takes O(n) time in the number of
+   * entries, whereas rebuilding the scheduler takes O(n log n).
+   *
+   * @param entries the complete set of entries to schedule.
+   * @param calculate_weight supplies the weight of the new entries.
+   */
+  template <class Entries>
+  void update(const Entries& entries, std::function<double(const C&)> calculate_weight) {
+    absl::flat_hash_set<const C*> pending;
+    pending.reserve(entries.size());
+    for (const auto& entry : entries) {
+      pending.insert(entry.get());
+    }
+
+    // Peeked entries are also in the queue, so we only need to forget about the removed ones.
+    prepick_list_.remove_if([&pending](const std::weak_ptr<C>& prepicked) {
+      std::shared_ptr<C> entry = prepicked.lock();
+      return entry == nullptr || !pending.contains(entry.get());
+    });
+
+    // Drop the queued entries that have expired or are no longer present, and take the ones that
+    // are kept out of the pending set. Each entry is present in the queue at most once.
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [&pending](const EdfEntry& edf_entry) {
+                                  std::shared_ptr<C> entry = edf_entry.entry_.lock();
+                                  return entry == nullptr || pending.erase(entry.get()) == 0;
+                                }),
+                 queue_.end());
+    std::make_heap(queue_.begin(), queue_.end());
+
+    for (const auto& entry : entries) {
+      if (pending.contains(entry.get())) {
+        add(calculate_weight(*entry), entry);
+      }
+    }
+  }
+
 private:
   /**
    * Clears expired entries and pops the next unexpired entry in the queue.
@@ -75,28 +121,33 @@ private:
         EDF_TRACE("Queue is empty.");
         return nullptr;
       }
-      const EdfEntry& edf_entry = queue_.top();
+      const EdfEntry& edf_entry = queue_.front();
       // Entry has been removed, let's see if there's another one.
       std::shared_ptr<C> ret = edf_entry.entry_.lock();
       if (!ret) {
         EDF_TRACE("Entry has expired, repick.");
-        queue_.pop();
+        popHeap();
         continue;
       }
       ASSERT(edf_entry.deadline_ >= current_time_);
       current_time_ = edf_entry.deadline_;
       EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
-      queue_.pop();
+      popHeap();
       return ret;
     }
   }
 
+  void popHeap() {
+    std::pop_heap(queue_.begin(), queue_.end());
+    queue_.pop_back();
+  }
+
   struct EdfEntry {
     double deadline_;
     // Tie breaker for entries with the same deadline. This is used to provide FIFO behavior.
     uint64_t order_offset_;
-    // We only hold a weak pointer, since we don't support a remove operator. This allows entries to
-    // be lazily unloaded from the queue.
+    // We only hold a weak pointer, so that entries are lazily unloaded from the queue when they
+    // are destroyed. Entries that are still alive are removed by update().
     std::weak_ptr<C> entry_;
 
     // Flip < direction to make this a min queue.
@@ -113,8 +164,8 @@ private:
   // Offset used during addition to break ties when entries have the same weight but should reflect
   // FIFO insertion order in picks.
   uint64_t order_offset_{};
-  // Min priority queue for EDF.
-  std::priority_queue<EdfEntry> queue_;
+  // Min priority queue for EDF, kept as a heap so that update() can filter it in place.
+  std::vector<EdfEntry> queue_;
   std::list<std::weak_ptr<C>> prepick_list_;
 };
 
@@ -14,6 +14,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -785,7 +786,9 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
   // consistent with what other LB implementations do (e.g. thread aware).
   // The downside of a full recompute is that time complexity is O(n * log n),
   // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+  // https://github.com/envoyproxy/envoy/issues/2874). With
+  // envoy.reloadable_features.edf_lb_incremental_update, existing schedulers are updated in
+  // O(n) instead, keeping the schedule of the hosts that remain.
   priority_update_cb_ = priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
   member_update_cb_ = priority_set.addMemberUpdateCb(
@@ -827,9 +830,11 @@ void EdfLoadBalancerBase::recalculateHostsInSlowStart(const HostVector& hosts) {
 }
 
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
-    // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
+  const bool incremental_update =
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.edf_lb_incremental_update");
+  const auto add_hosts_source = [this, incremental_update](HostsSource source,
+                                                           const HostVector& hosts) {
+    auto& scheduler = scheduler_[source];
     refreshHostSource(source);
     if (isSlowStartEnabled()) {
       recalculateHostsInSlowStart(hosts);
@@ -841,8 +846,20 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     // host selection with lower memory and CPU overhead.
     if (hostWeightsAreEqual(hosts) && noHostsAreInSlowStart()) {
       // Skip edf creation.
+      scheduler.edf_.reset();
       return;
     }
+
+    // If there is already a schedule for this source, only apply the membership changes to it
+    // rather than rebuilding it. This keeps the deadlines of the existing hosts, so the offset
+    // applied below when building the schedule is not needed. The weights of the existing hosts
+    // are refreshed as they are picked.
+    if (incremental_update && scheduler.edf_ != nullptr) {
+      scheduler.edf_->update(hosts, [this](const Host& host) { return hostWeight(host); });
+      return;
+    }
+
+    // Nuke existing scheduler if it exists.
     scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
 
     // Populate scheduler with host list.
@@ -1024,10 +1041,9 @@ double LeastRequestLoadBalancer::hostWeight(const Host& host) {
   // If the value of active requests is the max value, adding +1 will overflow
   // it and cause a divide by zero. This won't happen in normal cases but stops
   // failing fuzz tests
+  const uint64_t host_requests = hostRequests(host);
   const uint64_t active_request_value =
-      host.stats().rq_active_.value() != std::numeric_limits<uint64_t>::max()
-          ? host.stats().rq_active_.value() + 1
-          : host.stats().rq_active_.value();
+      host_requests != std::numeric_limits<uint64_t>::max() ? host_requests + 1 : host_requests;
 
   if (active_request_bias_ == 1.0) {
     host_weight = static_cast<double>(host.weight()) / active_request_value;
@@ -1066,8 +1082,8 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
       continue;
     }
 
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
+    const auto candidate_active_rq = hostRequests(*candidate_host);
+    const auto sampled_active_rq = hostRequests(*sampled_host);
     if (sampled_active_rq < candidate_active_rq) {
       candidate_host = sampled_host;
     }
@@ -1076,6 +1092,13 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
+uint64_t LeastRequestLoadBalancer::hostRequests(const Host& host) const {
+  if (use_outstanding_requests_) {
+    return host.load().outstanding_requests_.load(std::memory_order_relaxed);
+  }
+  return host.stats().rq_active_.value();
+}
+
 HostConstSharedPtr RandomLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
   if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
     return nullptr;
@@ -641,6 +641,8 @@ public:
             least_request_config.has_value()
                 ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(least_request_config.ref(), choice_count, 2)
                 : 2),
+        use_outstanding_requests_(least_request_config.has_value() &&
+                                  least_request_config->use_outstanding_requests()),
         active_request_bias_runtime_(
             least_request_config.has_value() && least_request_config->has_active_request_bias()
                 ? absl::optional<Runtime::Double>(
@@ -660,6 +662,7 @@ public:
             LoadBalancerConfigHelper::localityLbConfigFromProto(least_request_config),
             LoadBalancerConfigHelper::slowStartConfigFromProto(least_request_config), time_source),
         choice_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(least_request_config, choice_count, 2)),
+        use_outstanding_requests_(least_request_config.use_outstanding_requests()),
         active_request_bias_runtime_(
             least_request_config.has_active_request_bias()
                 ? absl::optional<Runtime::Double>(
@@ -691,8 +694,13 @@ private:
                                         const HostsSource& source) override;
   HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
+  // The number of requests the host is compared by.
+  uint64_t hostRequests(const Host& host) const;
 
   const uint32_t choice_count_;
+  // Whether hosts are compared by the outstanding requests of all workers, counting those
+  // waiting for a connection, rather than by their active requests.
+  const bool use_outstanding_requests_;
 
   // The exponent used to calculate host weights can be configured via runtime. We cache it for
   // performance reasons and refresh it in `LeastRequestLoadBalancer::refresh(uint32_t priority)`
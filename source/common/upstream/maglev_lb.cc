@@ -1,7 +1,13 @@
 #include "source/common/upstream/maglev_lb.h"
 
+#include <algorithm>
+
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
+#include "source/common/runtime/runtime_features.h"
+
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -19,12 +25,8 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   std::vector<TableBuildEntry> table_build_entries;
   table_build_entries.reserve(normalized_host_weights.size());
   for (const auto& host_weight : normalized_host_weights) {
-    const auto& host = host_weight.first;
-    const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
-    ASSERT(!key_to_hash.empty());
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(key_to_hash) % table_size_,
-                                     (HashUtil::xxHash64(key_to_hash, 1) % (table_size_ - 1)) + 1,
-                                     host_weight.second);
+    table_build_entries.push_back(
+        buildEntry(host_weight.first, host_weight.second, use_hostname_for_hashing));
   }
 
   table_.resize(table_size_);
@@ -42,15 +44,7 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
-      }
-
-      table_[c] = entry.host_;
-      entry.next_++;
-      entry.count_++;
+      fillEntry(entry);
       table_index++;
     }
   }
@@ -64,6 +58,110 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   stats_.min_entries_per_host_.set(min_entries_per_host);
   stats_.max_entries_per_host_.set(max_entries_per_host);
 
+  logTable(use_hostname_for_hashing);
+}
+
+MaglevTable::MaglevTable(const MaglevTable& previous,
+                         const NormalizedHostWeightVector& normalized_host_weights,
+                         bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats)
+    : table_size_(previous.table_size_), stats_(stats) {
+  ASSERT(!previous.empty());
+  if (normalized_host_weights.empty()) {
+    ENVOY_LOG(debug, "maglev: normalized hosts weights is empty, skipping building table");
+    return;
+  }
+
+  // Give each host its share of the table, rounded so that the shares add up to the table size.
+  // Unlike the full build, a host whose weight is below the resolution of the table may get no
+  // entry at all.
+  const uint64_t num_hosts = normalized_host_weights.size();
+  std::vector<uint64_t> target_counts(num_hosts);
+  std::vector<std::pair<double, uint64_t>> remainders;
+  remainders.reserve(num_hosts);
+  absl::flat_hash_map<const Host*, uint64_t> host_indexes;
+  host_indexes.reserve(num_hosts);
+  uint64_t assigned = 0;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    const double share = normalized_host_weights[i].second * table_size_;
+    target_counts[i] = static_cast<uint64_t>(share);
+    assigned += target_counts[i];
+    remainders.emplace_back(share - target_counts[i], i);
+    host_indexes.emplace(normalized_host_weights[i].first.get(), i);
+  }
+  std::sort(remainders.begin(), remainders.end(),
+            [](const std::pair<double, uint64_t>& lhs, const std::pair<double, uint64_t>& rhs) {
+              return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+            });
+  for (uint64_t i = 0; assigned < table_size_; i++, assigned++) {
+    target_counts[remainders[i % num_hosts].second]++;
+  }
+
+  // Keep the entries of the remaining hosts, up to their share, and free the others.
+  table_ = previous.table_;
+  std::vector<uint64_t> counts(num_hosts);
+  for (HostConstSharedPtr& host : table_) {
+    const auto it = host_indexes.find(host.get());
+    if (it != host_indexes.end() && counts[it->second] < target_counts[it->second]) {
+      counts[it->second]++;
+    } else {
+      host = nullptr;
+    }
+  }
+
+  // The free entries are exactly the entries missing from the shares of the hosts, which take
+  // turns at filling them following their permutations, as in the full build.
+  std::vector<TableBuildEntry> table_build_entries;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    if (counts[i] < target_counts[i]) {
+      TableBuildEntry& entry = table_build_entries.emplace_back(buildEntry(
+          normalized_host_weights[i].first, normalized_host_weights[i].second,
+          use_hostname_for_hashing));
+      entry.count_ = counts[i];
+      entry.target_count_ = target_counts[i];
+    }
+  }
+  uint64_t remaining_entries = table_build_entries.size();
+  while (remaining_entries > 0) {
+    for (TableBuildEntry& entry : table_build_entries) {
+      if (entry.count_ == entry.target_count_) {
+        continue;
+      }
+      fillEntry(entry);
+      if (entry.count_ == entry.target_count_) {
+        remaining_entries--;
+      }
+    }
+  }
+
+  const auto [min_entries_per_host, max_entries_per_host] =
+      std::minmax_element(target_counts.begin(), target_counts.end());
+  stats_.min_entries_per_host_.set(*min_entries_per_host);
+  stats_.max_entries_per_host_.set(*max_entries_per_host);
+
+  logTable(use_hostname_for_hashing);
+}
+
+MaglevTable::TableBuildEntry MaglevTable::buildEntry(const HostConstSharedPtr& host, double weight,
+                                                     bool use_hostname_for_hashing) {
+  const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
+  ASSERT(!key_to_hash.empty());
+  return {host, HashUtil::xxHash64(key_to_hash) % table_size_,
+          (HashUtil::xxHash64(key_to_hash, 1) % (table_size_ - 1)) + 1, weight};
+}
+
+void MaglevTable::fillEntry(TableBuildEntry& entry) {
+  uint64_t c = permutation(entry);
+  while (table_[c] != nullptr) {
+    entry.next_++;
+    c = permutation(entry);
+  }
+
+  table_[c] = entry.host_;
+  entry.next_++;
+  entry.count_++;
+}
+
+void MaglevTable::logTable(bool use_hostname_for_hashing) {
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (uint64_t i = 0; i < table_.size(); i++) {
       const absl::string_view key_to_hash = hashKey(table_[i], use_hostname_for_hashing);
@@ -140,6 +238,32 @@ MaglevLoadBalancer::MaglevLoadBalancer(
   }
 }
 
+ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
+MaglevLoadBalancer::createLoadBalancer(uint32_t priority,
+                                       const NormalizedHostWeightVector& normalized_host_weights,
+                                       double /* min_normalized_weight */,
+                                       double max_normalized_weight) {
+  if (tables_.size() <= priority) {
+    tables_.resize(priority + 1);
+  }
+  std::shared_ptr<MaglevTable>& table = tables_[priority];
+  if (table != nullptr && !table->empty() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.maglev_incremental_update")) {
+    table = std::make_shared<MaglevTable>(*table, normalized_host_weights,
+                                          use_hostname_for_hashing_, stats_);
+  } else {
+    table = std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight,
+                                          table_size_, use_hostname_for_hashing_, stats_);
+  }
+
+  if (hash_balance_factor_ == 0) {
+    return table;
+  }
+
+  return std::make_shared<BoundedLoadHashingLoadBalancer>(table, normalized_host_weights,
+                                                          hash_balance_factor_);
+}
+
 MaglevLoadBalancerStats MaglevLoadBalancer::generateStats(Stats::Scope& scope) {
   return {ALL_MAGLEV_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
@@ -40,9 +40,22 @@ public:
               double max_normalized_weight, uint64_t table_size, bool use_hostname_for_hashing,
               MaglevLoadBalancerStats& stats);
 
+  /**
+   * Builds a table from a previous, non empty table of the same size. The hosts that remain keep
+   * their entries, up to their new share of the table, and only the entries of removed hosts and
+   * the entries trimmed from hosts whose share shrank are reassigned, following the permutations
+   * of the hosts that need more entries. Unlike a table built from scratch, the result depends on
+   * the previous table.
+   */
+  MaglevTable(const MaglevTable& previous,
+              const NormalizedHostWeightVector& normalized_host_weights,
+              bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats);
+
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
   HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
+  bool empty() const { return table_.empty(); }
+
   // Recommended table size in section 5.3 of the paper.
   static const uint64_t DefaultTableSize = 65537;
 
@@ -58,9 +71,16 @@ private:
     double target_weight_{};
     uint64_t next_{};
     uint64_t count_{};
+    // The number of entries wanted, for incremental builds.
+    uint64_t target_count_{};
   };
 
+  TableBuildEntry buildEntry(const HostConstSharedPtr& host, double weight,
+                             bool use_hostname_for_hashing);
   uint64_t permutation(const TableBuildEntry& entry);
+  // Takes the next free entry in the permutation of the build entry.
+  void fillEntry(TableBuildEntry& entry);
+  void logTable(bool use_hostname_for_hashing);
 
   const uint64_t table_size_;
   std::vector<HostConstSharedPtr> table_;
@@ -89,23 +109,14 @@ public:
 private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double /* min_normalized_weight */, double max_normalized_weight) override {
-    HashingLoadBalancerSharedPtr maglev_lb =
-        std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight, table_size_,
-                                      use_hostname_for_hashing_, stats_);
-
-    if (hash_balance_factor_ == 0) {
-      return maglev_lb;
-    }
-
-    return std::make_shared<BoundedLoadHashingLoadBalancer>(
-        maglev_lb, std::move(normalized_host_weights), hash_balance_factor_);
-  }
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
+                     double /* min_normalized_weight */, double max_normalized_weight) override;
 
   static MaglevLoadBalancerStats generateStats(Stats::Scope& scope);
 
   Stats::ScopeSharedPtr scope_;
+  // The current table of each priority, to update it incrementally.
+  std::vector<std::shared_ptr<MaglevTable>> tables_;
   MaglevLoadBalancerStats stats_;
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
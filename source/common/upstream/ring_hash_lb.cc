@@ -8,8 +8,10 @@
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
@@ -77,6 +79,34 @@ RingHashLoadBalancer::RingHashLoadBalancer(
   }
 }
 
+ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
+RingHashLoadBalancer::createLoadBalancer(uint32_t priority,
+                                         const NormalizedHostWeightVector& normalized_host_weights,
+                                         double min_normalized_weight,
+                                         double /* max_normalized_weight */) {
+  if (rings_.size() <= priority) {
+    rings_.resize(priority + 1);
+  }
+  std::shared_ptr<Ring>& ring = rings_[priority];
+  if (ring != nullptr && !ring->ring_.empty() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.ring_hash_incremental_update")) {
+    ring = std::make_shared<Ring>(*ring, normalized_host_weights, min_normalized_weight,
+                                  min_ring_size_, max_ring_size_, hash_function_,
+                                  use_hostname_for_hashing_, stats_);
+  } else {
+    ring = std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
+                                  max_ring_size_, hash_function_, use_hostname_for_hashing_,
+                                  stats_);
+  }
+
+  if (hash_balance_factor_ == 0) {
+    return ring;
+  }
+
+  return std::make_shared<BoundedLoadHashingLoadBalancer>(ring, normalized_host_weights,
+                                                          hash_balance_factor_);
+}
+
 RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scope) {
   return {ALL_RING_HASH_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
@@ -131,6 +161,52 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t a
 }
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
+
+namespace {
+
+// Scale up the number of hashes per host such that the least-weighted host gets a whole number
+// of hashes on the ring. Other hosts might not end up with whole numbers, and that's fine (the
+// ring-building algorithm below can handle this). This preserves the original implementation's
+// behavior: when weights aren't provided, all hosts should get an equal number of hashes. In
+// the case where this number exceeds the max_ring_size, it's scaled back down to fit.
+double ringScale(double min_normalized_weight, uint64_t min_ring_size, uint64_t max_ring_size) {
+  return std::min(std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
+                  static_cast<double>(max_ring_size));
+}
+
+// Returns the number of hashes of each host in normalized_host_weights, generating (scale *
+// weight) hashes for each host. Since these aren't necessarily whole numbers, we maintain running
+// sums -- current_hashes and target_hashes -- which allows us to populate the ring in a mostly
+// stable way.
+//
+// For example, suppose we have 4 hosts, each with a normalized weight of 0.25, and a scale of
+// 6.0 (because the max_ring_size is 6). That means we want to generate 1.5 hashes per host.
+// We start the outer loop with current_hashes = 0 and target_hashes = 0.
+//   - For the first host, we set target_hashes = 1.5. After one run of the inner loop,
+//     current_hashes = 1. After another run, current_hashes = 2, so the inner loop ends.
+//   - For the second host, target_hashes becomes 3.0, and current_hashes is 2 from before.
+//     After only one run of the inner loop, current_hashes = 3, so the inner loop ends.
+//   - Likewise, the third host gets two hashes, and the fourth host gets one hash.
+std::vector<uint64_t> hashesPerHost(const NormalizedHostWeightVector& normalized_host_weights,
+                                    double scale) {
+  std::vector<uint64_t> hashes_per_host;
+  hashes_per_host.reserve(normalized_host_weights.size());
+  double current_hashes = 0.0;
+  double target_hashes = 0.0;
+  for (const auto& entry : normalized_host_weights) {
+    target_hashes += scale * entry.second;
+    uint64_t i = 0;
+    while (current_hashes < target_hashes) {
+      ++i;
+      ++current_hashes;
+    }
+    hashes_per_host.push_back(i);
+  }
+  return hashes_per_host;
+}
+
+} // namespace
+
 RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_host_weights,
                                  double min_normalized_weight, uint64_t min_ring_size,
                                  uint64_t max_ring_size, HashFunction hash_function,
@@ -143,80 +219,125 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     return;
   }
 
-  // Scale up the number of hashes per host such that the least-weighted host gets a whole number
-  // of hashes on the ring. Other hosts might not end up with whole numbers, and that's fine (the
-  // ring-building algorithm below can handle this). This preserves the original implementation's
-  // behavior: when weights aren't provided, all hosts should get an equal number of hashes. In
-  // the case where this number exceeds the max_ring_size, it's scaled back down to fit.
-  const double scale =
-      std::min(std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
-               static_cast<double>(max_ring_size));
+  const double scale = ringScale(min_normalized_weight, min_ring_size, max_ring_size);
 
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
   ring_.reserve(ring_size);
 
   // Populate the hash ring by walking through the (host, weight) pairs in
-  // normalized_host_weights, and generating (scale * weight) hashes for each host. Since these
-  // aren't necessarily whole numbers, we maintain running sums -- current_hashes and
-  // target_hashes -- which allows us to populate the ring in a mostly stable way.
-  //
-  // For example, suppose we have 4 hosts, each with a normalized weight of 0.25, and a scale of
-  // 6.0 (because the max_ring_size is 6). That means we want to generate 1.5 hashes per host.
-  // We start the outer loop with current_hashes = 0 and target_hashes = 0.
-  //   - For the first host, we set target_hashes = 1.5. After one run of the inner loop,
-  //     current_hashes = 1. After another run, current_hashes = 2, so the inner loop ends.
-  //   - For the second host, target_hashes becomes 3.0, and current_hashes is 2 from before.
-  //     After only one run of the inner loop, current_hashes = 3, so the inner loop ends.
-  //   - Likewise, the third host gets two hashes, and the fourth host gets one hash.
-  //
-  // For stats reporting, keep track of the minimum and maximum actual number of hashes per host.
-  // Users should hopefully pay attention to these numbers and alert if min_hashes_per_host is too
-  // low, since that implies an inaccurate request distribution.
+  // normalized_host_weights, and generating the hashes of each host.
+  const std::vector<uint64_t> hashes_per_host = hashesPerHost(normalized_host_weights, scale);
+  hashes_per_host_.reserve(normalized_host_weights.size());
+  for (uint64_t i = 0; i < normalized_host_weights.size(); i++) {
+    const auto& host = normalized_host_weights[i].first;
+    addHashes(host, 0, hashes_per_host[i], hash_function, use_hostname_for_hashing, ring_);
+    hashes_per_host_[host.get()] = hashes_per_host[i];
+  }
 
-  absl::InlinedVector<char, 196> hash_key_buffer;
-  double current_hashes = 0.0;
-  double target_hashes = 0.0;
-  uint64_t min_hashes_per_host = ring_size;
-  uint64_t max_hashes_per_host = 0;
-  for (const auto& entry : normalized_host_weights) {
-    const auto& host = entry.first;
-    const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
-    ASSERT(!key_to_hash.empty());
+  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+    return lhs.hash_ < rhs.hash_;
+  });
+  setStats(ring_size, hashes_per_host, use_hostname_for_hashing);
+}
 
-    hash_key_buffer.assign(key_to_hash.begin(), key_to_hash.end());
-    hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
+RingHashLoadBalancer::Ring::Ring(const Ring& previous,
+                                 const NormalizedHostWeightVector& normalized_host_weights,
+                                 double min_normalized_weight, uint64_t min_ring_size,
+                                 uint64_t max_ring_size, HashFunction hash_function,
+                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats)
+    : stats_(stats) {
+  ENVOY_LOG(trace, "ring hash: updating ring");
 
-    // As noted above: maintain current_hashes and target_hashes as running sums across the entire
-    // host set. `i` is needed only to construct the hash key, and tally min/max hashes per host.
-    target_hashes += scale * entry.second;
-    uint64_t i = 0;
-    while (current_hashes < target_hashes) {
-      const std::string i_str = absl::StrCat("", i);
-      hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
+  if (normalized_host_weights.empty()) {
+    return;
+  }
 
-      absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()),
-                                 hash_key_buffer.size());
+  const double scale = ringScale(min_normalized_weight, min_ring_size, max_ring_size);
+  const uint64_t ring_size = std::ceil(scale);
 
-      const uint64_t hash =
-          (hash_function == HashFunction::Cluster_RingHashLbConfig_HashFunction_MURMUR_HASH_2)
-              ? MurmurHash::murmurHash2(hash_key, MurmurHash::STD_HASH_SEED)
-              : HashUtil::xxHash64(hash_key);
+  // The hashes of a host only depend on its hash key and their index, so a host that had n hashes
+  // and now needs m keeps its hashes [0, min(n, m)) and adds or removes the others.
+  const std::vector<uint64_t> hashes_per_host = hashesPerHost(normalized_host_weights, scale);
+  std::vector<RingEntry> added_entries;
+  std::vector<RingEntry> removed_entries;
+  hashes_per_host_.reserve(normalized_host_weights.size());
+  for (uint64_t i = 0; i < normalized_host_weights.size(); i++) {
+    const auto& host = normalized_host_weights[i].first;
+    const auto it = previous.hashes_per_host_.find(host.get());
+    const uint64_t previous_hashes = it != previous.hashes_per_host_.end() ? it->second : 0;
+    if (hashes_per_host[i] > previous_hashes) {
+      addHashes(host, previous_hashes, hashes_per_host[i], hash_function, use_hostname_for_hashing,
+                added_entries);
+    } else if (hashes_per_host[i] < previous_hashes) {
+      addHashes(host, hashes_per_host[i], previous_hashes, hash_function,
+                use_hostname_for_hashing, removed_entries);
+    }
+    hashes_per_host_[host.get()] = hashes_per_host[i];
+  }
+  absl::flat_hash_set<std::pair<uint64_t, const Host*>> removed_hashes;
+  removed_hashes.reserve(removed_entries.size());
+  for (const RingEntry& entry : removed_entries) {
+    removed_hashes.emplace(entry.hash_, entry.host_.get());
+  }
+  std::sort(added_entries.begin(), added_entries.end(),
+            [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+              return lhs.hash_ < rhs.hash_;
+            });
 
-      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
-      ring_.push_back({hash, host});
-      ++i;
-      ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
+  // Merge the added hashes with the hashes kept from the previous ring, which are still sorted.
+  ring_.reserve(ring_size);
+  auto added_it = added_entries.begin();
+  for (const RingEntry& entry : previous.ring_) {
+    if (!hashes_per_host_.contains(entry.host_.get()) ||
+        removed_hashes.contains(std::make_pair(entry.hash_, entry.host_.get()))) {
+      continue;
     }
-    min_hashes_per_host = std::min(i, min_hashes_per_host);
-    max_hashes_per_host = std::max(i, max_hashes_per_host);
+    while (added_it != added_entries.end() && added_it->hash_ < entry.hash_) {
+      ring_.push_back(*added_it++);
+    }
+    ring_.push_back(entry);
   }
+  ring_.insert(ring_.end(), added_it, added_entries.end());
+  setStats(ring_size, hashes_per_host, use_hostname_for_hashing);
+}
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
+void RingHashLoadBalancer::Ring::addHashes(const HostConstSharedPtr& host, uint64_t begin,
+                                           uint64_t end, HashFunction hash_function,
+                                           bool use_hostname_for_hashing,
+                                           std::vector<RingEntry>& entries) {
+  const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
+  ASSERT(!key_to_hash.empty());
+
+  absl::InlinedVector<char, 196> hash_key_buffer;
+  hash_key_buffer.assign(key_to_hash.begin(), key_to_hash.end());
+  hash_key_buffer.emplace_back('_');
+  auto offset_start = hash_key_buffer.end();
+
+  // `i` is needed only to construct the hash key.
+  for (uint64_t i = begin; i < end; ++i) {
+    const std::string i_str = absl::StrCat("", i);
+    hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
+
+    absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()), hash_key_buffer.size());
+
+    const uint64_t hash =
+        (hash_function == HashFunction::Cluster_RingHashLbConfig_HashFunction_MURMUR_HASH_2)
+            ? MurmurHash::murmurHash2(hash_key, MurmurHash::STD_HASH_SEED)
+            : HashUtil::xxHash64(hash_key);
+
+    ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
+    entries.push_back({hash, host});
+    hash_key_buffer.erase(offset_start, hash_key_buffer.end());
+  }
+}
+
+// For stats reporting, keep track of the minimum and maximum actual number of hashes per host.
+// Users should hopefully pay attention to these numbers and alert if min_hashes_per_host is too
+// low, since that implies an inaccurate request distribution.
+void RingHashLoadBalancer::Ring::setStats(uint64_t ring_size,
+                                          const std::vector<uint64_t>& hashes_per_host,
+                                          bool use_hostname_for_hashing) {
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (const auto& entry : ring_) {
       const absl::string_view key_to_hash = hashKey(entry.host_, use_hostname_for_hashing);
@@ -224,9 +345,11 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     }
   }
 
+  const auto [min_hashes_per_host, max_hashes_per_host] =
+      std::minmax_element(hashes_per_host.begin(), hashes_per_host.end());
   stats_.size_.set(ring_size);
-  stats_.min_hashes_per_host_.set(min_hashes_per_host);
-  stats_.max_hashes_per_host_.set(max_hashes_per_host);
+  stats_.min_hashes_per_host_.set(*min_hashes_per_host);
+  stats_.max_hashes_per_host_.set(*max_hashes_per_host);
 }
 
 } // namespace Upstream
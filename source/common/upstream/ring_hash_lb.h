@@ -12,6 +12,8 @@
 #include "source/common/common/logger.h"
 #include "source/common/upstream/thread_aware_lb_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -66,11 +68,27 @@ private:
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
          bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats);
+    // Builds the ring from a previous ring built with the same settings. Only the hashes of added
+    // hosts and of hosts that need more of them are computed, and they are merged with the hashes
+    // kept from the previous ring, so the result is the ring a full build would produce.
+    Ring(const Ring& previous, const NormalizedHostWeightVector& normalized_host_weights,
+         double min_normalized_weight, uint64_t min_ring_size, uint64_t max_ring_size,
+         HashFunction hash_function, bool use_hostname_for_hashing,
+         RingHashLoadBalancerStats& stats);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
+    // Appends the hashes [begin, end) of the host to entries.
+    void addHashes(const HostConstSharedPtr& host, uint64_t begin, uint64_t end,
+                   HashFunction hash_function, bool use_hostname_for_hashing,
+                   std::vector<RingEntry>& entries);
+    void setStats(uint64_t ring_size, const std::vector<uint64_t>& hashes_per_host,
+                  bool use_hostname_for_hashing);
+
     std::vector<RingEntry> ring_;
+    // The number of hashes of each host in the ring.
+    absl::flat_hash_map<const Host*, uint64_t> hashes_per_host_;
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -78,23 +96,15 @@ private:
 
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double min_normalized_weight, double /* max_normalized_weight */) override {
-    HashingLoadBalancerSharedPtr ring_hash_lb =
-        std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
-                               max_ring_size_, hash_function_, use_hostname_for_hashing_, stats_);
-    if (hash_balance_factor_ == 0) {
-      return ring_hash_lb;
-    }
-
-    return std::make_shared<BoundedLoadHashingLoadBalancer>(
-        ring_hash_lb, std::move(normalized_host_weights), hash_balance_factor_);
-  }
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
+                     double min_normalized_weight, double /* max_normalized_weight */) override;
 
   static RingHashLoadBalancerStats generateStats(Stats::Scope& scope);
 
   Stats::ScopeSharedPtr scope_;
   RingHashLoadBalancerStats stats_;
+  // The current ring of each priority, to update it incrementally.
+  std::vector<std::shared_ptr<Ring>> rings_;
 
   static const uint64_t DefaultMinRingSize = 1024;
   static const uint64_t DefaultMaxRingSize = 1024 * 1024 * 8;
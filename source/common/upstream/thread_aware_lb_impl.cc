@@ -97,12 +97,14 @@ void ThreadAwareLoadBalancerBase::initialize() {
   // complicated initialization as the load balancer would need its own initialized callback. I
   // think the synchronous/asynchronous split is probably the best option.
   priority_update_cb_ = priority_set_.addPriorityUpdateCb(
-      [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
+      [this](uint32_t priority, const HostVector&, const HostVector&) -> void {
+        refresh(priority);
+      });
 
-  refresh();
+  refresh(absl::nullopt);
 }
 
-void ThreadAwareLoadBalancerBase::refresh() {
+void ThreadAwareLoadBalancerBase::refresh(absl::optional<uint32_t> updated_priority) {
   auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
       priority_set_.hostSetsPerPriority().size());
   auto healthy_per_priority_load =
@@ -118,15 +120,26 @@ void ThreadAwareLoadBalancerBase::refresh() {
     // in hosts set or hosts' health.
     per_priority_state->global_panic_ = per_priority_panic_[priority];
 
+    // The hosts of the other priorities have not changed, so their load balancers are reused
+    // unless they entered or left panic mode, which changes the hosts they balance across.
+    if (updated_priority.has_value() && priority != updated_priority.value() &&
+        per_priority_state_ != nullptr && priority < per_priority_state_->size() &&
+        (*per_priority_state_)[priority]->global_panic_ == per_priority_state->global_panic_) {
+      per_priority_state->current_lb_ = (*per_priority_state_)[priority]->current_lb_;
+      continue;
+    }
+
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
     NormalizedHostWeightVector normalized_host_weights;
     double min_normalized_weight = 1.0;
     double max_normalized_weight = 0.0;
     normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
                      min_normalized_weight, max_normalized_weight, locality_weighted_balancing_);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+    per_priority_state->current_lb_ =
+        createLoadBalancer(priority, std::move(normalized_host_weights), min_normalized_weight,
+                           max_normalized_weight);
   }
+  per_priority_state_ = per_priority_state_vector;
 
   {
     absl::WriterMutexLock lock(&factory_->mutex_);
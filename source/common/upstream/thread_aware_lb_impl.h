@@ -163,12 +163,18 @@ private:
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
   };
 
+  // Creates the load balancer of a priority. Implementations may keep the previous load balancer
+  // of each priority to update it incrementally.
   virtual HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
-  void refresh();
+  // Rebuilds the load balancers of the priorities affected by an update of updated_priority, or
+  // of all priorities if it is not set.
+  void refresh(absl::optional<uint32_t> updated_priority);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  // The state last handed to the factory. Only used on the main thread.
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
   const bool locality_weighted_balancing_{};
   Common::CallbackHandlePtr priority_update_cb_;
 };
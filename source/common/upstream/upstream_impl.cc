@@ -33,6 +33,7 @@
 #include "source/common/common/dns_utils.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/thread.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/utility.h"
 #include "source/common/http/http1/codec_stats.h"
@@ -453,6 +454,15 @@ Network::UpstreamTransportSocketFactory& HostDescriptionImpl::resolveTransportSo
   return match.factory_;
 }
 
+void HostDescriptionImpl::setLbPolicyData(HostLbPolicyDataPtr&& lb_policy_data) {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  if (lb_policy_data_ != nullptr) {
+    return;
+  }
+  lb_policy_data_ = std::move(lb_policy_data);
+  lb_policy_data_ptr_.store(lb_policy_data_.get(), std::memory_order_release);
+}
+
 Host::CreateConnectionData HostImpl::createConnection(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     Network::TransportSocketOptionsConstSharedPtr transport_socket_options) const {
@@ -987,6 +997,12 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      adaptive_preconnect_(
+          config.preconnect_policy().has_adaptive_preconnect()
+              ? std::make_unique<
+                    envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>(
+                    config.preconnect_policy().adaptive_preconnect())
+              : nullptr),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
       traffic_stats_(
           generateStats(*stats_scope_, factory_context.clusterManager().clusterStatNames())),
@@ -210,6 +210,11 @@ public:
   }
   HostStats& stats() const override { return stats_; }
   LoadMetricStats& loadMetricStats() const override { return load_metric_stats_; }
+  HostLoad& load() const override { return load_; }
+  HostLbPolicyData* lbPolicyData() const override {
+    return lb_policy_data_ptr_.load(std::memory_order_acquire);
+  }
+  void setLbPolicyData(HostLbPolicyDataPtr&& lb_policy_data) override;
   const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
   const std::string& hostname() const override { return hostname_; }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
@@ -297,6 +302,10 @@ private:
   Stats::StatNameDynamicStorage locality_zone_stat_name_;
   mutable HostStats stats_;
   mutable LoadMetricStatsImpl load_metric_stats_;
+  mutable HostLoad load_;
+  // Set at most once, and published to the workers through lb_policy_data_ptr_.
+  HostLbPolicyDataPtr lb_policy_data_;
+  std::atomic<HostLbPolicyData*> lb_policy_data_ptr_{nullptr};
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
   std::atomic<uint32_t> priority_;
@@ -789,6 +798,13 @@ public:
   }
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  OptRef<const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>
+  adaptivePreconnect() const override {
+    if (adaptive_preconnect_ == nullptr) {
+      return absl::nullopt;
+    }
+    return *adaptive_preconnect_;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -992,6 +1008,9 @@ private:
   absl::optional<std::chrono::milliseconds> max_connection_duration_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  const std::unique_ptr<
+      const envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect>
+      adaptive_preconnect_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopeSharedPtr stats_scope_;
   mutable LazyClusterTrafficStats traffic_stats_;
@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/grpc/typed_async_client.h"
 #include "source/common/http/utility.h"
@@ -79,7 +80,12 @@ template <typename LogRequest, typename LogResponse> class GrpcAccessLogClient {
 public:
   virtual ~GrpcAccessLogClient() = default;
   virtual bool isConnected() PURE;
-  virtual bool log(const LogRequest& request) PURE;
+  /**
+   * Sends a serialized request, draining it, unless the request can't be sent yet.
+   * @param request supplies the serialized LogRequest.
+   * @return false if the request was kept to be sent later.
+   */
+  virtual bool log(Buffer::Instance& request) PURE;
 
 protected:
   GrpcAccessLogClient(const Grpc::RawAsyncClientSharedPtr& client,
@@ -119,10 +125,13 @@ public:
 
   bool isConnected() override { return false; }
 
-  bool log(const LogRequest& request) override {
-    GrpcAccessLogClient<LogRequest, LogResponse>::client_->send(
-        GrpcAccessLogClient<LogRequest, LogResponse>::service_method_, request, request_cb_,
-        Tracing::NullSpan::instance(), GrpcAccessLogClient<LogRequest, LogResponse>::opts_);
+  bool log(Buffer::Instance& request) override {
+    auto message = std::make_unique<Buffer::OwnedImpl>();
+    message->move(request);
+    GrpcAccessLogClient<LogRequest, LogResponse>::client_->sendRaw(
+        GrpcAccessLogClient<LogRequest, LogResponse>::service_method_, std::move(message),
+        request_cb_, Tracing::NullSpan::instance(),
+        GrpcAccessLogClient<LogRequest, LogResponse>::opts_);
     return true;
   }
 
@@ -169,7 +178,7 @@ public:
 
   bool isConnected() override { return stream_ != nullptr && stream_->stream_ != nullptr; }
 
-  bool log(const LogRequest& request) override {
+  bool log(Buffer::Instance& request) override {
     if (!stream_) {
       stream_ = std::make_unique<LocalStream>(*this);
     }
@@ -184,10 +193,13 @@ public:
       if (stream_->stream_->isAboveWriteBufferHighWatermark()) {
         return false;
       }
-      stream_->stream_->sendMessage(request, false);
+      auto message = std::make_unique<Buffer::OwnedImpl>();
+      message->move(request);
+      stream_->stream_->sendMessageRaw(std::move(message), false);
     } else {
       // Clear out the stream data due to stream creation failure.
       stream_.reset();
+      request.drain(request.length());
     }
     return true;
   }
@@ -216,6 +228,8 @@ struct GrpcAccessLoggerStats {
  * entries and `LogRequest` and `LogResponse` gRPC messages.
  * The log entries and messages are distinct types to support batching of multiple access log
  * entries in a single gRPC messages that go on the wire.
+ * Loggers may either add the entries to `message_`, or serialize them as they are logged with
+ * `serializeEntry()`, so that a flush only serializes `message_` in front of them.
  */
 template <typename HttpLogProto, typename TcpLogProto, typename LogRequest, typename LogResponse>
 class GrpcAccessLogger : public Detail::GrpcAccessLogger<HttpLogProto, TcpLogProto> {
@@ -264,15 +278,41 @@ public:
   }
 
 protected:
+  /**
+   * Serializes an entry after the entries serialized so far, nested in the length-delimited fields
+   * field_numbers of the request, outermost first.
+   */
+  void serializeEntry(const Protobuf::Message& entry, absl::Span<const uint32_t> field_numbers) {
+    GrpcCommon::serializeNestedMessage(entry, field_numbers, serialized_entries_);
+  }
+
+  bool hasSerializedEntries() const { return serialized_entries_.length() != 0; }
+
   std::unique_ptr<Detail::GrpcAccessLogClient<LogRequest, LogResponse>> client_;
   LogRequest message_;
 
 private:
-  virtual bool isEmpty() PURE;
+  /**
+   * @return true if there is nothing to flush. By default, there is nothing to flush if no entry
+   * was serialized and `message_` is empty.
+   */
+  virtual bool isEmpty() { return !hasSerializedEntries() && message_.ByteSizeLong() == 0; }
   virtual void initMessage() PURE;
   virtual void addEntry(HttpLogProto&& entry) PURE;
   virtual void addEntry(TcpLogProto&& entry) PURE;
   virtual void clearMessage() { message_.Clear(); }
+  /**
+   * Serializes the part of the request preceding the serialized entries. By default this is
+   * `message_`, which works for entries that are not nested in repeated fields.
+   * @param entries_size supplies the size of the serialized entries.
+   * @param buffer supplies the buffer to serialize to.
+   */
+  virtual void serializeMessagePrefix(uint64_t /*entries_size*/, Buffer::Instance& buffer) {
+    const uint64_t size = message_.ByteSizeLong();
+    auto reservation = buffer.reserveSingleSlice(size);
+    message_.SerializeWithCachedSizesToArray(static_cast<uint8_t*>(reservation.slice().mem_));
+    reservation.commit(size);
+  }
 
   void flush() {
     if (isEmpty()) {
@@ -284,10 +324,18 @@ private:
       initMessage();
     }
 
-    if (client_->log(message_)) {
+    // The entries are moved into the request as they are, and are put back if the request can't
+    // be sent yet.
+    Buffer::OwnedImpl prefix;
+    serializeMessagePrefix(serialized_entries_.length(), prefix);
+    const uint64_t prefix_size = prefix.length();
+    serialized_entries_.prepend(prefix);
+    if (client_->log(serialized_entries_)) {
       // Clear the message regardless of the success.
       approximate_message_size_bytes_ = 0;
       clearMessage();
+    } else {
+      serialized_entries_.drain(prefix_size);
     }
   }
 
@@ -309,6 +357,8 @@ private:
   const Event::TimerPtr flush_timer_;
   const uint64_t max_buffer_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
+  // The entries logged since the last flush, in the protobuf wire format.
+  Buffer::OwnedImpl serialized_entries_;
   GrpcAccessLoggerStats stats_;
 };
 
@@ -1,5 +1,11 @@
 #include "source/extensions/access_loggers/common/grpc_access_logger_utils.h"
 
+#include "source/common/common/assert.h"
+
+#include "absl/container/inlined_vector.h"
+
+using Envoy::Protobuf::io::CodedOutputStream;
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
@@ -13,6 +19,55 @@ OptRef<const envoy::config::core::v3::RetryPolicy> optionalRetryPolicy(
   return config.grpc_stream_retry_policy();
 }
 
+namespace {
+
+// Embedded messages are treated the same way as strings (wire type 2).
+constexpr uint32_t ProtobufLengthDelimitedField = 2;
+
+uint32_t lengthDelimitedTag(uint32_t field_number) {
+  return (field_number << 3) | ProtobufLengthDelimitedField;
+}
+
+uint8_t* writeFieldHeader(uint32_t field_number, uint64_t size, uint8_t* target) {
+  target = CodedOutputStream::WriteVarint32ToArray(lengthDelimitedTag(field_number), target);
+  return CodedOutputStream::WriteVarint64ToArray(size, target);
+}
+
+} // namespace
+
+uint64_t fieldHeaderSize(uint32_t field_number, uint64_t size) {
+  return CodedOutputStream::VarintSize32(lengthDelimitedTag(field_number)) +
+         CodedOutputStream::VarintSize64(size);
+}
+
+void serializeFieldHeader(uint32_t field_number, uint64_t size, Buffer::Instance& buffer) {
+  // At most 5 bytes for the tag and 10 bytes for the length.
+  uint8_t header[16];
+  const uint8_t* end = writeFieldHeader(field_number, size, header);
+  buffer.add(header, end - header);
+}
+
+void serializeNestedMessage(const Protobuf::Message& message,
+                            absl::Span<const uint32_t> field_numbers, Buffer::Instance& buffer) {
+  // The content size of each field, which is the size of the fields nested in it.
+  absl::InlinedVector<uint64_t, 4> content_sizes(field_numbers.size());
+  uint64_t size = message.ByteSizeLong();
+  for (size_t i = field_numbers.size(); i > 0; i--) {
+    content_sizes[i - 1] = size;
+    size += fieldHeaderSize(field_numbers[i - 1], size);
+  }
+
+  // The message is written directly into the buffer, after the headers of the fields around it.
+  auto reservation = buffer.reserveSingleSlice(size);
+  ASSERT(reservation.slice().len_ >= size);
+  uint8_t* current = static_cast<uint8_t*>(reservation.slice().mem_);
+  for (size_t i = 0; i < field_numbers.size(); i++) {
+    current = writeFieldHeader(field_numbers[i], content_sizes[i], current);
+  }
+  message.SerializeWithCachedSizesToArray(current);
+  reservation.commit(size);
+}
+
 } // namespace GrpcCommon
 } // namespace AccessLoggers
 } // namespace Extensions
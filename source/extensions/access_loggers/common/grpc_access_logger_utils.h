@@ -1,8 +1,13 @@
 #pragma once
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/optref.h"
 #include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
 
+#include "source/common/protobuf/protobuf.h"
+
+#include "absl/types/span.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
@@ -11,6 +16,26 @@ namespace GrpcCommon {
 OptRef<const envoy::config::core::v3::RetryPolicy> optionalRetryPolicy(
     const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config);
 
+/**
+ * @return the size of the tag and length of a length-delimited field.
+ */
+uint64_t fieldHeaderSize(uint32_t field_number, uint64_t size);
+
+/**
+ * Appends the tag and length of a length-delimited field to buffer. The field's content is expected
+ * to follow.
+ */
+void serializeFieldHeader(uint32_t field_number, uint64_t size, Buffer::Instance& buffer);
+
+/**
+ * Appends message to buffer in the protobuf wire format, as the content of the nested
+ * length-delimited fields field_numbers, outermost first. A concatenation of such encodings parses
+ * as a single message, in which each message is an element of the innermost repeated field as long
+ * as the fields around it are not repeated.
+ */
+void serializeNestedMessage(const Protobuf::Message& message,
+                            absl::Span<const uint32_t> field_numbers, Buffer::Instance& buffer);
+
 }
 } // namespace AccessLoggers
 } // namespace Extensions
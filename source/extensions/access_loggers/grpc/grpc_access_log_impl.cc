@@ -15,6 +15,20 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace GrpcCommon {
 
+namespace {
+
+using envoy::service::accesslog::v3::StreamAccessLogsMessage;
+
+// The fields the HTTP and TCP entries are nested in.
+constexpr uint32_t HttpLogEntryFieldNumbers[] = {
+    StreamAccessLogsMessage::kHttpLogsFieldNumber,
+    StreamAccessLogsMessage::HTTPAccessLogEntries::kLogEntryFieldNumber};
+constexpr uint32_t TcpLogEntryFieldNumbers[] = {
+    StreamAccessLogsMessage::kTcpLogsFieldNumber,
+    StreamAccessLogsMessage::TCPAccessLogEntries::kLogEntryFieldNumber};
+
+} // namespace
+
 GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
     const Grpc::RawAsyncClientSharedPtr& client,
     const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
@@ -25,15 +39,11 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
       log_name_(config.log_name()), local_info_(local_info) {}
 
 void GrpcAccessLoggerImpl::addEntry(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) {
-  message_.mutable_http_logs()->mutable_log_entry()->Add(std::move(entry));
+  serializeEntry(entry, HttpLogEntryFieldNumbers);
 }
 
 void GrpcAccessLoggerImpl::addEntry(envoy::data::accesslog::v3::TCPAccessLogEntry&& entry) {
-  message_.mutable_tcp_logs()->mutable_log_entry()->Add(std::move(entry));
-}
-
-bool GrpcAccessLoggerImpl::isEmpty() {
-  return !message_.has_http_logs() && !message_.has_tcp_logs();
+  serializeEntry(entry, TcpLogEntryFieldNumbers);
 }
 
 void GrpcAccessLoggerImpl::initMessage() {
@@ -7,6 +7,7 @@
 
 #include "source/common/config/utility.h"
 #include "source/common/grpc/typed_async_client.h"
+#include "source/extensions/access_loggers/common/grpc_access_logger_utils.h"
 
 #include "opentelemetry/proto/collector/logs/v1/logs_service.pb.h"
 #include "opentelemetry/proto/common/v1/common.pb.h"
@@ -34,6 +35,13 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
 
 namespace {
 
+using opentelemetry::proto::collector::logs::v1::ExportLogsServiceRequest;
+using opentelemetry::proto::logs::v1::ResourceLogs;
+using opentelemetry::proto::logs::v1::ScopeLogs;
+
+// The log records are serialized as the log_records field of the ScopeLogs.
+constexpr uint32_t LogRecordFieldNumbers[] = {ScopeLogs::kLogRecordsFieldNumber};
+
 opentelemetry::proto::common::v1::KeyValue getStringKeyValue(const std::string& key,
                                                              const std::string& value) {
   opentelemetry::proto::common::v1::KeyValue keyValue;
@@ -50,7 +58,6 @@ void GrpcAccessLoggerImpl::initMessageRoot(
         config,
     const LocalInfo::LocalInfo& local_info) {
   auto* resource_logs = message_.add_resource_logs();
-  root_ = resource_logs->add_scope_logs();
   auto* resource = resource_logs->mutable_resource();
   *resource->add_attributes() = getStringKeyValue("log_name", config.common_config().log_name());
   *resource->add_attributes() = getStringKeyValue("zone_name", local_info.zoneName());
@@ -63,15 +70,29 @@ void GrpcAccessLoggerImpl::initMessageRoot(
 }
 
 void GrpcAccessLoggerImpl::addEntry(opentelemetry::proto::logs::v1::LogRecord&& entry) {
-  root_->mutable_log_records()->Add(std::move(entry));
+  serializeEntry(entry, LogRecordFieldNumbers);
 }
 
-bool GrpcAccessLoggerImpl::isEmpty() { return root_->log_records().empty(); }
-
-// The message is already initialized in the c'tor, and only the logs are cleared.
+// The message is already initialized in the c'tor, and is the same for every request.
 void GrpcAccessLoggerImpl::initMessage() {}
 
-void GrpcAccessLoggerImpl::clearMessage() { root_->clear_log_records(); }
+void GrpcAccessLoggerImpl::clearMessage() {}
+
+// The log records are nested in the single ScopeLogs of the single ResourceLogs, which are
+// repeated fields, so their lengths are written here including the serialized log records.
+void GrpcAccessLoggerImpl::serializeMessagePrefix(uint64_t entries_size, Buffer::Instance& buffer) {
+  const auto& resource_logs = message_.resource_logs(0);
+  // The ScopeLogs only holds the log records.
+  const uint64_t scope_logs_size = entries_size;
+  const uint64_t resource_logs_size =
+      resource_logs.ByteSizeLong() +
+      GrpcCommon::fieldHeaderSize(ResourceLogs::kScopeLogsFieldNumber, scope_logs_size) +
+      scope_logs_size;
+  GrpcCommon::serializeFieldHeader(ExportLogsServiceRequest::kResourceLogsFieldNumber,
+                                   resource_logs_size, buffer);
+  buffer.add(resource_logs.SerializeAsString());
+  GrpcCommon::serializeFieldHeader(ResourceLogs::kScopeLogsFieldNumber, scope_logs_size, buffer);
+}
 
 GrpcAccessLoggerCacheImpl::GrpcAccessLoggerCacheImpl(Grpc::AsyncClientManager& async_client_manager,
                                                      Stats::Scope& scope,
@@ -27,6 +27,8 @@ namespace OpenTelemetry {
 // structure:
 // ExportLogsServiceRequest -> (single) ResourceLogs -> (single) ScopeLogs ->
 // (repeated) LogRecord.
+// The ResourceLogs in `message_` holds everything but the ScopeLogs, which is written around the
+// log records serialized since the last flush.
 class GrpcAccessLoggerImpl
     : public Common::GrpcAccessLogger<
           opentelemetry::proto::logs::v1::LogRecord,
@@ -51,11 +53,11 @@ private:
   void addEntry(opentelemetry::proto::logs::v1::LogRecord&& entry) override;
   // Non used addEntry method (the above is used for both TCP and HTTP).
   void addEntry(ProtobufWkt::Empty&& entry) override { (void)entry; };
-  bool isEmpty() override;
+  // `message_` always holds the ResourceLogs, so only the log records count.
+  bool isEmpty() override { return !hasSerializedEntries(); }
   void initMessage() override;
   void clearMessage() override;
-
-  opentelemetry::proto::logs::v1::ScopeLogs* root_;
+  void serializeMessagePrefix(uint64_t entries_size, Buffer::Instance& buffer) override;
 };
 
 class GrpcAccessLoggerCacheImpl
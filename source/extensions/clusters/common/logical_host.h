@@ -101,6 +101,9 @@ public:
   }
   HostStats& stats() const override { return logical_host_->stats(); }
   LoadMetricStats& loadMetricStats() const override { return logical_host_->loadMetricStats(); }
+  HostLoad& load() const override { return logical_host_->load(); }
+  HostLbPolicyData* lbPolicyData() const override { return logical_host_->lbPolicyData(); }
+  void setLbPolicyData(HostLbPolicyDataPtr&&) override {}
   const std::string& hostnameForHealthChecks() const override {
     return logical_host_->hostnameForHealthChecks();
   }
@@ -33,8 +33,8 @@ using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
                          const std::string&, Stats::Scope&, TimeSource& time_source,
-                         HttpCache& http_cache)
-    : time_source_(time_source), cache_(http_cache),
+                         HttpCache& http_cache, RequestCoalescerSharedPtr coalescer)
+    : time_source_(time_source), cache_(http_cache), coalescer_(std::move(coalescer)),
       vary_allow_list_(config.allowed_vary_headers()) {}
 
 void CacheFilter::onDestroy() {
@@ -45,6 +45,9 @@ void CacheFilter::onDestroy() {
   if (insert_) {
     insert_->onDestroy();
   }
+  // A leader whose response was not inserted yet won't insert it now.
+  coalescing_leader_.reset();
+  coalescing_waiter_.reset();
 }
 
 void CacheFilter::onStreamComplete() {
@@ -79,6 +82,9 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  if (coalescer_ != nullptr && request_allows_inserts_ && !is_head_request_) {
+    coalescing_key_ = lookup_request.key();
+  }
   lookup_ = cache_.makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -106,9 +112,10 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     // Filter chain iteration is paused while a lookup is outstanding, but the filter chain manager
     // can still generate a local reply. One case where this can happen is when a downstream idle
     // timeout fires, which may mean that the HttpCache isn't correctly setting deadlines on its
-    // asynchronous operations or is otherwise getting stuck.
-    ENVOY_BUG(Http::Utility::getResponseStatus(headers) !=
-                  Envoy::enumToInt(Http::Code::RequestTimeout),
+    // asynchronous operations or is otherwise getting stuck. Waiting for a coalesced request, on
+    // the other hand, may legitimately outlast the stream's timeouts.
+    ENVOY_BUG(coalescing_waiter_ != nullptr || Http::Utility::getResponseStatus(headers) !=
+                                                   Envoy::enumToInt(Http::Code::RequestTimeout),
               "Request timed out while cache lookup was outstanding.");
     filter_state_ = FilterState::NotServingFromCache;
     return Http::FilterHeadersStatus::Continue;
@@ -138,7 +145,7 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     // chunks to the cache if we're already in a failure state and should abort, but we can only do
     // that if we can communicate failures back to the filter, so we should fix this.
     insert_->insertHeaders(
-        headers, metadata, [](bool) {}, end_stream);
+        headers, metadata, end_stream ? releaseLeaderOnComplete() : [](bool) {}, end_stream);
     if (end_stream) {
       insert_status_ = InsertStatus::InsertSucceeded;
     }
@@ -146,6 +153,8 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     // insertion yet.
   } else {
     insert_status_ = InsertStatus::NoInsertResponseNotCacheable;
+    // Any requests waiting for this one will find nothing in cache and go upstream themselves.
+    coalescing_leader_.reset();
   }
   filter_state_ = FilterState::NotServingFromCache;
   return Http::FilterHeadersStatus::Continue;
@@ -165,7 +174,7 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     ENVOY_STREAM_LOG(debug, "CacheFilter::encodeData inserting body", *encoder_callbacks_);
     // TODO(toddmgreer): Wait for the cache if necessary.
     insert_->insertBody(
-        data, [](bool) {}, end_stream);
+        data, end_stream ? releaseLeaderOnComplete() : [](bool) {}, end_stream);
     if (end_stream) {
       insert_status_ = InsertStatus::InsertSucceeded;
     }
@@ -188,7 +197,7 @@ Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::ResponseTrailerMap&
   response_has_trailers_ = !trailers.empty();
   if (insert_) {
     ENVOY_STREAM_LOG(debug, "CacheFilter::encodeTrailers inserting trailers", *encoder_callbacks_);
-    insert_->insertTrailers(trailers, [](bool) {});
+    insert_->insertTrailers(trailers, releaseLeaderOnComplete());
   }
   insert_status_ = InsertStatus::InsertSucceeded;
 
@@ -379,6 +388,13 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
 
   // TODO(yosrym93): Handle request only-if-cached directive
   lookup_result_ = std::make_unique<LookupResult>(std::move(result));
+  if (waitForLeader(request_headers)) {
+    return;
+  }
+  handleLookupResult(request_headers);
+}
+
+void CacheFilter::handleLookupResult(Http::RequestHeaderMap& request_headers) {
   switch (lookup_result_->cache_entry_status_) {
   case CacheEntryStatus::FoundNotModified:
     PANIC("unsupported code");
@@ -411,6 +427,65 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
   decoder_callbacks_->continueDecoding();
 }
 
+bool CacheFilter::waitForLeader(Http::RequestHeaderMap& request_headers) {
+  if (!coalescing_key_.has_value() ||
+      (lookup_result_->cache_entry_status_ != CacheEntryStatus::Unusable &&
+       lookup_result_->cache_entry_status_ != CacheEntryStatus::RequiresValidation)) {
+    return false;
+  }
+  // A request joins at most once: after the wait it either finds the leader's response in cache,
+  // or goes upstream itself.
+  const Key key = std::move(coalescing_key_.value());
+  coalescing_key_.reset();
+  RequestCoalescer::Membership membership =
+      coalescer_->join(key, decoder_callbacks_->dispatcher(),
+                       [this, &request_headers](bool timed_out) {
+                         onLeaderDone(request_headers, timed_out);
+                       });
+  coalescing_leader_ = std::move(membership.leader_);
+  coalescing_waiter_ = std::move(membership.waiter_);
+  if (coalescing_waiter_ == nullptr) {
+    return false;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for a coalesced request", *decoder_callbacks_);
+  coalesced_lookup_result_ = std::move(lookup_result_);
+  return true;
+}
+
+void CacheFilter::onLeaderDone(Http::RequestHeaderMap& request_headers, bool timed_out) {
+  // The wait is over, so the stream's timeouts apply to the cache again. This is called by the
+  // waiter, which is released once the call has returned.
+  decoder_callbacks_->dispatcher().post([waiter = std::move(coalescing_waiter_)] {});
+  if (filter_state_ == FilterState::NotServingFromCache) {
+    // A response was injected into the filter chain while waiting.
+    return;
+  }
+  if (timed_out) {
+    ENVOY_STREAM_LOG(debug, "CacheFilter timed out waiting for a coalesced request",
+                     *decoder_callbacks_);
+    coalescer_->stats().coalesced_request_timeouts_.inc();
+    lookup_result_ = std::move(coalesced_lookup_result_);
+    handleLookupResult(request_headers);
+    return;
+  }
+  // The leader is done, so its response is most likely in cache now.
+  coalesced_lookup_result_.reset();
+  lookup_->onDestroy();
+  lookup_ = cache_.makeLookupContext(
+      LookupRequest(request_headers, time_source_.systemTime(), vary_allow_list_),
+      *decoder_callbacks_);
+  getHeaders(request_headers);
+}
+
+std::function<void(bool)> CacheFilter::releaseLeaderOnComplete() {
+  if (coalescing_leader_ == nullptr) {
+    return [](bool) {};
+  }
+  // The cache may call this on any thread, and after the filter is destroyed.
+  return [leader = std::make_shared<RequestCoalescer::LeaderPtr>(std::move(coalescing_leader_))](
+             bool) { leader->reset(); };
+}
+
 // TODO(toddmgreer): Handle downstream backpressure.
 void CacheFilter::onBody(Buffer::InstancePtr&& body) {
   // Can be called during decoding if a valid cache hit is found,
@@ -567,9 +642,10 @@ void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_
     // TODO(yosrym93): else the cached entry should be deleted.
     // Update metadata associated with the cached response. Right now this is only response_time;
     const ResponseMetadata metadata = {time_source_.systemTime()};
-    cache_.updateHeaders(*lookup_, response_headers, metadata,
-                         [](bool updated ABSL_ATTRIBUTE_UNUSED) {});
+    cache_.updateHeaders(*lookup_, response_headers, metadata, releaseLeaderOnComplete());
     insert_status_ = InsertStatus::HeaderUpdate;
+  } else {
+    coalescing_leader_.reset();
   }
 
   // A cache entry was successfully validated -> encode cached body and trailers.
@@ -11,6 +11,7 @@
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -54,7 +55,7 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              HttpCache& http_cache);
+              HttpCache& http_cache, RequestCoalescerSharedPtr coalescer = nullptr);
   // Http::StreamFilterBase
   void onDestroy() override;
   void onStreamComplete() override;
@@ -81,6 +82,20 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Acts on lookup_result_ once any wait for a coalesced request is over.
+  void handleLookupResult(Http::RequestHeaderMap& request_headers);
+
+  // If request coalescing is enabled and lookup_result_ means the request has to go upstream,
+  // joins the other requests for the same key. Returns true if the request waits for the leader.
+  bool waitForLeader(Http::RequestHeaderMap& request_headers);
+
+  // Called when the wait started by waitForLeader is over.
+  void onLeaderDone(Http::RequestHeaderMap& request_headers, bool timed_out);
+
+  // Returns a callback for the final insert or header update, which releases the waiting requests
+  // when the cache has been updated.
+  std::function<void(bool)> releaseLeaderOnComplete();
+
   // Set required state in the CacheFilter for handling a cache hit.
   void handleCacheHit();
 
@@ -128,6 +143,7 @@ private:
 
   TimeSource& time_source_;
   HttpCache& cache_;
+  const RequestCoalescerSharedPtr coalescer_;
   LookupContextPtr lookup_;
   InsertContextPtr insert_;
   LookupResultPtr lookup_result_;
@@ -154,6 +170,14 @@ private:
   FilterState filter_state_ = FilterState::Initial;
 
   bool is_head_request_ = false;
+
+  // The cache key of the request, kept for request coalescing.
+  absl::optional<Key> coalescing_key_;
+  // Set while the request leads the requests for its key, or waits for their leader.
+  RequestCoalescer::LeaderPtr coalescing_leader_;
+  RequestCoalescer::WaiterSharedPtr coalescing_waiter_;
+  // The result of the lookup that missed, set aside while waiting for the leader.
+  LookupResultPtr coalesced_lookup_result_;
   // The status of the insert operation or header update, or decision not to insert or update.
   // If it's too early to determine the final status, this is empty.
   absl::optional<InsertStatus> insert_status_;
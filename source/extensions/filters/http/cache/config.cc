@@ -20,10 +20,19 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
 
   auto cache = http_cache_factory->getCache(config, context);
 
-  return [config, stats_prefix, &context,
-          cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(), *cache));
+  // Shared by the filters of all workers, so that requests are coalesced across workers.
+  RequestCoalescerSharedPtr coalescer;
+  if (config.has_collapsed_forwarding()) {
+    coalescer = std::make_shared<RequestCoalescer>(
+        std::chrono::milliseconds(
+            PROTOBUF_GET_MS_OR_DEFAULT(config.collapsed_forwarding(), max_wait, 5000)),
+        stats_prefix, context.scope());
+  }
+
+  return [config, stats_prefix, &context, cache,
+          coalescer](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<CacheFilter>(
+        config, stats_prefix, context.scope(), context.timeSource(), *cache, coalescer));
   };
 }
 
@@ -0,0 +1,65 @@
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+RequestCoalescer::Waiter::Waiter(Event::Dispatcher& dispatcher,
+                                 std::chrono::milliseconds max_wait, WaitCallback cb)
+    : cb_(std::move(cb)),
+      timer_(dispatcher.createTimer([this] { done(true); })) {
+  timer_->enableTimer(max_wait);
+}
+
+void RequestCoalescer::Waiter::done(bool timed_out) {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  timer_->disableTimer();
+  cb_(timed_out);
+}
+
+RequestCoalescer::RequestCoalescer(std::chrono::milliseconds max_wait,
+                                   const std::string& stats_prefix, Stats::Scope& scope)
+    : max_wait_(max_wait),
+      stats_({ALL_CACHE_COALESCING_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix + "cache."))}) {}
+
+RequestCoalescer::Membership RequestCoalescer::join(const Key& key, Event::Dispatcher& dispatcher,
+                                                    WaitCallback cb) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = in_flight_.try_emplace(key);
+  if (inserted) {
+    return {std::make_unique<Leader>(shared_from_this(), key), nullptr};
+  }
+  stats_.coalesced_requests_.inc();
+  auto waiter = std::make_shared<Waiter>(dispatcher, max_wait_, std::move(cb));
+  it->second.push_back({dispatcher, waiter});
+  return {nullptr, std::move(waiter)};
+}
+
+void RequestCoalescer::release(const Key& key) {
+  std::vector<PendingWaiter> waiters;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = in_flight_.find(key);
+    ASSERT(it != in_flight_.end());
+    waiters = std::move(it->second);
+    in_flight_.erase(it);
+  }
+  // The leader may be released on any thread, and a waiter may only be used and destroyed on the
+  // thread of its dispatcher, so each waiter is woken up there and held weakly until then.
+  for (PendingWaiter& pending : waiters) {
+    pending.dispatcher_.post([weak_waiter = std::move(pending.waiter_)] {
+      if (WaiterSharedPtr waiter = weak_waiter.lock()) {
+        waiter->done(false);
+      }
+    });
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All cache filter request coalescing stats. @see stats_macros.h
+ */
+#define ALL_CACHE_COALESCING_STATS(COUNTER)                                                        \
+  COUNTER(coalesced_requests)                                                                      \
+  COUNTER(coalesced_request_timeouts)
+
+/**
+ * Struct definition for cache filter request coalescing stats. @see stats_macros.h
+ */
+struct CacheCoalescingStats {
+  ALL_CACHE_COALESCING_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Collapses concurrent cache misses for the same key, from any worker, into a single upstream
+ * request. The first request to miss becomes the leader for the key; requests that miss while it
+ * is in flight wait until the leader has finished filling the cache, or until max_wait has
+ * elapsed, before looking the key up again.
+ */
+class RequestCoalescer : public std::enable_shared_from_this<RequestCoalescer> {
+public:
+  // Called with true if the wait timed out, or false once the leader is done.
+  using WaitCallback = std::function<void(bool timed_out)>;
+
+  /**
+   * Held by the leader for a key while its response is being fetched and inserted. Destroying it,
+   * from any thread, wakes up the waiting requests.
+   */
+  class Leader {
+  public:
+    Leader(std::shared_ptr<RequestCoalescer> coalescer, const Key& key)
+        : coalescer_(std::move(coalescer)), key_(key) {}
+    ~Leader() { coalescer_->release(key_); }
+
+  private:
+    const std::shared_ptr<RequestCoalescer> coalescer_;
+    const Key key_;
+  };
+  using LeaderPtr = std::unique_ptr<Leader>;
+
+  /**
+   * Held by a request waiting for a leader. Must be created and destroyed on the thread of its
+   * dispatcher, which is where the callback runs; destroying it stops the wait.
+   */
+  class Waiter {
+  public:
+    Waiter(Event::Dispatcher& dispatcher, std::chrono::milliseconds max_wait, WaitCallback cb);
+
+  private:
+    friend class RequestCoalescer;
+    void done(bool timed_out);
+
+    const WaitCallback cb_;
+    const Event::TimerPtr timer_;
+    bool done_ = false;
+  };
+  using WaiterSharedPtr = std::shared_ptr<Waiter>;
+
+  // Exactly one of leader_ and waiter_ is set.
+  struct Membership {
+    LeaderPtr leader_;
+    WaiterSharedPtr waiter_;
+  };
+
+  RequestCoalescer(std::chrono::milliseconds max_wait, const std::string& stats_prefix,
+                   Stats::Scope& scope);
+
+  /**
+   * Joins the requests for key. If no other request for the key is in flight, the caller becomes
+   * its leader. Otherwise cb is called on the caller's dispatcher when the leader is done or
+   * max_wait has elapsed, whichever comes first.
+   */
+  Membership join(const Key& key, Event::Dispatcher& dispatcher, WaitCallback cb);
+
+  CacheCoalescingStats& stats() { return stats_; }
+
+private:
+  void release(const Key& key);
+
+  struct PendingWaiter {
+    Event::Dispatcher& dispatcher_;
+    std::weak_ptr<Waiter> waiter_;
+  };
+
+  const std::chrono::milliseconds max_wait_;
+  CacheCoalescingStats stats_;
+  absl::Mutex mutex_;
+  // The waiters of each key that has a leader. Waiters that timed out or were destroyed are left
+  // in place until the leader is done.
+  absl::flat_hash_map<Key, std::vector<PendingWaiter>, MessageUtil, MessageUtil>
+      in_flight_ ABSL_GUARDED_BY(mutex_);
+};
+
+using RequestCoalescerSharedPtr = std::shared_ptr<RequestCoalescer>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
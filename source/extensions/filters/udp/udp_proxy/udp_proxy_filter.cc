@@ -256,6 +256,12 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
       cluster.filter_.read_callbacks_->udpListener().dispatcher(),
       [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
       Event::FileReadyType::Read);
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_proxy_batch_upstream_writes")) {
+    batch_writer_ = std::make_unique<Network::UdpBatchWriter>(socket_->ioHandle(), true);
+    flush_writes_cb_ =
+        cluster.filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+            [this] { flushUpstreamWrites(); });
+  }
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -288,6 +294,9 @@ UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
+  if (batch_writer_ != nullptr && batch_writer_->bufferedDatagrams() > 0) {
+    flushUpstreamWrites();
+  }
   cluster_.filter_.config_->stats().downstream_sess_active_.dec();
   cluster_.cluster_.info()
       ->resourceManager(Upstream::ResourcePriority::Default)
@@ -401,6 +410,13 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
 
     skip_connect_ = true;
   }
+  if (batch_writer_ != nullptr) {
+    batch_writer_->write(buffer);
+    if (!flush_writes_cb_->enabled()) {
+      flush_writes_cb_->scheduleCallbackCurrentIteration();
+    }
+    return;
+  }
   Api::IoCallUint64Result rc =
       Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
   if (!rc.ok()) {
@@ -411,6 +427,18 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   }
 }
 
+void UdpProxyFilter::ActiveSession::flushUpstreamWrites() {
+  const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
+  const Network::UdpBatchWriter::FlushResult result =
+      batch_writer_->flush(local_ip, *host_->address());
+  ENVOY_LOG(trace, "flushed {} datagrams upstream, dropped {}: downstream={} upstream={}",
+            result.datagrams_sent_, result.datagrams_dropped_, addresses_.peer_->asStringView(),
+            host_->address()->asStringView());
+  cluster_.cluster_stats_.sess_tx_datagrams_.add(result.datagrams_sent_);
+  cluster_.cluster_stats_.sess_tx_errors_.add(result.datagrams_dropped_);
+  cluster_.cluster_.info()->trafficStats()->upstream_cx_tx_bytes_total_.add(result.bytes_sent_);
+}
+
 void UdpProxyFilter::ActiveSession::processPacket(Network::Address::InstanceConstSharedPtr,
                                                   Network::Address::InstanceConstSharedPtr,
                                                   Buffer::InstancePtr buffer, MonotonicTime) {
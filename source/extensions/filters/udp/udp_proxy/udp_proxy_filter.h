@@ -3,6 +3,7 @@
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/accesslog/v3/accesslog.pb.h"
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/network/filter.h"
@@ -15,6 +16,7 @@
 #include "source/common/common/random_generator.h"
 #include "source/common/network/socket_impl.h"
 #include "source/common/network/socket_interface.h"
+#include "source/common/network/udp_batch_writer.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
@@ -204,6 +206,7 @@ private:
   private:
     void onIdleTimer();
     void onReadReady();
+    void flushUpstreamWrites();
     void fillSessionStreamInfo();
 
     // Network::UdpPacketProcessor
@@ -247,6 +250,10 @@ private:
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     const Network::SocketPtr socket_;
+    // If envoy.reloadable_features.udp_proxy_batch_upstream_writes is set, datagrams written to the
+    // upstream host are buffered and sent together at the end of the dispatcher loop iteration.
+    std::unique_ptr<Network::UdpBatchWriter> batch_writer_;
+    Event::SchedulableCallbackPtr flush_writes_cb_;
     // The socket should be connected to avoid port exhaustion unless runtime guard
     // envoy.reloadable_features.udp_proxy_connect is unset or use_original_src_ip_ is set. If it
     // is true, there will be no calling `connect()` on the socket.
@@ -68,6 +68,16 @@ bool CacheEvictionThread::waitForSignal() {
   return !terminating_;
 }
 
+void CacheShared::addToIndexFromFilename(absl::string_view filename, uint64_t file_size) {
+  if (index_ == nullptr) {
+    return;
+  }
+  const absl::optional<uint64_t> key_hash = CacheIndex::keyHashFromFilename(filename);
+  if (key_hash.has_value()) {
+    addToIndex(key_hash.value(), file_size);
+  }
+}
+
 void CacheShared::initStats() {
   if (config_.has_max_cache_size_bytes()) {
     stats_.size_limit_bytes_.set(config_.max_cache_size_bytes().value());
@@ -75,13 +85,30 @@ void CacheShared::initStats() {
   if (config_.has_max_cache_entry_count()) {
     stats_.size_limit_count_.set(config_.max_cache_entry_count().value());
   }
-  // TODO(ravenblack): Add support for directory tree structure.
-  for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(std::string{cachePath()})) {
-    if (!isCacheFile(entry)) {
-      continue;
+  if (index_ != nullptr && index_->loadedClean()) {
+    // The index was closed cleanly, so it matches the cache directory and there is no need
+    // to scan it.
+    size_count_ += index_->entryCount();
+    size_bytes_ += index_->totalBytes();
+  } else {
+    // TODO(ravenblack): Add support for directory tree structure.
+    for (const Filesystem::DirectoryEntry& entry :
+         Filesystem::Directory(std::string{cachePath()})) {
+      if (!isCacheFile(entry)) {
+        continue;
+      }
+      size_count_++;
+      size_bytes_ += entry.size_bytes_.value_or(0);
+      addToIndexFromFilename(entry.name_, entry.size_bytes_.value_or(0));
+    }
+    if (index_ != nullptr) {
+      if (index_->overflowed()) {
+        ENVOY_LOG(warn, "cache index for {} is full, lookups will use the filesystem",
+                  cachePath());
+      } else {
+        index_ready_ = true;
+      }
     }
-    size_count_++;
-    size_bytes_ += entry.size_bytes_.value_or(0);
   }
   stats_.size_count_.set(size_count_);
   stats_.size_bytes_.set(size_bytes_);
@@ -107,6 +134,8 @@ void CacheShared::evict() {
     }
     count++;
     size += entry.size_bytes_.value_or(0);
+    // Files may have been added by another process using the same cache.
+    addToIndexFromFilename(entry.name_, entry.size_bytes_.value_or(0));
     struct stat s;
     if (os_sys_calls.stat(absl::StrCat(cachePath(), entry.name_).c_str(), &s).return_value_ != -1) {
 #ifdef _DARWIN_FEATURE_64_BIT_INODE
@@ -152,6 +181,10 @@ void CacheShared::evict() {
       // and the eviction thread will be churning, trying and failing to remove a file, which would
       // be worth logging a warning, versus if the file is already gone then there's no problem.
       trackFileRemoved(it->size_);
+      const absl::optional<uint64_t> key_hash = CacheIndex::keyHashFromFilename(it->name_);
+      if (key_hash.has_value()) {
+        removeFromIndex(key_hash.value());
+      }
     }
     ++it;
   }
@@ -0,0 +1,306 @@
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+namespace {
+constexpr std::array<char, 4> FileId = {'C', 'I', 'D', 'X'};
+// Changing the version invalidates existing index files, which are then cleared and rebuilt
+// from the cache directory.
+constexpr uint32_t Version = 1;
+constexpr uint64_t EmptyHash = 0;
+constexpr uint64_t TombstoneHash = 1;
+// 2M slots of 16 bytes; the file is sparse, so unused slots take no disk space.
+constexpr uint64_t DefaultCapacity = 1 << 21;
+constexpr uint64_t MinCapacity = 1 << 10;
+constexpr uint64_t MaxCapacity = 1 << 30;
+
+// Keys which hash to a reserved slot value share a slot hash with another key. The index
+// may then report a false hit, which is harmless.
+uint64_t slotHash(uint64_t key_hash) {
+  return key_hash <= TombstoneHash ? key_hash + TombstoneHash + 1 : key_hash;
+}
+} // namespace
+
+// The layout of the index file. The header is followed by capacity_ slots.
+struct CacheIndex::Header {
+  std::array<char, 4> file_id_;
+  uint32_t version_;
+  uint64_t capacity_;
+  // 1 if the index was closed cleanly; set to 0 while the index is in use.
+  std::atomic<uint64_t> clean_;
+  std::atomic<uint64_t> entry_count_;
+  std::atomic<uint64_t> total_bytes_;
+  // Slots which are either in use or tombstones.
+  std::atomic<uint64_t> used_slots_;
+};
+
+struct CacheIndex::Slot {
+  std::atomic<uint64_t> key_hash_;
+  std::atomic<uint64_t> file_size_;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the cache index requires lock-free atomics to be shared between processes");
+
+std::unique_ptr<CacheIndex> CacheIndex::create(const std::string& path, uint64_t capacity) {
+  ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const uint64_t mapping_size = sizeof(Header) + capacity * sizeof(Slot);
+  const Api::SysCallIntResult open_result =
+      os_sys_calls.open(path.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+  if (open_result.return_value_ == -1) {
+    ENVOY_LOG(warn, "failed to open cache index {}: {}", path, errorDetails(open_result.errno_));
+    return nullptr;
+  }
+  const int fd = open_result.return_value_;
+  struct stat s;
+  if (os_sys_calls.fstat(fd, &s).return_value_ == -1 ||
+      static_cast<uint64_t>(s.st_size) != mapping_size) {
+    // Truncating to zero first discards any previous contents, so the file reads as zeroes,
+    // which is an empty table.
+    Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(fd, 0);
+    if (truncate_result.return_value_ != -1) {
+      truncate_result = os_sys_calls.ftruncate(fd, mapping_size);
+    }
+    if (truncate_result.return_value_ == -1) {
+      ENVOY_LOG(warn, "failed to resize cache index {}: {}", path,
+                errorDetails(truncate_result.errno_));
+      os_sys_calls.close(fd);
+      return nullptr;
+    }
+  }
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mmap_result.return_value_ == MAP_FAILED) {
+    ENVOY_LOG(warn, "failed to map cache index {}: {}", path, errorDetails(mmap_result.errno_));
+    os_sys_calls.close(fd);
+    return nullptr;
+  }
+  auto index = std::unique_ptr<CacheIndex>(
+      new CacheIndex(fd, mmap_result.return_value_, mapping_size, capacity));
+  index->load();
+  return index;
+}
+
+CacheIndex::CacheIndex(int fd, void* mapping, uint64_t mapping_size, uint64_t capacity)
+    : fd_(fd), mapping_(mapping), mapping_size_(mapping_size), capacity_(capacity),
+      header_(static_cast<Header*>(mapping)),
+      slots_(reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header))) {}
+
+CacheIndex::~CacheIndex() {
+  if (!overflowed_) {
+    header_->clean_.store(1);
+  }
+  munmap(mapping_, mapping_size_);
+  Api::OsSysCallsSingleton::get().close(fd_);
+}
+
+uint64_t CacheIndex::capacityForEntries(absl::optional<uint64_t> max_entries) {
+  if (!max_entries.has_value()) {
+    return DefaultCapacity;
+  }
+  // Twice the limit leaves room for the cache to briefly exceed it before eviction, and
+  // keeps probe sequences short.
+  uint64_t capacity = MinCapacity;
+  while (capacity < MaxCapacity && capacity / 2 < max_entries.value()) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+absl::optional<uint64_t> CacheIndex::keyHashFromFilename(absl::string_view filename) {
+  uint64_t key_hash;
+  if (!absl::ConsumePrefix(&filename, "cache-") || !absl::SimpleAtoi(filename, &key_hash)) {
+    return absl::nullopt;
+  }
+  return key_hash;
+}
+
+void CacheIndex::load() {
+  const bool valid = header_->file_id_ == FileId && header_->version_ == Version &&
+                     header_->capacity_ == capacity_;
+  loaded_clean_ = valid && header_->clean_.exchange(0) == 1;
+  if (!loaded_clean_) {
+    clear();
+    header_->file_id_ = FileId;
+    header_->version_ = Version;
+    header_->capacity_ = capacity_;
+    return;
+  }
+  if (header_->used_slots_.load() - header_->entry_count_.load() > capacity_ / 8) {
+    absl::MutexLock lock(&mu_);
+    compact();
+  }
+}
+
+void CacheIndex::clear() {
+  header_->clean_.store(0);
+  for (uint64_t i = 0; i < capacity_; i++) {
+    slots_[i].key_hash_.store(EmptyHash, std::memory_order_relaxed);
+    slots_[i].file_size_.store(0, std::memory_order_relaxed);
+  }
+  header_->entry_count_.store(0);
+  header_->total_bytes_.store(0);
+  header_->used_slots_.store(0);
+}
+
+void CacheIndex::compact() {
+  std::vector<std::pair<uint64_t, uint64_t>> entries;
+  entries.reserve(header_->entry_count_.load());
+  for (uint64_t i = 0; i < capacity_; i++) {
+    const uint64_t hash = slots_[i].key_hash_.load();
+    if (hash != EmptyHash && hash != TombstoneHash) {
+      entries.emplace_back(hash, slots_[i].file_size_.load());
+    }
+  }
+  clear();
+  for (const auto& [hash, file_size] : entries) {
+    insertLocked(hash, file_size);
+  }
+}
+
+absl::optional<uint64_t> CacheIndex::find(uint64_t key_hash) const {
+  const uint64_t hash = slotHash(key_hash);
+  absl::ReaderMutexLock lock(&mu_);
+  for (uint64_t i = 0; i < capacity_; i++) {
+    const Slot& slot = slots_[(hash + i) & (capacity_ - 1)];
+    const uint64_t slot_hash = slot.key_hash_.load();
+    if (slot_hash == hash) {
+      return slot.file_size_.load();
+    }
+    if (slot_hash == EmptyHash) {
+      break;
+    }
+  }
+  return absl::nullopt;
+}
+
+bool CacheIndex::insert(uint64_t key_hash, uint64_t file_size) {
+  const uint64_t hash = slotHash(key_hash);
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    if (insertLocked(hash, file_size)) {
+      return true;
+    }
+  }
+  absl::MutexLock lock(&mu_);
+  // Tombstones count as used slots, so reclaim them before giving up, unless the index already
+  // overflowed and will be cleared when next opened anyway.
+  if (header_->used_slots_.load() > header_->entry_count_.load() && !overflowed_) {
+    compact();
+  }
+  if (insertLocked(hash, file_size)) {
+    return true;
+  }
+  overflowed_ = true;
+  return false;
+}
+
+bool CacheIndex::insertLocked(uint64_t hash, uint64_t file_size) {
+  while (true) {
+    Slot* free_slot = nullptr;
+    uint64_t free_slot_hash = EmptyHash;
+    for (uint64_t i = 0; i < capacity_; i++) {
+      Slot& slot = slots_[(hash + i) & (capacity_ - 1)];
+      const uint64_t slot_hash = slot.key_hash_.load();
+      if (slot_hash == hash) {
+        const uint64_t old_size = slot.file_size_.exchange(file_size);
+        // Unsigned arithmetic wraps, so this also handles a smaller size.
+        header_->total_bytes_ += file_size - old_size;
+        return true;
+      }
+      if (slot_hash == TombstoneHash && free_slot == nullptr) {
+        // Reuse the first tombstone, but keep probing in case the key is further along.
+        free_slot = &slot;
+        free_slot_hash = TombstoneHash;
+      } else if (slot_hash == EmptyHash) {
+        if (free_slot == nullptr) {
+          // Keep a quarter of the slots empty so that probe sequences stay short.
+          if (header_->used_slots_.load() >= maxUsedSlots()) {
+            return false;
+          }
+          free_slot = &slot;
+        }
+        break;
+      }
+    }
+    if (free_slot == nullptr) {
+      return false;
+    }
+    if (!free_slot->key_hash_.compare_exchange_strong(free_slot_hash, hash)) {
+      // Another thread or process took the slot; probe again, as it may have been
+      // inserting the same key.
+      continue;
+    }
+    if (free_slot_hash == EmptyHash) {
+      header_->used_slots_++;
+    }
+    free_slot->file_size_.store(file_size);
+    header_->entry_count_++;
+    header_->total_bytes_ += file_size;
+    return true;
+  }
+}
+
+absl::optional<uint64_t> CacheIndex::remove(uint64_t key_hash) {
+  const uint64_t hash = slotHash(key_hash);
+  absl::ReaderMutexLock lock(&mu_);
+  for (uint64_t i = 0; i < capacity_; i++) {
+    uint64_t position = (hash + i) & (capacity_ - 1);
+    Slot& slot = slots_[position];
+    uint64_t slot_hash = slot.key_hash_.load();
+    if (slot_hash == hash) {
+      const uint64_t file_size = slot.file_size_.load();
+      if (!slot.key_hash_.compare_exchange_strong(slot_hash, TombstoneHash)) {
+        // Removed concurrently by another thread or process.
+        return absl::nullopt;
+      }
+      header_->entry_count_--;
+      header_->total_bytes_ -= file_size;
+      // No probe sequence continues past a tombstone followed by an empty slot, so it and the
+      // tombstones before it can be emptied, and stop counting as used. An insert racing with
+      // this may be left unreachable, which is a false miss.
+      if (slots_[(position + 1) & (capacity_ - 1)].key_hash_.load() == EmptyHash) {
+        uint64_t tombstone_hash = TombstoneHash;
+        while (slots_[position].key_hash_.compare_exchange_strong(tombstone_hash, EmptyHash)) {
+          header_->used_slots_--;
+          position = (position - 1) & (capacity_ - 1);
+          tombstone_hash = TombstoneHash;
+        }
+      }
+      return file_size;
+    }
+    if (slot_hash == EmptyHash) {
+      break;
+    }
+  }
+  return absl::nullopt;
+}
+
+uint64_t CacheIndex::entryCount() const { return header_->entry_count_.load(); }
+
+uint64_t CacheIndex::totalBytes() const { return header_->total_bytes_.load(); }
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
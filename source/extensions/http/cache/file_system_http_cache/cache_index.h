@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+/**
+ * CacheIndex is a memory-mapped, persistent hash table from the stable hash of a cache key
+ * to the size of its cache entry file. It allows lookups to detect a cache miss without
+ * touching the filesystem, and allows the cache size to be known at startup without
+ * scanning the cache directory.
+ *
+ * The table uses open addressing with linear probing in a file of fixed capacity. Slots
+ * are updated with atomic operations, so the index may be shared with another process
+ * using the same cache (e.g. during hot restart); in that case the index is only a hint,
+ * as updates from the two processes may race, but every inconsistency is either a false
+ * hit (the file open fails and the entry is removed) or a false miss (the response is
+ * fetched and inserted again).
+ *
+ * See DESIGN.md for how the index is kept in sync with the cache directory.
+ */
+class CacheIndex : public Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  /**
+   * Opens the index at the given path, creating it if it doesn't exist. If the existing
+   * file has a different capacity or format, or was not closed cleanly, it is cleared.
+   * @param path the path of the index file.
+   * @param capacity the number of slots in the table. Must be a power of two.
+   * @return the index, or nullptr if the file could not be opened or mapped.
+   */
+  static std::unique_ptr<CacheIndex> create(const std::string& path, uint64_t capacity);
+
+  /**
+   * Marks the index as clean, unless an insert failed, and unmaps it.
+   */
+  ~CacheIndex();
+
+  /**
+   * @return the table capacity to use for a cache with the given entry count limit, or
+   *     for a cache with no limit if max_entries is nullopt.
+   */
+  static uint64_t capacityForEntries(absl::optional<uint64_t> max_entries);
+
+  /**
+   * @param filename the name of a cache entry file, without path.
+   * @return the key hash the file was named after, or nullopt if the name is not that of
+   *     a cache entry file.
+   */
+  static absl::optional<uint64_t> keyHashFromFilename(absl::string_view filename);
+
+  /**
+   * @return true if the index was closed cleanly by its previous user, and its contents
+   *     can be trusted to match the cache directory without a scan.
+   */
+  bool loadedClean() const { return loaded_clean_; }
+
+  /**
+   * @param key_hash the stable hash of a cache key.
+   * @return the size of the cache entry file, or nullopt if the key is not in the index.
+   */
+  absl::optional<uint64_t> find(uint64_t key_hash) const ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Adds an entry to the index, or updates the size of an existing entry.
+   * @param key_hash the stable hash of a cache key.
+   * @param file_size the size of the cache entry file.
+   * @return false if the index is full, in which case it no longer reflects the cache
+   *     directory and will be cleared when next opened.
+   */
+  bool insert(uint64_t key_hash, uint64_t file_size) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Removes an entry from the index.
+   * @param key_hash the stable hash of a cache key.
+   * @return the size of the removed entry, or nullopt if the key was not in the index.
+   */
+  absl::optional<uint64_t> remove(uint64_t key_hash) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return true if an insert failed because the index was full.
+   */
+  bool overflowed() const { return overflowed_; }
+
+  /**
+   * @return the number of entries in the index.
+   */
+  uint64_t entryCount() const;
+
+  /**
+   * @return the sum of the file sizes of the entries in the index.
+   */
+  uint64_t totalBytes() const;
+
+  /**
+   * @return the number of slots in the table.
+   */
+  uint64_t capacity() const { return capacity_; }
+
+  static constexpr absl::string_view filename() { return "file-cache-index"; }
+
+private:
+  struct Header;
+  struct Slot;
+
+  CacheIndex(int fd, void* mapping, uint64_t mapping_size, uint64_t capacity);
+
+  // Clears the table unless the mapped file is a valid index of this capacity that was
+  // closed cleanly, then marks it as in use.
+  void load();
+  void clear();
+  // Rewrites the table without its tombstones. Must be called with mu_ held exclusively.
+  void compact() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns false if there was no free slot for the entry.
+  bool insertLocked(uint64_t hash, uint64_t file_size) ABSL_SHARED_LOCKS_REQUIRED(mu_);
+  uint64_t maxUsedSlots() const { return capacity_ / 4 * 3; }
+
+  const int fd_;
+  void* const mapping_;
+  const uint64_t mapping_size_;
+  const uint64_t capacity_;
+  Header* const header_;
+  Slot* const slots_;
+  bool loaded_clean_ = false;
+  std::atomic<bool> overflowed_ = false;
+
+  // Lookups and updates share the lock and synchronize through atomic operations on the
+  // slots; it is only held exclusively while the table is compacted.
+  mutable absl::Mutex mu_;
+};
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
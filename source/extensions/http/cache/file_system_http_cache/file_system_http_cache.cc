@@ -35,8 +35,8 @@ void FileSystemHttpCache::writeVaryNodeToDisk(const Key& key,
   h->set_value(absl::StrJoin(vary_values, ","));
   std::string filename = absl::StrCat(cachePath(), generateFilename(key));
   async_file_manager_->createAnonymousFile(
-      cachePath(), [headers, filename = std::move(filename),
-                    cleanup](absl::StatusOr<AsyncFileHandle> open_result) {
+      cachePath(), [headers, filename = std::move(filename), cleanup, shared = shared_,
+                    key_hash = stableHashKey(key)](absl::StatusOr<AsyncFileHandle> open_result) {
         if (!open_result.ok()) {
           ENVOY_LOG(warn, "writing vary node, failed to createAnonymousFile: {}",
                     open_result.status());
@@ -52,17 +52,20 @@ void FileSystemHttpCache::writeVaryNodeToDisk(const Key& key,
         size_t sz = buf2.length();
         auto queued = file_handle->write(
             buf2, 0,
-            [file_handle, cleanup, sz,
-             filename = std::move(filename)](absl::StatusOr<size_t> write_result) {
+            [file_handle, cleanup, sz, filename = std::move(filename), shared,
+             key_hash](absl::StatusOr<size_t> write_result) {
               if (!write_result.ok() || write_result.value() != sz) {
                 ENVOY_LOG(warn, "writing vary node, failed to write: {}", write_result.status());
                 file_handle->close([](absl::Status) {}).IgnoreError();
                 return;
               }
               auto queued = file_handle->createHardLink(
-                  filename, [cleanup, file_handle](absl::Status link_result) {
+                  filename,
+                  [cleanup, file_handle, shared, key_hash, sz](absl::Status link_result) {
                     if (!link_result.ok()) {
                       ENVOY_LOG(warn, "writing vary node, failed to link: {}", link_result);
+                    } else {
+                      shared->addToIndex(key_hash, sz);
                     }
                     file_handle->close([](absl::Status) {}).IgnoreError();
                   });
@@ -87,7 +90,19 @@ FileSystemHttpCache::FileSystemHttpCache(
 }
 
 CacheShared::CacheShared(ConfigProto config, Stats::Scope& stats_scope)
-    : config_(config), stats_(generateStats(stats_scope, cachePath())) {}
+    : config_(config), stats_(generateStats(stats_scope, cachePath())) {
+  if (config_.persistent_index()) {
+    absl::optional<uint64_t> max_entries;
+    if (config_.has_max_cache_entry_count()) {
+      max_entries = config_.max_cache_entry_count().value();
+    }
+    index_ = CacheIndex::create(absl::StrCat(cachePath(), CacheIndex::filename()),
+                                CacheIndex::capacityForEntries(max_entries));
+    // An index that was closed cleanly is usable immediately; otherwise it is rebuilt
+    // by the eviction thread's initial scan of the cache directory.
+    index_ready_ = index_ != nullptr && index_->loadedClean();
+  }
+}
 
 FileSystemHttpCache::~FileSystemHttpCache() { cache_eviction_thread_.removeCache(shared_); }
 
@@ -388,6 +403,35 @@ void CacheShared::trackFileRemoved(uint64_t file_size) {
   stats_.size_bytes_.set(size_bytes_);
 }
 
+bool FileSystemHttpCache::mayContain(const Key& key) const {
+  return shared_->mayContain(stableHashKey(key));
+}
+bool CacheShared::mayContain(uint64_t key_hash) const {
+  return !index_ready_ || index_->find(key_hash).has_value();
+}
+
+void FileSystemHttpCache::addToIndex(const Key& key, uint64_t file_size) {
+  shared_->addToIndex(stableHashKey(key), file_size);
+}
+void CacheShared::addToIndex(uint64_t key_hash, uint64_t file_size) {
+  if (index_ == nullptr) {
+    return;
+  }
+  if (!index_->insert(key_hash, file_size) && index_ready_.exchange(false)) {
+    ENVOY_LOG(warn, "cache index for {} is full, lookups will use the filesystem until restart",
+              cachePath());
+  }
+}
+
+void FileSystemHttpCache::removeFromIndex(const Key& key) {
+  shared_->removeFromIndex(stableHashKey(key));
+}
+void CacheShared::removeFromIndex(uint64_t key_hash) {
+  if (index_ != nullptr) {
+    index_->remove(key_hash);
+  }
+}
+
 bool CacheShared::needsEviction() const {
   if (config_.has_max_cache_size_bytes() && size_bytes_ > config_.max_cache_size_bytes().value()) {
     return true;
@@ -7,6 +7,7 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/common/async_files/async_file_manager.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
 #include "source/extensions/http/cache/file_system_http_cache/stats.h"
 
 #include "absl/base/thread_annotations.h"
@@ -177,6 +178,27 @@ public:
    */
   void trackFileRemoved(uint64_t file_size);
 
+  /**
+   * Returns false if the cache index is in use and has no entry for the given key, in
+   * which case there is no cache entry file for the key and the lookup is a miss.
+   * @param key the key to check.
+   * @return false if the key is known not to be in the cache.
+   */
+  bool mayContain(const Key& key) const;
+
+  /**
+   * Updates the cache index, if any, to reflect that a cache entry file has been added.
+   * @param key the key of the cache entry.
+   * @param file_size The size in bytes of the file that was added.
+   */
+  void addToIndex(const Key& key, uint64_t file_size);
+
+  /**
+   * Updates the cache index, if any, to reflect that a cache entry file has been removed.
+   * @param key the key of the cache entry.
+   */
+  void removeFromIndex(const Key& key);
+
   // UpdateHeaders copies an existing cache entry to a new file. This value is
   // the size of a copy-chunk. It's public for unit tests only, as the chunk size
   // is totally irrelevant to the outward-facing API.
@@ -230,7 +252,7 @@ private:
 // This part of the cache implementation is shared between CacheEvictionThread and
 // FileSystemHttpCache. The implementation of CacheShared is also split between the
 // two implementation files, accordingly.
-struct CacheShared {
+struct CacheShared : public Logger::Loggable<Logger::Id::cache_filter> {
   CacheShared(ConfigProto config, Stats::Scope& stats_scope);
   const ConfigProto config_;
   CacheStats stats_;
@@ -244,6 +266,11 @@ struct CacheShared {
   std::atomic<uint64_t> size_count_ = 0;
   std::atomic<uint64_t> size_bytes_ = 0;
   bool needs_init_ = true;
+  // Present if the persistent_index config is set and the index file could be opened.
+  std::unique_ptr<CacheIndex> index_;
+  // True when index_ reflects the cache directory, so that keys missing from the index can
+  // be treated as misses. Until then, and if the index fills up, lookups use the filesystem.
+  std::atomic<bool> index_ready_ = false;
 
   /**
    * @return true if the eviction thread should do a pass over this cache.
@@ -268,6 +295,33 @@ struct CacheShared {
    */
   void trackFileRemoved(uint64_t file_size);
 
+  /**
+   * @param key_hash the stable hash of a cache key.
+   * @return false if the index is ready and has no entry for the key.
+   */
+  bool mayContain(uint64_t key_hash) const;
+
+  /**
+   * Adds or updates an entry in the index, if any.
+   * @param key_hash the stable hash of the cache key.
+   * @param file_size The size in bytes of the cache entry file.
+   */
+  void addToIndex(uint64_t key_hash, uint64_t file_size);
+
+  /**
+   * Removes an entry from the index, if any.
+   * @param key_hash the stable hash of the cache key.
+   */
+  void removeFromIndex(uint64_t key_hash);
+
+  /**
+   * Adds an entry to the index, if any, for a cache entry file found in the cache
+   * directory. Runs in the CacheEvictionThread.
+   * @param filename the name of the file, without path.
+   * @param file_size The size in bytes of the file.
+   */
+  void addToIndexFromFilename(absl::string_view filename, uint64_t file_size);
+
   /**
    * Performs an eviction pass over this cache. Runs in the CacheEvictionThread.
    */
@@ -279,6 +279,7 @@ void InsertOperationQueue::commit(std::shared_ptr<InsertOperationQueue> p,
                           uint64_t file_size =
                               header_block_.offsetToTrailers() + header_block_.trailerSize();
                           cache_->trackFileAdded(file_size);
+                          cache_->addToIndex(key_, file_size);
                           // By clearing cleanup before destructor, we prevent logging an error.
                           cleanup_ = nullptr;
                         });
@@ -28,12 +28,21 @@ void FileLookupContext::getHeaders(LookupHeadersCallback&& cb) {
 
 void FileLookupContext::getHeadersWithLock(LookupHeadersCallback cb) {
   mu_.AssertHeld();
+  if (!cache_.mayContain(key_)) {
+    // The cache index has no entry for the key, so there is no file to open.
+    cb(LookupResult{});
+    return;
+  }
   cancel_action_in_flight_ = cache_.asyncFileManager()->openExistingFile(
       filepath(), Common::AsyncFiles::AsyncFileManager::Mode::ReadOnly,
       [this, cb](absl::StatusOr<AsyncFileHandle> open_result) {
         absl::MutexLock lock(&mu_);
         cancel_action_in_flight_ = nullptr;
         if (!open_result.ok()) {
+          if (absl::IsNotFound(open_result.status())) {
+            // The index may be out of date, e.g. if the file was removed by another process.
+            cache_.removeFromIndex(key_);
+          }
           cb(LookupResult{});
           return;
         }
@@ -105,17 +114,19 @@ void FileLookupContext::getHeadersWithLock(LookupHeadersCallback cb) {
 
 void FileLookupContext::invalidateCacheEntry() {
   cache_.asyncFileManager()->stat(
-      filepath(), [file = filepath(),
-                   cache = cache_.shared_from_this()](absl::StatusOr<struct stat> stat_result) {
+      filepath(), [file = filepath(), cache = cache_.shared_from_this(),
+                   key = key_](absl::StatusOr<struct stat> stat_result) {
         size_t file_size = 0;
         if (stat_result.ok()) {
           file_size = stat_result.value().st_size;
         }
-        cache->asyncFileManager()->unlink(file, [cache, file_size](absl::Status unlink_result) {
-          if (unlink_result.ok()) {
-            cache->trackFileRemoved(file_size);
-          }
-        });
+        cache->asyncFileManager()->unlink(
+            file, [cache, file_size, key](absl::Status unlink_result) {
+              if (unlink_result.ok()) {
+                cache->trackFileRemoved(file_size);
+                cache->removeFromIndex(key);
+              }
+            });
       });
 }
 
@@ -31,24 +31,39 @@ absl::optional<Key> variedRequestKey(const LookupRequest& request,
   return varied_request_key;
 }
 
+uint64_t entrySize(const Http::ResponseHeaderMap& response_headers, const std::string& body,
+                   const Http::ResponseTrailerMap* trailers) {
+  return response_headers.byteSize() + body.size() + (trailers ? trailers->byteSize() : 0);
+}
+
 class SimpleLookupContext : public LookupContext {
 public:
   SimpleLookupContext(SimpleHttpCache& cache, LookupRequest&& request)
-      : cache_(cache), request_(std::move(request)) {}
+      : cache_(cache), request_(std::move(request)), key_hash_(stableHashKey(request_.key())) {}
 
   void getHeaders(LookupHeadersCallback&& cb) override {
-    auto entry = cache_.lookup(request_);
+    auto entry = cache_.lookup(request_, key_hash_);
     body_ = std::move(entry.body_);
     trailers_ = std::move(entry.trailers_);
     cb(entry.response_headers_ ? request_.makeLookupResult(std::move(entry.response_headers_),
-                                                           std::move(entry.metadata_), body_.size(),
-                                                           trailers_ != nullptr)
+                                                           std::move(entry.metadata_),
+                                                           body_->size(), trailers_ != nullptr)
                                : LookupResult{});
   }
 
   void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
-    ASSERT(range.end() <= body_.length(), "Attempt to read past end of body.");
-    cb(std::make_unique<Buffer::OwnedImpl>(&body_[range.begin()], range.length()));
+    ASSERT(range.end() <= body_->length(), "Attempt to read past end of body.");
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      // The fragment references the cached body, which it keeps alive until the buffer is drained.
+      auto* fragment = new Buffer::BufferFragmentImpl(
+          body_->data() + range.begin(), range.length(),
+          [body = body_](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+            delete this_fragment;
+          });
+      buffer->addBufferFragment(*fragment);
+    }
+    cb(std::move(buffer));
   }
 
   // The cache must call cb with the cached trailers.
@@ -58,12 +73,14 @@ public:
   }
 
   const LookupRequest& request() const { return request_; }
+  uint64_t keyHash() const { return key_hash_; }
   void onDestroy() override {}
 
 private:
   SimpleHttpCache& cache_;
   const LookupRequest request_;
-  std::string body_;
+  const uint64_t key_hash_;
+  std::shared_ptr<const std::string> body_;
   Http::ResponseTrailerMapPtr trailers_;
 };
 
@@ -71,6 +88,7 @@ class SimpleInsertContext : public InsertContext {
 public:
   SimpleInsertContext(LookupContext& lookup_context, SimpleHttpCache& cache)
       : key_(dynamic_cast<SimpleLookupContext&>(lookup_context).request().key()),
+        key_hash_(dynamic_cast<SimpleLookupContext&>(lookup_context).keyHash()),
         request_headers_(
             dynamic_cast<SimpleLookupContext&>(lookup_context).request().requestHeaders()),
         vary_allow_list_(
@@ -115,17 +133,19 @@ public:
 private:
   bool commit() {
     committed_ = true;
+    auto body = std::make_shared<const std::string>(body_.toString());
     if (VaryHeaderUtils::hasVary(*response_headers_)) {
-      return cache_.varyInsert(key_, std::move(response_headers_), std::move(metadata_),
-                               body_.toString(), request_headers_, vary_allow_list_,
+      return cache_.varyInsert(key_, key_hash_, std::move(response_headers_), std::move(metadata_),
+                               std::move(body), request_headers_, vary_allow_list_,
                                std::move(trailers_));
     } else {
-      return cache_.insert(key_, std::move(response_headers_), std::move(metadata_),
-                           body_.toString(), std::move(trailers_));
+      return cache_.insert(key_, key_hash_, std::move(response_headers_), std::move(metadata_),
+                           std::move(body), std::move(trailers_));
     }
   }
 
   Key key_;
+  const uint64_t key_hash_;
   const Http::RequestHeaderMap& request_headers_;
   const VaryAllowList& vary_allow_list_;
   Http::ResponseHeaderMapPtr response_headers_;
@@ -137,6 +157,12 @@ private:
 };
 } // namespace
 
+SimpleHttpCache::SimpleHttpCache(const SimpleHttpCacheConfig& config)
+    : config_(config),
+      max_shard_size_bytes_(
+          (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_cache_size_bytes, 0) + ShardCount - 1) /
+          ShardCount) {}
+
 LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request,
                                                     Http::StreamDecoderFilterCallbacks&) {
   return std::make_unique<SimpleLookupContext>(*this, std::move(request));
@@ -148,97 +174,117 @@ void SimpleHttpCache::updateHeaders(const LookupContext& lookup_context,
                                     std::function<void(bool)> on_complete) {
   const auto& simple_lookup_context = static_cast<const SimpleLookupContext&>(lookup_context);
   const Key& key = simple_lookup_context.request().key();
-  absl::WriterMutexLock lock(&mutex_);
-  auto iter = map_.find(key);
-  if (iter == map_.end() || !iter->second.response_headers_) {
-    on_complete(false);
-    return;
-  }
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    absl::optional<Key> varied_key =
-        variedRequestKey(simple_lookup_context.request(), *iter->second.response_headers_);
-    if (!varied_key.has_value()) {
+  const uint64_t key_hash = simple_lookup_context.keyHash();
+  absl::optional<Key> varied_key;
+  {
+    Shard& key_shard = shard(key_hash);
+    absl::WriterMutexLock lock(&key_shard.mutex_);
+    StoredEntry* stored = find(key_shard, key, key_hash);
+    if (stored == nullptr) {
       on_complete(false);
       return;
     }
-    iter = map_.find(varied_key.value());
-    if (iter == map_.end() || !iter->second.response_headers_) {
-      on_complete(false);
+    if (!VaryHeaderUtils::hasVary(*stored->entry_.response_headers_)) {
+      updateStoredEntry(key_shard, *stored, response_headers, metadata);
+      on_complete(true);
       return;
     }
+    varied_key =
+        variedRequestKey(simple_lookup_context.request(), *stored->entry_.response_headers_);
   }
-  Entry& entry = iter->second;
-
-  applyHeaderUpdate(response_headers, *entry.response_headers_);
-  entry.metadata_ = metadata;
+  if (!varied_key.has_value()) {
+    on_complete(false);
+    return;
+  }
+  // The varied response is in the shard of the varied key.
+  const uint64_t varied_key_hash = stableHashKey(varied_key.value());
+  Shard& varied_key_shard = shard(varied_key_hash);
+  absl::WriterMutexLock lock(&varied_key_shard.mutex_);
+  StoredEntry* stored = find(varied_key_shard, varied_key.value(), varied_key_hash);
+  if (stored == nullptr) {
+    on_complete(false);
+    return;
+  }
+  updateStoredEntry(varied_key_shard, *stored, response_headers, metadata);
   on_complete(true);
 }
 
-SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
-    return Entry{};
+SimpleHttpCache::StoredEntry* SimpleHttpCache::find(Shard& shard, const Key& key,
+                                                    uint64_t key_hash) {
+  auto iter = shard.map_.find(key_hash);
+  if (iter == shard.map_.end() || !MessageUtil()(iter->second->key_, key)) {
+    return nullptr;
   }
-  ASSERT(iter->second.response_headers_);
-
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
-  } else {
-    Http::ResponseTrailerMapPtr trailers_map;
-    if (iter->second.trailers_) {
-      trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
+  ASSERT(iter->second->entry_.response_headers_);
+  iter->second->referenced_.store(true, std::memory_order_relaxed);
+  return iter->second.get();
+}
+
+SimpleHttpCache::Entry SimpleHttpCache::copyEntry(const Entry& entry) {
+  Http::ResponseTrailerMapPtr trailers_map;
+  if (entry.trailers_) {
+    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*entry.trailers_);
+  }
+  return SimpleHttpCache::Entry{
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+      entry.metadata_, entry.body_, std::move(trailers_map)};
+}
+
+SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request, uint64_t key_hash) {
+  Http::ResponseHeaderMapPtr vary_headers;
+  {
+    Shard& key_shard = shard(key_hash);
+    absl::ReaderMutexLock lock(&key_shard.mutex_);
+    const StoredEntry* stored = find(key_shard, request.key(), key_hash);
+    if (stored == nullptr) {
+      return Entry{};
+    }
+    if (!VaryHeaderUtils::hasVary(*stored->entry_.response_headers_)) {
+      return copyEntry(stored->entry_);
     }
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+    // The varied response is in the shard of the varied key, which is looked up without holding
+    // this shard's lock.
+    vary_headers =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*stored->entry_.response_headers_);
   }
+  return varyLookup(request, *vary_headers);
 }
 
-bool SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
-                             ResponseMetadata&& metadata, std::string&& body,
+bool SimpleHttpCache::insert(const Key& key, uint64_t key_hash,
+                             Http::ResponseHeaderMapPtr&& response_headers,
+                             ResponseMetadata&& metadata, std::shared_ptr<const std::string>&& body,
                              Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] = SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
-                                     std::move(body), std::move(trailers)};
-  return true;
+  return store(key, key_hash,
+               SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                      std::move(body), std::move(trailers)});
 }
 
 SimpleHttpCache::Entry
 SimpleHttpCache::varyLookup(const LookupRequest& request,
-                            const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
-  absl::optional<Key> varied_key = variedRequestKey(request, *response_headers);
+                            const Http::ResponseHeaderMap& response_headers) {
+  absl::optional<Key> varied_key = variedRequestKey(request, response_headers);
   if (!varied_key.has_value()) {
     return SimpleHttpCache::Entry{};
   }
-  Key& varied_request_key = varied_key.value();
+  const Key& varied_request_key = varied_key.value();
+  const uint64_t varied_key_hash = stableHashKey(varied_request_key);
 
-  auto iter = map_.find(varied_request_key);
-  if (iter == map_.end()) {
+  Shard& varied_key_shard = shard(varied_key_hash);
+  absl::ReaderMutexLock lock(&varied_key_shard.mutex_);
+  const StoredEntry* stored = find(varied_key_shard, varied_request_key, varied_key_hash);
+  if (stored == nullptr) {
     return SimpleHttpCache::Entry{};
   }
-  ASSERT(iter->second.response_headers_);
-  Http::ResponseTrailerMapPtr trailers_map;
-  if (iter->second.trailers_) {
-    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-  }
-
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+  return copyEntry(stored->entry_);
 }
 
-bool SimpleHttpCache::varyInsert(const Key& request_key,
+bool SimpleHttpCache::varyInsert(const Key& request_key, uint64_t key_hash,
                                  Http::ResponseHeaderMapPtr&& response_headers,
-                                 ResponseMetadata&& metadata, std::string&& body,
+                                 ResponseMetadata&& metadata,
+                                 std::shared_ptr<const std::string>&& body,
                                  const Http::RequestHeaderMap& request_headers,
                                  const VaryAllowList& vary_allow_list,
                                  Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-
   absl::btree_set<absl::string_view> vary_header_values =
       VaryHeaderUtils::getVaryValues(*response_headers);
   ASSERT(!vary_header_values.empty());
@@ -251,29 +297,114 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
     // Skip the insert if we are unable to create a vary key.
     return false;
   }
+  const std::string vary_header_value = absl::StrJoin(vary_header_values, ",");
 
   varied_request_key.add_custom_fields(vary_identifier.value());
-  map_[varied_request_key] = SimpleHttpCache::Entry{
-      std::move(response_headers), std::move(metadata), std::move(body), std::move(trailers)};
+  if (!store(varied_request_key, stableHashKey(varied_request_key),
+             SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                    std::move(body), std::move(trailers)})) {
+    return false;
+  }
 
   // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
-    Envoy::Http::ResponseHeaderMapPtr vary_only_map =
-        Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
-    vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
-                           absl::StrJoin(vary_header_values, ","));
-    // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
-    // we have inserted as the body for this first lookup. This way, we would know which keys we
-    // have inserted for that resource. For the first entry simply use vary_identifier as the
-    // entry_list; for future entries append vary_identifier to existing list.
-    std::string entry_list;
-    map_[request_key] =
-        SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}};
+  {
+    Shard& key_shard = shard(key_hash);
+    absl::ReaderMutexLock lock(&key_shard.mutex_);
+    if (find(key_shard, request_key, key_hash) != nullptr) {
+      return true;
+    }
   }
+  Envoy::Http::ResponseHeaderMapPtr vary_only_map =
+      Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
+  vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary, vary_header_value);
+  // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
+  // we have inserted as the body for this first lookup. This way, we would know which keys we
+  // have inserted for that resource. For the first entry simply use vary_identifier as the
+  // entry_list; for future entries append vary_identifier to existing list.
+  store(request_key, key_hash,
+        SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::make_shared<const std::string>(),
+                               {}});
   return true;
 }
 
+bool SimpleHttpCache::store(const Key& key, uint64_t key_hash, Entry&& entry) {
+  const uint64_t size_bytes =
+      entrySize(*entry.response_headers_, *entry.body_, entry.trailers_.get());
+  if (max_shard_size_bytes_ != 0 && size_bytes > max_shard_size_bytes_) {
+    // The entry would evict everything else in its shard, and then itself.
+    return false;
+  }
+  Shard& key_shard = shard(key_hash);
+  absl::WriterMutexLock lock(&key_shard.mutex_);
+  auto existing = key_shard.map_.find(key_hash);
+  if (existing != key_shard.map_.end()) {
+    key_shard.size_bytes_ -= existing->second->size_bytes_;
+    key_shard.clock_.erase(existing->second->clock_position_);
+    key_shard.map_.erase(existing);
+  }
+  // Evicting before inserting keeps the new entry, which nothing has referenced yet, from being
+  // the one evicted when every other entry has been referenced.
+  evict(key_shard, size_bytes);
+  auto stored = std::make_unique<StoredEntry>();
+  stored->key_ = key;
+  stored->entry_ = std::move(entry);
+  stored->size_bytes_ = size_bytes;
+  stored->clock_position_ = key_shard.clock_.insert(key_shard.clock_.end(), key_hash);
+  key_shard.size_bytes_ += size_bytes;
+  key_shard.map_[key_hash] = std::move(stored);
+  return true;
+}
+
+void SimpleHttpCache::updateStoredEntry(Shard& shard, StoredEntry& stored,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const ResponseMetadata& metadata) {
+  applyHeaderUpdate(response_headers, *stored.entry_.response_headers_);
+  stored.entry_.metadata_ = metadata;
+  const uint64_t size_bytes = entrySize(*stored.entry_.response_headers_, *stored.entry_.body_,
+                                        stored.entry_.trailers_.get());
+  // Unsigned arithmetic wraps, so this also handles headers that got smaller.
+  shard.size_bytes_ += size_bytes - stored.size_bytes_;
+  stored.size_bytes_ = size_bytes;
+}
+
+void SimpleHttpCache::evict(Shard& shard, uint64_t incoming_bytes) {
+  if (max_shard_size_bytes_ == 0) {
+    return;
+  }
+  // Every entry skipped over has its referenced_ flag cleared, so this takes at most two passes
+  // through the clock. store() rejects entries larger than the budget, so the clock can't run out.
+  while (shard.size_bytes_ + incoming_bytes > max_shard_size_bytes_) {
+    ASSERT(!shard.clock_.empty());
+    auto iter = shard.map_.find(shard.clock_.front());
+    ASSERT(iter != shard.map_.end());
+    if (iter->second->referenced_.exchange(false, std::memory_order_relaxed)) {
+      shard.clock_.splice(shard.clock_.end(), shard.clock_, shard.clock_.begin());
+      continue;
+    }
+    shard.size_bytes_ -= iter->second->size_bytes_;
+    shard.clock_.pop_front();
+    shard.map_.erase(iter);
+  }
+}
+
+uint64_t SimpleHttpCache::entryCount() {
+  uint64_t count = 0;
+  for (Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    count += shard.map_.size();
+  }
+  return count;
+}
+
+uint64_t SimpleHttpCache::sizeBytes() {
+  uint64_t size_bytes = 0;
+  for (Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    size_bytes += shard.size_bytes_;
+  }
+  return size_bytes;
+}
+
 InsertContextPtr SimpleHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
                                                     Http::StreamEncoderFilterCallbacks&) {
   ASSERT(lookup_context != nullptr);
@@ -296,20 +427,22 @@ public:
   std::string name() const override { return std::string(Name); }
   // From TypedFactory
   ProtobufTypes::MessagePtr createEmptyConfigProto() override {
-    return std::make_unique<
-        envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig>();
+    return std::make_unique<SimpleHttpCacheConfig>();
   }
   // From HttpCacheFactory
   std::shared_ptr<HttpCache>
-  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig&,
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
            Server::Configuration::FactoryContext& context) override {
-    return context.singletonManager().getTyped<SimpleHttpCache>(
-        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), &createCache);
-  }
-
-private:
-  static std::shared_ptr<Singleton::Instance> createCache() {
-    return std::make_shared<SimpleHttpCache>();
+    SimpleHttpCacheConfig config;
+    MessageUtil::unpackTo(filter_config.typed_config(), config);
+    std::shared_ptr<SimpleHttpCache> cache = context.singletonManager().getTyped<SimpleHttpCache>(
+        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton),
+        [&config] { return std::make_shared<SimpleHttpCache>(config); });
+    if (!Protobuf::util::MessageDifferencer::Equals(cache->config(), config)) {
+      throw EnvoyException(fmt::format("mismatched SimpleHttpCacheConfig\n{}\nvs.\n{}",
+                                       cache->config().DebugString(), config.DebugString()));
+    }
+    return cache;
   }
 };
 
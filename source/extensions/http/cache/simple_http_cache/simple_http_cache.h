@@ -1,5 +1,13 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
+
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 
@@ -12,19 +20,66 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
+using SimpleHttpCacheConfig =
+    envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig;
+
+// In-memory cache backend. Entries are spread over independently locked shards by the stable hash
+// of their key, and the least recently used entries of a shard are evicted when the shard exceeds
+// its share of max_cache_size_bytes.
 class SimpleHttpCache : public HttpCache, public Singleton::Instance {
 private:
   struct Entry {
     Http::ResponseHeaderMapPtr response_headers_;
     ResponseMetadata metadata_;
-    std::string body_;
+    // Shared with the lookups reading it, so that a body is never copied once inserted.
+    std::shared_ptr<const std::string> body_;
     Http::ResponseTrailerMapPtr trailers_;
   };
 
+  // An entry in a shard.
+  struct StoredEntry {
+    Key key_;
+    Entry entry_;
+    uint64_t size_bytes_;
+    // The entry's position in the shard's clock_.
+    std::list<uint64_t>::iterator clock_position_;
+    // Set by lookups, which only hold the shard lock for reading, and cleared by eviction.
+    std::atomic<bool> referenced_{false};
+  };
+
+  // Entries are keyed by the stable hash of their key, and the key itself is compared on lookup,
+  // so a hash collision only causes one of the colliding responses to replace the other.
+  struct Shard {
+    absl::Mutex mutex_;
+    absl::flat_hash_map<uint64_t, std::unique_ptr<StoredEntry>> map_ ABSL_GUARDED_BY(mutex_);
+    // The key hashes of the entries in insertion order. Eviction works through it as a CLOCK
+    // approximation of LRU: referenced entries get a second chance at the back of the list.
+    std::list<uint64_t> clock_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  };
+
+  static constexpr size_t ShardCount = 16;
+
+  Shard& shard(uint64_t key_hash) { return shards_[key_hash % ShardCount]; }
+
   // Looks for a response that has been varied. Only called from lookup.
-  Entry varyLookup(const LookupRequest& request,
-                   const Http::ResponseHeaderMapPtr& response_headers);
+  Entry varyLookup(const LookupRequest& request, const Http::ResponseHeaderMap& response_headers);
+
+  // Returns the entry for key, or nullptr if there is none, and marks it as referenced. Must be
+  // called with the shard lock held.
+  StoredEntry* find(Shard& shard, const Key& key, uint64_t key_hash)
+      ABSL_SHARED_LOCKS_REQUIRED(shard.mutex_);
+  static Entry copyEntry(const Entry& entry);
+
+  // Stores an entry, replacing any entry with the same key hash, after evicting entries until it
+  // fits in the shard's size budget. Returns false if the entry alone exceeds the budget.
+  bool store(const Key& key, uint64_t key_hash, Entry&& entry);
+  void updateStoredEntry(Shard& shard, StoredEntry& stored,
+                         const Http::ResponseHeaderMap& response_headers,
+                         const ResponseMetadata& metadata)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+  // Evicts entries until incoming_bytes more fit in the shard's size budget.
+  void evict(Shard& shard, uint64_t incoming_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
 
   // A list of headers that we do not want to update upon validation
   // We skip these headers because either it's updated by other application logic
@@ -33,6 +88,9 @@ private:
   static const absl::flat_hash_set<Http::LowerCaseString> headersNotToUpdate();
 
 public:
+  SimpleHttpCache() : SimpleHttpCache(SimpleHttpCacheConfig()) {}
+  explicit SimpleHttpCache(const SimpleHttpCacheConfig& config);
+
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request,
                                      Http::StreamDecoderFilterCallbacks& callbacks) override;
@@ -44,19 +102,32 @@ public:
                      std::function<void(bool)> on_complete) override;
   CacheInfo cacheInfo() const override;
 
-  Entry lookup(const LookupRequest& request);
-  bool insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
-              ResponseMetadata&& metadata, std::string&& body,
+  // The key_hash arguments are the stableHashKey() of the request's key, computed once per
+  // request by the lookup context.
+  Entry lookup(const LookupRequest& request, uint64_t key_hash);
+  bool insert(const Key& key, uint64_t key_hash, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, std::shared_ptr<const std::string>&& body,
               Http::ResponseTrailerMapPtr&& trailers);
 
   // Inserts a response that has been varied on certain headers.
-  bool varyInsert(const Key& request_key, Http::ResponseHeaderMapPtr&& response_headers,
-                  ResponseMetadata&& metadata, std::string&& body,
+  bool varyInsert(const Key& request_key, uint64_t key_hash,
+                  Http::ResponseHeaderMapPtr&& response_headers, ResponseMetadata&& metadata,
+                  std::shared_ptr<const std::string>&& body,
                   const Http::RequestHeaderMap& request_headers,
                   const VaryAllowList& vary_allow_list, Http::ResponseTrailerMapPtr&& trailers);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  const SimpleHttpCacheConfig& config() const { return config_; }
+
+  // The number of entries and their total size in bytes, including the entries flagging varied
+  // responses.
+  uint64_t entryCount();
+  uint64_t sizeBytes();
+
+private:
+  const SimpleHttpCacheConfig config_;
+  // The size budget of each shard, or 0 if the size is not limited.
+  const uint64_t max_shard_size_bytes_;
+  std::array<Shard, ShardCount> shards_;
 };
 
 } // namespace Cache
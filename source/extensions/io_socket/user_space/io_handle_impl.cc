@@ -242,6 +242,12 @@ Api::IoCallUint64Result IoHandleImpl::recvmmsg(RawSliceArrays&, uint32_t, RecvMs
   return Network::IoSocketError::ioResultSocketInvalidAddress();
 }
 
+Api::IoCallUint64Result IoHandleImpl::sendmmsg(const RawSliceArrays&, uint64_t,
+                                               const Network::Address::Ip*,
+                                               const Network::Address::Instance&) {
+  return Network::IoSocketError::ioResultSocketInvalidAddress();
+}
+
 Api::IoCallUint64Result IoHandleImpl::recv(void* buffer, size_t length, int flags) {
   if (!isOpen()) {
     return {0, Api::IoErrorPtr(new Network::IoSocketError(SOCKET_ERROR_BADF),
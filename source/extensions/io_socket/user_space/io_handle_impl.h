@@ -62,6 +62,9 @@ public:
                                   uint32_t self_port, RecvMsgOutput& output) override;
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                    RecvMsgOutput& output) override;
+  Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, uint64_t gso_size,
+                                   const Network::Address::Ip* self_ip,
+                                   const Network::Address::Instance& peer_address) override;
   Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
   bool supportsMmsg() const override;
   bool supportsUdpGro() const override;
@@ -0,0 +1,37 @@
+#include "source/extensions/load_balancing_policies/peak_ewma/config.h"
+
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+
+Upstream::ThreadAwareLoadBalancerPtr Factory::create(const Upstream::ClusterInfo& cluster_info,
+                                                     const Upstream::PrioritySet& priority_set,
+                                                     Runtime::Loader& runtime,
+                                                     Random::RandomGenerator& random,
+                                                     TimeSource& time_source) {
+
+  const auto* typed_config =
+      dynamic_cast<const envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma*>(
+          cluster_info.loadBalancingPolicy().get());
+
+  // The load balancing policy configuration will be loaded and validated in the main thread when we
+  // load the cluster configuration. So we can assume the configuration is valid here.
+  ASSERT(typed_config != nullptr,
+         "Invalid load balancing policy configuration for peak EWMA load balancer");
+
+  return std::make_unique<PeakEwmaThreadAwareLoadBalancer>(cluster_info, priority_set, runtime,
+                                                           random, time_source, *typed_config);
+}
+
+/**
+ * Static registration for the Factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(Factory, Upstream::TypedLoadBalancerFactory);
+
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
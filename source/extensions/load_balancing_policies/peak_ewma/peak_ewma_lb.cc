@@ -0,0 +1,131 @@
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include <cmath>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+
+PeakEwmaHostData::PeakEwmaHostData(std::chrono::nanoseconds decay_time, TimeSource& time_source)
+    : decay_time_ns_(decay_time.count()), time_source_(time_source), last_update_ns_(nowNs()) {}
+
+int64_t PeakEwmaHostData::nowNs() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time_source_.monotonicTime().time_since_epoch())
+      .count();
+}
+
+void PeakEwmaHostData::onResponseTime(std::chrono::microseconds response_time) {
+  const double rtt_us = response_time.count();
+  const int64_t now_ns = nowNs();
+  const int64_t elapsed_ns =
+      std::max<int64_t>(now_ns - last_update_ns_.exchange(now_ns, std::memory_order_relaxed), 0);
+  const double weight = std::exp(-elapsed_ns / decay_time_ns_);
+
+  // Concurrent updates are all applied, in some order, and each with the time elapsed since the
+  // one before it.
+  double ewma_us = ewma_us_.load(std::memory_order_relaxed);
+  double updated_us;
+  do {
+    updated_us =
+        ewma_us < 0 || rtt_us > ewma_us ? rtt_us : ewma_us * weight + rtt_us * (1 - weight);
+  } while (!ewma_us_.compare_exchange_weak(ewma_us, updated_us, std::memory_order_relaxed));
+}
+
+absl::optional<double> PeakEwmaHostData::ewma() const {
+  const double ewma_us = ewma_us_.load(std::memory_order_relaxed);
+  if (ewma_us < 0) {
+    return absl::nullopt;
+  }
+  // Decay the average towards 0 while no request completes, so that a host that was slow is
+  // eventually tried again.
+  const int64_t elapsed_ns =
+      std::max<int64_t>(nowNs() - last_update_ns_.load(std::memory_order_relaxed), 0);
+  return ewma_us * std::exp(-elapsed_ns / decay_time_ns_);
+}
+
+PeakEwmaLoadBalancer::PeakEwmaLoadBalancer(
+    const Upstream::PrioritySet& priority_set, const Upstream::PrioritySet* local_priority_set,
+    Upstream::ClusterLbStats& stats, Runtime::Loader& runtime, Random::RandomGenerator& random,
+    uint32_t healthy_panic_threshold, const PeakEwmaLbProto& config)
+    : ZoneAwareLoadBalancerBase(
+          priority_set, local_priority_set, stats, runtime, random, healthy_panic_threshold,
+          Upstream::LoadBalancerConfigHelper::localityLbConfigFromProto(config)),
+      choice_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, choice_count, 2)),
+      default_rtt_us_(PROTOBUF_GET_MS_OR_DEFAULT(config, default_rtt, 10) * 1000.0) {}
+
+double PeakEwmaLoadBalancer::cost(const Upstream::Host& host) const {
+  // Only this policy attaches data to the hosts of the cluster. It does so on the main thread, so a
+  // new host may be picked before it has any.
+  const auto* data = static_cast<const PeakEwmaHostData*>(host.lbPolicyData());
+  const double rtt_us = data != nullptr ? data->ewma().value_or(default_rtt_us_) : default_rtt_us_;
+  return rtt_us * (host.load().outstanding_requests_.load(std::memory_order_relaxed) + 1);
+}
+
+Upstream::HostConstSharedPtr
+PeakEwmaLoadBalancer::chooseHostOnce(Upstream::LoadBalancerContext* context) {
+  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random_.random());
+  if (!hosts_source) {
+    return nullptr;
+  }
+
+  const Upstream::HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+
+  Upstream::HostConstSharedPtr candidate_host =
+      hosts_to_use[random_.random() % hosts_to_use.size()];
+  double candidate_cost = cost(*candidate_host);
+  for (uint32_t choice_idx = 1; choice_idx < choice_count_; ++choice_idx) {
+    const Upstream::HostConstSharedPtr& sampled_host =
+        hosts_to_use[random_.random() % hosts_to_use.size()];
+    const double sampled_cost = cost(*sampled_host);
+    if (sampled_cost < candidate_cost) {
+      candidate_host = sampled_host;
+      candidate_cost = sampled_cost;
+    }
+  }
+  return candidate_host;
+}
+
+PeakEwmaThreadAwareLoadBalancer::PeakEwmaThreadAwareLoadBalancer(
+    const Upstream::ClusterInfo& cluster_info, const Upstream::PrioritySet& priority_set,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, TimeSource& time_source,
+    const PeakEwmaLbProto& config)
+    : priority_set_(priority_set), time_source_(time_source),
+      decay_time_(std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, decay_time, 10000))),
+      factory_(std::make_shared<LbFactory>(cluster_info, runtime, random, config)) {}
+
+void PeakEwmaThreadAwareLoadBalancer::initialize() {
+  for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+    addHostData(host_set->hosts());
+  }
+  member_update_cb_handle_ = priority_set_.addMemberUpdateCb(
+      [this](const Upstream::HostVector& hosts_added, const Upstream::HostVector&) {
+        addHostData(hosts_added);
+      });
+}
+
+void PeakEwmaThreadAwareLoadBalancer::addHostData(const Upstream::HostVector& hosts) {
+  for (const Upstream::HostSharedPtr& host : hosts) {
+    host->setLbPolicyData(std::make_unique<PeakEwmaHostData>(decay_time_, time_source_));
+  }
+}
+
+Upstream::LoadBalancerPtr
+PeakEwmaThreadAwareLoadBalancer::LbFactory::create(Upstream::LoadBalancerParams params) {
+  return std::make_unique<PeakEwmaLoadBalancer>(
+      params.priority_set, params.local_priority_set, cluster_info_.lbStats(), runtime_, random_,
+      PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info_.lbConfig(),
+                                                     healthy_panic_threshold, 100, 50),
+      config_);
+}
+
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
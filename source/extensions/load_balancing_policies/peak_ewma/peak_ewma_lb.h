@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/callback.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/load_balancing_policies/peak_ewma/v3/peak_ewma.pb.h"
+#include "envoy/upstream/load_balancer.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/upstream/load_balancer_impl.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+
+using PeakEwmaLbProto = envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma;
+
+/**
+ * The peak EWMA of the round trip times of a host, shared by the load balancers of all workers.
+ * Updates and reads are lock free.
+ */
+class PeakEwmaHostData : public Upstream::HostLbPolicyData {
+public:
+  PeakEwmaHostData(std::chrono::nanoseconds decay_time, TimeSource& time_source);
+
+  // Upstream::HostLbPolicyData
+  void onResponseTime(std::chrono::microseconds response_time) override;
+
+  /**
+   * @return the average round trip time in microseconds, decayed up to now, or nullopt if no
+   *         request to the host completed yet.
+   */
+  absl::optional<double> ewma() const;
+
+private:
+  int64_t nowNs() const;
+
+  const double decay_time_ns_;
+  TimeSource& time_source_;
+  // Negative until the first round trip time is observed.
+  std::atomic<double> ewma_us_{-1};
+  std::atomic<int64_t> last_update_ns_;
+};
+
+/**
+ * Worker local load balancer picking the host with the lowest peak EWMA cost among choice_count
+ * random hosts.
+ */
+class PeakEwmaLoadBalancer : public Upstream::ZoneAwareLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(const Upstream::PrioritySet& priority_set,
+                       const Upstream::PrioritySet* local_priority_set,
+                       Upstream::ClusterLbStats& stats, Runtime::Loader& runtime,
+                       Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+                       const PeakEwmaLbProto& config);
+
+  // Upstream::ZoneAwareLoadBalancerBase
+  Upstream::HostConstSharedPtr chooseHostOnce(Upstream::LoadBalancerContext* context) override;
+  // Like the least request load balancer, this can not pick a host ahead of time, as the costs
+  // may change before the pick.
+  Upstream::HostConstSharedPtr peekAnotherHost(Upstream::LoadBalancerContext*) override {
+    return nullptr;
+  }
+
+private:
+  double cost(const Upstream::Host& host) const;
+
+  const uint32_t choice_count_;
+  const double default_rtt_us_;
+};
+
+/**
+ * Attaches a PeakEwmaHostData to each host of the cluster, on the main thread, and creates the
+ * worker local load balancers.
+ */
+class PeakEwmaThreadAwareLoadBalancer : public Upstream::ThreadAwareLoadBalancer {
+public:
+  PeakEwmaThreadAwareLoadBalancer(const Upstream::ClusterInfo& cluster_info,
+                                  const Upstream::PrioritySet& priority_set,
+                                  Runtime::Loader& runtime, Random::RandomGenerator& random,
+                                  TimeSource& time_source, const PeakEwmaLbProto& config);
+
+  // Upstream::ThreadAwareLoadBalancer
+  Upstream::LoadBalancerFactorySharedPtr factory() override { return factory_; }
+  void initialize() override;
+
+private:
+  class LbFactory : public Upstream::LoadBalancerFactory {
+  public:
+    LbFactory(const Upstream::ClusterInfo& cluster_info, Runtime::Loader& runtime,
+              Random::RandomGenerator& random, const PeakEwmaLbProto& config)
+        : cluster_info_(cluster_info), runtime_(runtime), random_(random), config_(config) {}
+
+    // Upstream::LoadBalancerFactory
+    Upstream::LoadBalancerPtr create() override { PANIC("not implemented"); }
+    Upstream::LoadBalancerPtr create(Upstream::LoadBalancerParams params) override;
+
+  private:
+    const Upstream::ClusterInfo& cluster_info_;
+    Runtime::Loader& runtime_;
+    Random::RandomGenerator& random_;
+    const PeakEwmaLbProto config_;
+  };
+
+  void addHostData(const Upstream::HostVector& hosts);
+
+  const Upstream::PrioritySet& priority_set_;
+  TimeSource& time_source_;
+  const std::chrono::nanoseconds decay_time_;
+  const std::shared_ptr<LbFactory> factory_;
+  Common::CallbackHandlePtr member_update_cb_handle_;
+};
+
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
@@ -17,6 +17,10 @@ bool OpenTelemetryGrpcTraceExporter::log(const ExportTraceServiceRequest& reques
   return client_.log(request);
 }
 
+bool OpenTelemetryGrpcTraceExporter::isAboveWriteBufferHighWatermark() const {
+  return client_.isAboveWriteBufferHighWatermark();
+}
+
 } // namespace OpenTelemetry
 } // namespace Tracers
 } // namespace Extensions
@@ -75,6 +75,11 @@ public:
     return true;
   }
 
+  bool isAboveWriteBufferHighWatermark() const {
+    return stream_ != nullptr && stream_->stream_ != nullptr &&
+           stream_->stream_->isAboveWriteBufferHighWatermark();
+  }
+
   Grpc::AsyncClient<ExportTraceServiceRequest, ExportTraceServiceResponse> client_;
   std::unique_ptr<LocalStream> stream_;
   const Protobuf::MethodDescriptor& service_method_;
@@ -86,6 +91,12 @@ public:
 
   bool log(const ExportTraceServiceRequest& request);
 
+  /**
+   * @return true if the collector is not reading fast enough, in which case log() would reject
+   * the request.
+   */
+  bool isAboveWriteBufferHighWatermark() const;
+
 private:
   OpenTelemetryGrpcTraceExporterClient client_;
 };
@@ -7,6 +7,7 @@
 #include "source/common/common/empty_string.h"
 #include "source/common/common/logger.h"
 #include "source/common/config/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/tracing/http_tracer_impl.h"
 
 #include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
@@ -39,7 +40,9 @@ Driver::Driver(const envoy::config::trace::v3::OpenTelemetryConfig& opentelemetr
     }
     TracerPtr tracer = std::make_unique<Tracer>(
         std::move(exporter), factory_context.timeSource(), factory_context.api().randomGenerator(),
-        factory_context.runtime(), dispatcher, tracing_stats_, opentelemetry_config.service_name());
+        factory_context.runtime(), dispatcher, tracing_stats_, opentelemetry_config.service_name(),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(opentelemetry_config, max_queue_size, 2048),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(opentelemetry_config, max_export_batch_size, 512));
 
     return std::make_shared<TlsTracer>(std::move(tracer));
   });
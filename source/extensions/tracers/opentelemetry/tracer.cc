@@ -1,5 +1,6 @@
 #include "source/extensions/tracers/opentelemetry/tracer.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -94,9 +95,11 @@ void Span::setTag(absl::string_view name, absl::string_view value) {
 Tracer::Tracer(OpenTelemetryGrpcTraceExporterPtr exporter, Envoy::TimeSource& time_source,
                Random::RandomGenerator& random, Runtime::Loader& runtime,
                Event::Dispatcher& dispatcher, OpenTelemetryTracerStats tracing_stats,
-               const std::string& service_name)
+               const std::string& service_name, uint64_t max_queue_size,
+               uint64_t max_export_batch_size)
     : exporter_(std::move(exporter)), time_source_(time_source), random_(random), runtime_(runtime),
-      tracing_stats_(tracing_stats), service_name_(service_name) {
+      tracing_stats_(tracing_stats), service_name_(service_name), max_queue_size_(max_queue_size),
+      max_export_batch_size_(max_export_batch_size) {
   if (service_name.empty()) {
     service_name_ = std::string{kDefaultServiceName};
   }
@@ -114,7 +117,7 @@ void Tracer::enableTimer() {
   flush_timer_->enableTimer(std::chrono::milliseconds(flush_interval));
 }
 
-void Tracer::flushSpans() {
+ExportTraceServiceRequest Tracer::newExportRequest() const {
   ExportTraceServiceRequest request;
   // A request consists of ResourceSpans.
   ::opentelemetry::proto::trace::v1::ResourceSpans* resource_span = request.add_resource_spans();
@@ -126,23 +129,56 @@ void Tracer::flushSpans() {
   key_value.set_key(std::string{kServiceNameKey});
   *key_value.mutable_value() = value_proto;
   (*resource_span->mutable_resource()->add_attributes()) = key_value;
-  ::opentelemetry::proto::trace::v1::ScopeSpans* scope_span = resource_span->add_scope_spans();
-  for (const auto& pending_span : span_buffer_) {
-    (*scope_span->add_spans()) = pending_span;
+  resource_span->add_scope_spans();
+  return request;
+}
+
+void Tracer::flushSpans() {
+  if (span_buffer_.empty()) {
+    return;
+  }
+  if (!exporter_) {
+    ENVOY_LOG(info, "Skipping log request to OpenTelemetry: no exporter configured");
+    span_buffer_.clear();
+    return;
   }
-  if (exporter_) {
-    tracing_stats_.spans_sent_.add(span_buffer_.size());
+  if (exporter_->isAboveWriteBufferHighWatermark()) {
+    // The batch would be rejected, so don't build it. The spans stay buffered for a later flush.
+    ENVOY_LOG(trace, "Deferring log request to OpenTelemetry trace collector.");
+    return;
+  }
+  size_t exported = 0;
+  while (exported < span_buffer_.size()) {
+    const size_t batch_size =
+        std::min<size_t>(max_export_batch_size_, span_buffer_.size() - exported);
+    ExportTraceServiceRequest request = newExportRequest();
+    auto* spans = request.mutable_resource_spans(0)->mutable_scope_spans(0)->mutable_spans();
+    spans->Reserve(batch_size);
+    // The buffered spans are moved into the request rather than copied.
+    for (size_t i = 0; i < batch_size; i++) {
+      *spans->Add() = std::move(span_buffer_[exported + i]);
+    }
     if (!exporter_->log(request)) {
-      // TODO: should there be any sort of retry or reporting here?
+      // The collector is not keeping up. Put the spans back, so that they are retried by the next
+      // flush unless the buffer fills up in the meantime.
       ENVOY_LOG(trace, "Unsuccessful log request to OpenTelemetry trace collector.");
+      for (size_t i = 0; i < batch_size; i++) {
+        span_buffer_[exported + i] = std::move(*spans->Mutable(i));
+      }
+      break;
     }
-  } else {
-    ENVOY_LOG(info, "Skipping log request to OpenTelemetry: no exporter configured");
+    tracing_stats_.spans_sent_.add(batch_size);
+    exported += batch_size;
   }
-  span_buffer_.clear();
+  span_buffer_.erase(span_buffer_.begin(), span_buffer_.begin() + exported);
 }
 
 void Tracer::sendSpan(::opentelemetry::proto::trace::v1::Span& span) {
+  // Check for room before copying the span, so that dropped spans cost nothing but the counter.
+  if (span_buffer_.size() >= max_queue_size_) {
+    tracing_stats_.spans_dropped_.inc();
+    return;
+  }
   span_buffer_.push_back(span);
   const uint64_t min_flush_spans =
       runtime_.snapshot().getInteger("tracing.opentelemetry.min_flush_spans", 5U);
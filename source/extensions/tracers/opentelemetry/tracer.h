@@ -22,6 +22,7 @@ namespace OpenTelemetry {
 
 #define OPENTELEMETRY_TRACER_STATS(COUNTER)                                                        \
   COUNTER(spans_sent)                                                                              \
+  COUNTER(spans_dropped)                                                                           \
   COUNTER(timer_flushed)
 
 struct OpenTelemetryTracerStats {
@@ -35,8 +36,12 @@ class Tracer : Logger::Loggable<Logger::Id::tracing> {
 public:
   Tracer(OpenTelemetryGrpcTraceExporterPtr exporter, Envoy::TimeSource& time_source,
          Random::RandomGenerator& random, Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
-         OpenTelemetryTracerStats tracing_stats, const std::string& service_name);
+         OpenTelemetryTracerStats tracing_stats, const std::string& service_name,
+         uint64_t max_queue_size, uint64_t max_export_batch_size);
 
+  /**
+   * Buffers a finished span until it is exported, or drops it if the buffer is full.
+   */
   void sendSpan(::opentelemetry::proto::trace::v1::Span& span);
 
   Tracing::SpanPtr startSpan(const Tracing::Config& config, const std::string& operation_name,
@@ -51,9 +56,12 @@ private:
    */
   void enableTimer();
   /*
-   * Removes all spans from the span buffer and sends them to the collector.
+   * Sends the spans in the span buffer to the collector, in batches of at most
+   * max_export_batch_size_ spans. The spans of a batch the exporter did not accept are kept in the
+   * buffer for the next flush.
    */
   void flushSpans();
+  ExportTraceServiceRequest newExportRequest() const;
 
   OpenTelemetryGrpcTraceExporterPtr exporter_;
   Envoy::TimeSource& time_source_;
@@ -63,6 +71,8 @@ private:
   Event::TimerPtr flush_timer_;
   OpenTelemetryTracerStats tracing_stats_;
   std::string service_name_;
+  const uint64_t max_queue_size_;
+  const uint64_t max_export_batch_size_;
 };
 
 /**
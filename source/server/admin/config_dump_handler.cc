@@ -1,16 +1,23 @@
 #include "source/server/admin/config_dump_handler.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/matchers.h"
 #include "source/common/common/regex.h"
 #include "source/common/common/statusor.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
 #include "source/common/network/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -134,6 +141,11 @@ bool shouldIncludeEdsInDump(const Http::Utility::QueryParams& params) {
   return params.find("include_eds") != params.end();
 }
 
+// Helper method to get the stream parameter.
+bool shouldStreamDump(const Http::Utility::QueryParams& params) {
+  return params.find("stream") != params.end();
+}
+
 absl::StatusOr<Matchers::StringMatcherPtr>
 buildNameMatcher(const Http::Utility::QueryParams& params) {
   const auto name_regex = Utility::queryParam(params, "name_regex");
@@ -152,11 +164,339 @@ buildNameMatcher(const Http::Utility::QueryParams& params) {
   }
 }
 
+// Well-known types have their own JSON representation, so their fields are not streamed apart.
+bool isWellKnownType(const Protobuf::Descriptor& descriptor) {
+  return absl::StartsWith(descriptor.file()->name(), "google/protobuf/");
+}
+
+// Serves the dump built by ConfigDumpHandler::handlerConfigDump as a single chunk.
+class BufferedConfigDumpRequest : public Admin::Request {
+public:
+  BufferedConfigDumpRequest(const ConfigDumpHandler& handler, AdminStream& admin_stream)
+      : handler_(handler), admin_stream_(admin_stream) {}
+
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override {
+    return handler_.handlerConfigDump(response_headers, response_, admin_stream_);
+  }
+
+  bool nextChunk(Buffer::Instance& response) override {
+    response.move(response_);
+    return false;
+  }
+
+private:
+  const ConfigDumpHandler& handler_;
+  AdminStream& admin_stream_;
+  Buffer::OwnedImpl response_;
+};
+
 } // namespace
 
+ConfigDumpRequest::ConfigDumpRequest(ConfigTracker::CbsMap callbacks,
+                                     const absl::optional<std::string>& resource,
+                                     const absl::optional<std::string>& mask,
+                                     Matchers::StringMatcherPtr name_matcher,
+                                     Thread::ThreadFactory& thread_factory, uint32_t json_threads)
+    : callbacks_(std::move(callbacks)), next_callback_(callbacks_.begin()), resource_(resource),
+      mask_string_(mask), name_matcher_(std::move(name_matcher)), thread_factory_(thread_factory),
+      json_threads_(std::max<uint32_t>(json_threads, 1)) {
+  if (mask.has_value()) {
+    mask_.emplace();
+    ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &mask_.value());
+  }
+}
+
+ConfigDumpRequest::~ConfigDumpRequest() {
+  {
+    Thread::LockGuard lock(json_lock_);
+    json_exit_ = true;
+    json_batch_ready_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : json_helpers_) {
+    thread->join();
+  }
+}
+
+Http::Code ConfigDumpRequest::start(Http::ResponseHeaderMap& response_headers) {
+  Http::Code code = Http::Code::OK;
+  if (resource_.has_value()) {
+    // The requested resources are all in one config, which is looked up and masked upfront so
+    // that errors are reported with the status.
+    code = Http::Code::NotFound;
+    error_ = fmt::format("{} not found in config dump", resource_.value());
+    for (; next_callback_ != callbacks_.end(); ++next_callback_) {
+      ProtobufTypes::MessagePtr message = next_callback_->second(*name_matcher_);
+      ASSERT(message);
+      const Protobuf::FieldDescriptor* field =
+          message->GetDescriptor()->FindFieldByName(resource_.value());
+      if (field == nullptr) {
+        continue;
+      }
+      if (!field->is_repeated()) {
+        code = Http::Code::BadRequest;
+        error_ = fmt::format("{} is not a repeated field. Use ?mask={} to get only this field",
+                             field->name(), field->name());
+        break;
+      }
+      code = Http::Code::OK;
+      error_.clear();
+      if (mask_.has_value()) {
+        const Protobuf::Reflection* reflection = message->GetReflection();
+        for (int i = 0; i < reflection->FieldSize(*message, field); ++i) {
+          if (!trimResourceMessage(mask_.value(),
+                                   *reflection->MutableRepeatedMessage(message.get(), field, i))) {
+            code = Http::Code::BadRequest;
+            error_ = absl::StrCat("FieldMask ", mask_->DebugString(),
+                                  " could not be successfully used.");
+            break;
+          }
+        }
+      }
+      config_ = std::move(message);
+      fields_.push_back(field);
+      break;
+    }
+  } else if (!nextConfig() && mask_.has_value()) {
+    code = Http::Code::BadRequest;
+    error_ = absl::StrCat("FieldMask ", mask_string_.value(),
+                          " could not be successfully applied to any configs.");
+  }
+
+  if (code != Http::Code::OK) {
+    response_headers.addReference(Http::Headers::get().XContentTypeOptions,
+                                  Http::Headers::get().XContentTypeOptionValues.Nosniff);
+    response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
+    config_.reset();
+    return code;
+  }
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  return Http::Code::OK;
+}
+
+bool ConfigDumpRequest::nextChunk(Buffer::Instance& response) {
+  if (!error_.empty()) {
+    response.add(error_);
+    return false;
+  }
+  if (!started_) {
+    response.add("{\"configs\":[");
+    started_ = true;
+  }
+
+  if (resource_.has_value()) {
+    if (config_ == nullptr || addResources(response, *config_, fields_[0], true)) {
+      response.add("]}\n");
+      return false;
+    }
+    return true;
+  }
+
+  if (config_ == nullptr && !nextConfig()) {
+    response.add("]}\n");
+    return false;
+  }
+  if (!config_started_) {
+    startConfig(response);
+  }
+  while (field_index_ < fields_.size()) {
+    if (resource_index_ == 0) {
+      response.add(absl::StrCat(",\"", fields_[field_index_]->name(), "\":["));
+    }
+    if (!addResources(response, *resources_, fields_[field_index_], false)) {
+      return true;
+    }
+    response.add("]");
+    ++field_index_;
+    resource_index_ = 0;
+  }
+  response.add("}");
+  config_.reset();
+  resources_.reset();
+  return true;
+}
+
+bool ConfigDumpRequest::nextConfig() {
+  for (; next_callback_ != callbacks_.end(); ++next_callback_) {
+    ProtobufTypes::MessagePtr message = next_callback_->second(*name_matcher_);
+    ASSERT(message);
+    // As in the buffered dump, configs the mask does not apply to are skipped, because different
+    // configs have different valid masks.
+    if (mask_.has_value() && !checkFieldMaskAndTrimMessage(mask_.value(), *message)) {
+      continue;
+    }
+    ++next_callback_;
+    config_ = std::move(message);
+    config_started_ = false;
+    return true;
+  }
+  return false;
+}
+
+void ConfigDumpRequest::startConfig(Buffer::Instance& response) {
+  const Protobuf::Descriptor* descriptor = config_->GetDescriptor();
+  const Protobuf::Reflection* reflection = config_->GetReflection();
+  fields_.clear();
+  if (!isWellKnownType(*descriptor)) {
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+      const Protobuf::FieldDescriptor* field = descriptor->field(i);
+      if (field->is_repeated() && !field->is_map() && field->message_type() != nullptr &&
+          reflection->FieldSize(*config_, field) > 0) {
+        fields_.push_back(field);
+      }
+    }
+  }
+  resources_.reset(config_->New());
+  reflection->SwapFields(config_.get(), resources_.get(), fields_);
+  field_index_ = 0;
+  resource_index_ = 0;
+
+  MessageUtil::redact(*config_);
+  ProtobufWkt::Any any;
+  any.PackFrom(*config_);
+  std::string json = MessageUtil::getJsonStringFromMessageOrError(any);
+  // The closing brace follows the resources.
+  if (absl::EndsWith(json, "}")) {
+    json.pop_back();
+  }
+  response.add(absl::StrCat(any_config_ ? "," : "", json));
+  any_config_ = true;
+  config_started_ = true;
+}
+
+bool ConfigDumpRequest::addResources(Buffer::Instance& response, Protobuf::Message& message,
+                                     const Protobuf::FieldDescriptor* field, bool pack) {
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  const int end = std::min<int>(reflection->FieldSize(message, field),
+                                resource_index_ + static_cast<int>(ResourcesPerChunk));
+  std::vector<const Protobuf::Message*> batch;
+  batch.reserve(end - resource_index_);
+  for (int i = resource_index_; i < end; ++i) {
+    Protobuf::Message* resource = reflection->MutableRepeatedMessage(&message, field, i);
+    // Redaction stays on this thread, as it may unpack and repack Any fields.
+    MessageUtil::redact(*resource);
+    batch.push_back(resource);
+  }
+  const std::vector<std::string> json = toJson(batch, pack);
+  for (size_t i = 0; i < json.size(); ++i) {
+    if (resource_index_ + i > 0) {
+      response.add(",");
+    }
+    response.add(json[i]);
+  }
+  resource_index_ = end;
+  return end == reflection->FieldSize(message, field);
+}
+
+std::vector<std::string>
+ConfigDumpRequest::toJson(const std::vector<const Protobuf::Message*>& messages, bool pack) {
+  std::vector<std::string> json(messages.size());
+  const uint64_t num_threads = std::max<uint64_t>(
+      1, std::min<uint64_t>(json_threads_, messages.size() / MinResourcesPerThread));
+  // The messages are interleaved between the threads, which write to distinct strings.
+  const auto convert = [&messages, &json, num_threads, pack](uint64_t first) {
+    for (size_t i = first; i < messages.size(); i += num_threads) {
+      if (pack) {
+        ProtobufWkt::Any any;
+        any.PackFrom(*messages[i]);
+        json[i] = MessageUtil::getJsonStringFromMessageOrError(any);
+      } else {
+        json[i] = MessageUtil::getJsonStringFromMessageOrError(*messages[i]);
+      }
+    }
+  };
+  if (num_threads > 1) {
+    while (json_helpers_.size() < json_threads_ - 1) {
+      const uint64_t index = json_helpers_.size() + 1;
+      json_helpers_.push_back(
+          thread_factory_.createThread([this, index]() { runJsonThread(index); }));
+    }
+    Thread::LockGuard lock(json_lock_);
+    json_convert_ = convert;
+    json_batch_threads_ = num_threads;
+    json_pending_ = num_threads - 1;
+    json_batch_++;
+    json_batch_ready_.notifyAll();
+  }
+  convert(0);
+  if (num_threads > 1) {
+    Thread::LockGuard lock(json_lock_);
+    while (json_pending_ > 0) {
+      json_batch_done_.wait(json_lock_);
+    }
+    json_convert_ = nullptr;
+  }
+  return json;
+}
+
+void ConfigDumpRequest::runJsonThread(uint64_t index) {
+  uint64_t batch = 0;
+  while (true) {
+    std::function<void(uint64_t)> convert;
+    {
+      Thread::LockGuard lock(json_lock_);
+      while (!json_exit_ && json_batch_ == batch) {
+        json_batch_ready_.wait(json_lock_);
+      }
+      if (json_exit_) {
+        return;
+      }
+      batch = json_batch_;
+      if (index >= json_batch_threads_) {
+        // Small batches are not split between all the threads.
+        continue;
+      }
+      convert = json_convert_;
+    }
+    convert(index);
+    Thread::LockGuard lock(json_lock_);
+    if (--json_pending_ == 0) {
+      json_batch_done_.notifyOne();
+    }
+  }
+}
+
 ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
     : HandlerContextBase(server), config_tracker_(config_tracker) {}
 
+Admin::RequestPtr ConfigDumpHandler::makeRequest(AdminStream& admin_stream) const {
+  const Http::Utility::QueryParams query_params = admin_stream.queryParams();
+  if (!shouldStreamDump(query_params)) {
+    return std::make_unique<BufferedConfigDumpRequest>(*this, admin_stream);
+  }
+  absl::StatusOr<Matchers::StringMatcherPtr> name_matcher = buildNameMatcher(query_params);
+  if (!name_matcher.ok()) {
+    return Admin::makeStaticTextRequest(name_matcher.status().ToString(), Http::Code::BadRequest);
+  }
+  return std::make_unique<ConfigDumpRequest>(
+      callbacksMap(shouldIncludeEdsInDump(query_params)), resourceParam(query_params),
+      maskParam(query_params), std::move(name_matcher).value(), server_.api().threadFactory(),
+      StreamJsonThreads);
+}
+
+Admin::UrlHandler ConfigDumpHandler::configDumpHandler() const {
+  return {"/config_dump",
+          "dump current Envoy configs (experimental)",
+          [this](AdminStream& admin_stream) -> Admin::RequestPtr {
+            return makeRequest(admin_stream);
+          },
+          false,
+          false,
+          {{Admin::ParamDescriptor::Type::String, "resource", "The resource to dump"},
+           {Admin::ParamDescriptor::Type::String, "mask",
+            "The mask to apply. When both resource and mask are specified, "
+            "the mask is applied to every element in the desired repeated field so that only a "
+            "subset of fields are returned. The mask is parsed as a ProtobufWkt::FieldMask"},
+           {Admin::ParamDescriptor::Type::String, "name_regex",
+            "Dump only the currently loaded configurations whose names match the specified "
+            "regex. Can be used with both resource and mask query parameters."},
+           {Admin::ParamDescriptor::Type::Boolean, "include_eds",
+            "Dump currently loaded configuration including EDS. See the response definition "
+            "for more information"},
+           {Admin::ParamDescriptor::Type::Boolean, "stream",
+            "Stream the dump one resource at a time, as JSON without whitespace, rather than "
+            "building it whole first"}}};
+}
+
 Http::Code ConfigDumpHandler::handlerConfigDump(Http::ResponseHeaderMap& response_headers,
                                                 Buffer::Instance& response,
                                                 AdminStream& admin_stream) const {
@@ -197,18 +537,7 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
     envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
     const std::string& resource, const Matchers::StringMatcher& name_matcher,
     bool include_eds) const {
-  Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
-  if (include_eds) {
-    // TODO(mattklein123): Add ability to see warming clusters in admin output.
-    auto all_clusters = server_.clusterManager().clusters();
-    if (!all_clusters.active_clusters_.empty()) {
-      callbacks_map.emplace("endpoint", [this](const Matchers::StringMatcher& name_matcher) {
-        return dumpEndpointConfigs(name_matcher);
-      });
-    }
-  }
-
-  for (const auto& [name, callback] : callbacks_map) {
+  for (const auto& [name, callback] : callbacksMap(include_eds)) {
     UNREFERENCED_PARAMETER(name);
     ProtobufTypes::MessagePtr message = callback(name_matcher);
     ASSERT(message);
@@ -251,18 +580,7 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
 absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addAllConfigToDump(
     envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
     const Matchers::StringMatcher& name_matcher, bool include_eds) const {
-  Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
-  if (include_eds) {
-    // TODO(mattklein123): Add ability to see warming clusters in admin output.
-    auto all_clusters = server_.clusterManager().clusters();
-    if (!all_clusters.active_clusters_.empty()) {
-      callbacks_map.emplace("endpoint", [this](const Matchers::StringMatcher& name_matcher) {
-        return dumpEndpointConfigs(name_matcher);
-      });
-    }
-  }
-
-  for (const auto& [name, callback] : callbacks_map) {
+  for (const auto& [name, callback] : callbacksMap(include_eds)) {
     UNREFERENCED_PARAMETER(name);
     ProtobufTypes::MessagePtr message = callback(name_matcher);
     ASSERT(message);
@@ -290,6 +608,20 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addAllConf
   return absl::nullopt;
 }
 
+ConfigTracker::CbsMap ConfigDumpHandler::callbacksMap(bool include_eds) const {
+  ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
+  if (include_eds) {
+    // TODO(mattklein123): Add ability to see warming clusters in admin output.
+    auto all_clusters = server_.clusterManager().clusters();
+    if (!all_clusters.active_clusters_.empty()) {
+      callbacks_map.emplace("endpoint", [this](const Matchers::StringMatcher& name_matcher) {
+        return dumpEndpointConfigs(name_matcher);
+      });
+    }
+  }
+  return callbacks_map;
+}
+
 ProtobufTypes::MessagePtr
 ConfigDumpHandler::dumpEndpointConfigs(const Matchers::StringMatcher& name_matcher) const {
   auto endpoint_config_dump = std::make_unique<envoy::admin::v3::EndpointsConfigDump>();
@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
@@ -8,7 +12,10 @@
 #include "envoy/http/header_map.h"
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
+#include "envoy/thread/thread.h"
 
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
 #include "source/server/admin/config_tracker_impl.h"
 #include "source/server/admin/handler_ctx.h"
 
@@ -17,14 +24,105 @@
 namespace Envoy {
 namespace Server {
 
+/**
+ * Streams a config dump as JSON, one config at a time. The resources in the repeated fields of
+ * each config, or the resources selected by the resource parameter, are masked, redacted and
+ * converted a batch at a time, so that neither the ConfigDump nor its JSON is ever held as a whole.
+ * The JSON conversion of each batch is spread over up to json_threads threads. The output has the
+ * same content as the buffered dump, without its whitespace.
+ */
+class ConfigDumpRequest : public Admin::Request {
+public:
+  // The number of resources converted for each chunk.
+  static constexpr uint64_t ResourcesPerChunk = 1000;
+  // The number of resources below which a batch is not split any further between threads.
+  static constexpr uint64_t MinResourcesPerThread = 100;
+
+  ConfigDumpRequest(ConfigTracker::CbsMap callbacks, const absl::optional<std::string>& resource,
+                    const absl::optional<std::string>& mask,
+                    Matchers::StringMatcherPtr name_matcher, Thread::ThreadFactory& thread_factory,
+                    uint32_t json_threads);
+  ~ConfigDumpRequest() override;
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+private:
+  // Calls the callbacks from next_callback_ until one returns a config that the mask, if any,
+  // applies to, which becomes config_. Returns false if there is none.
+  bool nextConfig();
+  // Adds the JSON of config_ without its resources, and moves these into resources_.
+  void startConfig(Buffer::Instance& response);
+  // Adds the next batch of the resources in field of message, returning true once they are all
+  // added. If pack is set, the resources are packed into Any messages.
+  bool addResources(Buffer::Instance& response, Protobuf::Message& message,
+                    const Protobuf::FieldDescriptor* field, bool pack);
+  std::vector<std::string> toJson(const std::vector<const Protobuf::Message*>& messages,
+                                  bool pack);
+  // Runs the share of each batch converted by the helper thread with the given index.
+  void runJsonThread(uint64_t index);
+
+  ConfigTracker::CbsMap callbacks_;
+  ConfigTracker::CbsMap::const_iterator next_callback_;
+  const absl::optional<std::string> resource_;
+  const absl::optional<std::string> mask_string_;
+  absl::optional<Protobuf::FieldMask> mask_;
+  const Matchers::StringMatcherPtr name_matcher_;
+  Thread::ThreadFactory& thread_factory_;
+  const uint32_t json_threads_;
+
+  // Set if start() failed, to be sent instead of the dump.
+  std::string error_;
+  bool started_{false};
+  // The config being streamed. With the resource parameter, it holds the requested resources.
+  ProtobufTypes::MessagePtr config_;
+  bool config_started_{false};
+  bool any_config_{false};
+  // The resources of config_ and the fields holding them, which are streamed one by one.
+  ProtobufTypes::MessagePtr resources_;
+  std::vector<const Protobuf::FieldDescriptor*> fields_;
+  size_t field_index_{0};
+  int resource_index_{0};
+
+  // The helper threads converting resources to JSON, started with the first batch that is split
+  // between threads, and kept until the request is destroyed.
+  std::vector<Thread::ThreadPtr> json_helpers_;
+  Thread::MutexBasicLockable json_lock_;
+  // Signaled when a batch is ready for the helpers, or when they should exit.
+  Thread::CondVar json_batch_ready_;
+  // Signaled when the last helper working on a batch is done with its share.
+  Thread::CondVar json_batch_done_;
+  // Converts the share of the current batch of the thread with the given index.
+  std::function<void(uint64_t)> json_convert_ ABSL_GUARDED_BY(json_lock_);
+  // Counts the batches handed to the helpers.
+  uint64_t json_batch_ ABSL_GUARDED_BY(json_lock_){0};
+  // The number of threads, including the main thread, sharing the current batch.
+  uint64_t json_batch_threads_ ABSL_GUARDED_BY(json_lock_){0};
+  // The number of helpers still converting their share of the current batch.
+  uint64_t json_pending_ ABSL_GUARDED_BY(json_lock_){0};
+  bool json_exit_ ABSL_GUARDED_BY(json_lock_){false};
+};
+
 class ConfigDumpHandler : public HandlerContextBase {
 
 public:
+  // The number of threads converting streamed resources to JSON, including the main thread.
+  static constexpr uint32_t StreamJsonThreads = 4;
+
   ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server);
 
   Http::Code handlerConfigDump(Http::ResponseHeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&) const;
 
+  /**
+   * @return a request streaming the dump if the stream parameter is set, or else a request
+   * serving the dump built by handlerConfigDump.
+   */
+  Admin::RequestPtr makeRequest(AdminStream& admin_stream) const;
+
+  Admin::UrlHandler configDumpHandler() const;
+
 private:
   absl::optional<std::pair<Http::Code, std::string>>
   addAllConfigToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
@@ -39,6 +137,9 @@ private:
                     const std::string& resource, const Matchers::StringMatcher& name_matcher,
                     bool include_eds) const;
 
+  // Returns the config tracker callbacks, with one for the endpoints if include_eds is set.
+  ConfigTracker::CbsMap callbacksMap(bool include_eds) const;
+
   /**
    * Helper methods to add endpoints config
    */
@@ -75,8 +75,40 @@ struct MetricLessThan {
     ASSERT(&a->constSymbolTable() == &b->constSymbolTable());
     return a->constSymbolTable().lessThan(a->statName(), b->statName());
   }
+  template <class StatType>
+  bool operator()(const Stats::RefcountPtr<StatType>& a,
+                  const Stats::RefcountPtr<StatType>& b) const {
+    return (*this)(a.get(), b.get());
+  }
 };
 
+/**
+ * Outputs a group of metrics sharing a tag-extracted name, sorted by their tags' textual
+ * representation to satisfy the "preferred" ordering from the prometheus spec, which will be
+ * consistent across calls.
+ *
+ * @return false if nothing was output because the name is not a valid prometheus metric name.
+ */
+template <class StatType, class MetricPtr>
+bool outputGroup(Buffer::Instance& response, const std::string& tag_extracted_name,
+                 std::vector<MetricPtr>& metrics,
+                 const std::function<std::string(const StatType& metric,
+                                                 const std::string& prefixed_tag_extracted_name)>&
+                     generate_output,
+                 absl::string_view type, const Stats::CustomStatNamespaces& custom_namespaces) {
+  const absl::optional<std::string> prefixed_tag_extracted_name =
+      PrometheusStatsFormatter::metricName(tag_extracted_name, custom_namespaces);
+  if (!prefixed_tag_extracted_name.has_value()) {
+    return false;
+  }
+  response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
+  std::sort(metrics.begin(), metrics.end(), MetricLessThan());
+  for (const auto& metric : metrics) {
+    response.add(generate_output(*metric, prefixed_tag_extracted_name.value()));
+  }
+  return true;
+}
+
 /**
  * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
  * them by tag-extracted metric name, and then outputting them in the correct sorted order into
@@ -141,22 +173,9 @@ uint64_t outputStatType(
 
   auto result = groups.size();
   for (auto& group : groups) {
-    const absl::optional<std::string> prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first),
-                                             custom_namespaces);
-    if (!prefixed_tag_extracted_name.has_value()) {
+    if (!outputGroup(response, global_symbol_table.toString(group.first), group.second,
+                     generate_output, type, custom_namespaces)) {
       --result;
-      continue;
-    }
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name.value()));
     }
   }
   return result;
@@ -285,5 +304,100 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
   return metric_name_count;
 }
 
+PrometheusStatsRequest::PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                                               const Stats::CustomStatNamespaces& custom_namespaces)
+    : stats_(stats), params_(params), custom_namespaces_(custom_namespaces),
+      counters_(stats.symbolTable()), gauges_(stats.symbolTable()),
+      text_readouts_(stats.symbolTable()), histograms_(stats.symbolTable()) {}
+
+Http::Code PrometheusStatsRequest::start(Http::ResponseHeaderMap&) {
+  populateGroups(counters_, &Stats::Store::forEachCounter);
+  return Http::Code::OK;
+}
+
+bool PrometheusStatsRequest::nextChunk(Buffer::Instance& response) {
+  // nextChunk's contract is to add up to chunk_size_ additional bytes. The
+  // caller is not required to drain the bytes after each call to nextChunk.
+  const uint64_t end_length = response.length() + chunk_size_;
+  while (response.length() < end_length) {
+    bool more = false;
+    switch (phase_) {
+    case Phase::Counters:
+      more = renderGroups(counters_, generateNumericOutput<Stats::Counter>, "counter", response,
+                          end_length);
+      break;
+    case Phase::Gauges:
+      more = renderGroups(gauges_, generateNumericOutput<Stats::Gauge>, "gauge", response,
+                          end_length);
+      break;
+    case Phase::TextReadouts:
+      // TextReadout stats are returned in gauge format, so "gauge" type is set intentionally.
+      more = renderGroups(text_readouts_, generateTextReadoutOutput, "gauge", response, end_length);
+      break;
+    case Phase::Histograms:
+      more = renderGroups(histograms_, generateHistogramOutput, "histogram", response, end_length);
+      break;
+    case Phase::Done:
+      return false;
+    }
+    if (!more) {
+      nextPhase();
+    }
+  }
+  return phase_ != Phase::Done;
+}
+
+void PrometheusStatsRequest::nextPhase() {
+  switch (phase_) {
+  case Phase::Counters:
+    phase_ = Phase::Gauges;
+    populateGroups(gauges_, &Stats::Store::forEachGauge);
+    break;
+  case Phase::Gauges:
+    if (params_.prometheus_text_readouts_) {
+      phase_ = Phase::TextReadouts;
+      populateGroups(text_readouts_, &Stats::Store::forEachTextReadout);
+    } else {
+      phase_ = Phase::Histograms;
+      populateGroups(histograms_, &Stats::Store::forEachHistogram);
+    }
+    break;
+  case Phase::TextReadouts:
+    phase_ = Phase::Histograms;
+    populateGroups(histograms_, &Stats::Store::forEachHistogram);
+    break;
+  case Phase::Histograms:
+  case Phase::Done:
+    phase_ = Phase::Done;
+    break;
+  }
+}
+
+template <class StatType>
+void PrometheusStatsRequest::populateGroups(Groups<StatType>& groups, ForEachFn<StatType> fn) {
+  ASSERT(groups.empty());
+  // References are taken so that the stats outlive the iteration, as for Store::counters().
+  (stats_.*fn)(nullptr, [this, &groups](StatType& metric) {
+    if (shouldShowMetric(metric, params_)) {
+      groups[metric.tagExtractedStatName()].emplace_back(&metric);
+    }
+  });
+}
+
+template <class StatType>
+bool PrometheusStatsRequest::renderGroups(Groups<StatType>& groups,
+                                          GenerateFn<StatType> generate_output,
+                                          absl::string_view type, Buffer::Instance& response,
+                                          uint64_t end_length) {
+  while (!groups.empty() && response.length() < end_length) {
+    auto iter = groups.begin();
+    outputGroup<StatType>(response, stats_.symbolTable().toString(iter->first), iter->second,
+                          generate_output, type, custom_namespaces_);
+    // The key refers to the storage of the stats in the group, so the group is erased last.
+    groups.erase(iter);
+  }
+  return !groups.empty();
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <map>
 #include <regex>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/server/admin.h"
 #include "envoy/stats/custom_stat_namespaces.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/store.h"
 
+#include "source/common/stats/symbol_table.h"
 #include "source/server/admin/stats_params.h"
 
 namespace Envoy {
@@ -47,5 +52,61 @@ public:
              const Stats::CustomStatNamespaces& custom_namespace_factory);
 };
 
+/**
+ * Streams stats in the Prometheus format in chunks, like StatsRequest does for the other formats,
+ * rather than rendering all of them into one buffer. All the lines of a metric must be rendered as
+ * one group, so the stats are visited one type at a time and grouped by tag-extracted name as they
+ * are visited; the groups are then rendered in order over as many chunks as needed. The output is
+ * the same as PrometheusStatsFormatter::statsAsPrometheus.
+ */
+class PrometheusStatsRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                         const Stats::CustomStatNamespaces& custom_namespaces);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  // Renders groups until at least chunk_size_ bytes were added. Chunks end on group boundaries.
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  // The types in the order they are rendered in.
+  enum class Phase { Counters, Gauges, TextReadouts, Histograms, Done };
+
+  // The stats of a type to render, grouped by tag-extracted name.
+  template <class StatType>
+  using Groups = std::map<Stats::StatName, std::vector<Stats::RefcountPtr<StatType>>,
+                          Stats::StatNameLessThan>;
+  template <class StatType>
+  using ForEachFn = void (Stats::Store::*)(Stats::SizeFn, Stats::StatFn<StatType>) const;
+  template <class StatType>
+  using GenerateFn = std::string (*)(const StatType&, const std::string&);
+
+  // Moves to the next phase and groups its stats.
+  void nextPhase();
+  template <class StatType> void populateGroups(Groups<StatType>& groups, ForEachFn<StatType> fn);
+  // Renders and removes groups until response reaches end_length. Returns false if all the groups
+  // were rendered.
+  template <class StatType>
+  bool renderGroups(Groups<StatType>& groups, GenerateFn<StatType> generate_output,
+                    absl::string_view type, Buffer::Instance& response, uint64_t end_length);
+
+  Stats::Store& stats_;
+  const StatsParams params_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+  Phase phase_{Phase::Counters};
+  // Only the groups of the current phase are populated.
+  Groups<Stats::Counter> counters_;
+  Groups<Stats::Gauge> gauges_;
+  Groups<Stats::TextReadout> text_readouts_;
+  Groups<Stats::ParentHistogram> histograms_;
+  uint64_t chunk_size_{DefaultChunkSize};
+};
+
 } // namespace Server
 } // namespace Envoy
@@ -79,23 +79,14 @@ Admin::RequestPtr StatsHandler::makeRequest(AdminStream& admin_stream) {
     return Admin::makeStaticTextRequest(response, code);
   }
 
-  if (params.format_ == StatsFormat::Prometheus) {
-    // TODO(#16139): modify streaming algorithm to cover Prometheus.
-    //
-    // This may be easiest to accomplish by populating the set
-    // with tagExtractedName(), and allowing for vectors of
-    // stats as multiples will have the same tag-extracted names.
-    // Ideally we'd find a way to do this without slowing down
-    // the non-Prometheus implementations.
-    Buffer::OwnedImpl response;
-    prometheusFlushAndRender(params, response);
-    return Admin::makeStaticTextRequest(response, code);
-  }
-
   if (server_.statsConfig().flushOnAdmin()) {
     server_.flushStats();
   }
 
+  if (params.format_ == StatsFormat::Prometheus) {
+    return makePrometheusRequest(server_.stats(), server_.api().customStatNamespaces(), params);
+  }
+
   return makeRequest(server_.stats(), params,
                      [this]() -> Admin::UrlHandler { return statsHandler(); });
 }
@@ -105,33 +96,26 @@ Admin::RequestPtr StatsHandler::makeRequest(Stats::Store& stats, const StatsPara
   return std::make_unique<StatsRequest>(stats, params, url_handler_fn);
 }
 
-Http::Code StatsHandler::handlerPrometheusStats(Http::ResponseHeaderMap&,
-                                                Buffer::Instance& response,
-                                                AdminStream& admin_stream) {
-  return prometheusStats(admin_stream.getRequestHeaders().getPathValue(), response);
-}
-
-Http::Code StatsHandler::prometheusStats(absl::string_view path_and_query,
-                                         Buffer::Instance& response) {
+Admin::RequestPtr StatsHandler::makePrometheusRequest(AdminStream& admin_stream) {
   StatsParams params;
-  Http::Code code = params.parse(path_and_query, response);
+  Buffer::OwnedImpl response;
+  Http::Code code = params.parse(admin_stream.getRequestHeaders().getPathValue(), response);
   if (code != Http::Code::OK) {
-    return code;
+    return Admin::makeStaticTextRequest(response, code);
   }
 
   if (server_.statsConfig().flushOnAdmin()) {
     server_.flushStats();
   }
 
-  prometheusFlushAndRender(params, response);
-  return Http::Code::OK;
+  return makePrometheusRequest(server_.stats(), server_.api().customStatNamespaces(), params);
 }
 
-void StatsHandler::prometheusFlushAndRender(const StatsParams& params, Buffer::Instance& response) {
-  if (server_.statsConfig().flushOnAdmin()) {
-    server_.flushStats();
-  }
-  prometheusRender(server_.stats(), server_.api().customStatNamespaces(), params, response);
+Admin::RequestPtr
+StatsHandler::makePrometheusRequest(Stats::Store& stats,
+                                    const Stats::CustomStatNamespaces& custom_namespaces,
+                                    const StatsParams& params) {
+  return std::make_unique<PrometheusStatsRequest>(stats, params, custom_namespaces);
 }
 
 void StatsHandler::prometheusRender(Stats::Store& stats,
@@ -186,5 +170,22 @@ Admin::UrlHandler StatsHandler::statsHandler() {
         {"cumulative", "disjoint", "none"}}}};
 }
 
+Admin::UrlHandler StatsHandler::prometheusStatsHandler() {
+  return {"/stats/prometheus",
+          "print server stats in prometheus format",
+          [this](AdminStream& admin_stream) -> Admin::RequestPtr {
+            return makePrometheusRequest(admin_stream);
+          },
+          false,
+          false,
+          {{Admin::ParamDescriptor::Type::Boolean, "usedonly",
+            "Only include stats that have been written by system since restart"},
+           {Admin::ParamDescriptor::Type::Boolean, "text_readouts",
+            "Render text_readouts as new gaugues with value 0 (increases Prometheus "
+            "data size)"},
+           {Admin::ParamDescriptor::Type::String, "filter",
+            "Regular expression (Google re2) for filtering stats"}}};
+}
+
 } // namespace Server
 } // namespace Envoy
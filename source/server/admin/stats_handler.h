@@ -33,32 +33,12 @@ public:
                                               Buffer::Instance& response, AdminStream&);
   Http::Code handlerStatsRecentLookupsEnable(Http::ResponseHeaderMap& response_headers,
                                              Buffer::Instance& response, AdminStream&);
-  Http::Code handlerPrometheusStats(Http::ResponseHeaderMap& response_headers,
-                                    Buffer::Instance& response, AdminStream&);
 
   /**
-   * Parses and executes a prometheus stats request.
-   *
-   * @param path_and_query the URL path and query
-   * @param response buffer into which to write response
-   * @return http response code
-   */
-  Http::Code prometheusStats(absl::string_view path_and_query, Buffer::Instance& response);
-
-  /**
-   * Checks the server_ to see if a flush is needed, and then renders the
-   * prometheus stats request.
-   *
-   * @params params the already-parsed parameters.
-   * @param response buffer into which to write response
-   */
-  void prometheusFlushAndRender(const StatsParams& params, Buffer::Instance& response);
-
-  /**
-   * Renders the stats as prometheus. This is broken out as a separately
-   * callable API to facilitate the benchmark
-   * (test/server/admin/stats_handler_speed_test.cc) which does not have a
-   * server object.
+   * Renders the stats as prometheus into a single buffer. The admin endpoints
+   * stream them with makePrometheusRequest instead. This is kept as a separately
+   * callable API for the benchmark (test/server/admin/stats_handler_speed_test.cc),
+   * which does not have a server object.
    *
    * @params stats the stats store to read
    * @param custom_namespaces namespace mappings used for prometheus
@@ -83,16 +63,21 @@ public:
    */
   Admin::UrlHandler statsHandler();
 
+  /**
+   * @return a URL handler streaming the stats in prometheus format.
+   */
+  Admin::UrlHandler prometheusStatsHandler();
+
   static Admin::RequestPtr makeRequest(Stats::Store& stats, const StatsParams& params,
                                        StatsRequest::UrlHandlerFn url_handler_fn = nullptr);
   Admin::RequestPtr makeRequest(AdminStream&);
   // static Admin::RequestPtr makeRequest(Stats::Store& stats, const StatsParams& params,
   //                                     StatsRequest::UrlHandlerFn url_handler_fn);
 
-private:
-  static Http::Code prometheusStats(absl::string_view path_and_query, Buffer::Instance& response,
-                                    Stats::Store& stats,
-                                    Stats::CustomStatNamespaces& custom_namespaces);
+  static Admin::RequestPtr
+  makePrometheusRequest(Stats::Store& stats, const Stats::CustomStatNamespaces& custom_namespaces,
+                        const StatsParams& params);
+  Admin::RequestPtr makePrometheusRequest(AdminStream& admin_stream);
 };
 
 } // namespace Server
@@ -1,6 +1,9 @@
 #include "source/server/hot_restarting_child.h"
 
+#include "source/common/api/os_sys_calls_impl_hot_restart.h"
 #include "source/common/common/utility.h"
+#include "source/common/runtime/runtime_features.h"
+#include "source/server/stats_segment.h"
 
 namespace Envoy {
 namespace Server {
@@ -42,7 +45,9 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  // A parent which does not know about shared memory ignores the flag and replies with the stats.
+  wrapped_request.mutable_request()->mutable_stats()->set_shared_memory(
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.hot_restart_stats_shared_memory"));
   sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
@@ -109,6 +114,11 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
     hot_restart_generation_stat_name_ = hotRestartGeneration(*stats_store.rootScope()).statName();
   }
 
+  if (!stats_proto.shared_memory_name().empty()) {
+    mergeParentStatsFromSharedMemory(stats_proto.shared_memory_name());
+    return;
+  }
+
   // Convert the protobuf for serialized dynamic spans into the structure
   // required by StatMerger.
   Stats::StatMerger::DynamicsMap dynamics;
@@ -122,5 +132,27 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+void HotRestartingChild::mergeParentStatsFromSharedMemory(const std::string& segment_name) {
+  std::unique_ptr<StatsSegmentReader> reader = StatsSegmentReader::openSharedMemory(segment_name);
+  // The parent writes a new segment for each request, and the mapping outlives the name.
+  Api::HotRestartOsSysCallsSingleton::get().shmUnlink(segment_name.c_str());
+  if (reader == nullptr) {
+    ENVOY_LOG(warn, "cannot read the stats exported by the hot restart parent to {}",
+              segment_name);
+    return;
+  }
+
+  // Each stat is merged with its name and spans as laid out in the segment, rather than being
+  // copied into maps keyed by name first.
+  reader->forEachCounter(
+      [this](absl::string_view name, const Stats::DynamicSpans& spans, uint64_t value) {
+        stat_merger_->mergeCounter(name, spans, value);
+      });
+  reader->forEachGauge(
+      [this](absl::string_view name, const Stats::DynamicSpans& spans, uint64_t value) {
+        stat_merger_->mergeGauge(name, spans, value);
+      });
+}
+
 } // namespace Server
 } // namespace Envoy
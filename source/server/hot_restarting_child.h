@@ -23,6 +23,8 @@ public:
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
 
 private:
+  void mergeParentStatsFromSharedMemory(const std::string& segment_name);
+
   const int restart_epoch_;
   bool parent_terminated_{};
   sockaddr_un parent_address_;
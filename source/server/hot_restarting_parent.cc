@@ -2,11 +2,13 @@
 
 #include "envoy/server/instance.h"
 
+#include "source/common/api/os_sys_calls_impl_hot_restart.h"
 #include "source/common/memory/stats.h"
 #include "source/common/network/utility.h"
 #include "source/common/stats/stat_merger.h"
 #include "source/common/stats/symbol_table.h"
 #include "source/common/stats/utility.h"
+#include "source/server/stats_segment.h"
 
 namespace Envoy {
 namespace Server {
@@ -15,7 +17,8 @@ using HotRestartMessage = envoy::HotRestartMessage;
 
 HotRestartingParent::HotRestartingParent(int base_id, int restart_epoch,
                                          const std::string& socket_path, mode_t socket_mode)
-    : HotRestartingBase(base_id), restart_epoch_(restart_epoch) {
+    : HotRestartingBase(base_id), restart_epoch_(restart_epoch),
+      stats_segment_name_(fmt::format("/envoy_stats_{}_{}", base_id, restart_epoch)) {
   child_address_ = createDomainSocketAddress(restart_epoch_ + 1, "child", socket_path, socket_mode);
   bindDomainSocket(restart_epoch_, "parent", socket_path, socket_mode);
 }
@@ -55,7 +58,12 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      if (wrapped_request->request().stats().shared_memory()) {
+        internal_->exportStatsToSharedMemory(wrapped_reply.mutable_reply()->mutable_stats(),
+                                             stats_segment_name_);
+      } else {
+        internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      }
       sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -82,7 +90,11 @@ void HotRestartingParent::onSocketEvent() {
   }
 }
 
-void HotRestartingParent::shutdown() { socket_event_.reset(); }
+void HotRestartingParent::shutdown() {
+  socket_event_.reset();
+  // The child unlinks each stats segment once it has mapped it, but may have exited before that.
+  Api::HotRestartOsSysCallsSingleton::get().shmUnlink(stats_segment_name_.c_str());
+}
 
 HotRestartingParent::Internal::Internal(Server::Instance* server) : server_(server) {
   Stats::Gauge& hot_restart_generation = hotRestartGeneration(*server->stats().rootScope());
@@ -136,26 +148,73 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
 // magnitude of memory usage that they are meant to avoid, since this map holds full-string
 // names. The problem can be solved by splitting the export up over many chunks.
 void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
-  server_->stats().forEachSinkedGauge(nullptr, [this, stats](Stats::Gauge& gauge) mutable {
+  forEachStatToExport(
+      [this, stats](Stats::Gauge& gauge) {
+        const std::string name = gauge.name();
+        (*stats->mutable_gauges())[name] = gauge.value();
+        recordDynamics(stats, name, gauge.statName());
+      },
+      [this, stats](Stats::Counter& counter, uint64_t latched_value) {
+        const std::string name = counter.name();
+        (*stats->mutable_counter_deltas())[name] = latched_value;
+        recordDynamics(stats, name, counter.statName());
+      });
+  exportServerStats(stats);
+}
+
+void HotRestartingParent::Internal::exportStatsToSharedMemory(
+    HotRestartMessage::Reply::Stats* stats, const std::string& segment_name) {
+  Stats::SymbolTable& symbol_table = server_->stats().symbolTable();
+  StatsSegmentWriter writer(symbol_table);
+  forEachStatToExport(
+      // The stats are referenced by the writer, as their names are only read once the allocator
+      // lock has been released.
+      [&writer](Stats::Gauge& gauge) {
+        writer.addGauge(Stats::GaugeSharedPtr(&gauge), gauge.value());
+      },
+      [&writer](Stats::Counter& counter, uint64_t latched_value) {
+        writer.addCounter(Stats::CounterSharedPtr(&counter), latched_value);
+      });
+  if (writer.writeSharedMemory(segment_name)) {
+    stats->set_shared_memory_name(segment_name);
+  } else {
+    // The counters have been latched, so their deltas can only be taken from the writer.
+    writer.forEachGauge([this, stats, &symbol_table](Stats::StatName stat_name, uint64_t value) {
+      const std::string name = symbol_table.toString(stat_name);
+      (*stats->mutable_gauges())[name] = value;
+      recordDynamics(stats, name, stat_name);
+    });
+    writer.forEachCounter([this, stats, &symbol_table](Stats::StatName stat_name, uint64_t value) {
+      const std::string name = symbol_table.toString(stat_name);
+      (*stats->mutable_counter_deltas())[name] = value;
+      recordDynamics(stats, name, stat_name);
+    });
+  }
+  exportServerStats(stats);
+}
+
+void HotRestartingParent::Internal::forEachStatToExport(
+    const std::function<void(Stats::Gauge&)>& gauge_fn,
+    const std::function<void(Stats::Counter&, uint64_t)>& counter_fn) {
+  server_->stats().forEachSinkedGauge(nullptr, [&gauge_fn](Stats::Gauge& gauge) {
     if (gauge.used()) {
-      const std::string name = gauge.name();
-      (*stats->mutable_gauges())[name] = gauge.value();
-      recordDynamics(stats, name, gauge.statName());
+      gauge_fn(gauge);
     }
   });
 
-  server_->stats().forEachSinkedCounter(nullptr, [this, stats](Stats::Counter& counter) mutable {
+  server_->stats().forEachSinkedCounter(nullptr, [&counter_fn](Stats::Counter& counter) {
     if (counter.used()) {
       // The hot restart parent is expected to have stopped its normal stat exporting (and so
       // latching) by the time it begins exporting to the hot restart child.
       uint64_t latched_value = counter.latch();
       if (latched_value > 0) {
-        const std::string name = counter.name();
-        (*stats->mutable_counter_deltas())[name] = latched_value;
-        recordDynamics(stats, name, counter.statName());
+        counter_fn(counter, latched_value);
       }
     }
   });
+}
+
+void HotRestartingParent::Internal::exportServerStats(HotRestartMessage::Reply::Stats* stats) {
   stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <string>
+
 #include "source/common/common/hash.h"
 #include "source/server/hot_restarting_base.h"
 
@@ -30,11 +33,21 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Like exportStatsToChild, but writes the counters and gauges to the shared memory object
+    // named segment_name, falling back to the reply if it cannot be written.
+    void exportStatsToSharedMemory(envoy::HotRestartMessage::Reply::Stats* stats,
+                                   const std::string& segment_name);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
 
   private:
+    // Calls gauge_fn with each used gauge, and counter_fn with each used counter which was added
+    // to since it was last exported, latching it.
+    void forEachStatToExport(const std::function<void(Stats::Gauge&)>& gauge_fn,
+                             const std::function<void(Stats::Counter&, uint64_t)>& counter_fn);
+    void exportServerStats(envoy::HotRestartMessage::Reply::Stats* stats);
+
     Server::Instance* const server_{};
   };
 
@@ -42,6 +55,7 @@ private:
   void onSocketEvent();
 
   const int restart_epoch_;
+  const std::string stats_segment_name_;
   sockaddr_un child_address_;
   Event::FileEventPtr socket_event_;
   std::unique_ptr<Internal> internal_;
@@ -1,5 +1,6 @@
 #include "source/server/server.h"
 
+#include <algorithm>
 #include <csignal>
 #include <cstdint>
 #include <ctime>
@@ -97,8 +98,8 @@ InstanceImpl::InstanceImpl(
           process_context ? ProcessContextOptRef(std::ref(*process_context)) : absl::nullopt,
           watermark_factory)),
       dispatcher_(api_->allocateDispatcher("main_thread")),
-      access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+      access_log_manager_(options.fileFlushIntervalMsec(), options.fileFlushThreads(), *api_,
+                          *dispatcher_, access_log_lock, store),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(getHandler(*dispatcher_)), worker_factory_(thread_local_, *api_, hooks),
       terminated_(false),
@@ -197,47 +198,64 @@ void InstanceImpl::failHealthcheck(bool fail) {
   server_stats_->live_.set(live_.load());
 }
 
-MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source) {
-  store.forEachSinkedCounter(
-      [this](std::size_t size) {
-        snapped_counters_.reserve(size);
-        counters_.reserve(size);
-      },
-      [this](Stats::Counter& counter) {
-        snapped_counters_.push_back(Stats::CounterSharedPtr(&counter));
-        counters_.push_back({counter.latch(), counter});
-      });
-
-  store.forEachSinkedGauge(
-      [this](std::size_t size) {
-        snapped_gauges_.reserve(size);
-        gauges_.reserve(size);
-      },
-      [this](Stats::Gauge& gauge) {
-        ASSERT(gauge.importMode() != Stats::Gauge::ImportMode::Uninitialized);
-        snapped_gauges_.push_back(Stats::GaugeSharedPtr(&gauge));
-        gauges_.push_back(gauge);
-      });
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source,
+                                       bool changed_only) {
+  Stats::SizeFn counters_size = [this](std::size_t size) {
+    snapped_counters_.reserve(size);
+    counters_.reserve(size);
+  };
+  Stats::StatFn<Stats::Counter> add_counter = [this](Stats::Counter& counter) {
+    snapped_counters_.push_back(Stats::CounterSharedPtr(&counter));
+    counters_.push_back({counter.latch(), counter});
+  };
+  Stats::SizeFn gauges_size = [this](std::size_t size) {
+    snapped_gauges_.reserve(size);
+    gauges_.reserve(size);
+  };
+  Stats::StatFn<Stats::Gauge> add_gauge = [this](Stats::Gauge& gauge) {
+    ASSERT(gauge.importMode() != Stats::Gauge::ImportMode::Uninitialized);
+    snapped_gauges_.push_back(Stats::GaugeSharedPtr(&gauge));
+    gauges_.push_back(gauge);
+  };
+  Stats::SizeFn text_readouts_size = [this](std::size_t size) {
+    snapped_text_readouts_.reserve(size);
+    text_readouts_.reserve(size);
+  };
+  Stats::StatFn<Stats::TextReadout> add_text_readout = [this](Stats::TextReadout& text_readout) {
+    snapped_text_readouts_.push_back(Stats::TextReadoutSharedPtr(&text_readout));
+    text_readouts_.push_back(text_readout);
+  };
+
+  if (changed_only) {
+    // Counters that were not written have no increment to latch.
+    store.forEachChangedSinkedCounter(counters_size, add_counter);
+    store.forEachChangedSinkedGauge(gauges_size, add_gauge);
+  } else {
+    store.forEachSinkedCounter(counters_size, add_counter);
+    store.forEachSinkedGauge(gauges_size, add_gauge);
+  }
 
   store.forEachSinkedHistogram(
-      [this](std::size_t size) {
-        snapped_histograms_.reserve(size);
-        histograms_.reserve(size);
+      [this, changed_only](std::size_t size) {
+        if (!changed_only) {
+          snapped_histograms_.reserve(size);
+          histograms_.reserve(size);
+        }
       },
-      [this](Stats::ParentHistogram& histogram) {
+      [this, changed_only](Stats::ParentHistogram& histogram) {
+        // The histograms were all merged for this flush, which tells which ones have samples.
+        if (changed_only && histogram.intervalStatistics().sampleCount() == 0) {
+          return;
+        }
         snapped_histograms_.push_back(Stats::ParentHistogramSharedPtr(&histogram));
         histograms_.push_back(histogram);
       });
 
-  store.forEachSinkedTextReadout(
-      [this](std::size_t size) {
-        snapped_text_readouts_.reserve(size);
-        text_readouts_.reserve(size);
-      },
-      [this](Stats::TextReadout& text_readout) {
-        snapped_text_readouts_.push_back(Stats::TextReadoutSharedPtr(&text_readout));
-        text_readouts_.push_back(text_readout);
-      });
+  if (changed_only) {
+    store.forEachChangedSinkedTextReadout(text_readouts_size, add_text_readout);
+  } else {
+    store.forEachSinkedTextReadout(text_readouts_size, add_text_readout);
+  }
 
   snapshot_time_ = time_source.systemTime();
 }
@@ -248,7 +266,11 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, S
   // NOTE: Even if there are no sinks, creating the snapshot has the important property that it
   //       latches all counters on a periodic basis. The hot restart code assumes this is being
   //       done so this should not be removed.
-  MetricSnapshotImpl snapshot(store, time_source);
+  const bool changed_only =
+      !sinks.empty() && std::all_of(sinks.begin(), sinks.end(), [](const Stats::SinkPtr& sink) {
+        return sink->flushChangedMetricsOnly();
+      });
+  MetricSnapshotImpl snapshot(store, time_source, changed_only);
   for (const auto& sink : sinks) {
     sink->flush(snapshot);
   }
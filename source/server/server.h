@@ -426,7 +426,10 @@ private:
 //                     copying and probably be a cleaner API in general.
 class MetricSnapshotImpl : public Stats::MetricSnapshot {
 public:
-  explicit MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source);
+  // If changed_only is set, only the metrics changed since the previous snapshot of the store
+  // with changed_only set are included. See Stats::Sink::flushChangedMetricsOnly().
+  explicit MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source,
+                              bool changed_only = false);
 
   // Stats::MetricSnapshot
   const std::vector<CounterSnapshot>& counters() override { return counters_; }
@@ -0,0 +1,274 @@
+#include "source/server/stats_segment.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "envoy/api/os_sys_calls_hot_restart.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/api/os_sys_calls_impl_hot_restart.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/safe_memcpy.h"
+
+namespace Envoy {
+namespace Server {
+
+namespace {
+
+void appendUint32(uint32_t value, std::string& out) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+uint64_t paddedLength(uint64_t length) { return (length + 3) & ~uint64_t(3); }
+
+} // namespace
+
+void StatsSegmentWriter::forEachCounter(const StatFn& fn) const {
+  for (const auto& [name, value] : counters_) {
+    fn(name, value);
+  }
+}
+
+void StatsSegmentWriter::forEachGauge(const StatFn& fn) const {
+  for (const auto& [name, value] : gauges_) {
+    fn(name, value);
+  }
+}
+
+void StatsSegmentWriter::appendName(Stats::StatName stat_name, std::string& names) const {
+  const std::string name = symbol_table_.toString(stat_name);
+  const Stats::DynamicSpans spans = symbol_table_.getDynamicSpans(stat_name);
+  appendUint32(name.size(), names);
+  appendUint32(spans.size(), names);
+  for (const Stats::DynamicSpan& span : spans) {
+    appendUint32(span.first, names);
+    appendUint32(span.second, names);
+  }
+  names.append(name);
+  names.append(paddedLength(name.size()) - name.size(), '\0');
+}
+
+std::string StatsSegmentWriter::nameTable() const {
+  std::string names;
+  for (const auto& counter : counters_) {
+    appendName(counter.first, names);
+  }
+  for (const auto& gauge : gauges_) {
+    appendName(gauge.first, names);
+  }
+  return names;
+}
+
+uint64_t StatsSegmentWriter::segmentSize(const std::string& names) const {
+  return sizeof(StatsSegmentHeader) + (counters_.size() + gauges_.size()) * sizeof(uint64_t) +
+         names.size();
+}
+
+void StatsSegmentWriter::layOut(const std::string& names, char* memory) const {
+  StatsSegmentHeader header;
+  header.magic_ = StatsSegmentMagic;
+  header.version_ = StatsSegmentVersion;
+  header.num_counters_ = counters_.size();
+  header.num_gauges_ = gauges_.size();
+  header.size_ = segmentSize(names);
+
+  // Everything but the magic, which is written once the rest of the segment is visible.
+  const char* header_bytes = reinterpret_cast<const char*>(&header);
+  char* out = std::copy(header_bytes + sizeof(uint64_t), header_bytes + sizeof(header),
+                        memory + sizeof(uint64_t));
+  for (const auto& counter : counters_) {
+    safeMemcpyUnsafeDst(out, &counter.second);
+    out += sizeof(uint64_t);
+  }
+  for (const auto& gauge : gauges_) {
+    safeMemcpyUnsafeDst(out, &gauge.second);
+    out += sizeof(uint64_t);
+  }
+  out = std::copy(names.begin(), names.end(), out);
+  ASSERT(static_cast<uint64_t>(out - memory) == header.size_);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::copy(header_bytes, header_bytes + sizeof(uint64_t), memory);
+}
+
+std::string StatsSegmentWriter::segment() const {
+  const std::string names = nameTable();
+  std::string segment(segmentSize(names), '\0');
+  layOut(names, segment.data());
+  return segment;
+}
+
+bool StatsSegmentWriter::writeSharedMemory(const std::string& name) const {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  // Readers which have opened the previous object keep it until they close it.
+  hot_restart_os_sys_calls.shmUnlink(name.c_str());
+  const Api::SysCallIntResult open_result =
+      hot_restart_os_sys_calls.shmOpen(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (open_result.return_value_ == -1) {
+    ENVOY_LOG(warn, "cannot create stats shared memory {}: {}", name,
+              errorDetails(open_result.errno_));
+    return false;
+  }
+  const int fd = open_result.return_value_;
+
+  // The values are laid out straight into the mapping; only the name table is built beforehand,
+  // as its size is needed to size the object.
+  const std::string names = nameTable();
+  const uint64_t size = segmentSize(names);
+  bool written = false;
+  const Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(fd, size);
+  if (truncate_result.return_value_ != -1) {
+    const Api::SysCallPtrResult mmap_result =
+        os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mmap_result.return_value_ != MAP_FAILED) {
+      char* memory = static_cast<char*>(mmap_result.return_value_);
+      layOut(names, memory);
+      os_sys_calls.munmap(memory, size);
+      written = true;
+    } else {
+      ENVOY_LOG(warn, "cannot map stats shared memory {}: {}", name,
+                errorDetails(mmap_result.errno_));
+    }
+  } else {
+    ENVOY_LOG(warn, "cannot size stats shared memory {} to {} bytes: {}", name, size,
+              errorDetails(truncate_result.errno_));
+  }
+  os_sys_calls.close(fd);
+  if (!written) {
+    hot_restart_os_sys_calls.shmUnlink(name.c_str());
+  }
+  return written;
+}
+
+StatsSegmentReader::StatsSegmentReader(absl::string_view memory, void* mapping)
+    : mapping_(mapping) {
+  if (mapping_ == nullptr) {
+    copy_ = std::string(memory);
+    memory_ = copy_;
+  } else {
+    memory_ = memory;
+  }
+}
+
+StatsSegmentReader::~StatsSegmentReader() {
+  if (mapping_ != nullptr) {
+    Api::OsSysCallsSingleton::get().munmap(mapping_, memory_.size());
+  }
+}
+
+std::unique_ptr<StatsSegmentReader> StatsSegmentReader::create(absl::string_view memory) {
+  std::unique_ptr<StatsSegmentReader> reader(new StatsSegmentReader(memory, nullptr));
+  if (!reader->parse()) {
+    return nullptr;
+  }
+  return reader;
+}
+
+std::unique_ptr<StatsSegmentReader> StatsSegmentReader::openSharedMemory(const std::string& name) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult open_result =
+      Api::HotRestartOsSysCallsSingleton::get().shmOpen(name.c_str(), O_RDONLY, 0);
+  if (open_result.return_value_ == -1) {
+    return nullptr;
+  }
+  const int fd = open_result.return_value_;
+  struct stat stat_buf;
+  const Api::SysCallIntResult stat_result = os_sys_calls.fstat(fd, &stat_buf);
+  if (stat_result.return_value_ == -1 ||
+      static_cast<uint64_t>(stat_buf.st_size) < sizeof(StatsSegmentHeader)) {
+    os_sys_calls.close(fd);
+    return nullptr;
+  }
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, stat_buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid once the object is closed.
+  os_sys_calls.close(fd);
+  if (mmap_result.return_value_ == MAP_FAILED) {
+    return nullptr;
+  }
+  std::unique_ptr<StatsSegmentReader> reader(new StatsSegmentReader(
+      absl::string_view(static_cast<const char*>(mmap_result.return_value_), stat_buf.st_size),
+      mmap_result.return_value_));
+  if (!reader->parse()) {
+    return nullptr;
+  }
+  return reader;
+}
+
+bool StatsSegmentReader::parse() {
+  StatsSegmentHeader header;
+  if (memory_.size() < sizeof(header)) {
+    return false;
+  }
+  safeMemcpyUnsafeSrc(&header.magic_, memory_.data());
+  std::atomic_thread_fence(std::memory_order_acquire);
+  safeMemcpyUnsafeSrc(&header, memory_.data());
+  if (header.magic_ != StatsSegmentMagic || header.version_ != StatsSegmentVersion ||
+      header.size_ < sizeof(header) || header.size_ > memory_.size()) {
+    return false;
+  }
+  // Bounds each count by the values that fit in the segment before adding them up.
+  const uint64_t max_values = (header.size_ - sizeof(header)) / sizeof(uint64_t);
+  if (header.num_counters_ > max_values || header.num_gauges_ > max_values - header.num_counters_) {
+    return false;
+  }
+  const uint64_t num_stats = header.num_counters_ + header.num_gauges_;
+  num_counters_ = header.num_counters_;
+  stats_.resize(num_stats);
+
+  const char* data = memory_.data();
+  uint64_t offset = sizeof(header);
+  for (Stat& stat : stats_) {
+    safeMemcpyUnsafeSrc(&stat.value_, data + offset);
+    offset += sizeof(uint64_t);
+  }
+  auto read_uint32 = [&](uint32_t& value) {
+    if (header.size_ - offset < sizeof(value)) {
+      return false;
+    }
+    safeMemcpyUnsafeSrc(&value, data + offset);
+    offset += sizeof(value);
+    return true;
+  };
+  for (Stat& stat : stats_) {
+    uint32_t name_length;
+    uint32_t num_spans;
+    if (!read_uint32(name_length) || !read_uint32(num_spans)) {
+      return false;
+    }
+    stat.spans_.reserve(std::min<uint64_t>(num_spans, (header.size_ - offset) / 8));
+    for (uint32_t i = 0; i < num_spans; ++i) {
+      Stats::DynamicSpan span;
+      if (!read_uint32(span.first) || !read_uint32(span.second)) {
+        return false;
+      }
+      stat.spans_.push_back(span);
+    }
+    if (header.size_ - offset < paddedLength(name_length)) {
+      return false;
+    }
+    stat.name_ = memory_.substr(offset, name_length);
+    offset += paddedLength(name_length);
+  }
+  return true;
+}
+
+void StatsSegmentReader::forEachCounter(const StatFn& fn) const {
+  for (uint64_t i = 0; i < num_counters_; ++i) {
+    fn(stats_[i].name_, stats_[i].spans_, stats_[i].value_);
+  }
+}
+
+void StatsSegmentReader::forEachGauge(const StatFn& fn) const {
+  for (uint64_t i = num_counters_; i < stats_.size(); ++i) {
+    fn(stats_[i].name_, stats_[i].spans_, stats_[i].value_);
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/stats/symbol_table.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Header of a stats segment: a snapshot of counter and gauge values laid out in fixed-size arrays,
+ * followed by a table of their names, which can be placed in POSIX shared memory and read by
+ * another process on the same host without any serialization. The layout, in host byte order, is:
+ *
+ *   StatsSegmentHeader
+ *   uint64_t counter values[num_counters_]
+ *   uint64_t gauge values[num_gauges_]
+ *   for each counter, then each gauge:
+ *     uint32_t name length, uint32_t number of dynamic spans,
+ *     uint32_t first and last token of each dynamic span (@see SymbolTable::getDynamicSpans),
+ *     the name, padded with zeros to a multiple of 4 bytes.
+ *
+ * The magic is written last, so a reader never accepts a segment that is still being written.
+ */
+struct StatsSegmentHeader {
+  uint64_t magic_;
+  uint64_t version_;
+  uint64_t size_;
+  uint64_t num_counters_;
+  uint64_t num_gauges_;
+};
+
+constexpr uint64_t StatsSegmentMagic = 0x656e766f79737473;
+// Increment this whenever the layout of a stats segment changes.
+constexpr uint64_t StatsSegmentVersion = 1;
+
+/**
+ * Builds a stats segment.
+ */
+class StatsSegmentWriter : Logger::Loggable<Logger::Id::main> {
+public:
+  explicit StatsSegmentWriter(Stats::SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+
+  /**
+   * Adds a stat to the segment. The stat names must stay valid while the writer is used.
+   */
+  void addCounter(Stats::StatName name, uint64_t value) { counters_.emplace_back(name, value); }
+  void addGauge(Stats::StatName name, uint64_t value) { gauges_.emplace_back(name, value); }
+
+  /**
+   * Adds a stat to the segment, holding a reference to it so that its name stays valid.
+   */
+  void addCounter(Stats::CounterSharedPtr counter, uint64_t value) {
+    addCounter(counter->statName(), value);
+    counter_refs_.push_back(std::move(counter));
+  }
+  void addGauge(Stats::GaugeSharedPtr gauge, uint64_t value) {
+    addGauge(gauge->statName(), value);
+    gauge_refs_.push_back(std::move(gauge));
+  }
+
+  using StatFn = std::function<void(Stats::StatName name, uint64_t value)>;
+  void forEachCounter(const StatFn& fn) const;
+  void forEachGauge(const StatFn& fn) const;
+
+  /**
+   * @return the segment laid out into a string.
+   */
+  std::string segment() const;
+
+  /**
+   * Writes the segment to a new POSIX shared memory object, replacing any object with the same
+   * name, so that readers which have mapped the previous segment keep a consistent snapshot.
+   * @param name the name of the shared memory object, starting with '/'.
+   * @return whether the segment was written.
+   */
+  bool writeSharedMemory(const std::string& name) const;
+
+private:
+  void appendName(Stats::StatName name, std::string& names) const;
+  // The table of names, which is the only part of the segment whose size depends on the names.
+  std::string nameTable() const;
+  uint64_t segmentSize(const std::string& names) const;
+  // Lays the segment out into memory of segmentSize(names) bytes, writing the magic last.
+  void layOut(const std::string& names, char* memory) const;
+
+  Stats::SymbolTable& symbol_table_;
+  std::vector<std::pair<Stats::StatName, uint64_t>> counters_;
+  std::vector<std::pair<Stats::StatName, uint64_t>> gauges_;
+  // The stats added by reference, whose storage holds their names.
+  std::vector<Stats::CounterSharedPtr> counter_refs_;
+  std::vector<Stats::GaugeSharedPtr> gauge_refs_;
+};
+
+/**
+ * Reads the stats of a segment built by a StatsSegmentWriter, in this or another process.
+ */
+class StatsSegmentReader {
+public:
+  /**
+   * Parses a segment held in memory, which is copied.
+   * @return the reader, or nullptr if memory does not hold a valid segment.
+   */
+  static std::unique_ptr<StatsSegmentReader> create(absl::string_view memory);
+
+  /**
+   * Maps a segment written to POSIX shared memory.
+   * @param name the name of the shared memory object, starting with '/'.
+   * @return the reader, or nullptr if there is no such object or it is not a valid segment.
+   */
+  static std::unique_ptr<StatsSegmentReader> openSharedMemory(const std::string& name);
+
+  ~StatsSegmentReader();
+
+  using StatFn = std::function<void(absl::string_view name, const Stats::DynamicSpans& spans,
+                                    uint64_t value)>;
+  void forEachCounter(const StatFn& fn) const;
+  void forEachGauge(const StatFn& fn) const;
+
+  uint64_t numCounters() const { return num_counters_; }
+  uint64_t numGauges() const { return stats_.size() - num_counters_; }
+
+private:
+  struct Stat {
+    absl::string_view name_;
+    Stats::DynamicSpans spans_;
+    uint64_t value_;
+  };
+
+  StatsSegmentReader(absl::string_view memory, void* mapping);
+  // Parses the segment, returning false if it is not valid.
+  bool parse();
+
+  // Holds the segment when it was not mapped.
+  std::string copy_;
+  absl::string_view memory_;
+  void* const mapping_;
+  uint64_t num_counters_{0};
+  // The counters, then the gauges. The names point into memory_.
+  std::vector<Stat> stats_;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+
+#include "source/common/access_log/access_log_manager_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace AccessLog {
+namespace {
+
+// Measures the cost of writing to a single access log file from a varying number of threads,
+// e.g. from every worker logging to the same file. The file is /dev/null so that the cost of the
+// flush thread writing to disk doesn't dominate. The second argument is the number of shared flush
+// threads, 0 for a flush thread per file.
+void bmConcurrentWrites(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  const uint32_t file_flush_threads = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_threads > 2) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  constexpr uint32_t writes_per_thread = 10000;
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  Thread::MutexBasicLockable lock;
+  Stats::IsolatedStoreImpl store;
+  AccessLogManagerImpl access_log_manager(std::chrono::milliseconds(1000), file_flush_threads,
+                                          *api, *dispatcher, lock, store);
+  AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "/dev/null"});
+  const std::string line(200, 'a');
+
+  for (auto _ : state) { // NOLINT
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < num_threads; ++i) {
+      threads.push_back(api->threadFactory().createThread([&log_file, &line]() {
+        for (uint32_t j = 0; j < writes_per_thread; ++j) {
+          log_file->write(line);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * writes_per_thread);
+}
+BENCHMARK(bmConcurrentWrites)
+    ->ArgsProduct({{1, 2, 4, 8, 16}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace AccessLog
+} // namespace Envoy
@@ -11,6 +11,7 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -29,9 +30,10 @@ namespace {
 
 class AccessLogManagerImplTest : public testing::Test {
 protected:
-  AccessLogManagerImplTest()
+  AccessLogManagerImplTest() : AccessLogManagerImplTest(0) {}
+  explicit AccessLogManagerImplTest(uint32_t file_flush_threads)
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(timeout_40ms_, file_flush_threads, api_, dispatcher_, lock_, store_) {
     EXPECT_CALL(file_system_,
                 createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
                     Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})))
@@ -170,9 +172,9 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFileOnDemand) {
 
   EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
 
-  // The first write to a given file will start the flush thread. Because AccessManagerImpl::write
-  // holds the write_lock_ when the thread is started, the thread will flush on its first loop, once
-  // it obtains the write_lock_. Perform a write to get all that out of the way.
+  // The first write to a given file will start the flush thread. Because the data is queued by the
+  // time the thread checks for pending data, the thread will flush on its first loop. Perform a
+  // write to get all that out of the way.
   EXPECT_CALL(*file_, write_(_))
       .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
         return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
@@ -486,6 +488,59 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+// Writes from concurrent threads are all flushed, in order per thread.
+TEST_F(AccessLogManagerImplTest, ConcurrentWritesKeepPerThreadOrder) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  // MockFile::write() serializes calls to write_().
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&written](absl::string_view data) -> Api::IoCallSizeResult {
+        absl::StrAppend(&written, data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  constexpr uint32_t num_threads = 4;
+  // Enough data for the flush thread to flush concurrently with the writers.
+  constexpr uint32_t writes_per_thread = 10000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory_.createThread([&log_file, i]() {
+      for (uint32_t j = 0; j < writes_per_thread; ++j) {
+        log_file->write(absl::StrCat(i, ":", j, "\n"));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  std::vector<uint32_t> next(num_threads, 0);
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    for (absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+      std::vector<absl::string_view> parts = absl::StrSplit(line, ':');
+      ASSERT_EQ(2, parts.size());
+      uint32_t thread_index;
+      uint32_t write_index;
+      ASSERT_TRUE(absl::SimpleAtoi(parts[0], &thread_index));
+      ASSERT_TRUE(absl::SimpleAtoi(parts[1], &write_index));
+      ASSERT_LT(thread_index, num_threads);
+      EXPECT_EQ(next[thread_index]++, write_index);
+    }
+  }
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    EXPECT_EQ(writes_per_thread, next[i]);
+  }
+  EXPECT_EQ(num_threads * writes_per_thread, store_.counter("filesystem.write_buffered").value());
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
@@ -573,6 +628,119 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+class AccessLogManagerImplFlushThreadPoolTest : public AccessLogManagerImplTest {
+protected:
+  AccessLogManagerImplFlushThreadPoolTest() : AccessLogManagerImplTest(2) {}
+
+  void waitForWrites(Filesystem::MockFile& file, uint32_t num_writes) {
+    Thread::LockGuard lock(file.write_mutex_);
+    while (file.num_writes_ != num_writes) {
+      file.write_event_.wait(file.write_mutex_);
+    }
+  }
+};
+
+// All files are flushed by the shared threads on a single timer.
+TEST_F(AccessLogManagerImplFlushThreadPoolTest, FlushAllFilesPeriodically) {
+  // Only the pool creates a timer.
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  NiceMock<Filesystem::MockFile>* file2 = new NiceMock<Filesystem::MockFile>;
+  EXPECT_CALL(*file2, path()).WillRepeatedly(Return("bar"));
+  EXPECT_CALL(file_system_,
+              createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
+                  Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"})))
+      .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file2))));
+  EXPECT_CALL(*file2, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file2 = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"});
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("test"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file2, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("test2"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("test");
+  log_file2->write("test2");
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+
+  // make sure timer is re-enabled on callback call
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+  timer->invokeCallback();
+
+  waitForWrites(*file_, 1);
+  waitForWrites(*file2, 1);
+  waitForCounterEq("filesystem.write_completed", 2);
+  EXPECT_EQ(2UL, store_.counter("filesystem.flushed_by_timer").value());
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file2, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplFlushThreadPoolTest, BigDataChunkShouldBeFlushedWithoutTimer) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        std::string expected(1024 * 64 + 1, 'b');
+        EXPECT_EQ(0, data.compare(expected));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  std::string big_string(1024 * 64 + 1, 'b');
+  log_file->write(big_string);
+
+  waitForWrites(*file_, 1);
+  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplFlushThreadPoolTest, ReopenFileOnTimer) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  Sequence sq;
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+
+  access_log_manager_.reopen();
+  timer->invokeCallback();
+
+  {
+    Thread::LockGuard lock(file_->open_mutex_);
+    while (file_->num_opens_ != 2) {
+      file_->open_event_.wait(file_->open_mutex_);
+    }
+  }
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "source/common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+bool isAligned(const void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+class Tracked {
+public:
+  Tracked(int& live, std::string value) : live_(live), value_(std::move(value)) { ++live_; }
+  ~Tracked() { --live_; }
+
+  const std::string& value() const { return value_; }
+
+private:
+  int& live_;
+  const std::string value_;
+};
+
+TEST(ArenaTest, AllocatesLazily) {
+  Arena arena;
+  EXPECT_EQ(0, arena.blocks());
+  EXPECT_EQ(0, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndDistinct) {
+  Arena arena(64);
+  char* previous = nullptr;
+  for (size_t i = 0; i < 100; ++i) {
+    const size_t alignment = size_t(1) << (i % 7);
+    char* ptr = static_cast<char*>(arena.allocate(i + 1, alignment));
+    EXPECT_TRUE(isAligned(ptr, alignment)) << i;
+    EXPECT_NE(previous, ptr);
+    // Writes the whole allocation so that ASAN catches allocations past the end of a block.
+    memset(ptr, static_cast<int>(i), i + 1);
+    previous = ptr;
+  }
+  EXPECT_EQ(5050, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, BlocksGrow) {
+  Arena arena(128);
+  arena.allocate(100);
+  EXPECT_EQ(1, arena.blocks());
+  // Does not fit in the first block, and fits in the second one twice the size.
+  arena.allocate(100);
+  EXPECT_EQ(2, arena.blocks());
+  arena.allocate(100);
+  EXPECT_EQ(2, arena.blocks());
+  // Larger than the next block size.
+  arena.allocate(4096);
+  EXPECT_EQ(3, arena.blocks());
+}
+
+TEST(ArenaTest, ArenaPtr) {
+  int live = 0;
+  Arena arena;
+  {
+    ArenaPtr<Tracked> in_arena = makeArenaPtr<Tracked>(&arena, live, "arena");
+    ArenaPtr<Tracked> on_heap = makeArenaPtr<Tracked>(nullptr, live, "heap");
+    EXPECT_EQ(2, live);
+    EXPECT_EQ("arena", in_arena->value());
+    EXPECT_EQ("heap", on_heap->value());
+    EXPECT_EQ(1, arena.blocks());
+  }
+  EXPECT_EQ(0, live);
+}
+
+TEST(ArenaTest, ArenaAllocator) {
+  int live = 0;
+  Arena arena;
+  {
+    std::list<std::string, ArenaAllocator<std::string>> list{ArenaAllocator<std::string>(&arena)};
+    for (int i = 0; i < 10; ++i) {
+      list.emplace_back("value");
+    }
+    EXPECT_GT(arena.bytesAllocated(), 0);
+
+    std::shared_ptr<Tracked> shared =
+        std::allocate_shared<Tracked>(ArenaAllocator<Tracked>(&arena), live, "shared");
+    EXPECT_EQ(1, live);
+  }
+  EXPECT_EQ(0, live);
+}
+
+TEST(ArenaTest, ArenaAllocatorWithoutArena) {
+  std::list<std::string, ArenaAllocator<std::string>> list;
+  list.emplace_back("value");
+  EXPECT_EQ(nullptr, list.get_allocator().arena());
+  EXPECT_EQ("value", list.front());
+}
+
+} // namespace
+} // namespace Envoy
@@ -1,3 +1,4 @@
+#include "source/common/common/arena.h"
 #include "source/common/common/linked_object.h"
 
 #include "gtest/gtest.h"
@@ -41,4 +42,31 @@ TEST(LinkedObjectTest, MoveIntoListBack) {
   ASSERT_EQ(object_ptr, list.front().get());
 }
 
+class ArenaTestObject;
+using ArenaTestObjectList =
+    std::list<ArenaPtr<ArenaTestObject>, ArenaAllocator<ArenaPtr<ArenaTestObject>>>;
+
+class ArenaTestObject : public LinkedObject<ArenaTestObject, ArenaTestObjectList> {
+public:
+  ArenaTestObject() = default;
+};
+
+TEST(LinkedObjectTest, CustomListType) {
+  Arena arena;
+  ArenaTestObjectList list{ArenaAllocator<ArenaPtr<ArenaTestObject>>(&arena)};
+  auto object = makeArenaPtr<ArenaTestObject>(&arena);
+  ArenaTestObject* object_ptr = object.get();
+  LinkedList::moveIntoListBack(std::move(object), list);
+  auto object2 = makeArenaPtr<ArenaTestObject>(&arena);
+  ArenaTestObject* object2_ptr = object2.get();
+  LinkedList::moveIntoList(std::move(object2), list);
+  ASSERT_EQ(2, list.size());
+  ASSERT_EQ(object2_ptr, list.front().get());
+
+  ArenaPtr<ArenaTestObject> removed = object_ptr->removeFromList(list);
+  ASSERT_EQ(object_ptr, removed.get());
+  ASSERT_FALSE(removed->inserted());
+  ASSERT_EQ(1, list.size());
+}
+
 } // namespace Envoy
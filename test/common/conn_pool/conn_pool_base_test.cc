@@ -18,6 +18,9 @@ using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::Return;
 
+using AdaptivePreconnect =
+    envoy::config::cluster::v3::Cluster::PreconnectPolicy::AdaptivePreconnect;
+
 class TestActiveClient : public ActiveClient {
 public:
   TestActiveClient(ConnPoolImplBase& parent, uint32_t lifetime_stream_limit,
@@ -353,6 +356,98 @@ TEST_F(ConnPoolImplBaseTest, ExplicitPreconnectNotHealthy) {
   EXPECT_FALSE(pool_.maybePreconnectImpl(1));
 }
 
+TEST(AdaptivePreconnectEstimatorTest, AnticipatedStreams) {
+  AdaptivePreconnect config;
+  AdaptivePreconnectEstimator estimator(config);
+  const MonotonicTime start;
+
+  // Nothing is anticipated until a connect time is known.
+  for (int i = 0; i < 20; ++i) {
+    estimator.onNewStream(start);
+  }
+  EXPECT_EQ(0, estimator.anticipatedStreams(start));
+
+  // 20 streams per second with a 100ms connect time.
+  estimator.onConnected(std::chrono::milliseconds(100));
+  EXPECT_EQ(2, estimator.anticipatedStreams(start));
+
+  // The rate decays to 20 / e streams per second after a second without streams.
+  EXPECT_EQ(1, estimator.anticipatedStreams(start + std::chrono::seconds(1)));
+
+  // The anticipated streams are capped.
+  for (int i = 0; i < 1000; ++i) {
+    estimator.onNewStream(start);
+  }
+  EXPECT_EQ(10, estimator.anticipatedStreams(start));
+}
+
+TEST(AdaptivePreconnectEstimatorTest, ConnectTimePercentile) {
+  AdaptivePreconnect config;
+  config.mutable_rate_interval()->set_seconds(10);
+  config.mutable_max_anticipated_streams()->set_value(100);
+  AdaptivePreconnectEstimator p99_estimator(config);
+  config.mutable_connect_time_percentile()->set_value(50);
+  AdaptivePreconnectEstimator p50_estimator(config);
+  const MonotonicTime start;
+
+  // 10 streams per second.
+  for (int i = 0; i < 100; ++i) {
+    p99_estimator.onNewStream(start);
+    p50_estimator.onNewStream(start);
+  }
+  // One slow connect out of 32.
+  for (int i = 0; i < 32; ++i) {
+    const std::chrono::milliseconds connect_time(i == 0 ? 2000 : 100);
+    p99_estimator.onConnected(connect_time);
+    p50_estimator.onConnected(connect_time);
+  }
+  EXPECT_EQ(20, p99_estimator.anticipatedStreams(start));
+  EXPECT_EQ(1, p50_estimator.anticipatedStreams(start));
+
+  // The slow connect is forgotten once 32 more recent connects are known.
+  p99_estimator.onConnected(std::chrono::milliseconds(100));
+  EXPECT_EQ(1, p99_estimator.anticipatedStreams(start));
+}
+
+TEST_F(ConnPoolImplDispatcherBaseTest, AdaptivePreconnect) {
+  const AdaptivePreconnect config;
+  ON_CALL(*cluster_, adaptivePreconnect).WillByDefault(Return(makeOptRef(config)));
+  TestConnPoolImplBase pool(host_, Upstream::ResourcePriority::Default, *dispatcher_, nullptr,
+                            nullptr, state_);
+  ON_CALL(pool, instantiateActiveClient).WillByDefault(Invoke([&]() -> ActiveClientPtr {
+    auto ret = std::make_unique<NiceMock<TestActiveClient>>(pool, stream_limit_,
+                                                            concurrent_streams_, false);
+    clients_.push_back(ret.get());
+    ret->real_host_description_ = descr_;
+    return ret;
+  }));
+  ON_CALL(pool, onPoolReady(_, _)).WillByDefault(Invoke([](ActiveClient& client, AttachContext&) {
+    TestActiveClient::incrementActiveStreams(client);
+  }));
+
+  // Without a known connect time, only the connection for the stream is created.
+  EXPECT_CALL(pool, instantiateActiveClient);
+  pool.newStreamImpl(context_, /*can_send_early_data=*/false);
+  advanceTimeAndRun(100);
+  EXPECT_CALL(pool, onPoolReady);
+  clients_.back()->onEvent(Network::ConnectionEvent::Connected);
+  --clients_.back()->active_streams_;
+  pool.onStreamClosed(*clients_.back(), false);
+  EXPECT_EQ(ActiveClient::State::Ready, clients_.back()->state());
+
+  // A stream is expected during the 100ms connect, so taking the only ready client preconnects
+  // another one.
+  EXPECT_CALL(pool, onPoolReady);
+  EXPECT_CALL(pool, instantiateActiveClient);
+  pool.newStreamImpl(context_, /*can_send_early_data=*/false);
+  EXPECT_EQ(2, clients_.size());
+  EXPECT_EQ(ActiveClient::State::Connecting, clients_.back()->state());
+
+  --clients_.front()->active_streams_;
+  pool.onStreamClosed(*clients_.front(), false);
+  pool.destructAllConnections();
+}
+
 TEST_F(ConnPoolImplDispatcherBaseTest, MaxConnectionDurationTimerNull) {
   // Force a null max connection duration optional.
   // newActiveClientAndStream() will expect the connection duration timer to remain null.
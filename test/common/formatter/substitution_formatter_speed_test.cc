@@ -3,6 +3,7 @@
 
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "benchmark/benchmark.h"
 
@@ -53,6 +54,40 @@ std::unique_ptr<Envoy::TestStreamInfo> makeStreamInfo(TimeSource& time_source) {
   return stream_info;
 }
 
+// The same fields, as a text format.
+constexpr absl::string_view TextLogFormat =
+    "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT% %START_TIME(%Y/%m/%dT%H:%M:%S%z %s)% "
+    "%REQ(:METHOD)% "
+    "%REQ(X-FORWARDED-PROTO)%://%REQ(:AUTHORITY)%%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)% %PROTOCOL% "
+    "%RESPONSE_CODE% %BYTES_SENT% %DURATION% %REQ(REFERER)% %REQ(USER-AGENT)%\n";
+
+Http::TestRequestHeaderMapImpl makeRequestHeaders() {
+  return {{":method", "GET"},
+          {":authority", "example.com"},
+          {":path", "/some/path?with=query"},
+          {"x-forwarded-proto", "https"},
+          {"referer", "https://example.com/"},
+          {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) \"quoted\""}};
+}
+
+// Measures formatting a log line with the given formatter, for requests with typical headers.
+void formatWithHeaders(benchmark::State& state, const Formatter::Formatter& formatter) {
+  MockTimeSystem time_system;
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes +=
+        formatter.format(request_headers, response_headers, response_trailers, *stream_info, body)
+            .length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+
 } // namespace
 
 // Test measures how fast Formatters are constructed from
@@ -185,6 +220,30 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
 
+// The next benchmarks compare the same fields formatted as text, as JSON written directly and as
+// JSON converted from a Struct.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_TextAccessLogFormatterWithHeaders(benchmark::State& state) {
+  Envoy::Formatter::FormatterImpl formatter{std::string(TextLogFormat), false};
+  formatWithHeaders(state, formatter);
+}
+BENCHMARK(BM_TextAccessLogFormatterWithHeaders);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_JsonAccessLogFormatterWithHeaders(benchmark::State& state) {
+  formatWithHeaders(state, *makeJsonFormatter(false));
+}
+BENCHMARK(BM_JsonAccessLogFormatterWithHeaders);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StructJsonAccessLogFormatterWithHeaders(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.logging_with_fast_json_formatter", "false"}});
+  formatWithHeaders(state, *makeJsonFormatter(false));
+}
+BENCHMARK(BM_StructJsonAccessLogFormatterWithHeaders);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_FormatterCommandParsing(benchmark::State& state) {
   const std::string token = "Listener:namespace:key";
@@ -3516,6 +3516,61 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterWritesEscapedAndEmptyValues) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"some-header", "with \"quotes\"\t\\"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    z_header: '%REQ(some-header)%'
+    a_missing: '%REQ(missing-header)%'
+    "quoted \"key\"": '%PROTOCOL%'
+    number: 1.5
+    multi: '%PROTOCOL%/%REQ(missing-header)%/%REQ(some-header):4%'
+    list:
+      - '%REQ(missing-header)%'
+      - '%PROTOCOL%'
+      - nested_empty: '%REQ(missing-header)%'
+  )EOF",
+                            key_mapping);
+
+  {
+    JsonFormatterImpl formatter(key_mapping, false, false);
+    EXPECT_EQ(
+        "{\"a_missing\":\"-\",\"list\":[\"-\",\"HTTP/1.1\",{\"nested_empty\":\"-\"}],"
+        "\"multi\":\"HTTP/1.1/-/with\",\"number\":\"1.5\",\"quoted \\\"key\\\"\":\"HTTP/1.1\","
+        "\"z_header\":\"with \\\"quotes\\\"\\t\\\\\"}\n",
+        formatter.format(request_header, response_header, response_trailer, stream_info, body));
+  }
+  {
+    JsonFormatterImpl formatter(key_mapping, false, true);
+    EXPECT_EQ(
+        "{\"list\":[\"HTTP/1.1\",{}],\"multi\":\"HTTP/1.1//with\",\"number\":\"1.5\","
+        "\"quoted \\\"key\\\"\":\"HTTP/1.1\",\"z_header\":\"with \\\"quotes\\\"\\t\\\\\"}\n",
+        formatter.format(request_header, response_header, response_trailer, stream_info, body));
+  }
+
+  // The output is the same JSON as the one converted from a Struct.
+  for (const bool omit_empty_values : {false, true}) {
+    const std::string out_json =
+        JsonFormatterImpl(key_mapping, false, omit_empty_values)
+            .format(request_header, response_header, response_trailer, stream_info, body);
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues(
+        {{"envoy.reloadable_features.logging_with_fast_json_formatter", "false"}});
+    const std::string expected =
+        JsonFormatterImpl(key_mapping, false, omit_empty_values)
+            .format(request_header, response_header, response_trailer, stream_info, body);
+    EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
+  }
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
   Http::TestResponseHeaderMapImpl response_header{{"second", "PUT"}, {"test", "test"}};
@@ -0,0 +1,92 @@
+#include <memory>
+
+#include "envoy/http/filter_factory.h"
+
+#include "source/common/http/filter_manager.h"
+#include "source/common/stream_info/filter_state_impl.h"
+#include "source/extensions/filters/http/common/pass_through_filter.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/local_reply/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Filter chain of pass through filters, allocated from the stream arena when there is one.
+class PassThroughFilterChainFactory : public FilterChainFactory {
+public:
+  explicit PassThroughFilterChainFactory(uint32_t filters)
+      : filters_(filters), factory_([](FilterChainFactoryCallbacks& callbacks) {
+          OptRef<Arena> arena = callbacks.streamArena();
+          if (arena.has_value()) {
+            callbacks.addStreamFilter(std::allocate_shared<PassThroughFilter>(
+                ArenaAllocator<PassThroughFilter>(arena.ptr())));
+          } else {
+            callbacks.addStreamFilter(std::make_shared<PassThroughFilter>());
+          }
+        }) {}
+
+  bool createFilterChain(FilterChainManager& manager, bool) const override {
+    for (uint32_t i = 0; i < filters_; ++i) {
+      manager.applyFilterFactoryCb({}, factory_);
+    }
+    return true;
+  }
+  bool createUpgradeFilterChain(absl::string_view, const UpgradeMap*,
+                                FilterChainManager&) const override {
+    return false;
+  }
+
+private:
+  const uint32_t filters_;
+  // Mutable as FilterChainManager::applyFilterFactoryCb() takes a non-const reference.
+  mutable FilterFactoryCb factory_;
+};
+
+// Measures the cost of setting up a stream's filter chain, passing the request headers through it
+// and tearing it down.
+static void bmFilterChainSetupTeardown(benchmark::State& state) {
+  const uint32_t filters = state.range(0);
+  const bool stream_arena = state.range(1);
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.http_stream_arena", stream_arena ? "true" : "false"}});
+
+  testing::NiceMock<MockFilterManagerCallbacks> filter_manager_callbacks;
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  testing::NiceMock<Network::MockConnection> connection;
+  testing::NiceMock<LocalReply::MockLocalReply> local_reply;
+  testing::NiceMock<MockTimeSystem> time_source;
+  StreamInfo::FilterStateSharedPtr filter_state =
+      std::make_shared<StreamInfo::FilterStateImpl>(StreamInfo::FilterState::LifeSpan::Connection);
+  PassThroughFilterChainFactory filter_factory(filters);
+  TestRequestHeaderMapImpl request_headers{
+      {":authority", "host"}, {":path", "/"}, {":method", "GET"}, {":scheme", "http"}};
+
+  for (auto _ : state) { // NOLINT
+    DownstreamFilterManager filter_manager(
+        filter_manager_callbacks, dispatcher, connection, 0, nullptr, true, 10000, filter_factory,
+        local_reply, Protocol::Http2, time_source, filter_state,
+        StreamInfo::FilterState::LifeSpan::Connection);
+    filter_manager.createFilterChain();
+    filter_manager.requestHeadersInitialized();
+    filter_manager.decodeHeaders(request_headers, true);
+    filter_manager.destroyFilters();
+  }
+}
+BENCHMARK(bmFilterChainSetupTeardown)
+    ->ArgsProduct({{5, 10, 20}, {0, 1}})
+    ->ArgNames({"filters", "arena"});
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -15,6 +15,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_reply/mocks.h"
 #include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gtest/gtest.h"
 
@@ -432,6 +433,46 @@ TEST_F(FilterManagerTest, GetRouteLevelFilterConfigForNullRoute) {
   filter_manager_->destroyFilters();
 }
 
+TEST_F(FilterManagerTest, StreamArenaDisabledByDefault) {
+  initialize();
+  EXPECT_FALSE(filter_manager_->streamArena().has_value());
+  filter_manager_->destroyFilters();
+}
+
+// Verifies that filter factories can allocate their filters from the stream arena.
+TEST_F(FilterManagerTest, StreamArena) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.http_stream_arena", "true"}});
+  initialize();
+  ASSERT_TRUE(filter_manager_->streamArena().has_value());
+
+  // The filter lives in the arena, so the test must not keep a reference to it past the filter
+  // manager.
+  MockStreamDecoderFilter* decoder_filter = nullptr;
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainManager& manager) -> bool {
+        FilterFactoryCb factory = [&](FilterChainFactoryCallbacks& callbacks) {
+          ASSERT_TRUE(callbacks.streamArena().has_value());
+          auto filter = std::allocate_shared<NiceMock<MockStreamDecoderFilter>>(
+              ArenaAllocator<NiceMock<MockStreamDecoderFilter>>(callbacks.streamArena().ptr()));
+          decoder_filter = filter.get();
+          callbacks.addStreamDecoderFilter(std::move(filter));
+        };
+        manager.applyFilterFactoryCb({}, factory);
+        return true;
+      }));
+  filter_manager_->createFilterChain();
+  ASSERT_NE(nullptr, decoder_filter);
+  ASSERT_NE(nullptr, decoder_filter->callbacks_);
+  // The filter and its wrapper.
+  EXPECT_GT(filter_manager_->streamArena()->bytesAllocated(),
+            sizeof(MockStreamDecoderFilter) + sizeof(ActiveStreamDecoderFilter));
+
+  EXPECT_CALL(*decoder_filter, onDestroy());
+  filter_manager_->destroyFilters();
+  filter_manager_.reset();
+}
+
 } // namespace
 } // namespace Http
 } // namespace Envoy
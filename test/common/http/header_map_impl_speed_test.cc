@@ -1,6 +1,8 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
 
+#include "test/test_common/test_runtime.h"
+
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -295,5 +297,88 @@ static void headerMapImplRemovePrefix(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplRemovePrefix)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(50);
 
+/**
+ * Enable list or contiguous header map storage for the header maps created by a benchmark, as
+ * selected by its second argument.
+ */
+static void setHeaderStorage(benchmark::State& state, TestScopedRuntime& scoped_runtime) {
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.contiguous_header_map_storage",
+                               state.range(1) ? "true" : "false"}});
+}
+
+/**
+ * Create request headers with the usual pseudo headers and the given number of other headers.
+ */
+static RequestHeaderMapPtr createRequestHeaders(size_t num_headers) {
+  auto headers = Http::RequestHeaderMapImpl::create();
+  headers->setReferenceMethod(Http::Headers::get().MethodValues.Get);
+  headers->setReferenceScheme(Http::Headers::get().SchemeValues.Https);
+  headers->setHost("www.example.com");
+  headers->setPath("/index.html");
+  addDummyHeaders(*headers, num_headers);
+  return headers;
+}
+
+/**
+ * Measure the speed of iterating over request headers, with list or contiguous storage.
+ */
+static void headerMapImplStorageIterate(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setHeaderStorage(state, scoped_runtime);
+  auto headers = createRequestHeaders(state.range(0));
+  size_t total_len = 0;
+  for (auto _ : state) { // NOLINT
+    headers->iterate([&total_len](const HeaderEntry& header) -> HeaderMap::Iterate {
+      total_len += header.key().size() + header.value().size();
+      return HeaderMap::Iterate::Continue;
+    });
+  }
+  benchmark::DoNotOptimize(total_len);
+}
+BENCHMARK(headerMapImplStorageIterate)
+    ->ArgsProduct({{5, 10, 50}, {0, 1}})
+    ->ArgNames({"headers", "contiguous"});
+
+/**
+ * Measure the speed of copying request headers into a new header map, with list or contiguous
+ * storage. The destruction of the copy is also measured.
+ */
+static void headerMapImplStorageCopy(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setHeaderStorage(state, scoped_runtime);
+  auto headers = createRequestHeaders(state.range(0));
+  for (auto _ : state) { // NOLINT
+    auto copy = createHeaderMap<RequestHeaderMapImpl>(*headers);
+    benchmark::DoNotOptimize(copy->size());
+  }
+}
+BENCHMARK(headerMapImplStorageCopy)
+    ->ArgsProduct({{5, 10, 50}, {0, 1}})
+    ->ArgNames({"headers", "contiguous"});
+
+/**
+ * Measure the speed of preparing request headers for HTTP/2 encoding, with list or contiguous
+ * storage. This emulates the buildHeaders method of the HTTP/2 codec, which converts the header
+ * map into the header list submitted to the HTTP/2 library.
+ */
+static void headerMapImplStorageEmulateH2Encode(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setHeaderStorage(state, scoped_runtime);
+  auto headers = createRequestHeaders(state.range(0));
+  std::vector<std::pair<absl::string_view, absl::string_view>> final_headers;
+  for (auto _ : state) { // NOLINT
+    final_headers.clear();
+    final_headers.reserve(headers->size());
+    headers->iterate([&final_headers](const HeaderEntry& header) -> HeaderMap::Iterate {
+      final_headers.emplace_back(header.key().getStringView(), header.value().getStringView());
+      return HeaderMap::Iterate::Continue;
+    });
+    benchmark::DoNotOptimize(final_headers.data());
+  }
+}
+BENCHMARK(headerMapImplStorageEmulateH2Encode)
+    ->ArgsProduct({{5, 10, 50}, {0, 1}})
+    ->ArgNames({"headers", "contiguous"});
+
 } // namespace Http
 } // namespace Envoy
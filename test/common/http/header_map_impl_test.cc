@@ -63,8 +63,21 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Request
 Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::RequestHeaders>
     custom_header_1_copy(Http::LowerCaseString{"foo_custom_header"});
 
+// Runs the header map tests with both list and contiguous header storage.
+class HeaderMapImplTest : public testing::TestWithParam<bool> {
+protected:
+  HeaderMapImplTest() {
+    scoped_runtime_.mergeValues({{"envoy.reloadable_features.contiguous_header_map_storage",
+                                  GetParam() ? "true" : "false"}});
+  }
+
+  TestScopedRuntime scoped_runtime_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Storage, HeaderMapImplTest, testing::Bool());
+
 // Make sure that the same header registered twice points to the same location.
-TEST(HeaderMapImplTest, CustomRegisteredHeaders) {
+TEST_P(HeaderMapImplTest, CustomRegisteredHeaders) {
   TestRequestHeaderMapImpl headers;
   EXPECT_EQ(custom_header_1.handle(), custom_header_1_copy.handle());
   EXPECT_EQ(nullptr, headers.getInline(custom_header_1.handle()));
@@ -92,7 +105,7 @@ TEST(HeaderMapImplTest, CustomRegisteredHeaders) {
   EXPECT_EQ(header_map->get(Headers::get().name)[0]->value().getStringView(), 1);
 
 // Make sure that the O(1) headers are wired up properly.
-TEST(HeaderMapImplTest, AllInlineHeaders) {
+TEST_P(HeaderMapImplTest, AllInlineHeaders) {
   {
     auto header_map = RequestHeaderMapImpl::create();
     INLINE_REQ_STRING_HEADERS(TEST_INLINE_STRING_HEADER_FUNCS)
@@ -112,7 +125,7 @@ TEST(HeaderMapImplTest, AllInlineHeaders) {
   }
 }
 
-TEST(HeaderMapImplTest, InlineInsert) {
+TEST_P(HeaderMapImplTest, InlineInsert) {
   TestRequestHeaderMapImpl headers;
   EXPECT_TRUE(headers.empty());
   EXPECT_EQ(0, headers.size());
@@ -125,7 +138,7 @@ TEST(HeaderMapImplTest, InlineInsert) {
   EXPECT_EQ("hello", headers.get(Headers::get().Host)[0]->value().getStringView());
 }
 
-TEST(HeaderMapImplTest, InlineAppend) {
+TEST_P(HeaderMapImplTest, InlineAppend) {
   {
     TestRequestHeaderMapImpl headers;
     // Create via header and append.
@@ -163,7 +176,7 @@ TEST(HeaderMapImplTest, InlineAppend) {
   }
 }
 
-TEST(HeaderMapImplTest, MoveIntoInline) {
+TEST_P(HeaderMapImplTest, MoveIntoInline) {
   TestRequestHeaderMapImpl headers;
   HeaderString key;
   key.setCopy(Headers::get().EnvoyRetryOn.get());
@@ -182,7 +195,7 @@ TEST(HeaderMapImplTest, MoveIntoInline) {
   EXPECT_EQ("hello,there", headers.getEnvoyRetryOnValue());
 }
 
-TEST(HeaderMapImplTest, Remove) {
+TEST_P(HeaderMapImplTest, Remove) {
   TestRequestHeaderMapImpl headers;
 
   // Add random header and then remove by name.
@@ -224,7 +237,7 @@ TEST(HeaderMapImplTest, Remove) {
   EXPECT_EQ(0UL, headers.remove(Headers::get().ContentLength));
 }
 
-TEST(HeaderMapImplTest, RemoveHost) {
+TEST_P(HeaderMapImplTest, RemoveHost) {
   TestRequestHeaderMapImpl headers;
   headers.setHost("foo");
   EXPECT_EQ("foo", headers.get_("host"));
@@ -238,7 +251,7 @@ TEST(HeaderMapImplTest, RemoveHost) {
   EXPECT_EQ(nullptr, headers.Host());
 }
 
-TEST(HeaderMapImplTest, RemoveIf) {
+TEST_P(HeaderMapImplTest, RemoveIf) {
   LowerCaseString key1 = LowerCaseString("X-postfix-foo");
   LowerCaseString key2 = LowerCaseString("X-postfix-");
   LowerCaseString key3 = LowerCaseString("x-postfix-eep");
@@ -281,7 +294,7 @@ TEST(HeaderMapImplTest, RemoveIf) {
   }
 }
 
-TEST(HeaderMapImplTest, RemovePrefix) {
+TEST_P(HeaderMapImplTest, RemovePrefix) {
   // These will match.
   LowerCaseString key1 = LowerCaseString("X-prefix-foo");
   LowerCaseString key3 = LowerCaseString("X-Prefix-");
@@ -333,7 +346,7 @@ public:
   }
 };
 
-TEST(HeaderMapImplTest, SetRemovesAllValues) {
+TEST_P(HeaderMapImplTest, SetRemovesAllValues) {
   TestRequestHeaderMapImpl headers;
 
   LowerCaseString key1("hello");
@@ -374,7 +387,7 @@ TEST(HeaderMapImplTest, SetRemovesAllValues) {
   }
 }
 
-TEST(HeaderMapImplTest, DoubleInlineAdd) {
+TEST_P(HeaderMapImplTest, DoubleInlineAdd) {
   {
     TestRequestHeaderMapImpl headers;
     const std::string foo("foo");
@@ -410,7 +423,7 @@ TEST(HeaderMapImplTest, DoubleInlineAdd) {
 
 // Per https://github.com/envoyproxy/envoy/issues/7488 make sure we don't
 // combine set-cookie headers
-TEST(HeaderMapImplTest, DoubleCookieAdd) {
+TEST_P(HeaderMapImplTest, DoubleCookieAdd) {
   TestRequestHeaderMapImpl headers;
   const std::string foo("foo");
   const std::string bar("bar");
@@ -425,7 +438,7 @@ TEST(HeaderMapImplTest, DoubleCookieAdd) {
   ASSERT_EQ(set_cookie_value[1]->value().getStringView(), "bar");
 }
 
-TEST(HeaderMapImplTest, AppendCookieHeadersWithSemicolon) {
+TEST_P(HeaderMapImplTest, AppendCookieHeadersWithSemicolon) {
   TestRequestHeaderMapImpl headers;
   const std::string foo("foo=1");
   const std::string bar("bar=2");
@@ -439,7 +452,7 @@ TEST(HeaderMapImplTest, AppendCookieHeadersWithSemicolon) {
   ASSERT_EQ(cookie_value[0]->value().getStringView(), "foo=1; bar=2");
 }
 
-TEST(HeaderMapImplTest, DoubleInlineSet) {
+TEST_P(HeaderMapImplTest, DoubleInlineSet) {
   TestRequestHeaderMapImpl headers;
   headers.setReferenceKey(Headers::get().ContentType, "blah");
   headers.setReferenceKey(Headers::get().ContentType, "text/html");
@@ -447,7 +460,7 @@ TEST(HeaderMapImplTest, DoubleInlineSet) {
   EXPECT_EQ(1UL, headers.size());
 }
 
-TEST(HeaderMapImplTest, AddReferenceKey) {
+TEST_P(HeaderMapImplTest, AddReferenceKey) {
   TestRequestHeaderMapImpl headers;
   LowerCaseString foo("hello");
   headers.addReferenceKey(foo, "world");
@@ -455,7 +468,7 @@ TEST(HeaderMapImplTest, AddReferenceKey) {
   EXPECT_EQ("world", headers.get(foo)[0]->value().getStringView());
 }
 
-TEST(HeaderMapImplTest, SetReferenceKey) {
+TEST_P(HeaderMapImplTest, SetReferenceKey) {
   TestRequestHeaderMapImpl headers;
   LowerCaseString foo("hello");
   headers.setReferenceKey(foo, "world");
@@ -467,7 +480,7 @@ TEST(HeaderMapImplTest, SetReferenceKey) {
   EXPECT_EQ("monde", headers.get(foo)[0]->value().getStringView());
 }
 
-TEST(HeaderMapImplTest, SetCopy) {
+TEST_P(HeaderMapImplTest, SetCopy) {
   TestRequestHeaderMapImpl headers;
   LowerCaseString foo("hello");
   headers.setCopy(foo, "world");
@@ -511,7 +524,7 @@ TEST(HeaderMapImplTest, SetCopy) {
   EXPECT_EQ(headers.getPathValue(), "/foo");
 }
 
-TEST(HeaderMapImplTest, AddCopy) {
+TEST_P(HeaderMapImplTest, AddCopy) {
   TestRequestHeaderMapImpl headers;
 
   // Start with a string value.
@@ -582,7 +595,7 @@ TEST(HeaderMapImplTest, AddCopy) {
             headers.get(envoy_retry_on)[0]->value().getStringView());
 }
 
-TEST(HeaderMapImplTest, Equality) {
+TEST_P(HeaderMapImplTest, Equality) {
   TestRequestHeaderMapImpl headers1;
   TestRequestHeaderMapImpl headers2;
   EXPECT_EQ(headers1, headers2);
@@ -594,7 +607,7 @@ TEST(HeaderMapImplTest, Equality) {
   EXPECT_FALSE(headers1 == headers2);
 }
 
-TEST(HeaderMapImplTest, LargeCharInHeader) {
+TEST_P(HeaderMapImplTest, LargeCharInHeader) {
   TestRequestHeaderMapImpl headers;
   LowerCaseString static_key("\x90hello");
   std::string ref_value("value");
@@ -602,7 +615,7 @@ TEST(HeaderMapImplTest, LargeCharInHeader) {
   EXPECT_EQ("value", headers.get(static_key)[0]->value().getStringView());
 }
 
-TEST(HeaderMapImplTest, Iterate) {
+TEST_P(HeaderMapImplTest, Iterate) {
   TestRequestHeaderMapImpl headers;
   headers.addCopy(LowerCaseString("hello"), "world");
   headers.addCopy(LowerCaseString("foo"), "xxx");
@@ -619,7 +632,7 @@ TEST(HeaderMapImplTest, Iterate) {
   headers.iterate(cb.asIterateCb());
 }
 
-TEST(HeaderMapImplTest, IterateReverse) {
+TEST_P(HeaderMapImplTest, IterateReverse) {
   TestRequestHeaderMapImpl headers;
   headers.addCopy(LowerCaseString("hello"), "world");
   headers.addCopy(LowerCaseString("foo"), "bar");
@@ -642,7 +655,7 @@ TEST(HeaderMapImplTest, IterateReverse) {
   });
 }
 
-TEST(HeaderMapImplTest, Get) {
+TEST_P(HeaderMapImplTest, Get) {
   {
     auto headers = TestRequestHeaderMapImpl({{Headers::get().Path.get(), "/"}, {"hello", "world"}});
     EXPECT_EQ("/", headers.get(LowerCaseString(":path"))[0]->value().getStringView());
@@ -663,7 +676,7 @@ TEST(HeaderMapImplTest, Get) {
   }
 }
 
-TEST(HeaderMapImplTest, CreateHeaderMapFromIterator) {
+TEST_P(HeaderMapImplTest, CreateHeaderMapFromIterator) {
   std::vector<std::pair<LowerCaseString, std::string>> iter_headers{
       {LowerCaseString(Headers::get().Path), "/"}, {LowerCaseString("hello"), "world"}};
   auto headers = createHeaderMap<RequestHeaderMapImpl>(iter_headers.cbegin(), iter_headers.cend());
@@ -672,7 +685,7 @@ TEST(HeaderMapImplTest, CreateHeaderMapFromIterator) {
   EXPECT_TRUE(headers->get(LowerCaseString("foo")).empty());
 }
 
-TEST(HeaderMapImplTest, TestHeaderList) {
+TEST_P(HeaderMapImplTest, TestHeaderList) {
   std::array<std::string, 2> keys{Headers::get().Path.get(), "hello"};
   std::array<std::string, 2> values{"/", "world"};
 
@@ -690,7 +703,7 @@ TEST(HeaderMapImplTest, TestHeaderList) {
   EXPECT_THAT(to_string_views(header_list.values()), ElementsAre("/", "world"));
 }
 
-TEST(HeaderMapImplTest, TestAppendHeader) {
+TEST_P(HeaderMapImplTest, TestAppendHeader) {
   // Test appending to a string with a value.
   {
     TestRequestHeaderMapImpl headers;
@@ -753,7 +766,7 @@ TEST(TestHeaderMapImplDeathTest, TestHeaderLengthChecks) {
                "Trying to allocate overly large headers.");
 }
 
-TEST(HeaderMapImplTest, PseudoHeaderOrder) {
+TEST_P(HeaderMapImplTest, PseudoHeaderOrder) {
   HeaderAndValueCb cb;
 
   {
@@ -902,7 +915,7 @@ TEST(HeaderMapImplTest, PseudoHeaderOrder) {
 // Validate that TestRequestHeaderMapImpl copy construction and assignment works. This is a
 // regression for where we were missing a valid copy constructor and had the
 // default (dangerous) move semantics takeover.
-TEST(HeaderMapImplTest, TestRequestHeaderMapImplCopy) {
+TEST_P(HeaderMapImplTest, TestRequestHeaderMapImplCopy) {
   TestRequestHeaderMapImpl foo;
   foo.addCopy(LowerCaseString("foo"), "bar");
   auto headers = std::make_unique<TestRequestHeaderMapImpl>(foo);
@@ -916,7 +929,7 @@ TEST(HeaderMapImplTest, TestRequestHeaderMapImplCopy) {
 }
 
 // Make sure 'host' -> ':authority' auto translation only occurs for request headers.
-TEST(HeaderMapImplTest, HostHeader) {
+TEST_P(HeaderMapImplTest, HostHeader) {
   TestRequestHeaderMapImpl request_headers{{"host", "foo"}};
   EXPECT_EQ(request_headers.size(), 1);
   EXPECT_EQ(request_headers.get_(":authority"), "foo");
@@ -934,14 +947,14 @@ TEST(HeaderMapImplTest, HostHeader) {
   EXPECT_EQ(response_trailers.get_("host"), "foo");
 }
 
-TEST(HeaderMapImplTest, TestInlineHeaderAdd) {
+TEST_P(HeaderMapImplTest, TestInlineHeaderAdd) {
   TestRequestHeaderMapImpl foo;
   foo.addCopy(LowerCaseString(":path"), "GET");
   EXPECT_EQ(foo.size(), 1);
   EXPECT_TRUE(foo.Path() != nullptr);
 }
 
-TEST(HeaderMapImplTest, ClearHeaderMap) {
+TEST_P(HeaderMapImplTest, ClearHeaderMap) {
   TestRequestHeaderMapImpl headers;
   LowerCaseString static_key("hello");
   std::string ref_value("value");
@@ -983,7 +996,7 @@ TEST(HeaderMapImplTest, ClearHeaderMap) {
 }
 
 // Validates byte size is properly accounted for in different inline header setting scenarios.
-TEST(HeaderMapImplTest, InlineHeaderByteSize) {
+TEST_P(HeaderMapImplTest, InlineHeaderByteSize) {
   {
     TestRequestHeaderMapImpl headers;
     std::string foo = "foo";
@@ -1037,13 +1050,13 @@ TEST(HeaderMapImplTest, InlineHeaderByteSize) {
   }
 }
 
-TEST(HeaderMapImplTest, ValidHeaderString) {
+TEST_P(HeaderMapImplTest, ValidHeaderString) {
   EXPECT_TRUE(validHeaderString("abc"));
   EXPECT_FALSE(validHeaderString(absl::string_view("a\000bc", 4)));
   EXPECT_FALSE(validHeaderString("abc\n"));
 }
 
-TEST(HeaderMapImplTest, HttpTraceContextTest) {
+TEST_P(HeaderMapImplTest, HttpTraceContextTest) {
   {
     TestRequestHeaderMapImpl request_headers;
 
@@ -1104,5 +1117,122 @@ TEST(HeaderMapImplTest, HttpTraceContextTest) {
   }
 }
 
+// Headers keep their address while other headers are added and removed, and keep their order
+// when headers removed from the end of the map are replaced.
+TEST_P(HeaderMapImplTest, StableEntriesUnderChurn) {
+  TestRequestHeaderMapImpl headers;
+  headers.setReferenceKey(Headers::get().Method, "GET");
+  headers.addCopy(LowerCaseString("first"), "1");
+  const HeaderEntry* method = headers.Method();
+  const HeaderEntry* first = headers.get(LowerCaseString("first"))[0];
+
+  for (int i = 0; i < 100; i++) {
+    headers.setReferenceKey(Headers::get().Path, "/");
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), "value");
+    if (i % 2 == 0) {
+      EXPECT_EQ(1UL, headers.remove(LowerCaseString(absl::StrCat("x-header-", i))));
+    }
+    EXPECT_EQ(1UL, headers.removePath());
+  }
+  headers.addCopy(LowerCaseString("last"), "2");
+  headers.setReferenceKey(Headers::get().Scheme, "https");
+
+  EXPECT_EQ(method, headers.Method());
+  EXPECT_EQ(first, headers.get(LowerCaseString("first"))[0]);
+  EXPECT_EQ(54UL, headers.size());
+
+  std::vector<std::string> keys;
+  headers.iterate([&keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+    keys.emplace_back(header.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  ASSERT_EQ(54UL, keys.size());
+  EXPECT_EQ(":method", keys[0]);
+  EXPECT_EQ(":scheme", keys[1]);
+  EXPECT_EQ("first", keys[2]);
+  EXPECT_EQ("x-header-1", keys[3]);
+  EXPECT_EQ("x-header-99", keys[52]);
+  EXPECT_EQ("last", keys[53]);
+
+  EXPECT_EQ(50UL, headers.removePrefix(LowerCaseString("x-header-")));
+  TestRequestHeaderMapImpl expected{
+      {":method", "GET"}, {":scheme", "https"}, {"first", "1"}, {"last", "2"}};
+  EXPECT_EQ(expected, headers);
+}
+
+// Headers removed from the middle of the map, which leave tombstones behind with contiguous
+// storage, do not break the inline headers, lookups or the order of the remaining headers once the
+// tombstones are dropped.
+TEST_P(HeaderMapImplTest, RemoveFromTheMiddleUnderChurn) {
+  TestRequestHeaderMapImpl headers;
+  headers.setReferenceKey(Headers::get().Method, "GET");
+  headers.addCopy(LowerCaseString("first"), "1");
+  headers.setContentType("text/plain");
+
+  for (int i = 0; i < 1000; i++) {
+    headers.setPath(absl::StrCat("/", i));
+    if (i > 0) {
+      EXPECT_EQ(1UL, headers.remove(LowerCaseString(absl::StrCat("x-header-", i - 1))));
+    }
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), "value");
+    EXPECT_EQ(i > 0 ? 1UL : 0UL, headers.remove(LowerCaseString("x-last")));
+    headers.addCopy(LowerCaseString("x-last"), absl::StrCat(i));
+
+    EXPECT_EQ(absl::StrCat("/", i), headers.getPathValue());
+    EXPECT_EQ("GET", headers.getMethodValue());
+    EXPECT_EQ("text/plain", headers.getContentTypeValue());
+    EXPECT_EQ(1UL, headers.get(LowerCaseString(absl::StrCat("x-header-", i))).size());
+  }
+
+  TestRequestHeaderMapImpl expected{{":method", "GET"}, {":path", "/999"}, {"first", "1"}};
+  expected.setContentType("text/plain");
+  expected.addCopy(LowerCaseString("x-header-999"), "value");
+  expected.addCopy(LowerCaseString("x-last"), "999");
+  EXPECT_EQ(expected, headers);
+  EXPECT_EQ(expected.byteSize(), headers.byteSize());
+
+  headers.removeContentType();
+  EXPECT_EQ(nullptr, headers.ContentType());
+  EXPECT_EQ(5UL, headers.size());
+}
+
+// The results of get() and the entries passed to iterate() stay valid while other headers are
+// removed from and added to the map.
+TEST_P(HeaderMapImplTest, GetResultValidAcrossRemovalOfOtherHeaders) {
+  TestRequestHeaderMapImpl headers;
+  headers.setReferenceKey(Headers::get().Method, "GET");
+  for (int i = 0; i < 16; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat(i));
+  }
+  headers.addCopy(LowerCaseString("held"), "a");
+  headers.addCopy(LowerCaseString("held"), "b");
+  const HeaderMap::GetResult held = headers.get(LowerCaseString("held"));
+  ASSERT_EQ(2UL, held.size());
+  const HeaderEntry* method = nullptr;
+  headers.iterate([&method](const HeaderEntry& header) -> HeaderMap::Iterate {
+    method = &header;
+    return HeaderMap::Iterate::Break;
+  });
+
+  // Remove all the headers before the held ones, leaving mostly tombstones, then add more.
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(1UL, headers.remove(LowerCaseString(absl::StrCat("x-header-", i))));
+  }
+  EXPECT_EQ(0UL, headers.removeIf([](const HeaderEntry& header) {
+    return header.key().getStringView() == "x-none";
+  }));
+  for (int i = 0; i < 16; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-new-", i)), "value");
+  }
+
+  EXPECT_EQ(held[0], headers.get(LowerCaseString("held"))[0]);
+  EXPECT_EQ(held[1], headers.get(LowerCaseString("held"))[1]);
+  EXPECT_EQ("a", held[0]->value().getStringView());
+  EXPECT_EQ("b", held[1]->value().getStringView());
+  EXPECT_EQ(method, headers.Method());
+  EXPECT_EQ("GET", method->value().getStringView());
+  EXPECT_EQ(19UL, headers.size());
+}
+
 } // namespace Http
 } // namespace Envoy
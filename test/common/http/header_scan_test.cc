@@ -0,0 +1,61 @@
+#include <string>
+
+#include "source/common/http/header_scan.h"
+
+#include "absl/strings/ascii.h"
+#include "gtest/gtest.h"
+#include "nghttp2/nghttp2.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+bool referenceValueIsValid(absl::string_view value) {
+  return nghttp2_check_header_value(reinterpret_cast<const uint8_t*>(value.data()),
+                                    value.size()) != 0;
+}
+
+// Lengths around the 16 and 32 byte vector widths, so that every byte lands in both the vector
+// loops and the scalar tail.
+constexpr size_t Lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 47, 64, 65, 100};
+
+TEST(HeaderScanTest, ValueIsValidMatchesNghttp2) {
+  for (const size_t length : Lengths) {
+    for (size_t position = 0; position < length; ++position) {
+      for (int c = 0; c < 256; ++c) {
+        std::string value(length, 'a');
+        value[position] = static_cast<char>(c);
+        EXPECT_EQ(referenceValueIsValid(value), HeaderScan::valueIsValid(value))
+            << "length=" << length << " position=" << position << " byte=" << c;
+      }
+    }
+  }
+}
+
+TEST(HeaderScanTest, ValueIsValid) {
+  EXPECT_TRUE(HeaderScan::valueIsValid(""));
+  EXPECT_TRUE(HeaderScan::valueIsValid("text/html;\tcharset=\xc3\xa9 utf-8, application/json"));
+  EXPECT_FALSE(HeaderScan::valueIsValid("text/html; charset=utf-8, application/json\r\n"));
+  EXPECT_FALSE(HeaderScan::valueIsValid(absl::string_view("text/html;\0charset=utf-8", 24)));
+  EXPECT_FALSE(HeaderScan::valueIsValid("text/html; charset=utf-8\x7f"));
+}
+
+TEST(HeaderScanTest, ToLowerAscii) {
+  for (const size_t length : Lengths) {
+    for (size_t position = 0; position < length; ++position) {
+      for (int c = 0; c < 256; ++c) {
+        std::string value(length, 'X');
+        value[position] = static_cast<char>(c);
+        std::string expected = value;
+        absl::AsciiStrToLower(&expected);
+        HeaderScan::toLowerAscii(value.data(), value.size());
+        EXPECT_EQ(expected, value) << "length=" << length << " position=" << position
+                                   << " byte=" << c;
+      }
+    }
+  }
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
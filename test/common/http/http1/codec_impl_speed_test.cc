@@ -0,0 +1,112 @@
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/http1/codec_impl.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// A browser-like request: the usual request headers followed by enough x-request-attr-N
+// headers to reach the requested header count.
+std::string makeRequest(int num_headers) {
+  static constexpr absl::string_view common_headers[] = {
+      "Host: www.example.com",
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+      "Chrome/109.0.0.0 Safari/537.36",
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,"
+      "image/apng,*/*;q=0.8",
+      "Accept-Encoding: gzip, deflate, br",
+      "Accept-Language: en-US,en;q=0.9",
+      "Cache-Control: no-cache",
+      "Connection: keep-alive",
+      "Cookie: session=8f14e45fceea167a5a36dedd4bea2543; theme=dark; _ga=GA1.2.1234567890",
+      "Referer: https://www.example.com/search?q=envoy+proxy",
+      "Sec-Fetch-Dest: document",
+      "Sec-Fetch-Mode: navigate",
+      "Sec-Fetch-Site: same-origin",
+      "Upgrade-Insecure-Requests: 1",
+      "X-Forwarded-For: 203.0.113.195, 70.41.3.18, 150.172.238.178",
+      "X-Request-Id: 3e8a4c5b-27f4-4c1e-9d4b-6f0a2b9c8d71",
+  };
+
+  std::string request = "GET /api/v1/resources/items?limit=50&offset=100 HTTP/1.1\r\n";
+  int i = 0;
+  for (; i < num_headers && i < static_cast<int>(std::size(common_headers)); ++i) {
+    absl::StrAppend(&request, common_headers[i], "\r\n");
+  }
+  for (; i < num_headers; ++i) {
+    absl::StrAppend(&request, "X-Request-Attr-", i, ": value-", i,
+                    "; the quick brown fox jumps over the lazy dog\r\n");
+  }
+  request += "\r\n";
+  return request;
+}
+
+// Measures dispatching requests with many headers through the server codec, which is dominated by
+// header name and value scanning.
+static void bmServerDispatchHeaders(benchmark::State& state) {
+  const int num_headers = state.range(0);
+  const bool use_balsa = state.range(1);
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.http1_use_balsa_parser", use_balsa ? "true" : "false"}});
+
+  Stats::TestUtil::TestStore store;
+  Http1::CodecStats::AtomicPtr stats;
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  Http1Settings settings;
+  NiceMock<MockRequestDecoder> decoder;
+  ResponseEncoder* response_encoder = nullptr;
+  ON_CALL(callbacks, newStream(_, _))
+      .WillByDefault(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  ServerConnectionImpl codec(connection, Http1::CodecStats::atomicGet(stats, *store.rootScope()),
+                             callbacks, settings, DEFAULT_MAX_REQUEST_HEADERS_KB,
+                             DEFAULT_MAX_HEADERS_COUNT,
+                             envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+  const std::string request = makeRequest(num_headers);
+  const TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+
+  for (auto _ : state) { // NOLINT
+    Buffer::OwnedImpl buffer(request);
+    const Status status = codec.dispatch(buffer);
+    if (!status.ok() || response_encoder == nullptr) {
+      state.SkipWithError("Failed to dispatch the request");
+      break;
+    }
+    // Complete the stream so that the connection is ready for the next request.
+    response_encoder->encodeHeaders(response_headers, true);
+    response_encoder = nullptr;
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+
+  // Run deletion as would happen on the dispatchers.
+  connection.dispatcher_.to_delete_.clear();
+}
+BENCHMARK(bmServerDispatchHeaders)
+    ->ArgsProduct({{10, 30, 60}, {0, 1}})
+    ->ArgNames({"headers", "balsa"})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
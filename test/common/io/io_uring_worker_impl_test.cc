@@ -0,0 +1,151 @@
+#include <sys/socket.h>
+
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class TestRequest : public Request {
+public:
+  explicit TestRequest(std::function<void(int32_t)> cb) : cb_(std::move(cb)) {}
+
+  // Io::Request
+  void onCompletion(int32_t result) override { cb_(result); }
+
+  std::function<void(int32_t)> cb_;
+};
+
+class IoUringWorkerImplTest : public ::testing::Test {
+public:
+  IoUringWorkerImplTest() : api_(Api::createApiForTest()) {
+    if (!isIoUringSupported()) {
+      should_skip_ = true;
+      return;
+    }
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+    worker_ = std::make_unique<IoUringWorkerImpl>(8, false, *dispatcher_);
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds_) == 0, "");
+  }
+
+  ~IoUringWorkerImplTest() override {
+    if (should_skip_) {
+      return;
+    }
+    worker_.reset();
+    ::close(fds_[0]);
+    ::close(fds_[1]);
+  }
+
+  void SetUp() override {
+    if (should_skip_) {
+      GTEST_SKIP();
+    }
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::unique_ptr<IoUringWorkerImpl> worker_;
+  os_fd_t fds_[2];
+  bool should_skip_{};
+};
+
+TEST_F(IoUringWorkerImplTest, ReadvCompletionDelivered) {
+  char buffer[16]{};
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = sizeof(buffer);
+
+  int32_t read_result = 0;
+  EXPECT_EQ(IoUringResult::Ok,
+            worker_->submitReadvRequest(
+                fds_[0], &iov, 1,
+                std::make_unique<TestRequest>([this, &read_result](int32_t result) {
+                  read_result = result;
+                  dispatcher_->exit();
+                })));
+  EXPECT_EQ(1, worker_->numOfRequests());
+
+  ASSERT_EQ(5, ::write(fds_[1], "hello", 5));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(5, read_result);
+  EXPECT_EQ("hello", absl::string_view(buffer, 5));
+  EXPECT_EQ(0, worker_->numOfRequests());
+}
+
+TEST_F(IoUringWorkerImplTest, WritevBatchedWithinIteration) {
+  const std::string data = "hello";
+  struct iovec iov;
+  iov.iov_base = const_cast<char*>(data.data());
+  iov.iov_len = data.size();
+
+  uint32_t completions = 0;
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(IoUringResult::Ok,
+              worker_->submitWritevRequest(
+                  fds_[0], &iov, 1,
+                  std::make_unique<TestRequest>([this, &completions](int32_t result) {
+                    EXPECT_EQ(5, result);
+                    if (++completions == 3) {
+                      dispatcher_->exit();
+                    }
+                  })));
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(3, completions);
+  char buffer[16]{};
+  EXPECT_EQ(15, ::read(fds_[1], buffer, sizeof(buffer)));
+}
+
+// More requests than the size of the submission queue get submitted early.
+TEST_F(IoUringWorkerImplTest, SubmissionQueueOverflowFlushes) {
+  const std::string data = "a";
+  struct iovec iov;
+  iov.iov_base = const_cast<char*>(data.data());
+  iov.iov_len = data.size();
+
+  uint32_t completions = 0;
+  for (int i = 0; i < 12; i++) {
+    EXPECT_EQ(IoUringResult::Ok,
+              worker_->submitWritevRequest(
+                  fds_[0], &iov, 1,
+                  std::make_unique<TestRequest>([this, &completions](int32_t) {
+                    if (++completions == 12) {
+                      dispatcher_->exit();
+                    }
+                  })));
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(12, completions);
+}
+
+TEST_F(IoUringWorkerImplTest, CancelRequest) {
+  char buffer[16]{};
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = sizeof(buffer);
+
+  int32_t read_result = 0;
+  auto request = std::make_unique<TestRequest>([this, &read_result](int32_t result) {
+    read_result = result;
+    dispatcher_->exit();
+  });
+  TestRequest& request_ref = *request;
+  EXPECT_EQ(IoUringResult::Ok, worker_->submitReadvRequest(fds_[0], &iov, 1, std::move(request)));
+  EXPECT_EQ(IoUringResult::Ok, worker_->submitCancelRequest(request_ref));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(-ECANCELED, read_result);
+  EXPECT_EQ(0, worker_->numOfRequests());
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
@@ -153,6 +153,51 @@ TEST(IoSocketHandleImpl, NullptrIfaddrs) {
   EXPECT_FALSE(maybe_interface_name.has_value());
 }
 
+#ifdef __linux__
+TEST(IoSocketHandleImpl, SendmmsgWithGsoAndSourceAddress) {
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  IoSocketHandleImpl io_handle(42);
+  Address::Ipv4Instance local_address("127.0.0.2");
+  Address::Ipv4Instance peer_address("127.0.0.1", 5353);
+
+  char first[] = "aaaabbbb";
+  char second[] = "cc";
+  RawSliceArrays slices(2, absl::FixedArray<Buffer::RawSlice>(1));
+  slices[0][0] = {first, 8};
+  slices[1][0] = {second, 2};
+  EXPECT_CALL(os_sys_calls, sendmmsg(42, _, 2, 0))
+      .WillOnce(Invoke([](os_fd_t, struct mmsghdr* msgvec, unsigned int vlen,
+                          int) -> Api::SysCallIntResult {
+        for (unsigned int i = 0; i < vlen; i++) {
+          msghdr& hdr = msgvec[i].msg_hdr;
+          EXPECT_EQ(1, hdr.msg_iovlen);
+          EXPECT_NE(nullptr, hdr.msg_name);
+          bool found_pktinfo = false;
+          bool found_gso_size = false;
+          for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+               cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+              found_pktinfo = true;
+            } else if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+              found_gso_size = true;
+              EXPECT_EQ(4, *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)));
+            }
+          }
+          EXPECT_TRUE(found_pktinfo);
+          EXPECT_TRUE(found_gso_size);
+        }
+        EXPECT_EQ(8, msgvec[0].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_EQ(2, msgvec[1].msg_hdr.msg_iov[0].iov_len);
+        return {2, 0};
+      }));
+  const Api::IoCallUint64Result result =
+      io_handle.sendmmsg(slices, 4, local_address.ip(), peer_address);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(2, result.return_value_);
+}
+#endif
+
 class IoSocketHandleImplTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, IoSocketHandleImplTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -0,0 +1,119 @@
+// Compares reading from many connections with the readiness-based IoSocketHandleImpl against the
+// io_uring-based IoUringSocketHandleImpl which batches the syscalls of an event loop iteration.
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+constexpr absl::string_view Message = "GET / HTTP/1.1\r\nHost: example.com\r\n\r\n";
+
+class TestIoUringWorkerFactory : public Io::IoUringWorkerFactory {
+public:
+  // Io::IoUringWorkerFactory
+  OptRef<Io::IoUringWorker> getIoUringWorker() override {
+    if (worker_ == nullptr) {
+      return {};
+    }
+    return *worker_;
+  }
+  void onServerInitialized() override {}
+
+  std::unique_ptr<Io::IoUringWorkerImpl> worker_;
+};
+
+// Each iteration writes a message to every connection and runs the event loop until the message
+// has been read from all of them.
+void benchmarkReads(benchmark::State& state, bool use_io_uring) {
+  const uint64_t num_connections = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_connections > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  if (use_io_uring && !Io::isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur < 2 * num_connections + 64) {
+    state.SkipWithError("not enough file descriptors");
+    return;
+  }
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  TestIoUringWorkerFactory factory;
+  if (use_io_uring) {
+    factory.worker_ = std::make_unique<Io::IoUringWorkerImpl>(4096, false, *dispatcher);
+  }
+
+  std::vector<IoHandlePtr> handles;
+  std::vector<os_fd_t> peers;
+  uint64_t pending_reads = 0;
+  Buffer::OwnedImpl read_buffer;
+  for (uint64_t i = 0; i < num_connections; i++) {
+    os_fd_t fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    peers.push_back(fds[1]);
+    if (use_io_uring) {
+      handles.push_back(std::make_unique<IoUringSocketHandleImpl>(factory, 4096, fds[0], false,
+                                                                  absl::nullopt, true));
+    } else {
+      handles.push_back(std::make_unique<IoSocketHandleImpl>(fds[0]));
+    }
+    IoHandle& handle = *handles.back();
+    handle.initializeFileEvent(
+        *dispatcher,
+        [&handle, &pending_reads, &read_buffer, &dispatcher](uint32_t) {
+          while (handle.read(read_buffer, absl::nullopt).return_value_ > 0) {
+          }
+          read_buffer.drain(read_buffer.length());
+          if (--pending_reads == 0) {
+            dispatcher->exit();
+          }
+        },
+        Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+  }
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (os_fd_t peer : peers) {
+      RELEASE_ASSERT(::write(peer, Message.data(), Message.size()) ==
+                         static_cast<ssize_t>(Message.size()),
+                     "");
+    }
+    pending_reads = num_connections;
+    dispatcher->run(Event::Dispatcher::RunType::Block);
+  }
+  state.SetItemsProcessed(state.iterations() * num_connections);
+
+  handles.clear();
+  for (os_fd_t peer : peers) {
+    ::close(peer);
+  }
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+void bmReadvReadiness(benchmark::State& state) { benchmarkReads(state, false); }
+BENCHMARK(bmReadvReadiness)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void bmReadvIoUring(benchmark::State& state) { benchmarkReads(state, true); }
+BENCHMARK(bmReadvIoUring)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
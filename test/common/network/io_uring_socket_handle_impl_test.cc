@@ -0,0 +1,342 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
+#include "source/common/network/listener_filter_buffer_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestIoUringWorkerFactory : public Io::IoUringWorkerFactory {
+public:
+  // Io::IoUringWorkerFactory
+  OptRef<Io::IoUringWorker> getIoUringWorker() override {
+    if (worker_ == nullptr) {
+      return {};
+    }
+    return *worker_;
+  }
+  void onServerInitialized() override {}
+
+  std::unique_ptr<Io::IoUringWorkerImpl> worker_;
+};
+
+class IoUringSocketHandleImplTest : public ::testing::Test {
+public:
+  IoUringSocketHandleImplTest() : api_(Api::createApiForTest()) {
+    if (!Io::isIoUringSupported()) {
+      should_skip_ = true;
+      return;
+    }
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+    factory_.worker_ = std::make_unique<Io::IoUringWorkerImpl>(64, false, *dispatcher_);
+  }
+
+  ~IoUringSocketHandleImplTest() override {
+    if (should_skip_) {
+      return;
+    }
+    handle_.reset();
+    if (peer_fd_ != INVALID_SOCKET) {
+      ::close(peer_fd_);
+    }
+    factory_.worker_.reset();
+  }
+
+  void SetUp() override {
+    if (should_skip_) {
+      GTEST_SKIP();
+    }
+  }
+
+  void initializeConnectedHandle() {
+    os_fd_t fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    peer_fd_ = fds[1];
+    handle_ = std::make_unique<IoUringSocketHandleImpl>(factory_, 4096, fds[0], false,
+                                                        absl::nullopt, true);
+    initializeFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  }
+
+  void initializeFileEvent(uint32_t events) {
+    handle_->initializeFileEvent(
+        *dispatcher_,
+        [this](uint32_t events) {
+          events_ |= events;
+          dispatcher_->exit();
+        },
+        Event::PlatformDefaultTriggerType, events);
+  }
+
+  // Runs the event loop until the handle reports any events and returns them.
+  uint32_t waitForEvents() {
+    events_ = 0;
+    while (events_ == 0) {
+      dispatcher_->run(Event::Dispatcher::RunType::Block);
+    }
+    return std::exchange(events_, 0);
+  }
+
+  std::string readFromPeer(size_t length) {
+    std::string data;
+    char buffer[1024];
+    while (data.size() < length) {
+      const ssize_t rc = ::read(peer_fd_, buffer, sizeof(buffer));
+      if (rc > 0) {
+        data.append(buffer, rc);
+      } else {
+        dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      }
+    }
+    return data;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  TestIoUringWorkerFactory factory_;
+  std::unique_ptr<IoUringSocketHandleImpl> handle_;
+  os_fd_t peer_fd_{INVALID_SOCKET};
+  uint32_t events_{};
+  bool should_skip_{};
+};
+
+TEST_F(IoUringSocketHandleImplTest, Read) {
+  initializeConnectedHandle();
+  // A connected socket is writable right away.
+  EXPECT_EQ(Event::FileReadyType::Write, waitForEvents());
+
+  ASSERT_EQ(5, ::write(peer_fd_, "hello", 5));
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+
+  Buffer::OwnedImpl buffer;
+  auto result = handle_->read(buffer, absl::nullopt);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("hello", buffer.toString());
+
+  result = handle_->read(buffer, absl::nullopt);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+}
+
+TEST_F(IoUringSocketHandleImplTest, ReadvRespectsMaxLength) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  ASSERT_EQ(10, ::write(peer_fd_, "helloworld", 10));
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+
+  char data[8];
+  Buffer::RawSlice slice{data, sizeof(data)};
+  auto result = handle_->readv(5, &slice, 1);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("hello", absl::string_view(data, 5));
+  result = handle_->readv(8, &slice, 1);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("world", absl::string_view(data, 5));
+}
+
+TEST_F(IoUringSocketHandleImplTest, ReadEndOfStream) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  ::shutdown(peer_fd_, SHUT_WR);
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+
+  Buffer::OwnedImpl buffer;
+  auto result = handle_->read(buffer, absl::nullopt);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.return_value_);
+}
+
+TEST_F(IoUringSocketHandleImplTest, ClosedEventWhenReadDisabled) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  handle_->enableFileEvents(Event::FileReadyType::Closed);
+  ::shutdown(peer_fd_, SHUT_WR);
+  EXPECT_EQ(Event::FileReadyType::Closed, waitForEvents());
+}
+
+TEST_F(IoUringSocketHandleImplTest, Write) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  Buffer::OwnedImpl buffer("hello");
+  auto result = handle_->write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ(0, buffer.length());
+
+  // Only one write is in flight at a time.
+  buffer.add("world");
+  result = handle_->write(buffer);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(5, buffer.length());
+
+  EXPECT_EQ(Event::FileReadyType::Write, waitForEvents());
+  result = handle_->write(buffer);
+  EXPECT_EQ(5, result.return_value_);
+
+  EXPECT_EQ("helloworld", readFromPeer(10));
+}
+
+TEST_F(IoUringSocketHandleImplTest, CloseFlushesInFlightWrite) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_EQ(5, handle_->write(buffer).return_value_);
+  handle_->close();
+  EXPECT_FALSE(handle_->isOpen());
+
+  EXPECT_EQ("hello", readFromPeer(5));
+  // The socket gets closed once the write completes.
+  char data[8];
+  ssize_t rc;
+  while ((rc = ::read(peer_fd_, data, sizeof(data))) != 0) {
+    ASSERT_EQ(-1, rc);
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+}
+
+TEST_F(IoUringSocketHandleImplTest, CloseCancelsInFlightRead) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  // The read is in flight since the file event has been initialized.
+  EXPECT_EQ(1, factory_.worker_->numOfRequests());
+  handle_->close();
+  while (factory_.worker_->numOfRequests() != 0) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+}
+
+TEST_F(IoUringSocketHandleImplTest, Accept) {
+  const os_fd_t listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(0, ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+  ASSERT_EQ(0, ::listen(listen_fd, 8));
+  socklen_t addr_len = sizeof(addr);
+  ASSERT_EQ(0, ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+
+  handle_ = std::make_unique<IoUringSocketHandleImpl>(factory_, 4096, listen_fd);
+  initializeFileEvent(Event::FileReadyType::Read);
+
+  peer_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(0, ::connect(peer_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+
+  sockaddr_storage remote_addr;
+  socklen_t remote_addr_len = sizeof(remote_addr);
+  IoHandlePtr accepted =
+      handle_->accept(reinterpret_cast<sockaddr*>(&remote_addr), &remote_addr_len);
+  ASSERT_NE(nullptr, accepted);
+  EXPECT_EQ(AF_INET, remote_addr.ss_family);
+  EXPECT_EQ(sizeof(sockaddr_in), remote_addr_len);
+  EXPECT_EQ(nullptr, handle_->accept(reinterpret_cast<sockaddr*>(&remote_addr), &remote_addr_len));
+  accepted->close();
+}
+
+TEST_F(IoUringSocketHandleImplTest, Recv) {
+  initializeConnectedHandle();
+  waitForEvents();
+
+  char data[16];
+  auto result = handle_->recv(data, sizeof(data), MSG_PEEK);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  ASSERT_EQ(10, ::write(peer_fd_, "helloworld", 10));
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  result = handle_->recv(data, 5, MSG_PEEK);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("hello", absl::string_view(data, 5));
+  result = handle_->recv(data, 5, 0);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("hello", absl::string_view(data, 5));
+
+  // A peek asking for more than has been read keeps reading until it can be served.
+  result = handle_->recv(data, 10, MSG_PEEK);
+  EXPECT_EQ(5, result.return_value_);
+  ASSERT_EQ(5, ::write(peer_fd_, "again", 5));
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  result = handle_->recv(data, 10, MSG_PEEK);
+  EXPECT_EQ(10, result.return_value_);
+  EXPECT_EQ("worldagain", absl::string_view(data, 10));
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(10, handle_->read(buffer, absl::nullopt).return_value_);
+  EXPECT_EQ("worldagain", buffer.toString());
+}
+
+// Listener filters peek at and drain the data of an accepted socket through its listener filter
+// buffer, and the connection then reads the rest of it.
+TEST_F(IoUringSocketHandleImplTest, ListenerFilterBuffer) {
+  initializeConnectedHandle();
+  waitForEvents();
+  handle_->resetFileEvents();
+
+  std::string peeked;
+  bool closed = false;
+  auto filter_buffer = std::make_unique<ListenerFilterBufferImpl>(
+      *handle_, *dispatcher_, [&closed](bool) { closed = true; },
+      [this, &peeked](ListenerFilterBufferImpl& buffer) {
+        const Buffer::ConstRawSlice slice = buffer.rawSlice();
+        peeked = std::string(static_cast<const char*>(slice.mem_), slice.len_);
+        dispatcher_->exit();
+      },
+      8);
+
+  ASSERT_EQ(4, ::write(peer_fd_, "PROX", 4));
+  while (peeked.size() < 4) {
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  EXPECT_EQ("PROX", peeked);
+  ASSERT_EQ(8, ::write(peer_fd_, "Y 1 data", 8));
+  while (peeked.size() < 8) {
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  EXPECT_EQ("PROXY 1 ", peeked);
+  EXPECT_TRUE(filter_buffer->drain(8));
+  EXPECT_FALSE(closed);
+  filter_buffer->reset();
+  filter_buffer.reset();
+
+  initializeFileEvent(Event::FileReadyType::Read);
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(4, handle_->read(buffer, absl::nullopt).return_value_);
+  EXPECT_EQ("data", buffer.toString());
+}
+
+// Without a worker on the current thread the handle falls back to readiness-based IO.
+TEST_F(IoUringSocketHandleImplTest, FallbackWithoutWorker) {
+  TestIoUringWorkerFactory factory;
+  os_fd_t fds[2];
+  RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+  peer_fd_ = fds[1];
+  handle_ = std::make_unique<IoUringSocketHandleImpl>(factory, 4096, fds[0], false, absl::nullopt,
+                                                      true);
+  initializeFileEvent(Event::FileReadyType::Read);
+  EXPECT_EQ(0, factory_.worker_->numOfRequests());
+
+  ASSERT_EQ(5, ::write(peer_fd_, "hello", 5));
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, handle_->read(buffer, absl::nullopt).return_value_);
+  EXPECT_EQ("hello", buffer.toString());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
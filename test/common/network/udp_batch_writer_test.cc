@@ -0,0 +1,190 @@
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/udp_batch_writer.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/io_handle.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ByMove;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+Api::IoCallUint64Result makeNoError(uint64_t rc) {
+  auto no_error = Api::ioCallUint64ResultNoError();
+  no_error.return_value_ = rc;
+  return no_error;
+}
+
+Api::IoCallUint64Result makeError(int sys_errno) {
+  return {0, Api::IoErrorPtr(new IoSocketError(sys_errno), IoSocketError::deleteIoError)};
+}
+
+class UdpBatchWriterTest : public testing::Test {
+public:
+  void initialize(bool supports_mmsg, bool supports_gso) {
+    ON_CALL(io_handle_, supportsMmsg()).WillByDefault(Return(supports_mmsg));
+    ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(supports_gso));
+    writer_ = std::make_unique<UdpBatchWriter>(io_handle_, true);
+  }
+
+  void write(const std::string& datagram) {
+    Buffer::OwnedImpl buffer(datagram);
+    writer_->write(buffer);
+  }
+
+  // Expect a sendmmsg() call with the given GSO size and message payloads, which sends
+  // messages_sent messages.
+  void expectSendmmsg(uint64_t gso_size, std::vector<std::string> messages,
+                      uint64_t messages_sent) {
+    EXPECT_CALL(io_handle_, sendmmsg(_, gso_size, nullptr, _))
+        .WillOnce(Invoke([this, messages, messages_sent](
+                             const RawSliceArrays& slices, uint64_t, const Address::Ip*,
+                             const Address::Instance& peer_address) -> Api::IoCallUint64Result {
+          EXPECT_EQ(peer_address, peer_address_);
+          EXPECT_EQ(messages.size(), slices.size());
+          for (size_t i = 0; i < slices.size(); i++) {
+            EXPECT_EQ(messages[i], absl::string_view(static_cast<const char*>(slices[i][0].mem_),
+                                                     slices[i][0].len_));
+          }
+          return makeNoError(messages_sent);
+        }));
+  }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<MockIoHandle> io_handle_;
+  Address::Ipv4Instance peer_address_{"127.0.0.1", 53};
+  std::unique_ptr<UdpBatchWriter> writer_;
+};
+
+// Without GSO each datagram is sent as a message of a single sendmmsg() call.
+TEST_F(UdpBatchWriterTest, Mmsg) {
+  initialize(true, false);
+  EXPECT_FALSE(writer_->usingGso());
+  write("hello");
+  write("world!");
+  write("a");
+  EXPECT_EQ(3, writer_->bufferedDatagrams());
+
+  expectSendmmsg(0, {"hello", "world!", "a"}, 3);
+  const UdpBatchWriter::FlushResult result = writer_->flush(nullptr, peer_address_);
+  EXPECT_EQ(3, result.datagrams_sent_);
+  EXPECT_EQ(12, result.bytes_sent_);
+  EXPECT_EQ(0, result.datagrams_dropped_);
+  EXPECT_EQ(0, writer_->bufferedDatagrams());
+}
+
+// Runs of datagrams of the GSO size are coalesced, a shorter datagram ends a message and a larger
+// one starts a new sendmmsg() call.
+TEST_F(UdpBatchWriterTest, GsoCoalescing) {
+  initialize(true, true);
+  EXPECT_TRUE(writer_->usingGso());
+  write("aaaa");
+  write("bbbb");
+  write("cc");
+  write("dddd");
+  write("eeeeee");
+
+  testing::InSequence s;
+  expectSendmmsg(4, {"aaaabbbbcc", "dddd"}, 2);
+  expectSendmmsg(6, {"eeeeee"}, 1);
+  const UdpBatchWriter::FlushResult result = writer_->flush(nullptr, peer_address_);
+  EXPECT_EQ(5, result.datagrams_sent_);
+  EXPECT_EQ(20, result.bytes_sent_);
+  EXPECT_EQ(0, result.datagrams_dropped_);
+}
+
+// A GSO message holds at most MaxGsoSegments datagrams.
+TEST_F(UdpBatchWriterTest, GsoSegmentLimit) {
+  initialize(true, true);
+  for (uint32_t i = 0; i < UdpBatchWriter::MaxGsoSegments + 1; i++) {
+    write("x");
+  }
+
+  expectSendmmsg(1, {std::string(UdpBatchWriter::MaxGsoSegments, 'x'), "x"}, 2);
+  const UdpBatchWriter::FlushResult result = writer_->flush(nullptr, peer_address_);
+  EXPECT_EQ(UdpBatchWriter::MaxGsoSegments + 1, result.datagrams_sent_);
+}
+
+// A GSO send failure disables GSO and the datagrams are sent again without it.
+TEST_F(UdpBatchWriterTest, GsoFailureFallsBack) {
+  initialize(true, true);
+  write("aaaa");
+  write("bbbb");
+
+  testing::InSequence s;
+  EXPECT_CALL(io_handle_, sendmmsg(_, 4, nullptr, _)).WillOnce(Return(ByMove(makeError(EIO))));
+  expectSendmmsg(0, {"aaaa", "bbbb"}, 2);
+  const UdpBatchWriter::FlushResult result = writer_->flush(nullptr, peer_address_);
+  EXPECT_EQ(2, result.datagrams_sent_);
+  EXPECT_FALSE(writer_->usingGso());
+}
+
+// The remaining messages are sent again after a partial send, and a failed message is dropped.
+TEST_F(UdpBatchWriterTest, PartialSendAndError) {
+  initialize(true, false);
+  write("a");
+  write("bb");
+  write("ccc");
+
+  testing::InSequence s;
+  expectSendmmsg(0, {"a", "bb", "ccc"}, 1);
+  EXPECT_CALL(io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Return(ByMove(makeError(EMSGSIZE))));
+  expectSendmmsg(0, {"ccc"}, 1);
+  const UdpBatchWriter::FlushResult result = writer_->flush(nullptr, peer_address_);
+  EXPECT_EQ(2, result.datagrams_sent_);
+  EXPECT_EQ(4, result.bytes_sent_);
+  EXPECT_EQ(1, result.datagrams_dropped_);
+}
+
+// All the remaining datagrams are dropped if the socket buffer is full.
+TEST_F(UdpBatchWriterTest, Again) {
+  initialize(true, false);
+  write("a");
+  write("bb");
+
+  EXPECT_CALL(io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                             IoSocketError::deleteIoError)))));
+  const UdpBatchWriter::FlushResult result = writer_->flush(nullptr, peer_address_);
+  EXPECT_EQ(0, result.datagrams_sent_);
+  EXPECT_EQ(2, result.datagrams_dropped_);
+}
+
+// Without sendmmsg() support each datagram is sent with its own sendmsg() call.
+TEST_F(UdpBatchWriterTest, Sendmsg) {
+  initialize(false, true);
+  EXPECT_FALSE(writer_->usingGso());
+  write("hello");
+  write("world");
+
+  const Address::Ipv4Instance local_address("127.0.0.2");
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_CALL(io_handle_, sendmsg(_, 1, 0, local_address.ip(), _))
+      .WillOnce(Return(ByMove(makeNoError(5))))
+      .WillOnce(Return(ByMove(makeError(ECONNREFUSED))));
+  const UdpBatchWriter::FlushResult result = writer_->flush(local_address.ip(), peer_address_);
+  EXPECT_EQ(1, result.datagrams_sent_);
+  EXPECT_EQ(5, result.bytes_sent_);
+  EXPECT_EQ(1, result.datagrams_dropped_);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
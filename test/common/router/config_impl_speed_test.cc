@@ -6,6 +6,7 @@
 
 #include "test/mocks/server/instance.h"
 #include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -59,7 +60,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -78,14 +79,21 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
 
 /**
  * Measure the speed of doing a route match against a route table of varying sizes.
- * Why? Currently, route matching is linear in first-to-win ordering.
+ * Why? Route matching is first-to-win, so without the path route index the cost is linear in the
+ * position of the matched route. Prefix and exact path routes are indexed by default, regex routes
+ * are not.
  *
  * We construct the first `n - 1` items in the route table so they are not
  * matched by the incoming request. Only the last route will be matched.
  * We then time how long it takes for the request to be matched against the
  * last route.
  */
-static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type,
+                             bool path_route_index = true) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.router_path_route_index",
+                               path_route_index ? "true" : "false"}});
+
   // Setup router for benchmarking.
   Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
@@ -124,6 +132,20 @@ static void bmRouteTableSizeWithExactPathMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPath);
 }
 
+/**
+ * Same as bmRouteTableSizeWithPathPrefixMatch, walking the route table linearly.
+ */
+static void bmRouteTableSizeWithPathPrefixMatchNoIndex(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix, false);
+}
+
+/**
+ * Same as bmRouteTableSizeWithExactPathMatch, walking the route table linearly.
+ */
+static void bmRouteTableSizeWithExactPathMatchNoIndex(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPath, false);
+}
+
 /**
  * Benchmark a route table with regex path matchers in the form of:
  * - /shelves/{shelf_id}/route_1
@@ -138,6 +160,8 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
 
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmRouteTableSizeWithPathPrefixMatchNoIndex)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmRouteTableSizeWithExactPathMatchNoIndex)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
 } // namespace
@@ -8593,6 +8593,72 @@ virtual_hosts:
                 ->clusterName());
 }
 
+// The path route index must preserve first-match-wins semantics across indexed and unindexed
+// routes, and across route matches that depend on more than the path.
+TEST_F(RouteMatcherTest, PathRouteIndexPreservesRouteOrder) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: path_index
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/api/v1"
+          headers:
+          - name: x-canary
+            string_match:
+              exact: "true"
+        route: { cluster: canary}
+      - match:
+          safe_regex:
+            regex: "/api/v[0-9]+/regex"
+        route: { cluster: regex}
+      - match:
+          path: "/api/v1/exact"
+        route: { cluster: exact}
+      - match:
+          prefix: "/API/V2/"
+          case_sensitive: false
+        route: { cluster: insensitive}
+      - match:
+          path_separated_prefix: "/api/v1"
+        route: { cluster: separated}
+      - match:
+          prefix: "/api/v1"
+        route: { cluster: prefix}
+      - match:
+          prefix: "/"
+        route: { cluster: default}
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "regex", "exact", "insensitive", "separated", "prefix", "default"}, {});
+
+  for (const std::string value : {"true", "false"}) {
+    mergeValues({{"envoy.reloadable_features.router_path_route_index", value}});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+    auto cluster_name = [&config](const std::string& path, bool canary = false) {
+      Http::TestRequestHeaderMapImpl headers = genHeaders("path.index.com", path, "GET");
+      if (canary) {
+        headers.addCopy("x-canary", "true");
+      }
+      return config.route(headers, 0)->routeEntry()->clusterName();
+    };
+
+    EXPECT_EQ("canary", cluster_name("/api/v1/exact", true));
+    EXPECT_EQ("regex", cluster_name("/api/v1/regex"));
+    EXPECT_EQ("exact", cluster_name("/api/v1/exact"));
+    EXPECT_EQ("exact", cluster_name("/api/v1/exact?query=true"));
+    EXPECT_EQ("insensitive", cluster_name("/Api/v2/exact"));
+    EXPECT_EQ("separated", cluster_name("/api/v1/exact/"));
+    EXPECT_EQ("separated", cluster_name("/api/v1"));
+    EXPECT_EQ("separated", cluster_name("/api/v1#fragment"));
+    EXPECT_EQ("prefix", cluster_name("/api/v12"));
+    EXPECT_EQ("default", cluster_name("/apiv1"));
+    EXPECT_EQ("default", cluster_name("/"));
+  }
+}
+
 TEST_F(RouteMatcherTest, PathSeparatedPrefixMatchRewrite) {
 
   const std::string yaml = R"EOF(
@@ -0,0 +1,91 @@
+#include "source/common/router/path_route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+PathRouteIndex::Positions findCandidates(const PathRouteIndex& index, absl::string_view path) {
+  PathRouteIndex::Positions candidates;
+  index.findCandidates(path, candidates);
+  return candidates;
+}
+
+TEST(PathRouteIndexTest, Empty) {
+  PathRouteIndex index;
+  EXPECT_EQ(0, index.size());
+  EXPECT_THAT(findCandidates(index, "/"), IsEmpty());
+  EXPECT_THAT(findCandidates(index, ""), IsEmpty());
+}
+
+TEST(PathRouteIndexTest, Prefix) {
+  PathRouteIndex index;
+  index.addPrefix("/foo", 0);
+  index.addPrefix("/foobar", 1);
+  index.addPrefix("/fob", 2);
+  index.addPrefix("/", 3);
+  index.addPrefix("", 4);
+  index.addPrefix("/foo", 5);
+  EXPECT_EQ(6, index.size());
+
+  EXPECT_THAT(findCandidates(index, ""), ElementsAre(4));
+  EXPECT_THAT(findCandidates(index, "/"), ElementsAre(3, 4));
+  EXPECT_THAT(findCandidates(index, "/fo"), ElementsAre(3, 4));
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 3, 4, 5));
+  EXPECT_THAT(findCandidates(index, "/foob"), ElementsAre(0, 3, 4, 5));
+  EXPECT_THAT(findCandidates(index, "/foobar/baz"), ElementsAre(0, 1, 3, 4, 5));
+  EXPECT_THAT(findCandidates(index, "/fob"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(findCandidates(index, "/bar"), ElementsAre(3, 4));
+  EXPECT_THAT(findCandidates(index, "bar"), ElementsAre(4));
+}
+
+// Prefixes inserted shortest last split existing edges.
+TEST(PathRouteIndexTest, PrefixEdgeSplit) {
+  PathRouteIndex index;
+  index.addPrefix("/shelves/shelf_10/", 0);
+  index.addPrefix("/shelves/shelf_1/", 1);
+  index.addPrefix("/shelves/shelf_", 2);
+  index.addPrefix("/shelves/", 3);
+
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf_10/route"), ElementsAre(0, 2, 3));
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf_1/route"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf_2/route"), ElementsAre(2, 3));
+  EXPECT_THAT(findCandidates(index, "/shelves/shelf"), ElementsAre(3));
+  EXPECT_THAT(findCandidates(index, "/shelves"), IsEmpty());
+}
+
+TEST(PathRouteIndexTest, Exact) {
+  PathRouteIndex index;
+  index.addExact("/foo", 1);
+  index.addPrefix("/foo", 2);
+  index.addExact("/foo", 0);
+  index.addExact("/foo/bar", 3);
+  EXPECT_EQ(4, index.size());
+
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(findCandidates(index, "/foo/"), ElementsAre(2));
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(2, 3));
+  EXPECT_THAT(findCandidates(index, "/fo"), IsEmpty());
+}
+
+TEST(PathRouteIndexTest, Unindexed) {
+  PathRouteIndex index;
+  index.addPrefix("/foo", 0);
+  index.addUnindexed(1);
+  index.addUnindexed(3);
+  index.addExact("/bar", 2);
+  EXPECT_EQ(2, index.size());
+
+  EXPECT_THAT(index.unindexed(), ElementsAre(1, 3));
+  EXPECT_THAT(findCandidates(index, "/bar"), ElementsAre(2));
+  EXPECT_THAT(findCandidates(index, "/baz"), IsEmpty());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
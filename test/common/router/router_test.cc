@@ -4717,6 +4717,30 @@ TEST_P(RouterShadowingTest, NoShadowForConnect) {
   router_->onDestroy();
 }
 
+// The round trip time of the upstream request is reported to the load balancing policy data of the
+// host.
+TEST_F(RouterTest, LbPolicyDataResponseTime) {
+  NiceMock<Upstream::MockHostLbPolicyData> lb_policy_data;
+  ON_CALL(*cm_.thread_local_cluster_.conn_pool_.host_, lbPolicyData())
+      .WillByDefault(Return(&lb_policy_data));
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  test_time_.advanceTimeWait(std::chrono::milliseconds(5));
+  EXPECT_CALL(lb_policy_data, onResponseTime(std::chrono::microseconds(5000)));
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
 TEST_F(RouterTest, AltStatName) {
   // Also test no upstream timeout here.
   EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <string>
@@ -552,6 +553,86 @@ TEST_F(AllocatorImplTest, ForEachSinkedTextReadout) {
   EXPECT_EQ(num_iterations, 0);
 }
 
+// Returns the names of the changed counters, in order.
+std::vector<std::string> changedCounterNames(AllocatorImpl& alloc) {
+  std::vector<std::string> names;
+  alloc.forEachChangedSinkedCounter(
+      nullptr, [&names](Counter& counter) { names.push_back(counter.name()); });
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+TEST_F(AllocatorImplTest, ForEachChangedSinkedCounter) {
+  CounterSharedPtr c1 = alloc_.makeCounter(makeStat("c1"), StatName(), {});
+  CounterSharedPtr c2 = alloc_.makeCounter(makeStat("c2"), StatName(), {});
+
+  // The first call visits all the counters, and starts tracking the writes.
+  EXPECT_THAT(changedCounterNames(alloc_), testing::ElementsAre("c1", "c2"));
+  EXPECT_THAT(changedCounterNames(alloc_), testing::IsEmpty());
+
+  c1->inc();
+  c1->add(2);
+  CounterSharedPtr c3 = alloc_.makeCounter(makeStat("c3"), StatName(), {});
+  c3->inc();
+  EXPECT_THAT(changedCounterNames(alloc_), testing::ElementsAre("c1", "c3"));
+  EXPECT_EQ(3, c1->latch());
+  EXPECT_THAT(changedCounterNames(alloc_), testing::IsEmpty());
+
+  // A changed counter that is freed is forgotten.
+  c2->inc();
+  c3->inc();
+  c3.reset();
+  EXPECT_THAT(changedCounterNames(alloc_), testing::ElementsAre("c2"));
+}
+
+TEST_F(AllocatorImplTest, ForEachChangedSinkedGauge) {
+  GaugeSharedPtr g1 =
+      alloc_.makeGauge(makeStat("g1"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  GaugeSharedPtr g2 =
+      alloc_.makeGauge(makeStat("g2"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  auto changed = [this]() {
+    std::vector<std::string> names;
+    alloc_.forEachChangedSinkedGauge(nullptr,
+                                     [&names](Gauge& gauge) { names.push_back(gauge.name()); });
+    std::sort(names.begin(), names.end());
+    return names;
+  };
+
+  EXPECT_THAT(changed(), testing::ElementsAre("g1", "g2"));
+  EXPECT_THAT(changed(), testing::IsEmpty());
+
+  g1->set(5);
+  EXPECT_THAT(changed(), testing::ElementsAre("g1"));
+  g1->sub(5);
+  g2->setParentValue(3);
+  EXPECT_THAT(changed(), testing::ElementsAre("g1", "g2"));
+  EXPECT_FALSE(g2->used());
+}
+
+TEST_F(AllocatorImplTest, ForEachChangedSinkedTextReadout) {
+  std::unique_ptr<TestUtil::TestSinkPredicates> moved_sink_predicates =
+      std::make_unique<TestUtil::TestSinkPredicates>();
+  TestUtil::TestSinkPredicates* sink_predicates = moved_sink_predicates.get();
+  alloc_.setSinkPredicates(std::move(moved_sink_predicates));
+  const StatName sinked_name = makeStat("sinked");
+  sink_predicates->add(sinked_name);
+  TextReadoutSharedPtr sinked = alloc_.makeTextReadout(sinked_name, StatName(), {});
+  TextReadoutSharedPtr unsinked = alloc_.makeTextReadout(makeStat("unsinked"), StatName(), {});
+  auto changed = [this]() {
+    std::vector<std::string> names;
+    alloc_.forEachChangedSinkedTextReadout(
+        nullptr, [&names](TextReadout& text_readout) { names.push_back(text_readout.name()); });
+    return names;
+  };
+
+  EXPECT_THAT(changed(), testing::ElementsAre("sinked"));
+  sinked->set("a");
+  unsinked->set("b");
+  EXPECT_THAT(changed(), testing::ElementsAre("sinked"));
+  unsinked->set("c");
+  EXPECT_THAT(changed(), testing::IsEmpty());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
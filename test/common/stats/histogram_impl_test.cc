@@ -1,3 +1,8 @@
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "envoy/config/metrics/v3/stats.pb.h"
 
 #include "source/common/stats/histogram_impl.h"
@@ -107,5 +112,68 @@ TEST_F(HistogramSettingsImplTest, ScaledPercent) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({0.1, 2}));
 }
 
+TEST(FlatHistogramTest, Buckets) {
+  EXPECT_EQ(0, FlatHistogram::bucketIndex(0));
+  EXPECT_EQ(0, FlatHistogram::bucketLowerBound(0));
+  const std::vector<std::pair<uint64_t, uint64_t>> values_and_lower_bounds = {
+      {1, 1},
+      {9, 9},
+      {10, 10},
+      {99, 99},
+      {100, 100},
+      {129, 120},
+      {130, 130},
+      {99999, 99000},
+      {123456789, 120000000},
+      {UINT64_MAX, 9200000000000000000},
+  };
+  for (const auto& [value, lower_bound] : values_and_lower_bounds) {
+    EXPECT_EQ(lower_bound, FlatHistogram::bucketLowerBound(FlatHistogram::bucketIndex(value)))
+        << value;
+  }
+  EXPECT_EQ(FlatHistogram::bucketIndex(std::numeric_limits<int64_t>::max()),
+            FlatHistogram::bucketIndex(UINT64_MAX));
+  EXPECT_LT(FlatHistogram::bucketIndex(UINT64_MAX), FlatHistogram::NumBuckets);
+
+  // The indexes of increasing values do not decrease, and the lower bound of each bucket is in it.
+  uint32_t previous_index = 0;
+  for (uint64_t value = 1; value < 100000000000; value = value * 11 / 10 + 1) {
+    const uint32_t index = FlatHistogram::bucketIndex(value);
+    EXPECT_LE(previous_index, index);
+    EXPECT_EQ(index, FlatHistogram::bucketIndex(FlatHistogram::bucketLowerBound(index)));
+    previous_index = index;
+  }
+}
+
+TEST(FlatHistogramTest, MatchesCircllhist) {
+  const std::vector<uint64_t> values = {0, 1, 5, 5, 13, 41, 43, 125, 415, 2201, 3201, 123456789};
+  histogram_t* expected = hist_alloc();
+  FlatHistogram flat1;
+  FlatHistogram flat2;
+  for (size_t i = 0; i < values.size(); ++i) {
+    hist_insert_intscale(expected, values[i], 0, 1);
+    (i % 2 == 0 ? flat1 : flat2).recordValue(values[i]);
+  }
+
+  FlatHistogram merged;
+  flat1.moveInto(merged);
+  flat2.moveInto(merged);
+  for (uint32_t i = 0; i < FlatHistogram::NumBuckets; ++i) {
+    EXPECT_EQ(0, flat1.count(i));
+    EXPECT_EQ(0, flat2.count(i));
+  }
+  histogram_t* actual = hist_alloc();
+  merged.addTo(actual);
+
+  HistogramStatisticsImpl expected_statistics(expected);
+  HistogramStatisticsImpl actual_statistics(actual);
+  EXPECT_EQ(expected_statistics.quantileSummary(), actual_statistics.quantileSummary());
+  EXPECT_EQ(expected_statistics.bucketSummary(), actual_statistics.bucketSummary());
+  EXPECT_EQ(values.size(), actual_statistics.sampleCount());
+  EXPECT_EQ(expected_statistics.sampleSum(), actual_statistics.sampleSum());
+  hist_free(expected);
+  hist_free(actual);
+}
+
 } // namespace Stats
 } // namespace Envoy
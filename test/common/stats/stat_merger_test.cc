@@ -96,6 +96,15 @@ TEST_F(StatMergerTest, CounterMerge) {
   EXPECT_EQ(4, store_.counterFromString("draculaer").latch());
 }
 
+TEST_F(StatMergerTest, MergeSingleStats) {
+  store_.counterFromString("draculaer").inc();
+  stat_merger_.mergeCounter("draculaer", {}, 2);
+  EXPECT_EQ(3, store_.counterFromString("draculaer").value());
+
+  stat_merger_.mergeGauge("whywassixafraidofseven", {}, 111);
+  EXPECT_EQ(789, whywassixafraidofseven_.value());
+}
+
 TEST_F(StatMergerTest, BasicDefaultAccumulationImport) {
   Protobuf::Map<std::string, uint64_t> gauges;
   gauges["whywassixafraidofseven"] = 111;
@@ -267,6 +276,11 @@ public:
     EXPECT_EQ(name, symbol_table_->toString(decoded)) << "input=" << input_descriptor;
     EXPECT_TRUE(stat_name == decoded) << "input=" << input_descriptor << ", name=" << name;
 
+    // The spans can also be given directly, as they are when read from a stats segment.
+    StatMerger::DynamicContext spans_context(*symbol_table_);
+    StatName decoded_from_spans = spans_context.makeDynamicStatName(absl::string_view(name), spans);
+    EXPECT_TRUE(stat_name == decoded_from_spans) << "input=" << input_descriptor;
+
     return size;
   }
 
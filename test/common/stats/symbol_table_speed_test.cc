@@ -13,6 +13,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -62,6 +63,52 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Encodes cluster stat names on several threads at once. Most tokens are shared
+// across threads, but each thread also introduces tokens of its own, as when
+// many clusters are added concurrently.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeMultiThreaded(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  constexpr int num_clusters = 1000;
+  const std::vector<absl::string_view> cluster_stats = {
+      "upstream_cx_total",  "upstream_cx_active",  "upstream_rq_total",
+      "upstream_rq_active", "upstream_rq_timeout", "upstream_rq_retry",
+  };
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  Envoy::Stats::SymbolTableImpl table;
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.push_back(thread_factory.createThread([&table, &cluster_stats, t]() {
+        std::vector<Envoy::Stats::StatNameStorage> names;
+        names.reserve(num_clusters * cluster_stats.size());
+        for (int i = 0; i < num_clusters; ++i) {
+          const std::string cluster_name = absl::StrCat("cluster.cluster_", t, "_", i, ".");
+          for (absl::string_view stat : cluster_stats) {
+            names.emplace_back(absl::StrCat(cluster_name, stat), table);
+          }
+        }
+        for (Envoy::Stats::StatNameStorage& name : names) {
+          name.free(table);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+}
+BENCHMARK(bmEncodeMultiThreaded)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->ArgName("threads")
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
@@ -13,11 +13,13 @@
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
 
+#include "test/benchmark/main.h"
 #include "test/common/stats/stat_test_utility.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -32,6 +34,12 @@ public:
     Stats::TestUtil::forEachSampleStat(1000, true, [this](absl::string_view name) {
       stat_names_.push_back(std::make_unique<Stats::StatNameManagedStorage>(name, symbol_table_));
     });
+    for (absl::string_view name : {"upstream_cx_total", "upstream_cx_active", "upstream_rq_total",
+                                   "upstream_rq_active", "upstream_rq_timeout",
+                                   "upstream_rq_retry", "membership_change", "update_success"}) {
+      cluster_stat_names_.push_back(
+          std::make_unique<Stats::StatNameManagedStorage>(name, symbol_table_));
+    }
   }
 
   ~ThreadLocalStorePerf() {
@@ -54,6 +62,30 @@ public:
     }
   }
 
+  // Creates num_scopes scopes on each of num_threads threads, similar to what
+  // happens when many clusters arrive at once via CDS, populating each scope
+  // with a few counters. The scopes are released when the threads exit.
+  void createScopesConcurrently(uint32_t num_threads, uint32_t num_scopes) {
+    Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+    std::vector<Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (uint32_t t = 0; t < num_threads; ++t) {
+      threads.push_back(thread_factory.createThread([this, t, num_scopes]() {
+        std::vector<Stats::ScopeSharedPtr> scopes;
+        scopes.reserve(num_scopes);
+        for (uint32_t i = 0; i < num_scopes; ++i) {
+          scopes.push_back(store_.createScope(absl::StrCat("cluster.cluster_", t, "_", i, ".")));
+          for (const auto& stat_name_storage : cluster_stat_names_) {
+            scopes.back()->counterFromStatName(stat_name_storage->statName());
+          }
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+
   void initThreading() {
     if (!Envoy::Event::Libevent::Global::initialized()) {
       Envoy::Event::Libevent::Global::initialize();
@@ -80,6 +112,7 @@ private:
   Api::ApiPtr api_;
   envoy::config::metrics::v3::StatsConfig stats_config_;
   std::vector<std::unique_ptr<Stats::StatNameManagedStorage>> stat_names_;
+  std::vector<std::unique_ptr<Stats::StatNameManagedStorage>> cluster_stat_names_;
 };
 
 } // namespace Envoy
@@ -134,5 +167,135 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
-// TODO(jmarantz): add multi-threaded variant of this test, that aggressively
-// looks up stats in multiple threads to try to trigger contention issues.
+// Tests scope and counter creation racing across threads, which contends on
+// the store's scope registry, the scopes' central caches and the symbol table.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CreateScopesMultiThreaded(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  const uint32_t num_scopes = state.range(1);
+
+  Envoy::ThreadLocalStorePerf context;
+
+  for (auto _ : state) { // NOLINT
+    context.createScopesConcurrently(num_threads, num_scopes);
+  }
+}
+BENCHMARK(BM_CreateScopesMultiThreaded)
+    ->ArgsProduct({{1, 4, 16}, {1000}})
+    ->ArgNames({"threads", "scopes"})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
+
+namespace Envoy {
+
+// Holds a TLS histogram for each of num_workers workers of num_histograms histograms, recording
+// into circllhists or flat histograms. The workers are emulated on the benchmark thread, as a TLS
+// histogram is written by the thread that created it.
+class TlsHistogramPerf {
+public:
+  TlsHistogramPerf(bool flat, uint32_t num_histograms, uint32_t num_workers)
+      : flat_(flat), num_workers_(num_workers), name_("histogram", symbol_table_) {
+    tls_histograms_.reserve(num_histograms * num_workers);
+    for (uint32_t i = 0; i < num_histograms * num_workers; ++i) {
+      tls_histograms_.push_back(new Stats::ThreadLocalHistogramImpl(
+          name_.statName(), Stats::Histogram::Unit::Milliseconds, name_.statName(), {},
+          symbol_table_, flat));
+    }
+  }
+  ~TlsHistogramPerf() { hist_free(interval_histogram_); }
+
+  // Records a value into each TLS histogram, spread over two powers of ten like latencies.
+  void record() {
+    for (const Stats::TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+      tls_histogram->recordValue(10 + next_value_++ % 990);
+    }
+  }
+
+  void beginMerge() {
+    for (const Stats::TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+      tls_histogram->beginMerge();
+    }
+  }
+
+  // Merges the TLS histograms of each histogram into an interval histogram, like
+  // ParentHistogramImpl::merge.
+  void merge() {
+    for (size_t i = 0; i < tls_histograms_.size(); i += num_workers_) {
+      if (flat_) {
+        for (uint32_t worker = 0; worker < num_workers_; ++worker) {
+          tls_histograms_[i + worker]->merge(flat_histogram_);
+        }
+        flat_histogram_.addTo(interval_histogram_);
+        flat_histogram_.clear();
+      } else {
+        for (uint32_t worker = 0; worker < num_workers_; ++worker) {
+          tls_histograms_[i + worker]->merge(interval_histogram_);
+        }
+      }
+      benchmark::DoNotOptimize(hist_sample_count(interval_histogram_));
+      hist_clear(interval_histogram_);
+    }
+  }
+
+private:
+  const bool flat_;
+  const uint32_t num_workers_;
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::StatNameManagedStorage name_;
+  std::vector<Stats::TlsHistogramSharedPtr> tls_histograms_;
+  Stats::FlatHistogram flat_histogram_;
+  histogram_t* interval_histogram_{hist_alloc()};
+  uint64_t next_value_{0};
+};
+
+} // namespace Envoy
+
+static bool skipExpensiveHistograms(benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(1) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return true;
+  }
+  return false;
+}
+
+// Tests recording a value into each TLS histogram, with circllhists when the first argument is 0,
+// or flat histograms when it is 1.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RecordTlsHistograms(benchmark::State& state) {
+  if (skipExpensiveHistograms(state)) {
+    return;
+  }
+  Envoy::TlsHistogramPerf context(state.range(0) == 1, state.range(1), state.range(2));
+
+  for (auto _ : state) { // NOLINT
+    context.record();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1) * state.range(2));
+}
+BENCHMARK(BM_RecordTlsHistograms)
+    ->ArgsProduct({{0, 1}, {1000, 10000}, {32}})
+    ->ArgNames({"flat", "histograms", "workers"})
+    ->Unit(::benchmark::kMillisecond);
+
+// Tests merging the TLS histograms after a value was recorded into each, 100 times.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_MergeTlsHistograms(benchmark::State& state) {
+  if (skipExpensiveHistograms(state)) {
+    return;
+  }
+  Envoy::TlsHistogramPerf context(state.range(0) == 1, state.range(1), state.range(2));
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    for (uint32_t i = 0; i < 100; ++i) {
+      context.record();
+    }
+    context.beginMerge();
+    state.ResumeTiming();
+    context.merge();
+  }
+}
+BENCHMARK(BM_MergeTlsHistograms)
+    ->ArgsProduct({{0, 1}, {1000, 10000}, {32}})
+    ->ArgNames({"flat", "histograms", "workers"})
+    ->Unit(::benchmark::kMillisecond);
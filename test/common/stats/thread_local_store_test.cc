@@ -1,5 +1,6 @@
 #include <chrono>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <random>
 #include <string>
@@ -25,6 +26,7 @@
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/str_split.h"
@@ -1479,6 +1481,28 @@ TEST_F(HistogramTest, BasicSingleHistogramMerge) {
   EXPECT_EQ(1, validateMerge());
 }
 
+// Flat TLS histograms have the same statistics as circllhist ones.
+TEST_F(HistogramTest, FlatHistogramMultipleMerges) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.flat_tls_histograms", "true"}});
+  Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
+  Histogram& h2 = scope_.histogramFromString("h2", Histogram::Unit::Unspecified);
+
+  expectCallAndAccumulate(h1, 0);
+  expectCallAndAccumulate(h1, 43);
+  expectCallAndAccumulate(h1, 415);
+  expectCallAndAccumulate(h1, 2201);
+  expectCallAndAccumulate(h2, 1);
+  EXPECT_EQ(2, validateMerge());
+
+  expectCallAndAccumulate(h1, 3201);
+  expectCallAndAccumulate(h2, 123456789);
+  expectCallAndAccumulate(h2, std::numeric_limits<int64_t>::max());
+  EXPECT_EQ(2, validateMerge());
+
+  EXPECT_EQ(2, validateMerge());
+}
+
 TEST_F(HistogramTest, BasicMultiHistogramMerge) {
   Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
   Histogram& h2 = scope_.histogramFromString("h2", Histogram::Unit::Unspecified);
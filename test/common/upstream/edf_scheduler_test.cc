@@ -134,6 +134,75 @@ TEST(EdfSchedulerTest, ManyPeekahead) {
   }
 }
 
+// Validate that update() keeps the schedule of the remaining entries, drops the removed ones and
+// adds the new ones.
+TEST(EdfSchedulerTest, Update) {
+  EdfScheduler<uint32_t> sched1;
+  EdfScheduler<uint32_t> sched2;
+  constexpr uint32_t num_entries = 8;
+  std::vector<std::shared_ptr<uint32_t>> entries;
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries.push_back(std::make_shared<uint32_t>(i));
+    sched1.add(i + 1, entries[i]);
+    sched2.add(i + 1, entries[i]);
+  }
+  const auto weight = [](const uint32_t& entry) { return entry + 1; };
+  for (uint32_t i = 0; i < 10; ++i) {
+    sched1.pickAndAdd(weight);
+    sched2.pickAndAdd(weight);
+  }
+
+  // An update with the same entries doesn't change the schedule.
+  sched1.update(entries, weight);
+  for (uint32_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(*sched2.pickAndAdd(weight), *sched1.pickAndAdd(weight));
+  }
+
+  // Removed entries are no longer picked, even though they are still alive.
+  std::vector<std::shared_ptr<uint32_t>> remaining(entries.begin(), entries.begin() + 4);
+  sched1.update(remaining, weight);
+  uint32_t pick_count[num_entries] = {};
+  for (uint32_t i = 0; i < 100; ++i) {
+    ++pick_count[*sched1.pickAndAdd(weight)];
+  }
+  EXPECT_NEAR(10, pick_count[0], 1);
+  EXPECT_NEAR(20, pick_count[1], 1);
+  EXPECT_NEAR(30, pick_count[2], 1);
+  EXPECT_NEAR(40, pick_count[3], 1);
+  for (uint32_t i = 4; i < num_entries; ++i) {
+    EXPECT_EQ(0, pick_count[i]);
+  }
+
+  // New entries are scheduled with their weight.
+  auto new_entry = std::make_shared<uint32_t>(4);
+  remaining.push_back(new_entry);
+  sched1.update(remaining, weight);
+  uint32_t new_pick_count = 0;
+  for (uint32_t i = 0; i < 150; ++i) {
+    if (sched1.pickAndAdd(weight) == new_entry) {
+      ++new_pick_count;
+    }
+  }
+  EXPECT_NEAR(50, new_pick_count, 1);
+}
+
+// Validate that peeked entries which are removed by update() are not picked.
+TEST(EdfSchedulerTest, UpdateRemovesPeeked) {
+  EdfScheduler<uint32_t> sched;
+  auto first_entry = std::make_shared<uint32_t>(37);
+  auto second_entry = std::make_shared<uint32_t>(42);
+  sched.add(2, first_entry);
+  sched.add(1, second_entry);
+  EXPECT_EQ(37, *sched.peekAgain([](const uint32_t&) { return 1; }));
+
+  sched.update(std::vector<std::shared_ptr<uint32_t>>{second_entry},
+               [](const uint32_t&) { return 1; });
+  for (uint32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(42, *sched.pickAndAdd([](const uint32_t&) { return 1; }));
+  }
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
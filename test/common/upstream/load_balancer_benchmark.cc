@@ -1,5 +1,7 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
+#include <algorithm>
+#include <list>
 #include <memory>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -15,6 +17,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 
 #include "absl/types/optional.h"
 #include "benchmark/benchmark.h"
@@ -151,6 +154,62 @@ BENCHMARK(benchmarkRoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(::benchmark::kMillisecond);
 
+// Replace a percentage of the hosts of the tester on each iteration, similar to an EDS update.
+// Only the host set update, which updates the load balancer, is timed.
+void churnHosts(::benchmark::State& state, BaseTester& tester, uint64_t churn_percent,
+                bool weighted) {
+  HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  const uint64_t hosts_to_replace = std::max<uint64_t>(1, hosts.size() * churn_percent / 100);
+  uint64_t next_host = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    HostVector hosts_added;
+    HostVector hosts_removed(hosts.begin(), hosts.begin() + hosts_to_replace);
+    hosts.erase(hosts.begin(), hosts.begin() + hosts_to_replace);
+    for (uint64_t i = 0; i < hosts_to_replace; i++, next_host++) {
+      // Keep the replacement addresses distinct from the initial 10.0.0.0/16 hosts.
+      const uint64_t host = next_host % 65536;
+      const std::string url = fmt::format("tcp://10.1.{}.{}:6379", host / 256, host % 256);
+      hosts_added.push_back(makeTestHost(tester.info_, url, tester.simTime(),
+                                         weighted && host % 2 == 0 ? 10 : 1));
+    }
+    hosts.insert(hosts.end(), hosts_added.begin(), hosts_added.end());
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    state.ResumeTiming();
+
+    tester.priority_set_.updateHosts(
+        0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {}, hosts_added,
+        hosts_removed, absl::nullopt);
+  }
+}
+
+// Replace a percentage of the hosts of a weighted round robin load balancer on each iteration
+// to measure the cost of keeping the EDF schedulers up to date.
+void benchmarkRoundRobinLoadBalancerChurn(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t churn_percent = state.range(1);
+  const bool incremental_update = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.edf_lb_incremental_update",
+                               incremental_update ? "true" : "false"}});
+
+  RoundRobinTester tester(num_hosts, 50, 10);
+  tester.initialize();
+  churnHosts(state, tester, churn_percent, true);
+  benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+}
+BENCHMARK(benchmarkRoundRobinLoadBalancerChurn)
+    ->ArgsProduct({{1000, 10000, 50000}, {1, 10}, {0, 1}})
+    ->ArgNames({"hosts", "churn_percent", "incremental"})
+    ->Unit(::benchmark::kMillisecond);
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
@@ -171,8 +230,13 @@ public:
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               uint64_t table_size = MaglevTable::DefaultTableSize)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    if (table_size != MaglevTable::DefaultTableSize) {
+      config_ = envoy::config::cluster::v3::Cluster::MaglevLbConfig();
+      config_.value().mutable_table_size()->set_value(table_size);
+    }
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(
         priority_set_, stats_, stats_scope_, runtime_, random_,
         config_.has_value()
@@ -242,6 +306,59 @@ BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
     ->Arg(500)
     ->Unit(::benchmark::kMillisecond);
 
+// Replace a percentage of the hosts of a ring hash load balancer on each iteration to measure the
+// cost of updating its ring, with about 100 hashes per host.
+void benchmarkRingHashLoadBalancerChurn(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t churn_percent = state.range(1);
+  const bool incremental_update = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.ring_hash_incremental_update",
+                               incremental_update ? "true" : "false"}});
+
+  RingHashTester tester(num_hosts, num_hosts * 100);
+  tester.ring_hash_lb_->initialize();
+  churnHosts(state, tester, churn_percent, false);
+}
+BENCHMARK(benchmarkRingHashLoadBalancerChurn)
+    ->ArgsProduct({{1000, 10000, 20000}, {1, 10}, {0, 1}})
+    ->ArgNames({"hosts", "churn_percent", "incremental"})
+    ->Unit(::benchmark::kMillisecond);
+
+// Replace a percentage of the hosts of a Maglev load balancer on each iteration to measure the
+// cost of updating its table, with a table size over 100 times the number of hosts as
+// recommended by the paper.
+void benchmarkMaglevLoadBalancerChurn(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t churn_percent = state.range(1);
+  const bool incremental_update = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.maglev_incremental_update",
+                               incremental_update ? "true" : "false"}});
+
+  // Primes above 100 times the number of hosts.
+  const uint64_t table_size = num_hosts <= 1000 ? 100003 : (num_hosts <= 10000 ? 1000003 : 2000003);
+  MaglevTester tester(num_hosts, 0, 0, table_size);
+  tester.maglev_lb_->initialize();
+  churnHosts(state, tester, churn_percent, false);
+}
+BENCHMARK(benchmarkMaglevLoadBalancerChurn)
+    ->ArgsProduct({{1000, 10000, 20000}, {1, 10}, {0, 1}})
+    ->ArgNames({"hosts", "churn_percent", "incremental"})
+    ->Unit(::benchmark::kMillisecond);
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   // Upstream::LoadBalancerContext
@@ -312,6 +429,109 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Simulates workers that each run their own least request load balancer over the same hosts, and
+// send bursts of requests that wait for a connection before becoming active. Reports how evenly
+// the outstanding requests are spread over the hosts.
+class LeastRequestSimulation : public BaseTester {
+public:
+  LeastRequestSimulation(uint64_t num_hosts, uint64_t num_workers, bool use_outstanding_requests)
+      : BaseTester(num_hosts) {
+    envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+    lr_lb_config.set_use_outstanding_requests(use_outstanding_requests);
+    for (uint64_t i = 0; i < num_workers; ++i) {
+      workers_.push_back(std::make_unique<LeastRequestLoadBalancer>(
+          priority_set_, &local_priority_set_, stats_, runtime_, random_, common_config_,
+          lr_lb_config, simTime()));
+    }
+  }
+
+  // Advances the simulation by one tick, and returns the standard deviation of the outstanding
+  // requests of the hosts at its end.
+  double tick() {
+    // Requests connect one tick after being assigned to a host, and then take up to
+    // max_service_ticks to complete.
+    static constexpr uint64_t max_service_ticks = 10;
+    static constexpr uint64_t requests_per_worker = 10;
+
+    auto it = requests_.begin();
+    while (it != requests_.end()) {
+      if (it->connect_tick_ == tick_) {
+        it->host_->stats().rq_active_.inc();
+      }
+      if (it->done_tick_ == tick_) {
+        it->host_->stats().rq_active_.dec();
+        it->host_->load().outstanding_requests_--;
+        it = requests_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    // Interleave the workers, as they would run concurrently.
+    for (uint64_t i = 0; i < requests_per_worker; ++i) {
+      for (auto& worker : workers_) {
+        HostConstSharedPtr host = worker->chooseHost(nullptr);
+        host->load().outstanding_requests_++;
+        requests_.push_back({host, tick_ + 1, tick_ + 2 + random_.random() % max_service_ticks});
+      }
+    }
+    tick_++;
+
+    const HostVector& hosts = priority_set_.hostSetsPerPriority()[0]->hosts();
+    double mean = 0;
+    for (const auto& host : hosts) {
+      mean += host->load().outstanding_requests_;
+    }
+    mean /= hosts.size();
+    double variance = 0;
+    for (const auto& host : hosts) {
+      variance += std::pow(host->load().outstanding_requests_ - mean, 2);
+    }
+    return std::sqrt(variance / hosts.size());
+  }
+
+private:
+  struct Request {
+    HostConstSharedPtr host_;
+    uint64_t connect_tick_;
+    uint64_t done_tick_;
+  };
+
+  std::vector<std::unique_ptr<LeastRequestLoadBalancer>> workers_;
+  std::list<Request> requests_;
+  uint64_t tick_{};
+};
+
+void benchmarkLeastRequestLoadBalancerSimulation(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_workers = state.range(1);
+  const bool use_outstanding_requests = state.range(2) != 0;
+  const uint64_t ticks = 1000;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    LeastRequestSimulation simulation(num_hosts, num_workers, use_outstanding_requests);
+    state.ResumeTiming();
+
+    double stddev_sum = 0;
+    for (uint64_t i = 0; i < ticks; ++i) {
+      stddev_sum += simulation.tick();
+    }
+
+    state.PauseTiming();
+    state.counters["mean_stddev_outstanding"] = stddev_sum / ticks;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerSimulation)
+    ->Args({100, 1, 0})
+    ->Args({100, 1, 1})
+    ->Args({100, 8, 0})
+    ->Args({100, 8, 1})
+    ->Args({100, 32, 0})
+    ->Args({100, 32, 1})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
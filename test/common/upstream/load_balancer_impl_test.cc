@@ -1045,6 +1045,58 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Validate that host set updates are applied to the existing schedule when incremental EDF
+// updates are enabled.
+TEST_P(RoundRobinLoadBalancerTest, WeightedIncrementalUpdate) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.edf_lb_incremental_update", "true"}});
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  // Initial weights respected.
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  const auto count_picks = [this](uint32_t num_picks) {
+    absl::flat_hash_map<HostConstSharedPtr, uint32_t> pick_counts;
+    for (uint32_t i = 0; i < num_picks; ++i) {
+      ++pick_counts[lb_->chooseHost(nullptr)];
+    }
+    return pick_counts;
+  };
+
+  // Add a host, it joins the existing schedule.
+  HostSharedPtr host0 = hostSet().hosts_[0];
+  HostSharedPtr host1 = hostSet().hosts_[1];
+  HostSharedPtr host2 = makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3);
+  hostSet().healthy_hosts_.push_back(host2);
+  hostSet().hosts_.push_back(host2);
+  hostSet().runCallbacks({host2}, {});
+  auto pick_counts = count_picks(600);
+  EXPECT_NEAR(100, pick_counts[host0], 1);
+  EXPECT_NEAR(200, pick_counts[host1], 1);
+  EXPECT_NEAR(300, pick_counts[host2], 1);
+
+  // A host that becomes unhealthy is removed from the healthy hosts schedule.
+  hostSet().healthy_hosts_ = {host0, host2};
+  hostSet().runCallbacks({}, {});
+  pick_counts = count_picks(400);
+  EXPECT_NEAR(100, pick_counts[host0], 1);
+  EXPECT_EQ(0, pick_counts[host1]);
+  EXPECT_NEAR(300, pick_counts[host2], 1);
+
+  // Remove a host and bring the unhealthy one back.
+  hostSet().healthy_hosts_ = {host0, host1};
+  hostSet().hosts_ = {host0, host1};
+  hostSet().runCallbacks({}, {host2});
+  pick_counts = count_picks(300);
+  EXPECT_NEAR(100, pick_counts[host0], 1);
+  EXPECT_NEAR(200, pick_counts[host1], 1);
+  EXPECT_EQ(0, pick_counts[host2]);
+}
+
 // Validate that the RNG seed influences pick order when weighted RR.
 TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
@@ -2027,6 +2079,60 @@ TEST_P(LeastRequestLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
 }
 
+// Hosts are compared by their outstanding requests, including the requests waiting for a
+// connection, rather than by their active requests.
+TEST_P(LeastRequestLoadBalancerTest, OutstandingRequests) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+  lr_lb_config.set_use_outstanding_requests(true);
+  LeastRequestLoadBalancer lb{priority_set_, nullptr,        stats_,       runtime_,
+                              random_,       common_config_, lr_lb_config, simTime()};
+
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  hostSet().healthy_hosts_[0]->load().outstanding_requests_ = 3;
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(2);
+  hostSet().healthy_hosts_[1]->load().outstanding_requests_ = 2;
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb.chooseHost(nullptr));
+
+  // The default load balancer still uses the active requests.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+
+  hostSet().healthy_hosts_[1]->load().outstanding_requests_ = 4;
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb.chooseHost(nullptr));
+}
+
+// Host weights are scaled by the outstanding requests when hosts have different weights.
+TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithOutstandingRequests) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+  lr_lb_config.set_use_outstanding_requests(true);
+  LeastRequestLoadBalancer lb{priority_set_, nullptr,        stats_,       runtime_,
+                              random_,       common_config_, lr_lb_config, simTime()};
+
+  // Bringing hosts[1] to an outstanding request should yield a 1:1 ratio.
+  hostSet().healthy_hosts_[1]->load().outstanding_requests_ = 1;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  uint32_t host_0_picks = 0;
+  for (uint32_t i = 0; i < 10; ++i) {
+    if (lb.chooseHost(nullptr) == hostSet().healthy_hosts_[0]) {
+      host_0_picks++;
+    }
+  }
+  EXPECT_EQ(5, host_0_picks);
+}
+
 TEST_P(LeastRequestLoadBalancerTest, PNC) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime()),
@@ -12,6 +12,7 @@
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/priority_set.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 
 #include "absl/types/optional.h"
 
@@ -309,6 +310,50 @@ TEST_F(MaglevLoadBalancerTest, Weighted) {
   }
 }
 
+// With incremental updates, the hosts that remain keep their entries and only the entries of the
+// removed host are reassigned.
+TEST_F(MaglevLoadBalancerTest, IncrementalUpdate) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.maglev_incremental_update", "true"}});
+
+  // The weights add up to the table size, so the share of each host is its weight.
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime(), 3),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime(), 3),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime(), 5)};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init(11);
+
+  // The first incremental update brings the hosts from the entries of the full build to their
+  // exact shares.
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(3, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(5, lb_->stats().max_entries_per_host_.value());
+  LoadBalancerPtr lb = lb_->factory()->create();
+  std::vector<HostConstSharedPtr> previous_assignments;
+  for (uint32_t i = 0; i < 11; ++i) {
+    TestLoadBalancerContext context(i);
+    previous_assignments.push_back(lb->chooseHost(&context));
+  }
+
+  const HostSharedPtr removed_host = host_set_.hosts_[2];
+  host_set_.hosts_[2] = makeTestHost(info_, "tcp://127.0.0.1:93", simTime(), 5);
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({host_set_.hosts_[2]}, {removed_host});
+  EXPECT_EQ(3, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(5, lb_->stats().max_entries_per_host_.value());
+
+  lb = lb_->factory()->create();
+  for (uint32_t i = 0; i < 11; ++i) {
+    TestLoadBalancerContext context(i);
+    if (previous_assignments[i] == removed_host) {
+      EXPECT_EQ(host_set_.hosts_[2], lb->chooseHost(&context));
+    } else {
+      EXPECT_EQ(previous_assignments[i], lb->chooseHost(&context));
+    }
+  }
+}
+
 // Locality weighted sanity test when localities have the same weights. Host weights for hosts in
 // different localities shouldn't matter.
 TEST_F(MaglevLoadBalancerTest, LocalityWeightedSameLocalityWeights) {
@@ -602,6 +602,46 @@ TEST_P(RingHashLoadBalancerTest, HostWeightedTinyRing) {
   }
 }
 
+// Given a ring updated incrementally, expect the same ring as one built from scratch.
+TEST_P(RingHashLoadBalancerTest, IncrementalUpdate) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime(), 1),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime(), 2),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime(), 3)};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(256);
+  init();
+
+  // Remove a host, add another one, and change the weight of a remaining one.
+  const HostSharedPtr removed_host = hostSet().hosts_[0];
+  const HostSharedPtr added_host = makeTestHost(info_, "tcp://127.0.0.1:93", simTime(), 2);
+  hostSet().hosts_[1]->weight(5);
+  hostSet().hosts_ = {hostSet().hosts_[1], hostSet().hosts_[2], added_host};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({added_host}, {removed_host});
+  const uint64_t size = lb_->stats().size_.value();
+  const uint64_t min_hashes_per_host = lb_->stats().min_hashes_per_host_.value();
+  const uint64_t max_hashes_per_host = lb_->stats().max_hashes_per_host_.value();
+  LoadBalancerPtr lb = lb_->factory()->create();
+  std::vector<HostConstSharedPtr> assignments;
+  for (uint64_t i = 0; i < 4096; ++i) {
+    TestLoadBalancerContext context(i * (std::numeric_limits<uint64_t>::max() / 4096));
+    assignments.push_back(lb->chooseHost(&context));
+  }
+
+  init();
+  EXPECT_EQ(size, lb_->stats().size_.value());
+  EXPECT_EQ(min_hashes_per_host, lb_->stats().min_hashes_per_host_.value());
+  EXPECT_EQ(max_hashes_per_host, lb_->stats().max_hashes_per_host_.value());
+  lb = lb_->factory()->create();
+  for (uint64_t i = 0; i < 4096; ++i) {
+    TestLoadBalancerContext context(i * (std::numeric_limits<uint64_t>::max() / 4096));
+    EXPECT_EQ(assignments[i], lb->chooseHost(&context));
+  }
+}
+
 // Given hosts with weights 1, 2 and 3, and a sufficiently large ring, expect that requests will
 // distribute to the hosts with approximately the right proportion.
 TEST_P(RingHashLoadBalancerTest, HostWeightedLargeRing) {
@@ -17,6 +17,7 @@
 #include "test/mocks/stream_info/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
 
 using testing::_;
 using testing::InSequence;
@@ -86,8 +87,6 @@ private:
     mockAddEntry(MOCK_TCP_LOG_FIELD_NAME);
   }
 
-  bool isEmpty() override { return message_.fields().empty(); }
-
   void initMessage() override { ++num_inits_; }
 
   void clearMessage() override {
@@ -544,6 +543,30 @@ TEST_F(GrpcAccessLoggerCacheTest, Deduplication) {
   EXPECT_NE(logger1, logger_cache_.getOrCreateLogger(config, Common::GrpcAccessLoggerType::HTTP));
 }
 
+// Test that entries serialized one by one after a serialized message parse as a single message.
+TEST(GrpcAccessLoggerUtilsTest, SerializeNestedMessage) {
+  envoy::service::accesslog::v3::StreamAccessLogsMessage expected;
+  expected.mutable_identifier()->set_log_name("test_log_name");
+  Buffer::OwnedImpl buffer;
+  buffer.add(expected.SerializeAsString());
+
+  const uint32_t field_numbers[] = {
+      envoy::service::accesslog::v3::StreamAccessLogsMessage::kHttpLogsFieldNumber,
+      envoy::service::accesslog::v3::StreamAccessLogsMessage::HTTPAccessLogEntries::
+          kLogEntryFieldNumber};
+  // Use paths of different sizes so that the lengths take one to three bytes.
+  for (const size_t path_size : {1, 200, 20000}) {
+    envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+    entry.mutable_request()->set_path(std::string(path_size, 'a'));
+    GrpcCommon::serializeNestedMessage(entry, field_numbers, buffer);
+    *expected.mutable_http_logs()->add_log_entry() = entry;
+  }
+
+  envoy::service::accesslog::v3::StreamAccessLogsMessage message;
+  EXPECT_TRUE(message.ParseFromString(buffer.toString()));
+  EXPECT_TRUE(TestUtility::protoEqual(message, expected));
+}
+
 } // namespace
 } // namespace GrpcCommon
 } // namespace AccessLoggers
@@ -862,6 +862,194 @@ TEST_F(CacheFilterDeathTest, StreamTimeoutDuringLookup) {
       "Request timed out while cache lookup was outstanding.");
 }
 
+class CacheFilterCoalescingTest : public CacheFilterTest {
+protected:
+  void SetUp() override {
+    CacheFilterTest::SetUp();
+    ON_CALL(follower_decoder_callbacks_, dispatcher())
+        .WillByDefault(::testing::ReturnRef(*dispatcher_));
+    ON_CALL(follower_decoder_callbacks_.stream_info_, filterState())
+        .WillByDefault(::testing::ReturnRef(filter_state_));
+  }
+
+  CacheFilterSharedPtr
+  makeCoalescingFilter(Http::MockStreamDecoderFilterCallbacks& decoder_callbacks,
+                       Http::MockStreamEncoderFilterCallbacks& encoder_callbacks) {
+    auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
+                                                context_.timeSource(), simple_cache_, coalescer_);
+    filter->setDecoderFilterCallbacks(decoder_callbacks);
+    filter->setEncoderFilterCallbacks(encoder_callbacks);
+    return filter;
+  }
+
+  // Starts a leader and a follower request for the same response; only the leader goes upstream.
+  void startLeaderAndFollower(CacheFilterSharedPtr leader, CacheFilterSharedPtr follower) {
+    EXPECT_EQ(leader->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    EXPECT_EQ(follower->decodeHeaders(follower_request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+
+    EXPECT_CALL(decoder_callbacks_, continueDecoding);
+    EXPECT_CALL(follower_decoder_callbacks_, continueDecoding).Times(0);
+    EXPECT_CALL(follower_decoder_callbacks_, encodeHeaders_).Times(0);
+    // The follower's wait timer is pending, so run the dispatcher without blocking.
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+    ::testing::Mock::VerifyAndClearExpectations(&follower_decoder_callbacks_);
+    EXPECT_EQ(coalescer_->stats().coalesced_requests_.value(), 1);
+  }
+
+  const std::chrono::milliseconds max_wait_{1000};
+  RequestCoalescerSharedPtr coalescer_ =
+      std::make_shared<RequestCoalescer>(max_wait_, "", context_.scope());
+  Http::TestRequestHeaderMapImpl follower_request_headers_{
+      {":path", "/"}, {":method", "GET"}, {":scheme", "https"}};
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> follower_decoder_callbacks_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> follower_encoder_callbacks_;
+};
+
+TEST_F(CacheFilterCoalescingTest, FollowerServedFromLeaderResponse) {
+  request_headers_.setHost("FollowerServedFromLeaderResponse");
+  follower_request_headers_.setHost("FollowerServedFromLeaderResponse");
+  const std::string body = "abc";
+  CacheFilterSharedPtr leader = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  CacheFilterSharedPtr follower =
+      makeCoalescingFilter(follower_decoder_callbacks_, follower_encoder_callbacks_);
+  startLeaderAndFollower(leader, follower);
+
+  // Once the leader has inserted its response, the follower is served from cache.
+  EXPECT_CALL(follower_decoder_callbacks_,
+              encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  EXPECT_CALL(
+      follower_decoder_callbacks_,
+      encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  EXPECT_CALL(follower_decoder_callbacks_, continueDecoding).Times(0);
+  Buffer::OwnedImpl body_buffer(body);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  EXPECT_EQ(leader->encodeData(body_buffer, true), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&follower_decoder_callbacks_);
+
+  follower->onStreamComplete();
+  EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  EXPECT_EQ(coalescer_->stats().coalesced_request_timeouts_.value(), 0);
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, FollowerGoesUpstreamAfterTimeout) {
+  request_headers_.setHost("FollowerGoesUpstreamAfterTimeout");
+  follower_request_headers_.setHost("FollowerGoesUpstreamAfterTimeout");
+  CacheFilterSharedPtr leader = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  CacheFilterSharedPtr follower =
+      makeCoalescingFilter(follower_decoder_callbacks_, follower_encoder_callbacks_);
+  startLeaderAndFollower(leader, follower);
+
+  EXPECT_CALL(follower_decoder_callbacks_, continueDecoding);
+  time_source_.advanceTimeAndRun(max_wait_, *dispatcher_, Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&follower_decoder_callbacks_);
+  EXPECT_EQ(coalescer_->stats().coalesced_request_timeouts_.value(), 1);
+
+  // The leader finishing later doesn't wake the follower up again.
+  EXPECT_CALL(follower_decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  follower->onStreamComplete();
+  EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheMiss));
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, FollowerGoesUpstreamWhenLeaderResponseUncacheable) {
+  request_headers_.setHost("FollowerGoesUpstreamWhenLeaderResponseUncacheable");
+  follower_request_headers_.setHost("FollowerGoesUpstreamWhenLeaderResponseUncacheable");
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  CacheFilterSharedPtr leader = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  CacheFilterSharedPtr follower =
+      makeCoalescingFilter(follower_decoder_callbacks_, follower_encoder_callbacks_);
+  startLeaderAndFollower(leader, follower);
+
+  // The follower looks up the response again, misses, and goes upstream without waiting again.
+  EXPECT_CALL(follower_decoder_callbacks_, continueDecoding);
+  EXPECT_CALL(follower_decoder_callbacks_, encodeHeaders_).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&follower_decoder_callbacks_);
+  EXPECT_EQ(coalescer_->stats().coalesced_requests_.value(), 1);
+  EXPECT_EQ(coalescer_->stats().coalesced_request_timeouts_.value(), 0);
+
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, LeaderDestroyedBeforeResponse) {
+  request_headers_.setHost("LeaderDestroyedBeforeResponse");
+  follower_request_headers_.setHost("LeaderDestroyedBeforeResponse");
+  CacheFilterSharedPtr leader = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  CacheFilterSharedPtr follower =
+      makeCoalescingFilter(follower_decoder_callbacks_, follower_encoder_callbacks_);
+  startLeaderAndFollower(leader, follower);
+
+  EXPECT_CALL(follower_decoder_callbacks_, continueDecoding);
+  leader->onDestroy();
+  leader.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&follower_decoder_callbacks_);
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, FollowerDestroyedWhileWaiting) {
+  request_headers_.setHost("FollowerDestroyedWhileWaiting");
+  follower_request_headers_.setHost("FollowerDestroyedWhileWaiting");
+  CacheFilterSharedPtr leader = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  CacheFilterSharedPtr follower =
+      makeCoalescingFilter(follower_decoder_callbacks_, follower_encoder_callbacks_);
+  startLeaderAndFollower(leader, follower);
+
+  follower->onDestroy();
+  follower.reset();
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  leader->onDestroy();
+
+  // The leader's response was still inserted for later requests.
+  CacheFilterSharedPtr next = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_(IsSupersetOfHeaders(response_headers_), true));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(next->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(coalescer_->stats().coalesced_requests_.value(), 1);
+  next->onDestroy();
+}
+
+TEST_F(CacheFilterCoalescingTest, RequestTimeoutAfterWaitIsABug) {
+  request_headers_.setHost("RequestTimeoutAfterWaitIsABug");
+  follower_request_headers_.setHost("RequestTimeoutAfterWaitIsABug");
+  CacheFilterSharedPtr leader = makeCoalescingFilter(decoder_callbacks_, encoder_callbacks_);
+  CacheFilterSharedPtr follower =
+      makeCoalescingFilter(follower_decoder_callbacks_, follower_encoder_callbacks_);
+  startLeaderAndFollower(leader, follower);
+
+  // Hold back the result of the lookup the follower starts once the wait is over.
+  Event::DispatcherPtr lookup_dispatcher = api_->allocateDispatcher("lookup_thread");
+  ON_CALL(follower_decoder_callbacks_, dispatcher())
+      .WillByDefault(::testing::ReturnRef(*lookup_dispatcher));
+  EXPECT_CALL(follower_decoder_callbacks_, continueDecoding).Times(0);
+  leader->onDestroy();
+  leader.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  // The cache, not the wait, is now what the request timed out on.
+  Envoy::Http::TestResponseHeaderMapImpl local_response_headers{{":status", "408"}};
+  EXPECT_ENVOY_BUG(EXPECT_EQ(follower->encodeHeaders(local_response_headers, true),
+                             Http::FilterHeadersStatus::Continue),
+                   "Request timed out while cache lookup was outstanding.");
+  follower->onDestroy();
+}
+
 class LookupStatusTest
     : public ::testing::TestWithParam<std::tuple<absl::optional<CacheEntryStatus>, FilterState>> {
 protected:
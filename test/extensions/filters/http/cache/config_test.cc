@@ -33,6 +33,18 @@ TEST_F(CacheFilterFactoryTest, Basic) {
   ASSERT(dynamic_cast<CacheFilter*>(filter.get()));
 }
 
+TEST_F(CacheFilterFactoryTest, CollapsedForwarding) {
+  config_.mutable_typed_config()->PackFrom(
+      envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig());
+  config_.mutable_collapsed_forwarding()->mutable_max_wait()->set_seconds(1);
+  Http::FilterFactoryCb cb = factory_.createFilterFactoryFromProto(config_, "stats.", context_);
+  Http::StreamFilterSharedPtr filter;
+  EXPECT_CALL(filter_callback_, addStreamFilter(_)).WillOnce(::testing::SaveArg<0>(&filter));
+  cb(filter_callback_);
+  ASSERT(filter);
+  ASSERT(dynamic_cast<CacheFilter*>(filter.get()));
+}
+
 TEST_F(CacheFilterFactoryTest, NoTypedConfig) {
   EXPECT_THROW(factory_.createFilterFactoryFromProto(config_, "stats", context_), EnvoyException);
 }
@@ -17,6 +17,7 @@
 #include "test/mocks/upstream/cluster_update_callbacks_handle.h"
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
@@ -673,6 +674,65 @@ matcher:
   EXPECT_EQ(output_.back(), "fake_cluster 0 5 0 0 1");
 }
 
+// Verify that upstream writes are buffered and sent together when batching is enabled.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWrites) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.udp_proxy_batch_upstream_writes", "true"}});
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+  )EOF"));
+
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillRepeatedly(Return(false));
+  expectSessionCreate(upstream_address_);
+  TestSession& session = test_sessions_[0];
+  auto* flush_writes_cb = new Event::MockSchedulableCallback(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*session.socket_->io_handle_, supportsMmsg()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr)).Times(2);
+  EXPECT_CALL(*session.socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*flush_writes_cb, enabled()).Times(2);
+  EXPECT_CALL(*flush_writes_cb, scheduleCallbackCurrentIteration());
+  EXPECT_CALL(*session.socket_->io_handle_, sendmsg(_, _, _, _, _)).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  checkTransferStats(11 /*rx_bytes*/, 2 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+  EXPECT_EQ(
+      0, TestUtility::findCounter(
+             factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+             "udp.sess_tx_datagrams")
+             ->value());
+
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Invoke([&](const Network::RawSliceArrays& slices, uint64_t,
+                           const Network::Address::Ip*,
+                           const Network::Address::Instance& peer_address) {
+        EXPECT_EQ(peer_address, *upstream_address_);
+        EXPECT_EQ(2, slices.size());
+        EXPECT_EQ("hello", absl::string_view(static_cast<const char*>(slices[0][0].mem_),
+                                             slices[0][0].len_));
+        EXPECT_EQ("hello2", absl::string_view(static_cast<const char*>(slices[1][0].mem_),
+                                              slices[1][0].len_));
+        return makeNoError(2);
+      }));
+  flush_writes_cb->invokeCallback();
+  EXPECT_EQ(
+      2, TestUtility::findCounter(
+             factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+             "udp.sess_tx_datagrams")
+             ->value());
+  EXPECT_EQ(11, factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+                    ->traffic_stats_->upstream_cx_tx_bytes_total_.value());
+}
+
 // No upstream host handling.
 TEST_F(UdpProxyFilterTest, NoUpstreamHost) {
   InSequence s;
@@ -0,0 +1,139 @@
+// Benchmarks the startup cost of a file system cache, i.e. the work done to learn the
+// size of the cache and to be able to answer lookups, with and without a cache index.
+
+#include <fstream>
+#include <string>
+
+#include "source/common/filesystem/directory.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/environment.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+namespace {
+
+// Returns a cache directory populated with the given number of cache entry files, creating
+// it on first use.
+const std::string& cacheDirectory(uint64_t entries) {
+  static auto* directories = new absl::flat_hash_map<uint64_t, std::string>();
+  auto it = directories->find(entries);
+  if (it != directories->end()) {
+    return it->second;
+  }
+  const std::string path =
+      TestEnvironment::temporaryPath(absl::StrCat("cache_index_speed_test_", entries, "/"));
+  TestEnvironment::createPath(path);
+  for (uint64_t i = 0; i < entries; i++) {
+    // Spread the names like real key hashes.
+    std::ofstream file(absl::StrCat(path, "cache-", (i + 1) * 0x9E3779B97F4A7C15));
+    file << "cache entry";
+  }
+  return directories->emplace(entries, path).first->second;
+}
+
+bool skip(benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return true;
+  }
+  return false;
+}
+
+// Scans the cache directory into the index, returning the number of entries found.
+uint64_t scanDirectory(const std::string& path, CacheIndex* index) {
+  uint64_t count = 0;
+  for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(path)) {
+    if (entry.type_ != Filesystem::FileType::Regular || !absl::StartsWith(entry.name_, "cache-")) {
+      continue;
+    }
+    count++;
+    const absl::optional<uint64_t> key_hash = CacheIndex::keyHashFromFilename(entry.name_);
+    if (index != nullptr && key_hash.has_value()) {
+      index->insert(key_hash.value(), entry.size_bytes_.value_or(0));
+    }
+  }
+  return count;
+}
+
+// Measures the directory scan performed at startup without an index.
+void bmStartupWithoutIndex(benchmark::State& state) {
+  if (skip(state)) {
+    return;
+  }
+  const std::string& path = cacheDirectory(state.range(0));
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    benchmark::DoNotOptimize(scanDirectory(path, nullptr));
+  }
+}
+BENCHMARK(bmStartupWithoutIndex)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the startup when the index was not closed cleanly, and must be rebuilt by a
+// directory scan.
+void bmStartupRebuildIndex(benchmark::State& state) {
+  if (skip(state)) {
+    return;
+  }
+  const std::string& path = cacheDirectory(state.range(0));
+  const std::string index_path = absl::StrCat(path, CacheIndex::filename());
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    TestEnvironment::removePath(index_path);
+    state.ResumeTiming();
+    auto index = CacheIndex::create(index_path, CacheIndex::capacityForEntries(state.range(0)));
+    benchmark::DoNotOptimize(scanDirectory(path, index.get()));
+  }
+  TestEnvironment::removePath(index_path);
+}
+BENCHMARK(bmStartupRebuildIndex)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the startup when the index was closed cleanly, so it can be used as is.
+void bmStartupCleanIndex(benchmark::State& state) {
+  if (skip(state)) {
+    return;
+  }
+  const std::string& path = cacheDirectory(state.range(0));
+  const std::string index_path = absl::StrCat(path, CacheIndex::filename());
+  const uint64_t capacity = CacheIndex::capacityForEntries(state.range(0));
+  TestEnvironment::removePath(index_path);
+  scanDirectory(path, CacheIndex::create(index_path, capacity).get());
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto index = CacheIndex::create(index_path, capacity);
+    if (!index->loadedClean()) {
+      state.SkipWithError("index was not closed cleanly");
+      break;
+    }
+    benchmark::DoNotOptimize(index->entryCount());
+    benchmark::DoNotOptimize(index->totalBytes());
+  }
+  TestEnvironment::removePath(index_path);
+}
+BENCHMARK(bmStartupCleanIndex)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
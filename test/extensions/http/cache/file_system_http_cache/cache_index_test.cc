@@ -0,0 +1,195 @@
+#include <string>
+
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+class CacheIndexTest : public ::testing::Test {
+protected:
+  CacheIndexTest()
+      : path_(TestEnvironment::temporaryPath(
+            absl::StrCat("cache_index_test_", ::testing::UnitTest::GetInstance()
+                                                  ->current_test_info()
+                                                  ->name()))) {
+    TestEnvironment::removePath(path_);
+  }
+  ~CacheIndexTest() override { TestEnvironment::removePath(path_); }
+
+  std::unique_ptr<CacheIndex> open(uint64_t capacity = MinimalCapacity) {
+    auto index = CacheIndex::create(path_, capacity);
+    EXPECT_NE(index, nullptr);
+    return index;
+  }
+
+  static constexpr uint64_t MinimalCapacity = 1024;
+  const std::string path_;
+};
+
+namespace {
+
+TEST_F(CacheIndexTest, InsertFindRemove) {
+  auto index = open();
+  EXPECT_FALSE(index->loadedClean());
+  EXPECT_FALSE(index->find(12345).has_value());
+  EXPECT_TRUE(index->insert(12345, 100));
+  EXPECT_TRUE(index->insert(67890, 200));
+  EXPECT_EQ(index->find(12345), 100);
+  EXPECT_EQ(index->find(67890), 200);
+  EXPECT_EQ(index->entryCount(), 2);
+  EXPECT_EQ(index->totalBytes(), 300);
+  // Inserting an existing key updates its size.
+  EXPECT_TRUE(index->insert(12345, 50));
+  EXPECT_EQ(index->find(12345), 50);
+  EXPECT_EQ(index->entryCount(), 2);
+  EXPECT_EQ(index->totalBytes(), 250);
+  EXPECT_EQ(index->remove(12345), 50);
+  EXPECT_FALSE(index->find(12345).has_value());
+  EXPECT_FALSE(index->remove(12345).has_value());
+  EXPECT_EQ(index->entryCount(), 1);
+  EXPECT_EQ(index->totalBytes(), 200);
+}
+
+TEST_F(CacheIndexTest, ReservedHashesAreUsable) {
+  auto index = open();
+  EXPECT_TRUE(index->insert(0, 10));
+  EXPECT_TRUE(index->insert(1, 20));
+  EXPECT_EQ(index->find(0), 10);
+  EXPECT_EQ(index->find(1), 20);
+  EXPECT_EQ(index->remove(0), 10);
+  EXPECT_FALSE(index->find(0).has_value());
+  EXPECT_EQ(index->find(1), 20);
+}
+
+TEST_F(CacheIndexTest, CollidingKeysAreFoundAfterRemoval) {
+  auto index = open();
+  // Keys which are equal modulo the capacity probe the same slots.
+  EXPECT_TRUE(index->insert(5, 1));
+  EXPECT_TRUE(index->insert(5 + 1024, 2));
+  EXPECT_TRUE(index->insert(5 + 2048, 3));
+  EXPECT_EQ(index->remove(5 + 1024), 2);
+  EXPECT_EQ(index->find(5), 1);
+  EXPECT_EQ(index->find(5 + 2048), 3);
+  // The tombstone is reused.
+  EXPECT_TRUE(index->insert(5 + 3072, 4));
+  EXPECT_EQ(index->find(5 + 3072), 4);
+  EXPECT_EQ(index->entryCount(), 3);
+}
+
+TEST_F(CacheIndexTest, PersistsWhenClosedCleanly) {
+  {
+    auto index = open();
+    EXPECT_TRUE(index->insert(12345, 100));
+    EXPECT_TRUE(index->insert(67890, 200));
+  }
+  auto index = open();
+  EXPECT_TRUE(index->loadedClean());
+  EXPECT_EQ(index->find(12345), 100);
+  EXPECT_EQ(index->find(67890), 200);
+  EXPECT_EQ(index->entryCount(), 2);
+  EXPECT_EQ(index->totalBytes(), 300);
+}
+
+TEST_F(CacheIndexTest, ClearedIfNotClosedCleanly) {
+  auto index = open();
+  EXPECT_TRUE(index->insert(12345, 100));
+  // A second user of the index while the first is still open, as after a crash, can't
+  // trust its contents.
+  auto second_index = open();
+  EXPECT_FALSE(second_index->loadedClean());
+  EXPECT_FALSE(second_index->find(12345).has_value());
+  EXPECT_EQ(second_index->entryCount(), 0);
+}
+
+TEST_F(CacheIndexTest, ClearedIfCapacityChanges) {
+  {
+    auto index = open(1024);
+    EXPECT_TRUE(index->insert(12345, 100));
+  }
+  auto index = open(2048);
+  EXPECT_FALSE(index->loadedClean());
+  EXPECT_EQ(index->capacity(), 2048);
+  EXPECT_FALSE(index->find(12345).has_value());
+}
+
+TEST_F(CacheIndexTest, OverflowsWhenFull) {
+  {
+    auto index = open(MinimalCapacity);
+    for (uint64_t i = 0; i < MinimalCapacity / 4 * 3; i++) {
+      EXPECT_TRUE(index->insert(i * 7919, i));
+    }
+    EXPECT_FALSE(index->overflowed());
+    EXPECT_FALSE(index->insert(99999999, 1));
+    EXPECT_TRUE(index->overflowed());
+  }
+  // An index that overflowed is not clean.
+  EXPECT_FALSE(open(MinimalCapacity)->loadedClean());
+}
+
+TEST_F(CacheIndexTest, TombstonesAreCompacted) {
+  auto index = open(MinimalCapacity);
+  // Churning through many more keys than fit in the table at once only works if the
+  // tombstones left by removed keys are reclaimed.
+  for (uint64_t i = 0; i < MinimalCapacity * 16; i++) {
+    EXPECT_TRUE(index->insert(i * 7919, 1));
+    if (i >= 8) {
+      EXPECT_EQ(index->remove((i - 8) * 7919), 1);
+    }
+  }
+  EXPECT_FALSE(index->overflowed());
+  EXPECT_EQ(index->entryCount(), 8);
+  for (uint64_t i = MinimalCapacity * 16 - 8; i < MinimalCapacity * 16; i++) {
+    EXPECT_EQ(index->find(i * 7919), 1);
+  }
+}
+
+TEST_F(CacheIndexTest, TombstonesDoNotFillTable) {
+  auto index = open(MinimalCapacity);
+  // Fill the table to just below its limit, leaving too few slots for the tombstones of the
+  // churned keys to reach the compaction threshold before the table is full.
+  const uint64_t live_entries = MinimalCapacity / 4 * 3 - 64;
+  for (uint64_t i = 0; i < live_entries; i++) {
+    EXPECT_TRUE(index->insert(i * 7919, 1));
+  }
+  for (uint64_t i = live_entries; i < MinimalCapacity * 16; i++) {
+    EXPECT_TRUE(index->insert(i * 7919, 2));
+    EXPECT_EQ(index->remove(i * 7919), 2);
+  }
+  EXPECT_FALSE(index->overflowed());
+  EXPECT_EQ(index->entryCount(), live_entries);
+  EXPECT_EQ(index->totalBytes(), live_entries);
+  for (uint64_t i = 0; i < live_entries; i++) {
+    EXPECT_EQ(index->find(i * 7919), 1);
+  }
+}
+
+TEST(CacheIndexStaticTest, CapacityForEntries) {
+  EXPECT_EQ(CacheIndex::capacityForEntries(1), 1024);
+  EXPECT_EQ(CacheIndex::capacityForEntries(512), 1024);
+  EXPECT_EQ(CacheIndex::capacityForEntries(513), 2048);
+  EXPECT_EQ(CacheIndex::capacityForEntries(1000000), 1 << 21);
+  EXPECT_EQ(CacheIndex::capacityForEntries(absl::nullopt), 1 << 21);
+}
+
+TEST(CacheIndexStaticTest, KeyHashFromFilename) {
+  EXPECT_EQ(CacheIndex::keyHashFromFilename("cache-12345"), 12345);
+  EXPECT_EQ(CacheIndex::keyHashFromFilename("cache-18446744073709551615"),
+            18446744073709551615ULL);
+  EXPECT_FALSE(CacheIndex::keyHashFromFilename("cache-a").has_value());
+  EXPECT_FALSE(CacheIndex::keyHashFromFilename("other-12345").has_value());
+  EXPECT_FALSE(CacheIndex::keyHashFromFilename(CacheIndex::filename()).has_value());
+}
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
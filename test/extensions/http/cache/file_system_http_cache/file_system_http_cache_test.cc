@@ -80,6 +80,7 @@ public:
     ConfigProto cfg;
     MessageUtil::unpackTo(cache_config.typed_config(), cfg);
     cfg.set_cache_path(cache_path_);
+    cfg.set_persistent_index(persistent_index_);
     return cfg;
   }
 
@@ -92,7 +93,7 @@ public:
 protected:
   void deleteCacheFiles(std::string path) {
     for (const auto& it : ::Envoy::Filesystem::Directory(path)) {
-      if (absl::StartsWith(it.name_, "cache-")) {
+      if (absl::StartsWith(it.name_, "cache-") || it.name_ == CacheIndex::filename()) {
         env_.removePath(absl::StrCat(path, it.name_));
       }
     }
@@ -100,6 +101,7 @@ protected:
 
   ::Envoy::TestEnvironment env_;
   std::string cache_path_;
+  bool persistent_index_ = false;
   NiceMock<Server::Configuration::MockFactoryContext> context_;
   std::shared_ptr<FileSystemHttpCache> cache_;
   LogLevelSetter log_level_ = LogLevelSetter(spdlog::level::debug);
@@ -509,6 +511,48 @@ TEST_F(FileSystemHttpCacheTestWithMockFiles, FailedOpenForReadReturnsMiss) {
   EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Unusable);
 }
 
+class FileSystemHttpCacheTestWithMockFilesAndIndex : public FileSystemHttpCacheTestWithMockFiles {
+public:
+  void SetUp() override {
+    persistent_index_ = true;
+    initCache();
+    // Wait for the initial scan of the cache directory, which makes the index ready.
+    waitForEvictionThreadIdle();
+  }
+};
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndIndex, LookupOfKeyMissingFromIndexSkipsFileOpen) {
+  auto lookup = testLookupContext();
+  absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
+  LookupResult result;
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _)).Times(0);
+  lookup->getHeaders([&](LookupResult&& r) { result = std::move(r); });
+  EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Unusable);
+  // File handle didn't get used but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close([](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndIndex, LookupOfIndexedKeyReadsFile) {
+  cache_->addToIndex(key_, 12345);
+  EXPECT_TRUE(cache_->mayContain(key_));
+  EXPECT_NE(testLookupResult().cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_OK(mock_async_file_handle_->close([](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndIndex, FileNotFoundRemovesKeyFromIndex) {
+  cache_->addToIndex(key_, 12345);
+  auto lookup = testLookupContext();
+  absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
+  LookupResult result;
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _));
+  lookup->getHeaders([&](LookupResult&& r) { result = std::move(r); });
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>(absl::NotFoundError("Intentionally failed to open file")));
+  EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_FALSE(cache_->mayContain(key_));
+  EXPECT_OK(mock_async_file_handle_->close([](absl::Status) {}));
+}
+
 TEST_F(FileSystemHttpCacheTestWithMockFiles, FailedReadOfHeaderBlockInvalidatesTheCacheEntry) {
   // Fake-add two files of size 12345, so we can validate the stats decrease of removing a file.
   cache_->trackFileAdded(12345);
@@ -1251,6 +1295,19 @@ public:
   bool validationEnabled() const override { return true; }
 };
 
+// The standard cache tests, with lookups of missing entries answered by the cache index.
+class FileSystemHttpCacheWithIndexTestDelegate : public HttpCacheTestDelegate,
+                                                 public FileSystemCacheTestContext {
+public:
+  FileSystemHttpCacheWithIndexTestDelegate() {
+    persistent_index_ = true;
+    initCache();
+    waitForEvictionThreadIdle();
+  }
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+};
+
 // For the standard cache tests from http_cache_implementation_test_common.cc
 INSTANTIATE_TEST_SUITE_P(FileSystemHttpCacheTest, HttpCacheImplementationTest,
                          testing::Values(std::make_unique<FileSystemHttpCacheTestDelegate>),
@@ -1258,6 +1315,13 @@ INSTANTIATE_TEST_SUITE_P(FileSystemHttpCacheTest, HttpCacheImplementationTest,
                            return "FileSystemHttpCache";
                          });
 
+INSTANTIATE_TEST_SUITE_P(
+    FileSystemHttpCacheWithIndexTest, HttpCacheImplementationTest,
+    testing::Values(std::make_unique<FileSystemHttpCacheWithIndexTestDelegate>),
+    [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+      return "FileSystemHttpCacheWithIndex";
+    });
+
 TEST(Registration, GetCacheFromFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.extensions.http.cache.file_system_http_cache.v3.FileSystemHttpCacheConfig");
@@ -8,6 +8,7 @@
 
 #include "test/extensions/filters/http/cache/common.h"
 #include "test/extensions/filters/http/cache/http_cache_implementation_test_common.h"
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
@@ -35,6 +36,157 @@ INSTANTIATE_TEST_SUITE_P(SimpleHttpCacheTest, HttpCacheImplementationTest,
                            return "SimpleHttpCache";
                          });
 
+SimpleHttpCacheConfig boundedConfig(uint64_t max_cache_size_bytes) {
+  SimpleHttpCacheConfig config;
+  config.mutable_max_cache_size_bytes()->set_value(max_cache_size_bytes);
+  return config;
+}
+
+// A size limit large enough for every implementation test to fit.
+class BoundedSimpleHttpCacheTestDelegate : public HttpCacheTestDelegate {
+public:
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+
+private:
+  std::shared_ptr<SimpleHttpCache> cache_ =
+      std::make_shared<SimpleHttpCache>(boundedConfig(1024 * 1024));
+};
+
+INSTANTIATE_TEST_SUITE_P(BoundedSimpleHttpCacheTest, HttpCacheImplementationTest,
+                         testing::Values(std::make_unique<BoundedSimpleHttpCacheTestDelegate>),
+                         [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+                           return "BoundedSimpleHttpCache";
+                         });
+
+class SimpleHttpCacheEvictionTest : public testing::Test {
+protected:
+  // Each of the 16 shards gets a budget of 1000 bytes.
+  SimpleHttpCacheEvictionTest()
+      : cache_(boundedConfig(16 * 1000)), vary_allow_list_(allow_list_) {}
+
+  LookupRequest request(absl::string_view path) {
+    Http::TestRequestHeaderMapImpl request_headers{
+        {":path", std::string(path)}, {":scheme", "https"}, {":authority", "example.com"}};
+    return {request_headers, time_system_.systemTime(), vary_allow_list_};
+  }
+
+  bool insert(const LookupRequest& request, uint64_t body_size) {
+    return cache_.insert(request.key(), stableHashKey(request.key()),
+                         Http::createHeaderMap<Http::ResponseHeaderMapImpl>(
+                             {{Http::Headers::get().Status, "200"}}),
+                         {time_system_.systemTime()},
+                         std::make_shared<const std::string>(body_size, 'x'), nullptr);
+  }
+
+  bool cached(const LookupRequest& request) {
+    return cache_.lookup(request, stableHashKey(request.key())).response_headers_ != nullptr;
+  }
+
+  // Returns distinct paths whose keys fall in the same shard.
+  std::vector<std::string> pathsInOneShard(size_t count) {
+    std::vector<std::string> paths;
+    absl::optional<uint64_t> shard;
+    for (int i = 0; paths.size() < count; i++) {
+      const std::string path = absl::StrCat("/", i);
+      const uint64_t candidate_shard = stableHashKey(request(path).key()) % 16;
+      if (!shard.has_value()) {
+        shard = candidate_shard;
+      }
+      if (candidate_shard == shard.value()) {
+        paths.push_back(path);
+      }
+    }
+    return paths;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  testing::NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  SimpleHttpCache cache_;
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> allow_list_;
+  VaryAllowList vary_allow_list_;
+};
+
+TEST_F(SimpleHttpCacheEvictionTest, StaysWithinSizeLimit) {
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(insert(request(absl::StrCat("/", i)), 300));
+    EXPECT_LE(cache_.sizeBytes(), 16 * 1000);
+  }
+  // At most three 300 byte bodies fit in each shard.
+  EXPECT_LE(cache_.entryCount(), 16 * 3);
+  EXPECT_GT(cache_.entryCount(), 0);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, EvictsLeastRecentlyUsed) {
+  const std::vector<std::string> paths = pathsInOneShard(3);
+  EXPECT_TRUE(insert(request(paths[0]), 400));
+  EXPECT_TRUE(insert(request(paths[1]), 400));
+  // Reading the first entry gives it a second chance, so the second entry is evicted.
+  EXPECT_TRUE(cached(request(paths[0])));
+  EXPECT_TRUE(insert(request(paths[2]), 400));
+  EXPECT_TRUE(cached(request(paths[0])));
+  EXPECT_FALSE(cached(request(paths[1])));
+  EXPECT_TRUE(cached(request(paths[2])));
+  EXPECT_EQ(cache_.entryCount(), 2);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, StoresIntoShardOfReferencedEntries) {
+  const std::vector<std::string> paths = pathsInOneShard(3);
+  EXPECT_TRUE(insert(request(paths[0]), 400));
+  EXPECT_TRUE(insert(request(paths[1]), 400));
+  EXPECT_TRUE(cached(request(paths[0])));
+  EXPECT_TRUE(cached(request(paths[1])));
+  // Every entry in the shard has been referenced, so one of them makes room for the new entry
+  // rather than the new entry itself.
+  EXPECT_TRUE(insert(request(paths[2]), 400));
+  EXPECT_TRUE(cached(request(paths[2])));
+  EXPECT_FALSE(cached(request(paths[0])));
+  EXPECT_TRUE(cached(request(paths[1])));
+  EXPECT_EQ(cache_.entryCount(), 2);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, ReplacingEntryUpdatesSize) {
+  LookupRequest first = request("/");
+  EXPECT_TRUE(insert(first, 400));
+  const uint64_t size_bytes = cache_.sizeBytes();
+  EXPECT_TRUE(insert(first, 200));
+  EXPECT_EQ(cache_.sizeBytes(), size_bytes - 200);
+  EXPECT_EQ(cache_.entryCount(), 1);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, RejectsEntryLargerThanShard) {
+  LookupRequest large = request("/large");
+  EXPECT_FALSE(insert(large, 1000));
+  EXPECT_FALSE(cached(large));
+  EXPECT_EQ(cache_.sizeBytes(), 0);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, LookupsShareBody) {
+  LookupRequest first = request("/");
+  EXPECT_TRUE(insert(first, 400));
+  const uint64_t key_hash = stableHashKey(first.key());
+  EXPECT_EQ(cache_.lookup(first, key_hash).body_, cache_.lookup(first, key_hash).body_);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, BodyOutlivesEviction) {
+  const std::vector<std::string> paths = pathsInOneShard(3);
+  EXPECT_TRUE(insert(request(paths[0]), 400));
+  LookupContextPtr lookup_context = cache_.makeLookupContext(request(paths[0]), decoder_callbacks_);
+  lookup_context->getHeaders([](LookupResult&& result) { EXPECT_NE(result.headers_, nullptr); });
+  Buffer::InstancePtr body;
+  lookup_context->getBody({0, 400},
+                          [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+  // Replace the entry being read, then fill the shard so that it is evicted.
+  EXPECT_TRUE(insert(request(paths[0]), 300));
+  EXPECT_TRUE(insert(request(paths[1]), 400));
+  EXPECT_TRUE(insert(request(paths[2]), 400));
+  EXPECT_FALSE(cached(request(paths[0])));
+  lookup_context->onDestroy();
+  lookup_context.reset();
+  ASSERT_NE(body, nullptr);
+  EXPECT_EQ(body->toString(), std::string(400, 'x'));
+}
+
 TEST(Registration, GetFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig");
@@ -46,6 +198,21 @@ TEST(Registration, GetFactory) {
             "envoy.extensions.http.cache.simple");
 }
 
+TEST(Registration, MismatchedConfigThrows) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  testing::NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  envoy::extensions::filters::http::cache::v3::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(boundedConfig(1000));
+  std::shared_ptr<HttpCache> cache = factory->getCache(config, factory_context);
+  // The cache is shared, so a second config must match the first.
+  EXPECT_EQ(factory->getCache(config, factory_context), cache);
+  config.mutable_typed_config()->PackFrom(boundedConfig(2000));
+  EXPECT_THROW_WITH_REGEX(factory->getCache(config, factory_context), EnvoyException,
+                          "mismatched SimpleHttpCacheConfig");
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
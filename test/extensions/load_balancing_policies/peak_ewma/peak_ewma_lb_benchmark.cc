@@ -0,0 +1,85 @@
+// Usage: bazel run //test/extensions/load_balancing_policies/peak_ewma:peak_ewma_lb_benchmark
+
+#include <chrono>
+#include <memory>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/event/real_time_system.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+namespace {
+
+class PeakEwmaTester : public Event::TestUsingSimulatedTime {
+public:
+  PeakEwmaTester(uint64_t num_hosts) {
+    Upstream::HostVector hosts;
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(Upstream::makeTestHost(
+          info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256), simTime()));
+    }
+    Upstream::HostVectorConstSharedPtr updated_hosts =
+        std::make_shared<Upstream::HostVector>(hosts);
+    Upstream::HostsPerLocalityConstSharedPtr hosts_per_locality =
+        Upstream::makeHostsPerLocality({hosts});
+    priority_set_.updateHosts(
+        0, Upstream::HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {}, hosts, {},
+        absl::nullopt);
+
+    thread_aware_lb_ = std::make_unique<PeakEwmaThreadAwareLoadBalancer>(
+        *info_, priority_set_, runtime_, random_, simTime(), PeakEwmaLbProto());
+    thread_aware_lb_->initialize();
+    lb_ = thread_aware_lb_->factory()->create({priority_set_, nullptr});
+
+    // Give the hosts different round trip times.
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts[i]->lbPolicyData()->onResponseTime(std::chrono::microseconds(1000 + i));
+    }
+  }
+
+  Upstream::PrioritySetImpl priority_set_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  std::shared_ptr<Upstream::MockClusterInfo> info_{new NiceMock<Upstream::MockClusterInfo>()};
+  Upstream::ThreadAwareLoadBalancerPtr thread_aware_lb_;
+  Upstream::LoadBalancerPtr lb_;
+};
+
+// Measures picking a host, which reads the shared state of choice_count hosts.
+void bmChooseHost(::benchmark::State& state) {
+  PeakEwmaTester tester(state.range(0));
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(bmChooseHost)->Arg(10)->Arg(100)->Arg(1000);
+
+// Measures recording response times for a single host from concurrent workers, which all update
+// the same lock free average.
+void bmOnResponseTime(::benchmark::State& state) {
+  static Event::RealTimeSystem* time_system = new Event::RealTimeSystem();
+  static PeakEwmaHostData* data = new PeakEwmaHostData(std::chrono::seconds(10), *time_system);
+  uint64_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    data->onResponseTime(std::chrono::microseconds(1000 + i++ % 100));
+  }
+}
+BENCHMARK(bmOnResponseTime)->Threads(1)->Threads(4)->Threads(16);
+
+} // namespace
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <list>
+#include <vector>
+
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/mocks/upstream/host_set.h"
+#include "test/mocks/upstream/priority_set.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_random_generator.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+namespace {
+
+class PeakEwmaHostDataTest : public Event::TestUsingSimulatedTime, public testing::Test {
+protected:
+  PeakEwmaHostData data_{std::chrono::seconds(10), simTime()};
+};
+
+TEST_F(PeakEwmaHostDataTest, NoResponseTime) { EXPECT_EQ(absl::nullopt, data_.ewma()); }
+
+// The first response time, and higher ones, replace the average right away.
+TEST_F(PeakEwmaHostDataTest, Peak) {
+  data_.onResponseTime(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(10000, data_.ewma().value());
+
+  data_.onResponseTime(std::chrono::milliseconds(50));
+  EXPECT_DOUBLE_EQ(50000, data_.ewma().value());
+}
+
+// Lower response times bring the average down according to the time elapsed since the last one.
+TEST_F(PeakEwmaHostDataTest, Decay) {
+  data_.onResponseTime(std::chrono::milliseconds(50));
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+
+  // The average decays while no request completes.
+  EXPECT_DOUBLE_EQ(50000 * std::exp(-1), data_.ewma().value());
+
+  data_.onResponseTime(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(50000 * std::exp(-1) + 10000 * (1 - std::exp(-1)), data_.ewma().value());
+}
+
+class PeakEwmaLoadBalancerTest : public Event::TestUsingSimulatedTime, public testing::Test {
+protected:
+  void initialize() {
+    thread_aware_lb_ = std::make_unique<PeakEwmaThreadAwareLoadBalancer>(
+        *info_, priority_set_, runtime_, random_, simTime(), config_);
+    thread_aware_lb_->initialize();
+    lb_ = thread_aware_lb_->factory()->create({priority_set_, nullptr});
+  }
+
+  void addHosts(uint32_t count) {
+    Upstream::HostVector added;
+    for (uint32_t i = 0; i < count; ++i) {
+      added.push_back(Upstream::makeTestHost(
+          info_, fmt::format("tcp://127.0.0.1:{}", 80 + host_set_.hosts_.size()), simTime()));
+      host_set_.hosts_.push_back(added.back());
+    }
+    host_set_.healthy_hosts_ = host_set_.hosts_;
+    host_set_.runCallbacks(added, {});
+  }
+
+  PeakEwmaHostData& hostData(uint32_t index) {
+    return *static_cast<PeakEwmaHostData*>(host_set_.hosts_[index]->lbPolicyData());
+  }
+
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Upstream::MockPrioritySet> priority_set_;
+  Upstream::MockHostSet& host_set_ = *priority_set_.getMockHostSet(0);
+  std::shared_ptr<Upstream::MockClusterInfo> info_{new NiceMock<Upstream::MockClusterInfo>()};
+  PeakEwmaLbProto config_;
+  Upstream::ThreadAwareLoadBalancerPtr thread_aware_lb_;
+  Upstream::LoadBalancerPtr lb_;
+};
+
+TEST_F(PeakEwmaLoadBalancerTest, NoHosts) {
+  initialize();
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr));
+  EXPECT_EQ(nullptr, lb_->peekAnotherHost(nullptr));
+}
+
+// Host data is attached to the hosts present at initialization and to the hosts added later.
+TEST_F(PeakEwmaLoadBalancerTest, AttachesHostData) {
+  addHosts(2);
+  initialize();
+  EXPECT_NE(nullptr, host_set_.hosts_[0]->lbPolicyData());
+  EXPECT_NE(nullptr, host_set_.hosts_[1]->lbPolicyData());
+
+  addHosts(1);
+  EXPECT_NE(nullptr, host_set_.hosts_[2]->lbPolicyData());
+}
+
+// The host with the lowest round trip time multiplied by outstanding requests is picked.
+TEST_F(PeakEwmaLoadBalancerTest, PicksLowestCost) {
+  addHosts(2);
+  initialize();
+
+  hostData(0).onResponseTime(std::chrono::milliseconds(10));
+  hostData(1).onResponseTime(std::chrono::milliseconds(30));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(nullptr));
+
+  host_set_.hosts_[0]->load().outstanding_requests_ = 3;
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(nullptr));
+}
+
+// Hosts that did not complete any request yet use the default round trip time.
+TEST_F(PeakEwmaLoadBalancerTest, DefaultRtt) {
+  config_.mutable_default_rtt()->set_seconds(1);
+  addHosts(2);
+  initialize();
+
+  hostData(1).onResponseTime(std::chrono::milliseconds(500));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(nullptr));
+}
+
+// Simulates hosts with fixed round trip times, one of them much slower than the others, and
+// checks that the slow host gets much less than its even share of the requests.
+TEST_F(PeakEwmaLoadBalancerTest, SimulatedLatency) {
+  TestRandomGenerator test_random;
+  ON_CALL(random_, random()).WillByDefault(Invoke([&] { return test_random.random(); }));
+  const uint32_t num_hosts = 10;
+  addHosts(num_hosts);
+  initialize();
+
+  const auto rtt = [](uint32_t host_index) {
+    return std::chrono::milliseconds(host_index == 0 ? 50 : 5);
+  };
+  struct Request {
+    uint32_t host_index_;
+    MonotonicTime done_;
+  };
+  std::list<Request> requests;
+  std::vector<uint64_t> picks(num_hosts);
+  uint64_t total_picks = 0;
+
+  // Two requests per millisecond for 20 seconds.
+  for (uint32_t ms = 0; ms < 20000; ++ms) {
+    for (auto it = requests.begin(); it != requests.end();) {
+      if (it->done_ > simTime().monotonicTime()) {
+        ++it;
+        continue;
+      }
+      host_set_.hosts_[it->host_index_]->load().outstanding_requests_--;
+      hostData(it->host_index_).onResponseTime(rtt(it->host_index_));
+      it = requests.erase(it);
+    }
+    for (uint32_t i = 0; i < 2; ++i) {
+      Upstream::HostConstSharedPtr host = lb_->chooseHost(nullptr);
+      const uint32_t host_index =
+          std::find(host_set_.hosts_.begin(), host_set_.hosts_.end(), host) -
+          host_set_.hosts_.begin();
+      host->load().outstanding_requests_++;
+      requests.push_back({host_index, simTime().monotonicTime() + rtt(host_index)});
+      picks[host_index]++;
+      total_picks++;
+    }
+    simTime().advanceTimeWait(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_LT(picks[0], total_picks / num_hosts / 2);
+}
+
+} // namespace
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
@@ -84,6 +84,27 @@ TEST_F(OpenTelemetryGrpcTraceExporterTest, NoExportWithHighWatermark) {
   EXPECT_FALSE(exporter.log(request));
 }
 
+TEST_F(OpenTelemetryGrpcTraceExporterTest, HighWatermark) {
+  OpenTelemetryGrpcTraceExporter exporter(Grpc::RawAsyncClientPtr{async_client_});
+  // There is no stream to be above its watermark before the first export.
+  EXPECT_FALSE(exporter.isAboveWriteBufferHighWatermark());
+
+  expectStreamMessage(R"EOF(
+    resource_spans:
+      scope_spans:
+        - spans:
+          - name: "test"
+  )EOF");
+  opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest request;
+  opentelemetry::proto::trace::v1::Span span;
+  span.set_name("test");
+  *request.add_resource_spans()->add_scope_spans()->add_spans() = span;
+  EXPECT_TRUE(exporter.log(request));
+
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_TRUE(exporter.isAboveWriteBufferHighWatermark());
+}
+
 TEST_F(OpenTelemetryGrpcTraceExporterTest, ExportWithRemoteClose) {
   OpenTelemetryGrpcTraceExporter exporter(Grpc::RawAsyncClientPtr{async_client_});
   std::string request_yaml = R"EOF(
@@ -455,6 +455,146 @@ TEST_F(OpenTelemetryDriverTest, NoExportWithoutGrpcService) {
   EXPECT_EQ(0U, stats_.counter("tracing.opentelemetry.spans_sent").value());
 }
 
+TEST_F(OpenTelemetryDriverTest, ExportOTLPSpansInBatches) {
+  const std::string yaml_string = R"EOF(
+    grpc_service:
+      envoy_grpc:
+        cluster_name: fake-cluster
+      timeout: 0.250s
+    max_export_batch_size: 2
+    )EOF";
+  envoy::config::trace::v3::OpenTelemetryConfig opentelemetry_config;
+  TestUtility::loadFromYaml(yaml_string, opentelemetry_config);
+  setup(opentelemetry_config);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":authority", "test.com"}, {":path", "/"}, {":method", "GET"}};
+
+  // Flush after five spans, which are exported in batches of two, two and one spans.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.opentelemetry.min_flush_spans", 5U))
+      .Times(5)
+      .WillRepeatedly(Return(5));
+  std::vector<uint64_t> batch_sizes;
+  EXPECT_CALL(*mock_stream_ptr_, sendMessageRaw_(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&batch_sizes](Buffer::InstancePtr& request, bool) {
+        opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest request_proto;
+        ASSERT_TRUE(request_proto.ParseFromString(request->toString()));
+        batch_sizes.push_back(request_proto.resource_spans(0).scope_spans(0).spans_size());
+      }));
+  for (int i = 0; i < 5; i++) {
+    driver_
+        ->startSpan(mock_tracing_config_, request_headers, operation_name_,
+                    time_system_.systemTime(), {Tracing::Reason::Sampling, true})
+        ->finishSpan();
+  }
+  EXPECT_THAT(batch_sizes, testing::ElementsAre(2, 2, 1));
+  EXPECT_EQ(5U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+}
+
+TEST_F(OpenTelemetryDriverTest, DropSpansWhenQueueIsFull) {
+  const std::string yaml_string = R"EOF(
+    grpc_service:
+      envoy_grpc:
+        cluster_name: fake-cluster
+      timeout: 0.250s
+    max_queue_size: 2
+    )EOF";
+  envoy::config::trace::v3::OpenTelemetryConfig opentelemetry_config;
+  TestUtility::loadFromYaml(yaml_string, opentelemetry_config);
+  setup(opentelemetry_config);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":authority", "test.com"}, {":path", "/"}, {":method", "GET"}};
+
+  // The collector is not reading fast enough, so the spans stay buffered, and the spans finishing
+  // once the buffer is full are dropped without reaching the flush.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.opentelemetry.min_flush_spans", 5U))
+      .Times(2)
+      .WillRepeatedly(Return(1));
+  ON_CALL(*mock_stream_ptr_, isAboveWriteBufferHighWatermark()).WillByDefault(Return(true));
+  EXPECT_CALL(*mock_stream_ptr_, sendMessageRaw_(_, _)).Times(0);
+  for (int i = 0; i < 4; i++) {
+    driver_
+        ->startSpan(mock_tracing_config_, request_headers, operation_name_,
+                    time_system_.systemTime(), {Tracing::Reason::Sampling, true})
+        ->finishSpan();
+  }
+  EXPECT_EQ(0U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+  EXPECT_EQ(2U, stats_.counter("tracing.opentelemetry.spans_dropped").value());
+}
+
+TEST_F(OpenTelemetryDriverTest, RetrySpansWhenCollectorIsSlow) {
+  setupValidDriver();
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":authority", "test.com"}, {":path", "/"}, {":method", "GET"}};
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.opentelemetry.min_flush_spans", 5U))
+      .Times(2)
+      .WillRepeatedly(Return(1));
+  // The first span can't be exported while the collector is not reading fast enough.
+  EXPECT_CALL(*mock_stream_ptr_, isAboveWriteBufferHighWatermark())
+      .WillOnce(Return(true))
+      .WillRepeatedly(Return(false));
+  driver_
+      ->startSpan(mock_tracing_config_, request_headers, operation_name_,
+                  time_system_.systemTime(), {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  EXPECT_EQ(0U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+
+  // It is exported along with the next span once the collector caught up.
+  EXPECT_CALL(*mock_stream_ptr_, sendMessageRaw_(_, _))
+      .WillOnce(Invoke([](Buffer::InstancePtr& request, bool) {
+        opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest request_proto;
+        ASSERT_TRUE(request_proto.ParseFromString(request->toString()));
+        EXPECT_EQ(2, request_proto.resource_spans(0).scope_spans(0).spans_size());
+      }));
+  driver_
+      ->startSpan(mock_tracing_config_, request_headers, operation_name_,
+                  time_system_.systemTime(), {Tracing::Reason::Sampling, true})
+      ->finishSpan();
+  EXPECT_EQ(2U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+  EXPECT_EQ(0U, stats_.counter("tracing.opentelemetry.spans_dropped").value());
+}
+
+TEST_F(OpenTelemetryDriverTest, RetrySpansOnTimerWhenCollectorIsSlow) {
+  timer_ =
+      new NiceMock<Event::MockTimer>(&context_.server_factory_context_.thread_local_.dispatcher_);
+  ON_CALL(context_.server_factory_context_.thread_local_.dispatcher_, createTimer_(_))
+      .WillByDefault(Invoke([this](Event::TimerCb) { return timer_; }));
+  setupValidDriver();
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":authority", "test.com"}, {":path", "/"}, {":method", "GET"}};
+
+  // While the collector is not reading fast enough, the spans are buffered without being batched
+  // up for the exporter, once per finished span.
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.opentelemetry.min_flush_spans", 5U))
+      .Times(3)
+      .WillRepeatedly(Return(1));
+  EXPECT_CALL(*mock_stream_ptr_, isAboveWriteBufferHighWatermark())
+      .Times(3)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_stream_ptr_, sendMessageRaw_(_, _)).Times(0);
+  for (int i = 0; i < 3; i++) {
+    driver_
+        ->startSpan(mock_tracing_config_, request_headers, operation_name_,
+                    time_system_.systemTime(), {Tracing::Reason::Sampling, true})
+        ->finishSpan();
+  }
+  EXPECT_EQ(0U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+  testing::Mock::VerifyAndClearExpectations(mock_stream_ptr_.get());
+
+  // The timer exports them once the collector caught up.
+  EXPECT_CALL(*mock_stream_ptr_, isAboveWriteBufferHighWatermark())
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock_stream_ptr_, sendMessageRaw_(_, _))
+      .WillOnce(Invoke([](Buffer::InstancePtr& request, bool) {
+        opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest request_proto;
+        ASSERT_TRUE(request_proto.ParseFromString(request->toString()));
+        EXPECT_EQ(3, request_proto.resource_spans(0).scope_spans(0).spans_size());
+      }));
+  timer_->invokeCallback();
+  EXPECT_EQ(3U, stats_.counter("tracing.opentelemetry.spans_sent").value());
+}
+
 TEST_F(OpenTelemetryDriverTest, ExportSpanWithCustomServiceName) {
   const std::string yaml_string = R"EOF(
     grpc_service:
@@ -37,6 +37,9 @@ public:
                RecvMsgOutput& output));
   MOCK_METHOD(Api::IoCallUint64Result, recvmmsg,
               (RawSliceArrays & slices, uint32_t self_port, RecvMsgOutput& output));
+  MOCK_METHOD(Api::IoCallUint64Result, sendmmsg,
+              (const RawSliceArrays& slices, uint64_t gso_size, const Address::Ip* self_ip,
+               const Address::Instance& peer_address));
   MOCK_METHOD(Api::IoCallUint64Result, recv, (void* buffer, size_t length, int flags));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
   MOCK_METHOD(bool, supportsUdpGro, (), (const));
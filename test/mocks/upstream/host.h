@@ -77,6 +77,11 @@ public:
   MOCK_METHOD(void, setUnhealthy, (UnhealthyType));
 };
 
+class MockHostLbPolicyData : public HostLbPolicyData {
+public:
+  MOCK_METHOD(void, onResponseTime, (std::chrono::microseconds response_time));
+};
+
 class MockHostDescription : public HostDescription {
 public:
   MockHostDescription();
@@ -99,6 +104,9 @@ public:
   MOCK_METHOD(Network::UpstreamTransportSocketFactory&, transportSocketFactory, (), (const));
   MOCK_METHOD(HostStats&, stats, (), (const));
   MOCK_METHOD(LoadMetricStats&, loadMetricStats, (), (const));
+  MOCK_METHOD(HostLoad&, load, (), (const));
+  MOCK_METHOD(HostLbPolicyData*, lbPolicyData, (), (const));
+  MOCK_METHOD(void, setLbPolicyData, (HostLbPolicyDataPtr && lb_policy_data));
   MOCK_METHOD(const envoy::config::core::v3::Locality&, locality, (), (const));
   MOCK_METHOD(uint32_t, priority, (), (const));
   MOCK_METHOD(void, priority, (uint32_t));
@@ -122,6 +130,7 @@ public:
   testing::NiceMock<MockClusterInfo> cluster_;
   HostStats stats_;
   LoadMetricStatsImpl load_metric_stats_;
+  HostLoad load_;
   envoy::config::core::v3::Locality locality_;
   mutable Stats::TestUtil::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
@@ -209,6 +218,9 @@ public:
   MOCK_METHOD(void, setLastHcPassTime_, (MonotonicTime & last_hc_pass_time));
   MOCK_METHOD(HostStats&, stats, (), (const));
   MOCK_METHOD(LoadMetricStats&, loadMetricStats, (), (const));
+  MOCK_METHOD(HostLoad&, load, (), (const));
+  MOCK_METHOD(HostLbPolicyData*, lbPolicyData, (), (const));
+  MOCK_METHOD(void, setLbPolicyData, (HostLbPolicyDataPtr && lb_policy_data));
   MOCK_METHOD(uint32_t, weight, (), (const));
   MOCK_METHOD(void, weight, (uint32_t new_weight));
   MOCK_METHOD(bool, used, (), (const));
@@ -229,6 +241,7 @@ public:
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
   HostStats stats_;
   LoadMetricStatsImpl load_metric_stats_;
+  HostLoad load_;
   mutable Stats::TestUtil::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
   bool disable_active_health_check_ = false;
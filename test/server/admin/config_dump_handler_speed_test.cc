@@ -0,0 +1,140 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/admin/v3/config_dump.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/route/v3/route.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/matchers.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/server/admin/config_dump_handler.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Holds config tracker callbacks returning a synthetic config of num_resources dynamic clusters
+ * and as many route configurations.
+ */
+class ConfigDumpSpeedTest {
+public:
+  explicit ConfigDumpSpeedTest(uint64_t num_resources) {
+    auto clusters = std::make_shared<envoy::admin::v3::ClustersConfigDump>();
+    auto routes = std::make_shared<envoy::admin::v3::RoutesConfigDump>();
+    clusters->set_version_info("v1");
+    for (uint64_t i = 0; i < num_resources; ++i) {
+      const std::string name = absl::StrCat("cluster_", i);
+      envoy::config::cluster::v3::Cluster cluster;
+      cluster.set_name(name);
+      cluster.set_type(envoy::config::cluster::v3::Cluster::EDS);
+      cluster.mutable_connect_timeout()->set_seconds(5);
+      cluster.mutable_eds_cluster_config()->set_service_name(name);
+      cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_ads();
+      auto* dynamic_cluster = clusters->add_dynamic_active_clusters();
+      dynamic_cluster->set_version_info(absl::StrCat(i));
+      dynamic_cluster->mutable_last_updated()->set_seconds(i);
+      dynamic_cluster->mutable_cluster()->PackFrom(cluster);
+
+      envoy::config::route::v3::RouteConfiguration route_config;
+      route_config.set_name(absl::StrCat("route_", i));
+      auto* virtual_host = route_config.add_virtual_hosts();
+      virtual_host->set_name(absl::StrCat("host_", i));
+      virtual_host->add_domains(absl::StrCat("host_", i, ".example.com"));
+      auto* route = virtual_host->add_routes();
+      route->mutable_match()->set_prefix("/");
+      route->mutable_route()->set_cluster(name);
+      auto* dynamic_route_config = routes->add_dynamic_route_configs();
+      dynamic_route_config->set_version_info(absl::StrCat(i));
+      dynamic_route_config->mutable_route_config()->PackFrom(route_config);
+    }
+    callbacks_.emplace("clusters", [clusters](const Matchers::StringMatcher&) {
+      auto msg = std::make_unique<envoy::admin::v3::ClustersConfigDump>();
+      msg->CopyFrom(*clusters);
+      return msg;
+    });
+    callbacks_.emplace("routes", [routes](const Matchers::StringMatcher&) {
+      auto msg = std::make_unique<envoy::admin::v3::RoutesConfigDump>();
+      msg->CopyFrom(*routes);
+      return msg;
+    });
+  }
+
+  /**
+   * Builds the whole dump and its JSON, as ConfigDumpHandler::handlerConfigDump does.
+   */
+  uint64_t bufferedDump() {
+    Matchers::UniversalStringMatcher name_matcher;
+    envoy::admin::v3::ConfigDump dump;
+    for (const auto& [name, callback] : callbacks_) {
+      UNREFERENCED_PARAMETER(name);
+      dump.add_configs()->PackFrom(*callback(name_matcher));
+    }
+    MessageUtil::redact(dump);
+    Buffer::OwnedImpl data;
+    data.add(MessageUtil::getJsonStringFromMessageOrError(dump, true));
+    return data.length();
+  }
+
+  /**
+   * Streams the dump with a ConfigDumpRequest, draining each chunk as a connection would.
+   */
+  uint64_t streamedDump(uint32_t json_threads) {
+    ConfigDumpRequest request(callbacks_, absl::nullopt, absl::nullopt,
+                              std::make_unique<Matchers::UniversalStringMatcher>(),
+                              Thread::threadFactoryForTest(), json_threads);
+    auto response_headers = Http::ResponseHeaderMapImpl::create();
+    request.start(*response_headers);
+    Buffer::OwnedImpl data;
+    uint64_t count = 0;
+    bool more = true;
+    do {
+      more = request.nextChunk(data);
+      count += data.length();
+      data.drain(data.length());
+    } while (more);
+    return count;
+  }
+
+private:
+  ConfigTracker::CbsMap callbacks_;
+};
+
+} // namespace Server
+} // namespace Envoy
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_BufferedConfigDump(benchmark::State& state) {
+  const uint64_t num_resources = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_resources > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Server::ConfigDumpSpeedTest test(num_resources);
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(test.bufferedDump());
+  }
+}
+BENCHMARK(BM_BufferedConfigDump)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StreamedConfigDump(benchmark::State& state) {
+  const uint64_t num_resources = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_resources > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Server::ConfigDumpSpeedTest test(num_resources);
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(test.streamedDump(state.range(1)));
+  }
+}
+BENCHMARK(BM_StreamedConfigDump)
+    ->ArgsProduct({{1000, 100000}, {1, 4}})
+    ->Unit(benchmark::kMillisecond);
@@ -1,5 +1,6 @@
 #include "test/integration/filters/test_listener_filter.pb.h"
 #include "test/server/admin/admin_instance.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 using testing::HasSubstr;
 using testing::Return;
@@ -858,5 +859,136 @@ TEST_P(AdminInstanceTest, ConfigDumpEcdsByResourceAndMask) {
   EXPECT_EQ(expected_json, output);
 }
 
+ProtobufTypes::MessagePtr testDumpManyListenersConfig(const Matchers::StringMatcher&) {
+  auto msg = std::make_unique<envoy::admin::v3::ListenersConfigDump>();
+  msg->set_version_info("v1");
+  for (int i = 0; i < 2500; ++i) {
+    auto* dyn_listener = msg->add_dynamic_listeners();
+    dyn_listener->set_name(absl::StrCat("listener_", i));
+    dyn_listener->mutable_active_state()->set_version_info(absl::StrCat(i));
+  }
+  return msg;
+}
+
+class ConfigDumpStreamTest : public AdminInstanceTest {
+public:
+  ConfigDumpStreamTest() {
+    ON_CALL(server_.api_, threadFactory()).WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+  }
+
+  // Checks that the streamed dump for path_and_query has the same status and content as the
+  // buffered one.
+  void expectStreamMatchesBuffered(absl::string_view path_and_query) {
+    Buffer::OwnedImpl buffered;
+    Http::TestResponseHeaderMapImpl buffered_headers;
+    const Http::Code buffered_code = getCallback(path_and_query, buffered_headers, buffered);
+    Buffer::OwnedImpl streamed;
+    Http::TestResponseHeaderMapImpl streamed_headers;
+    const std::string stream_path =
+        absl::StrCat(path_and_query, absl::StrContains(path_and_query, "?") ? "&" : "?", "stream");
+    EXPECT_EQ(buffered_code, getCallback(stream_path, streamed_headers, streamed));
+    EXPECT_EQ(buffered_headers.getContentTypeValue(), streamed_headers.getContentTypeValue());
+    if (buffered_code != Http::Code::OK) {
+      EXPECT_EQ(buffered.toString(), streamed.toString());
+      return;
+    }
+    envoy::admin::v3::ConfigDump buffered_dump;
+    TestUtility::loadFromJson(buffered.toString(), buffered_dump);
+    envoy::admin::v3::ConfigDump streamed_dump;
+    TestUtility::loadFromJson(streamed.toString(), streamed_dump);
+    EXPECT_TRUE(TestUtility::protoEqual(buffered_dump, streamed_dump, true));
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, ConfigDumpStreamTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+TEST_P(ConfigDumpStreamTest, Empty) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?stream", header_map, response));
+  EXPECT_EQ("{\"configs\":[]}\n", response.toString());
+}
+
+TEST_P(ConfigDumpStreamTest, Configs) {
+  auto bootstrap = admin_.getConfigTracker().add("bootstrap", [](const Matchers::StringMatcher&) {
+    auto msg = std::make_unique<ProtobufWkt::StringValue>();
+    msg->set_value("bar");
+    return msg;
+  });
+  auto clusters = admin_.getConfigTracker().add("clusters", testDumpClustersConfig);
+  auto ecds = admin_.getConfigTracker().add("ecds", testDumpEcdsConfig);
+  auto listeners = admin_.getConfigTracker().add("listeners", testDumpManyListenersConfig);
+
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?stream", header_map, response));
+  EXPECT_THAT(response.toString(),
+              testing::StartsWith(R"EOF({"configs":[{"@type":"type.googleapis.com/)EOF"
+                                  R"EOF(google.protobuf.StringValue","value":"bar"},)EOF"));
+
+  expectStreamMatchesBuffered("/config_dump");
+  expectStreamMatchesBuffered("/config_dump?mask=version_info");
+  expectStreamMatchesBuffered("/config_dump?mask=static_clusters");
+  expectStreamMatchesBuffered("/config_dump?name_regex=listener_1.*");
+}
+
+TEST_P(ConfigDumpStreamTest, Resources) {
+  auto clusters = admin_.getConfigTracker().add("clusters", testDumpClustersConfig);
+  auto listeners = admin_.getConfigTracker().add("listeners", testDumpManyListenersConfig);
+
+  expectStreamMatchesBuffered("/config_dump?resource=dynamic_active_clusters");
+  expectStreamMatchesBuffered("/config_dump?resource=dynamic_listeners");
+  expectStreamMatchesBuffered("/config_dump?resource=dynamic_listeners&mask=name");
+  expectStreamMatchesBuffered("/config_dump?resource=dynamic_active_clusters&mask="
+                              "cluster.name,version_info,cluster.http2_protocol_options");
+  expectStreamMatchesBuffered("/config_dump?resource=static_listeners");
+}
+
+TEST_P(ConfigDumpStreamTest, Errors) {
+  auto clusters = admin_.getConfigTracker().add("clusters", testDumpClustersConfig);
+  auto bootstrap = admin_.getConfigTracker().add("bootstrap", [](const Matchers::StringMatcher&) {
+    auto msg = std::make_unique<envoy::admin::v3::BootstrapConfigDump>();
+    msg->mutable_bootstrap()->mutable_node()->add_extensions()->set_name("ext1");
+    return msg;
+  });
+
+  expectStreamMatchesBuffered("/config_dump?resource=foo");
+  expectStreamMatchesBuffered("/config_dump?resource=version_info");
+  expectStreamMatchesBuffered("/config_dump?resource=static_clusters&mask=bad");
+  expectStreamMatchesBuffered("/config_dump?mask=bootstrap.node.extensions.name");
+
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/config_dump?stream&name_regex=[", header_map, response));
+}
+
+// Counts the threads created through it, which are created by the test thread factory.
+class CountingThreadFactory : public Thread::ThreadFactory {
+public:
+  Thread::ThreadPtr createThread(std::function<void()> thread_routine,
+                                 Thread::OptionsOptConstRef options) override {
+    ++threads_created_;
+    return Thread::threadFactoryForTest().createThread(std::move(thread_routine), options);
+  }
+  Thread::ThreadId currentThreadId() override {
+    return Thread::threadFactoryForTest().currentThreadId();
+  }
+
+  uint32_t threads_created_{0};
+};
+
+TEST_P(ConfigDumpStreamTest, HelperThreadsCreatedOncePerRequest) {
+  CountingThreadFactory thread_factory;
+  ON_CALL(server_.api_, threadFactory()).WillByDefault(ReturnRef(thread_factory));
+  auto listeners = admin_.getConfigTracker().add("listeners", testDumpManyListenersConfig);
+
+  // The 2500 listeners are converted in three batches, each split between all the threads.
+  expectStreamMatchesBuffered("/config_dump?resource=dynamic_listeners");
+  EXPECT_EQ(ConfigDumpHandler::StreamJsonThreads - 1, thread_factory.threads_created_);
+}
+
 } // namespace Server
 } // namespace Envoy
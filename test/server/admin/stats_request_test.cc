@@ -1,7 +1,9 @@
 #include <memory>
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/custom_stat_namespaces_impl.h"
 #include "source/common/stats/thread_local_store.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_request.h"
 
 #include "test/mocks/event/mocks.h"
@@ -39,7 +41,7 @@ protected:
   }
 
   // Executes a request, counting the chunks that were generated.
-  uint32_t iterateChunks(StatsRequest& request, bool drain = true,
+  uint32_t iterateChunks(Admin::Request& request, bool drain = true,
                          Http::Code expect_code = Http::Code::OK) {
     Http::TestResponseHeaderMapImpl response_headers;
     Http::Code code = request.start(response_headers);
@@ -64,7 +66,7 @@ protected:
   }
 
   // Executes a request, returning the rendered buffer as a string.
-  std::string response(StatsRequest& request) {
+  std::string response(Admin::Request& request) {
     Http::TestResponseHeaderMapImpl response_headers;
     Http::Code code = request.start(response_headers);
     EXPECT_EQ(Http::Code::OK, code);
@@ -153,15 +155,85 @@ TEST_F(StatsRequestTest, OneStatJson) {
 }
 
 TEST_F(StatsRequestTest, OneStatPrometheus) {
-  // Currently the rendering infrastructure does not support Prometheus -- that
-  // gets rendered using a different code-path. This will be fixed at some
-  // point, to make Prometheus consume less resource, and when that occurs this
-  // test can exercise that.
+  // Prometheus needs its stats grouped by tag-extracted name, so it is rendered
+  // by PrometheusStatsRequest rather than StatsRequest.
   store_.rootScope()->counterFromStatName(makeStatName("foo"));
   EXPECT_ENVOY_BUG(iterateChunks(*makeRequest(false, StatsFormat::Prometheus, StatsType::All), true,
                                  Http::Code::BadRequest),
                    "reached Prometheus case in switch unexpectedly");
 }
 
+class PrometheusStatsRequestTest : public StatsRequestTest {
+protected:
+  // Adds one stat of each type for the cluster, tagged with its name, so that the stats of all
+  // the clusters share their tag-extracted names.
+  void addClusterStats(absl::string_view cluster) {
+    const Stats::StatNameTagVector tags{
+        {makeStatName("envoy.cluster_name"), makeStatName(cluster)}};
+    Stats::Scope& scope = *store_.rootScope();
+    scope.counterFromStatNameWithTags(makeStatName("cluster.rq"), tags).add(3);
+    scope
+        .gaugeFromStatNameWithTags(makeStatName("cluster.active"), tags,
+                                   Stats::Gauge::ImportMode::Accumulate)
+        .set(2);
+    scope.textReadoutFromStatNameWithTags(makeStatName("cluster.version"), tags).set("v1");
+    scope.histogramFromStatNameWithTags(makeStatName("cluster.time"), tags,
+                                        Stats::Histogram::Unit::Milliseconds);
+  }
+
+  std::unique_ptr<PrometheusStatsRequest> makePrometheusRequest(const StatsParams& params) {
+    return std::make_unique<PrometheusStatsRequest>(store_, params, custom_namespaces_);
+  }
+
+  std::string bufferedResponse(const StatsParams& params) {
+    Buffer::OwnedImpl data;
+    PrometheusStatsFormatter::statsAsPrometheus(
+        store_.counters(), store_.gauges(), store_.histograms(),
+        params.prometheus_text_readouts_ ? store_.textReadouts()
+                                         : std::vector<Stats::TextReadoutSharedPtr>(),
+        data, params, custom_namespaces_);
+    return data.toString();
+  }
+
+  Stats::CustomStatNamespacesImpl custom_namespaces_;
+};
+
+TEST_F(PrometheusStatsRequestTest, Empty) {
+  EXPECT_EQ(0, iterateChunks(*makePrometheusRequest(StatsParams())));
+}
+
+TEST_F(PrometheusStatsRequestTest, MatchesBufferedOutput) {
+  for (absl::string_view cluster : {"c", "a", "b"}) {
+    addClusterStats(cluster);
+  }
+  store_.rootScope()->counterFromStatName(makeStatName("server.foo"));
+
+  StatsParams params;
+  const std::string expected = bufferedResponse(params);
+  EXPECT_THAT(expected, testing::HasSubstr("envoy_cluster_rq{envoy_cluster_name=\"a\"} 3\n"));
+  EXPECT_EQ(expected, response(*makePrometheusRequest(params)));
+
+  params.prometheus_text_readouts_ = true;
+  params.used_only_ = true;
+  EXPECT_EQ(bufferedResponse(params), response(*makePrometheusRequest(params)));
+}
+
+TEST_F(PrometheusStatsRequestTest, ChunksEndOnGroups) {
+  for (absl::string_view cluster : {"a", "b"}) {
+    addClusterStats(cluster);
+  }
+  StatsParams params;
+  params.prometheus_text_readouts_ = true;
+
+  // Each type has one group, holding the stats of both clusters.
+  std::unique_ptr<PrometheusStatsRequest> request = makePrometheusRequest(params);
+  request->setChunkSize(1);
+  EXPECT_EQ(4, iterateChunks(*request));
+
+  request = makePrometheusRequest(params);
+  request->setChunkSize(1);
+  EXPECT_EQ(bufferedResponse(params), response(*request));
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -20,6 +20,7 @@ using testing::AnyNumber;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::Return;
+using testing::StrEq;
 using testing::WithArg;
 
 namespace Envoy {
@@ -100,6 +101,13 @@ TEST_F(HotRestartImplTest, DomainSocketError) {
   EXPECT_THROW(std::make_unique<HotRestartImpl>(0, 0, "@envoy_domain_socket", 0), EnvoyException);
 }
 
+// Test that the parent removes its stats segment on shutdown, in case the child did not.
+TEST_F(HotRestartImplTest, ShutdownUnlinksStatsSegment) {
+  setup();
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmUnlink(StrEq("/envoy_stats_0_0")));
+  hot_restart_->shutdown();
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
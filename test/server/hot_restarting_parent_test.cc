@@ -1,13 +1,17 @@
+#include <unistd.h>
+
 #include <memory>
 
 #include "source/common/network/address_impl.h"
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
+#include "source/server/stats_segment.h"
 
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 using testing::InSequence;
@@ -297,6 +301,55 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportStatsToSharedMemory) {
+  MockListenerManager listener_manager;
+  Stats::SymbolTableImpl parent_symbol_table;
+  Stats::TestUtil::TestStore parent_store(parent_symbol_table);
+
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(7));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(parent_store));
+
+  const std::string segment_name = absl::StrCat("/envoy_stats_parent_test_", getpid());
+  HotRestartMessage::Reply::Stats stats_proto;
+  {
+    Stats::StatNameDynamicPool dynamic(parent_store.symbolTable());
+    parent_store.counter("c1").add(2);
+    parent_store.counter("unused_counter");
+    parent_store.rootScope()->counterFromStatName(dynamic.add("c2")).inc();
+    parent_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+    parent_store.rootScope()
+        ->gaugeFromStatName(dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate)
+        .set(42);
+    hot_restarting_parent_.exportStatsToSharedMemory(&stats_proto, segment_name);
+  }
+  // Only the name of the segment is sent to the child, with the server stats.
+  EXPECT_EQ(segment_name, stats_proto.shared_memory_name());
+  EXPECT_TRUE(stats_proto.counter_deltas().empty());
+  EXPECT_TRUE(stats_proto.gauges().empty());
+  EXPECT_EQ(7, stats_proto.num_connections());
+
+  {
+    Stats::SymbolTableImpl child_symbol_table;
+    Stats::TestUtil::TestStore child_store(child_symbol_table);
+    Stats::StatNameDynamicPool dynamic(child_store.symbolTable());
+    Stats::Counter& c1 = child_store.counter("c1");
+    Stats::Counter& c2 = child_store.rootScope()->counterFromStatName(dynamic.add("c2"));
+    Stats::Gauge& g1 = child_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate);
+    Stats::Gauge& g2 = child_store.rootScope()->gaugeFromStatName(
+        dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate);
+
+    HotRestartingChild hot_restarting_child(0, 0, "@envoy_domain_socket", 0);
+    hot_restarting_child.mergeParentStats(child_store, stats_proto);
+    EXPECT_EQ(2, c1.value());
+    EXPECT_EQ(1, c2.value());
+    EXPECT_EQ(123, g1.value());
+    EXPECT_EQ(42, g2.value());
+  }
+  // The child unlinks the segment once it has read it.
+  EXPECT_EQ(nullptr, StatsSegmentReader::openSharedMemory(segment_name));
+}
+
 TEST_F(HotRestartingParentTest, DrainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 
@@ -35,6 +36,16 @@ private:
   size_t num_histograms_ = 0;
 };
 
+// A sink that only needs the metrics changed since the previous flush.
+class ChangedMetricsSink : public Stats::Sink {
+public:
+  void flush(Stats::MetricSnapshot& snapshot) override {
+    benchmark::DoNotOptimize(snapshot.counters().size());
+  }
+  void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+  bool flushChangedMetricsOnly() const override { return true; }
+};
+
 class StatsSinkFlushSpeedTest {
 public:
   StatsSinkFlushSpeedTest(size_t const num_stats, bool set_sink_predicates = false)
@@ -47,14 +58,15 @@ public:
     // Create counters
     for (uint64_t idx = 0; idx < num_stats; ++idx) {
       auto stat_name = pool_.add(absl::StrCat("counter.", idx));
-      stats_store_.rootScope()->counterFromStatName(stat_name).inc();
+      counters_.push_back(&stats_store_.rootScope()->counterFromStatName(stat_name));
+      counters_.back()->inc();
     }
     // Create gauges
     for (uint64_t idx = 0; idx < num_stats; ++idx) {
       auto stat_name = pool_.add(absl::StrCat("gauge.", idx));
-      stats_store_.rootScope()
-          ->gaugeFromStatName(stat_name, Stats::Gauge::ImportMode::NeverImport)
-          .set(idx);
+      gauges_.push_back(&stats_store_.rootScope()->gaugeFromStatName(
+          stat_name, Stats::Gauge::ImportMode::NeverImport));
+      gauges_.back()->set(idx);
     }
 
     // Create text readouts
@@ -80,12 +92,38 @@ public:
     }
   }
 
+  // Flushes after writing 1% of the counters and gauges, as in a large, mostly idle, server.
+  void testMostlyIdle(::benchmark::State& state, bool changed_only) {
+    std::list<Stats::SinkPtr> sinks;
+    if (changed_only) {
+      sinks.emplace_back(new ChangedMetricsSink());
+    } else {
+      sinks.emplace_back(new testing::NiceMock<Stats::MockSink>());
+    }
+    // The first flush has all the metrics.
+    Server::InstanceUtil::flushMetricsToSinks(sinks, stats_store_, time_system_);
+    uint64_t next = 0;
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      state.PauseTiming();
+      for (size_t i = 0; i < std::max<size_t>(1, counters_.size() / 100); ++i) {
+        next = (next + 97) % counters_.size();
+        counters_[next]->inc();
+        gauges_[next]->inc();
+      }
+      state.ResumeTiming();
+      Server::InstanceUtil::flushMetricsToSinks(sinks, stats_store_, time_system_);
+    }
+  }
+
 private:
   Stats::SymbolTableImpl symbol_table_;
   Stats::StatNamePool pool_;
   Stats::AllocatorImpl stats_allocator_;
   Stats::ThreadLocalStoreImpl stats_store_;
   Event::SimulatedTimeSystem time_system_;
+  std::vector<Stats::Counter*> counters_;
+  std::vector<Stats::Gauge*> gauges_;
 };
 
 static void bmFlushToSinks(::benchmark::State& state) {
@@ -110,10 +148,41 @@ static void bmFlushToSinksWithPredicatesSet(::benchmark::State& state) {
   speed_test.test(state);
 }
 
+static void bmFlushToSinksMostlyIdle(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  StatsSinkFlushSpeedTest speed_test(state.range(0));
+  speed_test.testMostlyIdle(state, false);
+}
+
+static void bmFlushChangedToSinksMostlyIdle(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  StatsSinkFlushSpeedTest speed_test(state.range(0));
+  speed_test.testMostlyIdle(state, true);
+}
+
 BENCHMARK(bmFlushToSinks)->Unit(::benchmark::kMillisecond)->RangeMultiplier(10)->Range(10, 1000000);
 BENCHMARK(bmFlushToSinksWithPredicatesSet)
     ->Unit(::benchmark::kMillisecond)
     ->RangeMultiplier(10)
     ->Range(10, 1000000);
 
+BENCHMARK(bmFlushToSinksMostlyIdle)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000000);
+BENCHMARK(bmFlushChangedToSinksMostlyIdle)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000000);
+
 } // namespace Envoy
@@ -11,6 +11,7 @@
 #include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/socket_option_impl.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
 #include "source/common/version/version.h"
 #include "source/server/process_context_impl.h"
@@ -111,6 +112,55 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store, time_system);
 }
 
+class MockChangedMetricsSink : public Stats::MockSink {
+public:
+  bool flushChangedMetricsOnly() const override { return true; }
+};
+
+TEST(ServerInstanceUtil, FlushChangedMetricsOnly) {
+  Stats::SymbolTableImpl symbol_table;
+  Stats::AllocatorImpl alloc(symbol_table);
+  Stats::ThreadLocalStoreImpl store(alloc);
+  Event::SimulatedTimeSystem time_system;
+  Stats::Counter& c1 = store.counterFromString("c1");
+  store.counterFromString("c2").inc();
+  Stats::Gauge& gauge = store.gaugeFromString("gauge", Stats::Gauge::ImportMode::Accumulate);
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* sink = new StrictMock<MockChangedMetricsSink>();
+  sinks.emplace_back(sink);
+  auto counter_names = [](Stats::MetricSnapshot& snapshot) {
+    std::vector<std::string> names;
+    for (const auto& counter : snapshot.counters()) {
+      names.push_back(counter.counter_.get().name());
+    }
+    return names;
+  };
+
+  // The first flush has all the metrics.
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([&](Stats::MetricSnapshot& snapshot) {
+    EXPECT_THAT(counter_names(snapshot), testing::IsSupersetOf({"c1", "c2"}));
+    EXPECT_FALSE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+
+  c1.add(2);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([&](Stats::MetricSnapshot& snapshot) {
+    EXPECT_THAT(counter_names(snapshot), testing::ElementsAre("c1"));
+    EXPECT_EQ(2, snapshot.counters()[0].delta_);
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+
+  gauge.set(3);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([&](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    ASSERT_EQ(1, snapshot.gauges().size());
+    EXPECT_EQ("gauge", snapshot.gauges()[0].get().name());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {
@@ -0,0 +1,149 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/stats/stat_merger.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/server/hot_restart.pb.h"
+#include "source/server/stats_segment.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Hands num_stats counters and as many gauges from a parent symbol table to a child store, half
+ * of them with a dynamic component, either through the hot restart reply or a stats segment.
+ */
+class StatsHandoffSpeedTest {
+public:
+  explicit StatsHandoffSpeedTest(uint64_t num_stats)
+      : pool_(parent_symbol_table_), dynamic_pool_(parent_symbol_table_),
+        child_store_(child_symbol_table_), stat_merger_(child_store_) {
+    for (uint64_t i = 0; i < num_stats; ++i) {
+      const std::string cluster = absl::StrCat("cluster_", i);
+      const Stats::StatName cluster_name =
+          i % 2 == 0 ? dynamic_pool_.add(cluster) : pool_.add(cluster);
+      joined_.push_back(parent_symbol_table_.join(
+          {pool_.add("cluster"), cluster_name, pool_.add("upstream_rq_total")}));
+      counters_.emplace_back(joined_.back().get());
+      joined_.push_back(parent_symbol_table_.join(
+          {pool_.add("cluster"), cluster_name, pool_.add("upstream_cx_active")}));
+      gauges_.emplace_back(joined_.back().get());
+    }
+  }
+
+  /**
+   * Exports the stats into the reply as HotRestartingParent::Internal::exportStatsToChild does,
+   * and merges them as HotRestartingChild::mergeParentStats does.
+   */
+  void protoHandoff() {
+    envoy::HotRestartMessage::Reply::Stats stats;
+    const auto record = [this, &stats](Protobuf::Map<std::string, uint64_t>& values,
+                                       Stats::StatName stat_name) {
+      const std::string name = parent_symbol_table_.toString(stat_name);
+      values[name] = 1;
+      const Stats::DynamicSpans spans = parent_symbol_table_.getDynamicSpans(stat_name);
+      if (!spans.empty()) {
+        envoy::HotRestartMessage::Reply::RepeatedSpan spans_proto;
+        for (const Stats::DynamicSpan& span : spans) {
+          envoy::HotRestartMessage::Reply::Span* span_proto = spans_proto.add_spans();
+          span_proto->set_first(span.first);
+          span_proto->set_last(span.second);
+        }
+        (*stats.mutable_dynamics())[name] = spans_proto;
+      }
+    };
+    for (Stats::StatName counter : counters_) {
+      record(*stats.mutable_counter_deltas(), counter);
+    }
+    for (Stats::StatName gauge : gauges_) {
+      record(*stats.mutable_gauges(), gauge);
+    }
+
+    envoy::HotRestartMessage::Reply::Stats received;
+    received.ParseFromString(stats.SerializeAsString());
+    Stats::StatMerger::DynamicsMap dynamics;
+    for (const auto& iter : received.dynamics()) {
+      Stats::DynamicSpans& spans = dynamics[iter.first];
+      for (const envoy::HotRestartMessage::Reply::Span& span_proto : iter.second.spans()) {
+        spans.push_back(Stats::DynamicSpan(span_proto.first(), span_proto.last()));
+      }
+    }
+    stat_merger_.mergeStats(received.counter_deltas(), received.gauges(), dynamics);
+  }
+
+  /**
+   * Lays the stats out into a segment and merges them from it, as
+   * HotRestartingChild::mergeParentStatsFromSharedMemory does once the segment is mapped.
+   */
+  void segmentHandoff() {
+    StatsSegmentWriter writer(parent_symbol_table_);
+    for (Stats::StatName counter : counters_) {
+      writer.addCounter(counter, 1);
+    }
+    for (Stats::StatName gauge : gauges_) {
+      writer.addGauge(gauge, 1);
+    }
+
+    std::unique_ptr<StatsSegmentReader> reader = StatsSegmentReader::create(writer.segment());
+    reader->forEachCounter(
+        [this](absl::string_view name, const Stats::DynamicSpans& spans, uint64_t value) {
+          stat_merger_.mergeCounter(name, spans, value);
+        });
+    reader->forEachGauge(
+        [this](absl::string_view name, const Stats::DynamicSpans& spans, uint64_t value) {
+          stat_merger_.mergeGauge(name, spans, value);
+        });
+  }
+
+private:
+  Stats::SymbolTableImpl parent_symbol_table_;
+  Stats::StatNamePool pool_;
+  Stats::StatNameDynamicPool dynamic_pool_;
+  std::vector<Stats::SymbolTable::StoragePtr> joined_;
+  std::vector<Stats::StatName> counters_;
+  std::vector<Stats::StatName> gauges_;
+  Stats::SymbolTableImpl child_symbol_table_;
+  Stats::IsolatedStoreImpl child_store_;
+  Stats::StatMerger stat_merger_;
+};
+
+} // namespace Server
+} // namespace Envoy
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ProtoStatsHandoff(benchmark::State& state) {
+  const uint64_t num_stats = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_stats > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Server::StatsHandoffSpeedTest test(num_stats);
+  for (auto _ : state) { // NOLINT
+    test.protoHandoff();
+  }
+}
+BENCHMARK(BM_ProtoStatsHandoff)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SegmentStatsHandoff(benchmark::State& state) {
+  const uint64_t num_stats = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_stats > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Server::StatsHandoffSpeedTest test(num_stats);
+  for (auto _ : state) { // NOLINT
+    test.segmentHandoff();
+  }
+}
+BENCHMARK(BM_SegmentStatsHandoff)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
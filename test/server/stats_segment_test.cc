@@ -0,0 +1,163 @@
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/stats/allocator_impl.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/server/stats_segment.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+struct ReadStat {
+  std::string name_;
+  Stats::DynamicSpans spans_;
+  uint64_t value_;
+
+  bool operator==(const ReadStat& other) const {
+    return name_ == other.name_ && spans_ == other.spans_ && value_ == other.value_;
+  }
+};
+
+class StatsSegmentTest : public testing::Test {
+protected:
+  StatsSegmentTest() : pool_(symbol_table_), dynamic_pool_(symbol_table_) {}
+
+  // Adds two counters and a gauge, one of them with a dynamic component.
+  void addStats(StatsSegmentWriter& writer) {
+    writer.addCounter(pool_.add("cluster.rq"), 3);
+    joined_.push_back(
+        symbol_table_.join({pool_.add("cluster"), dynamic_pool_.add("a.b"), pool_.add("rq")}));
+    writer.addCounter(Stats::StatName(joined_.back().get()), 0);
+    writer.addGauge(pool_.add("g"), 12345678901234);
+  }
+
+  std::vector<ReadStat> counters(const StatsSegmentReader& reader) {
+    std::vector<ReadStat> stats;
+    reader.forEachCounter(
+        [&stats](absl::string_view name, const Stats::DynamicSpans& spans, uint64_t value) {
+          stats.push_back({std::string(name), spans, value});
+        });
+    return stats;
+  }
+
+  std::vector<ReadStat> gauges(const StatsSegmentReader& reader) {
+    std::vector<ReadStat> stats;
+    reader.forEachGauge(
+        [&stats](absl::string_view name, const Stats::DynamicSpans& spans, uint64_t value) {
+          stats.push_back({std::string(name), spans, value});
+        });
+    return stats;
+  }
+
+  void expectStats(const StatsSegmentReader& reader) {
+    EXPECT_EQ(2, reader.numCounters());
+    EXPECT_EQ(1, reader.numGauges());
+    const std::vector<ReadStat> expected_counters = {{"cluster.rq", {}, 3},
+                                                     {"cluster.a.b.rq", {{1, 2}}, 0}};
+    EXPECT_EQ(expected_counters, counters(reader));
+    const std::vector<ReadStat> expected_gauges = {{"g", {}, 12345678901234}};
+    EXPECT_EQ(expected_gauges, gauges(reader));
+  }
+
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::StatNamePool pool_;
+  Stats::StatNameDynamicPool dynamic_pool_;
+  std::vector<Stats::SymbolTable::StoragePtr> joined_;
+};
+
+TEST_F(StatsSegmentTest, Empty) {
+  StatsSegmentWriter writer(symbol_table_);
+  const std::string segment = writer.segment();
+  EXPECT_EQ(sizeof(StatsSegmentHeader), segment.size());
+  std::unique_ptr<StatsSegmentReader> reader = StatsSegmentReader::create(segment);
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(0, reader->numCounters());
+  EXPECT_EQ(0, reader->numGauges());
+}
+
+TEST_F(StatsSegmentTest, RoundTrip) {
+  StatsSegmentWriter writer(symbol_table_);
+  addStats(writer);
+  std::unique_ptr<StatsSegmentReader> reader = StatsSegmentReader::create(writer.segment());
+  ASSERT_NE(nullptr, reader);
+  expectStats(*reader);
+}
+
+// Stats added by reference stay alive, along with their names, while the writer is used.
+TEST_F(StatsSegmentTest, HoldsStats) {
+  Stats::AllocatorImpl allocator(symbol_table_);
+  StatsSegmentWriter writer(symbol_table_);
+  {
+    Stats::CounterSharedPtr counter =
+        allocator.makeCounter(dynamic_pool_.add("counter"), Stats::StatName(), {});
+    Stats::GaugeSharedPtr gauge = allocator.makeGauge(
+        dynamic_pool_.add("gauge"), Stats::StatName(), {}, Stats::Gauge::ImportMode::Accumulate);
+    gauge->set(7);
+    writer.addCounter(counter, 3);
+    writer.addGauge(gauge, gauge->value());
+  }
+  std::unique_ptr<StatsSegmentReader> reader = StatsSegmentReader::create(writer.segment());
+  ASSERT_NE(nullptr, reader);
+  const std::vector<ReadStat> expected_counters = {{"counter", {{0, 0}}, 3}};
+  EXPECT_EQ(expected_counters, counters(*reader));
+  const std::vector<ReadStat> expected_gauges = {{"gauge", {{0, 0}}, 7}};
+  EXPECT_EQ(expected_gauges, gauges(*reader));
+}
+
+TEST_F(StatsSegmentTest, Invalid) {
+  StatsSegmentWriter writer(symbol_table_);
+  addStats(writer);
+  const std::string segment = writer.segment();
+
+  // Every truncation of the segment is rejected.
+  for (size_t size = 0; size < segment.size(); ++size) {
+    EXPECT_EQ(nullptr, StatsSegmentReader::create(segment.substr(0, size))) << size;
+  }
+
+  std::string bad_magic = segment;
+  bad_magic[0] ^= 1;
+  EXPECT_EQ(nullptr, StatsSegmentReader::create(bad_magic));
+
+  std::string bad_version = segment;
+  bad_version[offsetof(StatsSegmentHeader, version_)] ^= 1;
+  EXPECT_EQ(nullptr, StatsSegmentReader::create(bad_version));
+
+  // A count which overflows when added to the other one.
+  std::string bad_count = segment;
+  bad_count.replace(offsetof(StatsSegmentHeader, num_gauges_), sizeof(uint64_t),
+                    std::string(sizeof(uint64_t), '\xff'));
+  EXPECT_EQ(nullptr, StatsSegmentReader::create(bad_count));
+}
+
+TEST_F(StatsSegmentTest, SharedMemory) {
+  const std::string name = absl::StrCat("/envoy_stats_segment_test_", getpid());
+  EXPECT_EQ(nullptr, StatsSegmentReader::openSharedMemory(name));
+
+  StatsSegmentWriter writer(symbol_table_);
+  addStats(writer);
+  ASSERT_TRUE(writer.writeSharedMemory(name));
+  std::unique_ptr<StatsSegmentReader> reader = StatsSegmentReader::openSharedMemory(name);
+  ASSERT_NE(nullptr, reader);
+
+  // Writing again replaces the object, leaving the mapped segment as it was.
+  StatsSegmentWriter empty_writer(symbol_table_);
+  ASSERT_TRUE(empty_writer.writeSharedMemory(name));
+  expectStats(*reader);
+  std::unique_ptr<StatsSegmentReader> empty_reader = StatsSegmentReader::openSharedMemory(name);
+  ASSERT_NE(nullptr, empty_reader);
+  EXPECT_EQ(0, empty_reader->numCounters());
+  shm_unlink(name.c_str());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy